@@ -0,0 +1,105 @@
+#ifndef __D_ALLOC_H
+#define __D_ALLOC_H
+
+#include <dtypes.h>
+#include <stdlib.h>
+
+typedef struct _DAllocator DAllocator;
+
+/**
+ * @brief Allocates `size` bytes, returns NULL on failure.
+ */
+typedef void*(*DAllocFunc)(void* ctx, usize size);
+
+/**
+ * @brief Resizes a block of `old_size` bytes to `new_size` bytes, returns NULL on failure and leaves `ptr` untouched.
+ * A NULL `ptr` (with an `old_size` of 0) must behave as an allocation.
+ */
+typedef void*(*DReallocFunc)(void* ctx, void* ptr, usize old_size, usize new_size);
+
+/**
+ * @brief Releases a block of `size` bytes, `ptr` is never NULL.
+ */
+typedef void(*DFreeFunc)(void* ctx, void* ptr, usize size);
+
+/**
+ * DAllocator:
+ * @param alloc allocates a block.
+ * @param realloc resizes a block.
+ * @param free releases a block.
+ * @param ctx the user context given back to the three functions, an arena or a pool for instance.
+ *
+ * An allocator the containers of the library can be built with instead of the libc one.
+ * Every call receives the size of the block it works on, so allocators that do not record the size
+ * of their blocks (arenas, size class pools) can be plugged in without any header per block.
+ * A container only stores a pointer to its allocator: the `DAllocator` must outlive every container built with it.
+ * A NULL allocator everywhere means the libc one (`malloc`, `realloc`, `free`), which costs a single
+ * predictable branch over calling libc directly.
+ */
+struct _DAllocator {
+	DAllocFunc		alloc;
+	DReallocFunc	realloc;
+	DFreeFunc		free;
+	void*			ctx;
+};
+
+/**
+ * @brief Allocates `size` bytes with `allocator`, NULL meaning libc.
+ */
+static inline void*	d_alloc(const DAllocator* allocator, usize size)
+{
+	if (allocator == NULL)
+		return malloc(size);
+	return allocator -> alloc(allocator -> ctx, size);
+}
+
+/**
+ * @brief Allocates an array of `nmemb` elements of `size` bytes with `allocator`.
+ *
+ * @return void* The block, NULL if `nmemb * size` overflows or if the allocation fails.
+ */
+static inline void*	d_alloc_array(const DAllocator* allocator, usize nmemb, usize size)
+{
+	if (allocator == NULL)
+		return reallocarray(NULL, nmemb, size);
+	if (size != 0 && nmemb > MAX_SIZE_T_VALUE / size)
+		return NULL;
+	return allocator -> alloc(allocator -> ctx, nmemb * size);
+}
+
+/**
+ * @brief Resizes a block of `old_size` bytes to `new_size` bytes with `allocator`.
+ */
+static inline void*	d_realloc(const DAllocator* allocator, void* ptr, usize old_size, usize new_size)
+{
+	if (allocator == NULL)
+		return realloc(ptr, new_size);
+	return allocator -> realloc(allocator -> ctx, ptr, old_size, new_size);
+}
+
+/**
+ * @brief Resizes an array of `old_nmemb` elements of `size` bytes to `new_nmemb` elements with `allocator`.
+ *
+ * @return void* The resized block, NULL if `new_nmemb * size` overflows or if the allocation fails.
+ */
+static inline void*	d_realloc_array(const DAllocator* allocator, void* ptr, usize old_nmemb, usize new_nmemb, usize size)
+{
+	if (allocator == NULL)
+		return reallocarray(ptr, new_nmemb, size);
+	if (size != 0 && new_nmemb > MAX_SIZE_T_VALUE / size)
+		return NULL;
+	return allocator -> realloc(allocator -> ctx, ptr, old_nmemb * size, new_nmemb * size);
+}
+
+/**
+ * @brief Releases a block of `size` bytes allocated with `allocator`, nothing is done if `ptr` is NULL.
+ */
+static inline void	d_free(const DAllocator* allocator, void* ptr, usize size)
+{
+	if (allocator == NULL)
+		free(ptr);
+	else if (ptr != NULL)
+		allocator -> free(allocator -> ctx, ptr, size);
+}
+
+#endif
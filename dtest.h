@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <dutils.h>
 #include <sys/wait.h>
+#include <unistd.h>
 #define MAX_VALUE_SIZE_T (~(size_t)0)
 
 #define PRINT_SUCCESS_TEST(message) (printf(GREEN message RESET))
@@ -22,13 +23,13 @@ typedef char*(*DbgFn)(void*);
         } else { \
             if (pfn != NULL) { \
                 DbgFn fn = (DbgFn)pfn; \
-                char *_left = fn(left); \
-                char *_right = fn(right); \
+                char *_left = fn((void*)(left)); \
+                char *_right = fn((void*)(right)); \
                 fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, _left, _right); \
                 free(_left); \
                 free(_right); \
             } else { \
-                fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, left, right); \
+                fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, (const char*)(left), (const char*)(right)); \
             } \
         } \
         exit(0); \
@@ -46,11 +47,11 @@ typedef char*(*DbgFn)(void*);
         } else { \
             do { \
                 if ((pfn) == (NULL)) { \
-                    fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, left, right); \
+                    fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, (const char*)(left), (const char*)(right)); \
                 } else { \
                     DbgFn fn = (DbgFn)pfn; \
-                    char *_left = fn(left); \
-                    char *_right = fn(right); \
+                    char *_left = fn((void*)(left)); \
+                    char *_right = fn((void*)(right)); \
                     fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, _left, _right); \
                     free(_left); \
                     free(_right); \
@@ -80,12 +81,12 @@ typedef char*(*DbgFn)(void*);
             } else if ((pfn_left) != (NULL) && (pfn_right) == NULL) { \
                 DbgFn fn_left = (DbgFn)pfn_left; \
                 char *_left = fn_left(left); \
-                fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, _left, right); \
+                fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, _left, (const char*)(right)); \
                 free(_left); \
             } else if ((pfn_right) != (NULL) && (pfn_left) == NULL) { \
                 DbgFn fn_right = (DbgFn)pfn_right; \
                 char *_right = fn_left(right); \
-                fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, left, _right); \
+                fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, (const char*)(left), _right); \
                 free(_right); \
             } \
         } while (0); \
@@ -101,11 +102,11 @@ typedef char*(*DbgFn)(void*);
         } else { \
             do { \
                 if ((pfn) == (NULL)) { \
-                    fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, left, right); \
+                    fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, (const char*)(left), (const char*)(right)); \
                 } else { \
                     DbgFn fn = (DbgFn)pfn; \
-                    char *_left = fn(left); \
-                    char *_right = fn(right); \
+                    char *_left = fn((void*)(left)); \
+                    char *_right = fn((void*)(right)); \
                     fprintf(stderr, RED "\nassertion `left == right` failed\nleft: \"%s\"\nright: \"%s\"\n" RESET, _left, _right); \
                     free(_left); \
                     free(_right); \
@@ -128,11 +129,11 @@ typedef char*(*DbgFn)(void*);
         } else { \
             if (pfn != NULL) { \
                 DbgFn fn = (DbgFn)pfn; \
-                char *_data = fn(data); \
+                char *_data = fn((void*)(data)); \
                 fprintf(stderr, RED "\nassertion `data == NULL` failed\ndata: \"%s\"\n" RESET , _data); \
                 free(_data); \
             } else { \
-                fprintf(stderr, RED "\nassertion `data == NULL` failed\ndata: \"%s\"" RESET, data); \
+                fprintf(stderr, RED "\nassertion `data == NULL` failed\ndata: \"%s\"" RESET, (const char*)(data)); \
             } \
         } \
         exit(0); \
@@ -150,11 +151,11 @@ typedef char*(*DbgFn)(void*);
         } else { \
             if (pfn != NULL) { \
                 DbgFn fn = (DbgFn)pfn; \
-                char *_data = fn(data); \
+                char *_data = fn((void*)(data)); \
                 fprintf(stderr, RED "\nassertion `data == NULL` failed\ndata: \"%s\"\n" RESET , _data); \
                 free(_data); \
             } else { \
-                fprintf(stderr, RED "\nassertion `data == NULL` failed\ndata: \"%s\"" RESET, data); \
+                fprintf(stderr, RED "\nassertion `data == NULL` failed\ndata: \"%s\"" RESET, (const char*)(data)); \
             } \
         } \
         exit(0); \
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dsort.h"
+#include "dparallel.h"
+
+/*
+ * Sort benchmark of qsort against d_sort, the type-specialized d_sort_* and d_radix_sort, from 10^3 to 10^7
+ * elements, or to 10^N with `./bench N`.
+ *
+ * qsort and d_sort both call the comparator through a pointer, the difference between them is the algorithm. The
+ * specialized sorts run the same pdqsort with the comparison inlined, the radix sort does not compare at all.
+ * Each size is sorted from the same random input several times, and the fastest run is kept so that the noise of
+ * the machine does not hide the differences. Times are in ns per element.
+ *
+ * The parallel part sorts, sums and scans int32 arrays from 10^5 elements with the d_parallel_ functions on the
+ * shared pool, against d_sort_i32 and plain loops on one thread. Its speedups can only show on a machine with
+ * several cores.
+ */
+
+#define SORTED_ELEMENTS 20000000
+#define MIN_RUNS 3
+
+static double    now_in_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static u64   bench_rand(u64* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static int32 cmp_i32(const void* a, const void* b)
+{
+    int32 x = *(const int32*)a;
+    int32 y = *(const int32*)b;
+    return (x > y) - (x < y);
+}
+
+static int32 cmp_f64(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+typedef enum { SORT_QSORT, SORT_GENERIC, SORT_SPECIALIZED, SORT_RADIX } SortKind;
+
+static void    run_sort(SortKind kind, void* data, usize n, usize elem_size)
+{
+    bool is_double = elem_size == sizeof(double);
+    DCompareFunc cmp = is_double ? cmp_f64 : cmp_i32;
+    if (kind == SORT_QSORT)
+        qsort(data, n, elem_size, cmp);
+    else if (kind == SORT_GENERIC)
+        d_sort(data, n, elem_size, cmp);
+    else if (kind == SORT_SPECIALIZED && is_double)
+        d_sort_f64(data, n);
+    else if (kind == SORT_SPECIALIZED)
+        d_sort_i32(data, n);
+    else if (d_radix_sort(data, n, elem_size, is_double ? D_RADIX_FLOAT : D_RADIX_SIGNED, NULL) == false)
+        printf("radix sort failed\n");
+}
+
+//Fastest of the runs, in ns per element
+static double  bench_sort(SortKind kind, const void* input, void* data, usize n, usize elem_size)
+{
+    usize runs = SORTED_ELEMENTS / n;
+    if (runs < MIN_RUNS)
+        runs = MIN_RUNS;
+    double best = 1e300;
+    for (usize r = 0; r < runs; ++r)
+    {
+        memcpy(data, input, n * elem_size);
+        double start = now_in_seconds();
+        run_sort(kind, data, n, elem_size);
+        double elapsed = now_in_seconds() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best * 1e9 / n;
+}
+
+static void    bench_type(const char* name, usize elem_size, usize max_n)
+{
+    printf("\n%s, ns per element\n", name);
+    printf("%10s %12s %12s %12s %12s\n", "n", "qsort", "d_sort", "specialized", "radix");
+    void* input = malloc(max_n * elem_size);
+    void* data = malloc(max_n * elem_size);
+    void* check = malloc(max_n * elem_size);
+    if (input == NULL || data == NULL || check == NULL)
+    {
+        printf("not enough memory for %zu elements\n", max_n);
+        max_n = 0;
+    }
+    u64 state = 88172645463325252ULL;
+    for (usize n = 1000; n <= max_n; n *= 10)
+    {
+        for (usize i = 0; i < n; ++i)
+        {
+            u64 r = bench_rand(&state);
+            if (elem_size == sizeof(double))
+                ((double*)input)[i] = (double)(int64)r / 1e9;
+            else
+                ((int32*)input)[i] = (int32)r;
+        }
+        double ns[4];
+        for (SortKind kind = SORT_QSORT; kind <= SORT_RADIX; ++kind)
+        {
+            ns[kind] = bench_sort(kind, input, data, n, elem_size);
+            if (kind == SORT_QSORT)
+                memcpy(check, data, n * elem_size);
+            else if (memcmp(check, data, n * elem_size) != 0)
+                printf("different result for kind %d\n", kind);
+        }
+        printf("%10zu %12.2f %12.2f %12.2f %12.2f\n", n, ns[0], ns[1], ns[2], ns[3]);
+    }
+    free(input);
+    free(data);
+    free(check);
+}
+
+static void    add_i64(void* acc, const void* value, void* ctx)
+{
+    (void)ctx;
+    *(int64*)acc += *(const int64*)value;
+}
+
+static void    add_i32_to_i64(void* acc, const void* value, void* ctx)
+{
+    (void)ctx;
+    *(int64*)acc += *(const int32*)value;
+}
+
+static void    add_i32(void* acc, const void* value, void* ctx)
+{
+    (void)ctx;
+    *(int32*)acc += *(const int32*)value;
+}
+
+static void    bench_parallel(usize max_n)
+{
+    printf("\nparallel int32, %zu threads, ms per call\n", d_thread_pool_get_thread_count(d_thread_pool_get_shared()));
+    printf("%10s %12s %12s %12s %12s %12s %12s\n", "n", "d_sort_i32", "par sort", "sum loop", "par reduce",
+        "scan loop", "par scan");
+    u64 state = 88172645463325252ULL;
+    for (usize n = 100000; n <= max_n; n *= 10)
+    {
+        DArray* input = d_array_new(false, sizeof(int32), n);
+        DArray* array = d_array_new(false, sizeof(int32), n);
+        if (input == NULL || array == NULL)
+        {
+            printf("not enough memory for %zu elements\n", n);
+            d_array_destroy(&input);
+            d_array_destroy(&array);
+            return;
+        }
+        for (usize i = 0; i < n; ++i)
+            ((int32*)input -> data)[i] = (int32)bench_rand(&state);
+        input -> len = n;
+        array -> len = n;
+        double ms[6];
+        for (usize i = 0; i < 6; ++i)
+            ms[i] = 1e300;
+        int64 sums[2] = {0, 0};
+        for (usize r = 0; r < MIN_RUNS; ++r)
+        {
+            double times[6];
+            memcpy(array -> data, input -> data, n * sizeof(int32));
+            double start = now_in_seconds();
+            d_sort_i32(array -> data, n);
+            times[0] = now_in_seconds() - start;
+            memcpy(array -> data, input -> data, n * sizeof(int32));
+            start = now_in_seconds();
+            d_parallel_sort(array, cmp_i32, NULL);
+            times[1] = now_in_seconds() - start;
+            start = now_in_seconds();
+            sums[0] = 0;
+            for (usize i = 0; i < n; ++i)
+                sums[0] += ((int32*)input -> data)[i];
+            times[2] = now_in_seconds() - start;
+            start = now_in_seconds();
+            sums[1] = 0;
+            d_parallel_reduce(input, &sums[1], sizeof(int64), add_i32_to_i64, add_i64, NULL, NULL);
+            times[3] = now_in_seconds() - start;
+            memcpy(array -> data, input -> data, n * sizeof(int32));
+            start = now_in_seconds();
+            int32* values = array -> data;
+            for (usize i = 1; i < n; ++i)
+                values[i] += values[i - 1];
+            times[4] = now_in_seconds() - start;
+            memcpy(array -> data, input -> data, n * sizeof(int32));
+            start = now_in_seconds();
+            d_parallel_prefix_sum(array, add_i32, NULL, NULL);
+            times[5] = now_in_seconds() - start;
+            for (usize i = 0; i < 6; ++i)
+                if (times[i] < ms[i])
+                    ms[i] = times[i];
+        }
+        if (sums[0] != sums[1])
+            printf("different sums\n");
+        printf("%10zu %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f\n", n, ms[0] * 1e3, ms[1] * 1e3, ms[2] * 1e3,
+            ms[3] * 1e3, ms[4] * 1e3, ms[5] * 1e3);
+        d_array_destroy(&input);
+        d_array_destroy(&array);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    usize max_n = 10000000;
+    if (argc > 1)
+    {
+        max_n = 1;
+        for (int e = atoi(argv[1]); e > 0; --e)
+            max_n *= 10;
+    }
+    bench_type("random int32", sizeof(int32), max_n);
+    bench_type("random double", sizeof(double), max_n);
+    bench_parallel(max_n);
+    return 0;
+}
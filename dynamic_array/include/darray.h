@@ -2,12 +2,44 @@
 #define __D_ARRAY_H
 
 #include <dtypes.h>
+#include <dalloc.h>
 
 typedef struct _DArray			DArray;
 typedef struct _DPointerArray	DPointerArray;
+typedef struct _DGrowthPolicy	DGrowthPolicy;
 
 typedef void(*DestroyElemFunc)(void*);
 
+/**
+ * DGrowthPolicy:
+ * @param factor_num numerator of the growth factor, the capacity is multiplied by
+ *     `factor_num / factor_den` each time the array runs out of space.
+ * @param factor_den denominator of the growth factor.
+ * @param min_step the minimum number of elements added to the capacity on each growth.
+ * @param max_step the maximum number of elements added to the capacity on each growth,
+ *     0 means that the step is unbounded.
+ * @param round_to_size_class if true the new buffer size (in bytes) is rounded up to the
+ *     next allocator size class so the slack the allocator would waste becomes usable capacity.
+ *
+ * Describes how a #DArray or a #DPointerArray grows when it runs out of space.
+ * The factor must be strictly greater than 1 so that appending is amortized O(1).
+ * Setting a `max_step` turns the growth into an arithmetic one once the step reaches it,
+ * which trades the amortized O(1) guarantee for a bounded memory overhead on huge arrays.
+ */
+struct _DGrowthPolicy {
+	u32		factor_num;
+	u32		factor_den;
+	usize	min_step;
+	usize	max_step;
+	bool	round_to_size_class;
+};
+
+/**
+ * @brief The growth policy used by every array that was not given one: a factor of 1.5,
+ * a minimum step of 4 elements, no maximum step and size class rounding.
+ */
+#define D_GROWTH_POLICY_DEFAULT ((DGrowthPolicy){ .factor_num = 3, .factor_den = 2, .min_step = 4, .max_step = 0, .round_to_size_class = true })
+
 /**
  * DArray:
  * @param data a pointer to the element data. The data may be moved as
@@ -25,6 +57,55 @@ struct _DArray {
 	usize   	len;
 };
 
+/**
+ * DArrayHeader:
+ *
+ * Storage large enough to hold the private header of a #DArray, used to place a #DArray
+ * on the stack or inside another structure instead of allocating its header.
+ * Its content must only be accessed through the `array` member once initialized.
+ */
+#define D_ARRAY_HEADER_SIZE (sizeof(usize) * 16)
+
+typedef union _DArrayHeader DArrayHeader;
+
+union _DArrayHeader {
+	DArray	array;
+	u8		_private[D_ARRAY_HEADER_SIZE];
+	usize	_align;
+};
+
+/**
+ * @brief Declares a small-buffer-optimized dynamic array type.
+ *
+ * Expands to an anonymous structure holding a #DArray header followed by inline storage
+ * for the first `n` elements of type `type`. Once initialized with `d_small_array_init`,
+ * the array behaves as any other #DArray: it stays in the inline storage until it holds
+ * more than `n` elements, then moves its elements to the heap.
+ *
+ * @code
+ * D_SMALL_ARRAY(int, 8) small;
+ * DArray* array = d_small_array_init(&small, false);
+ * d_array_push_back(array, value);
+ * d_array_destroy(&array);
+ * @endcode
+ *
+ * @param type The type of the elements stored inline.
+ * @param n The number of elements that fit in the inline storage.
+ */
+#define D_SMALL_ARRAY(type, n) struct { DArrayHeader header; type inline_data[(n)]; }
+
+/**
+ * @brief Initializes a small array declared with `D_SMALL_ARRAY`.
+ *
+ * @param sa A pointer to the structure declared with `D_SMALL_ARRAY`.
+ * @param clear Same meaning as the `clear` parameter of `d_array_new`.
+ *
+ * @return DArray* A pointer to the #DArray living inside `sa`.
+ */
+#define d_small_array_init(sa, clear) \
+	d_array_init_inline(&(sa)->header, (clear), sizeof(*(sa)->inline_data), (sa)->inline_data, \
+		sizeof((sa)->inline_data) / sizeof(*(sa)->inline_data))
+
 /**
  * DPointerArray:
  * @pdata: points to the array of pointers, which may be moved when the
@@ -101,6 +182,55 @@ struct _DPointerArray {
  */
 DArray  *d_array_new				(bool	clear,		usize elem_size, usize reserved_elem);
 
+/**
+ * @brief Creates a new dynamic array whose header and buffer are allocated with `allocator`.
+ *
+ * Same as `d_array_new`, but every allocation, reallocation and deallocation of the array goes through
+ * `allocator` instead of libc, which lets a hot array live in an arena, a pool or huge pages.
+ * The array only keeps a pointer to `allocator`, so it must outlive the array. `d_array_copy` gives the
+ * copy the same allocator.
+ *
+ * @param clear A boolean value indicating whether to zero out the allocated memory for elements.
+ * @param elem_size The size of each element in the dynamic array, in bytes.
+ * @param reserved_elem The initial number of elements that the array is reserved to hold, 0 for the default capacity.
+ * @param allocator The allocator of the array, NULL for libc.
+ *
+ * @return DArray* A pointer to the newly created `DArray`. Returns NULL if the allocation fails.
+ */
+DArray  *d_array_new_with_allocator	(bool	clear,		usize elem_size, usize reserved_elem, const DAllocator* allocator);
+
+/**
+ * @brief Initializes a dynamic array in caller provided memory.
+ *
+ * Builds a `DArray` whose header lives in `header` and whose first `inline_capacity` elements
+ * live in `storage`, so creating it allocates nothing. When an append needs more room than
+ * `storage` offers, the elements are moved to a heap buffer and the array keeps growing there.
+ * `d_array_destroy` may be called on such an array: it releases the heap buffer, if any,
+ * but neither `header` nor `storage`. Both must outlive the array. The capacity of an array
+ * still using its inline storage never goes below the inline capacity.
+ * Most callers should use the `D_SMALL_ARRAY` and `d_small_array_init` macros instead.
+ *
+ * @param header The memory that will hold the array's header. Must not be NULL.
+ * @param clear A boolean value indicating whether to zero out the memory of the elements.
+ * @param elem_size The size of each element in the dynamic array, in bytes.
+ * @param storage The inline storage for the first elements, must be at least
+ *                `elem_size * inline_capacity` bytes long.
+ * @param inline_capacity The number of elements `storage` can hold.
+ *
+ * @return DArray* A pointer to the `DArray` stored in `header`.
+ */
+DArray  *d_array_init_inline		(DArrayHeader* header, bool clear, usize elem_size, void* storage, usize inline_capacity);
+
+/**
+ * @brief Tells whether a dynamic array still stores its elements in its inline storage.
+ *
+ * @param array A pointer to the `DArray`. Must not be NULL.
+ *
+ * @return bool true if the elements live in the storage given to `d_array_init_inline`,
+ *         false if they live in a heap buffer.
+ */
+bool	d_array_is_inline			(DArray* array);
+
 /**
  * @brief Creates a copy of an existing dynamic array.
  *
@@ -135,7 +265,8 @@ usize	d_array_get_capacity		(DArray* array);
  *                or smaller than the current capacity.
  *
  * This function adjusts the array's storage capacity, which can be used to either
- * increase or decrease the size of the array.
+ * increase or decrease the size of the array. If `new_capacity` is lower than the
+ * length of the array, the elements past `new_capacity` are dropped.
  *
  * @return a pointer to the updated #DArray with the modified capacity. If the
  *          reallocation fails, it typically returns NULL.
@@ -213,6 +344,83 @@ DArray  *d_array_clear_array		(DArray* array);
  */
 void    d_array_destroy				(DArray** array);
 
+/**
+ * @brief Sets the growth policy of a dynamic array.
+ *
+ * Copies `policy` into the `DArray`, every further growth of the array will follow it.
+ * Passing NULL restores `D_GROWTH_POLICY_DEFAULT`.
+ *
+ * @param array A pointer to the `DArray` whose growth policy is modified. Must not be NULL.
+ * @param policy A pointer to the new policy, or NULL for the default one.
+ *
+ * @return DArray* A pointer to the updated `DArray`. Returns NULL if the policy is invalid
+ *         (see `d_growth_policy_is_valid`), in which case the array is left untouched.
+ */
+DArray	*d_array_set_growth_policy	(DArray* array, const DGrowthPolicy* policy);
+
+/**
+ * @brief Retrieves how many times the buffer of a dynamic array has been reallocated.
+ *
+ * Every growth triggered by an append and every call to `d_array_modify_capacity` that
+ * changes the capacity counts as one reallocation. The initial allocation is not counted.
+ *
+ * @param array A pointer to the `DArray`. Must not be NULL.
+ *
+ * @return usize The number of reallocations of the array's buffer.
+ */
+usize	d_array_get_realloc_count	(DArray* array);
+
+/**
+ * @brief Retrieves the allocator a dynamic array was created with.
+ *
+ * @param array A pointer to the `DArray`. Must not be NULL.
+ *
+ * @return const DAllocator* The allocator of the array, NULL when it uses libc. Arrays initialized with
+ *         `d_array_init_inline` always spill to libc memory.
+ */
+const DAllocator*	d_array_get_allocator	(DArray* array);
+
+/**
+ * @brief Retrieves the size in bytes of an element of a dynamic array.
+ *
+ * @param array A pointer to the `DArray`. Must not be NULL.
+ *
+ * @return usize The `elem_size` the array was created with.
+ */
+usize	d_array_get_elem_size		(DArray* array);
+
+/*-------------------------------------------------DGrowthPolicy-------------------------------------------------*/
+
+/**
+ * @brief Checks that a growth policy guarantees progress.
+ *
+ * A policy is valid when its factor is strictly greater than 1, its minimum step is not 0
+ * and its maximum step, when set, is not lower than its minimum step.
+ *
+ * @param policy A pointer to the policy to check. Must not be NULL.
+ *
+ * @return bool true if the policy is valid, false otherwise.
+ */
+bool	d_growth_policy_is_valid		(const DGrowthPolicy* policy);
+
+/**
+ * @brief Computes the capacity an array should grow to.
+ *
+ * Applies `policy` to `capacity` until the result can hold `required` elements: the
+ * capacity is multiplied by the growth factor, the step is clamped to [min_step, max_step],
+ * the result is raised to `required` if still too small and finally rounded up to the next
+ * allocator size class when the policy asks for it.
+ *
+ * @param policy A pointer to a valid growth policy. Must not be NULL.
+ * @param capacity The current capacity, in elements.
+ * @param required The minimum capacity, in elements, the array needs.
+ * @param elem_size The size of one element in bytes, used for the size class rounding.
+ *
+ * @return usize The new capacity in elements. Returns 0 if the new capacity in bytes
+ *         would overflow a `usize`.
+ */
+usize	d_growth_policy_next_capacity	(const DGrowthPolicy* policy, usize capacity, usize required, usize elem_size);
+
 /*-------------------------------------------------DPointerArray-------------------------------------------------*/
 
 /**
@@ -235,6 +443,22 @@ void    d_array_destroy				(DArray** array);
  */
 DPointerArray*	d_pointer_array_new					(usize reserved_elem, bool null_terminated, DestroyElemFunc free_func);
 
+/**
+ * @brief Creates a new dynamic pointer array whose header and buffer are allocated with `allocator`.
+ *
+ * Same as `d_pointer_array_new`, but the memory of the array itself goes through `allocator` instead of libc.
+ * The elements are not concerned: `free_func` is still the one releasing them. The array only keeps a pointer
+ * to `allocator`, so it must outlive the array.
+ *
+ * @param reserved_elem The initial number of pointers that the array is reserved to hold, 0 for the default capacity.
+ * @param null_terminated A boolean flag indicating whether the array should be NULL-terminated.
+ * @param free_func The function called on each element when destroying the array, may be NULL.
+ * @param allocator The allocator of the array, NULL for libc.
+ *
+ * @return DPointerArray* A pointer to the newly created `DPointerArray`. Returns NULL if the allocation fails.
+ */
+DPointerArray*	d_pointer_array_new_with_allocator	(usize reserved_elem, bool null_terminated, DestroyElemFunc free_func, const DAllocator* allocator);
+
 /**
  * @brief Retrieves the current capacity of a dynamic pointer array.
  *
@@ -343,4 +567,36 @@ DPointerArray  *d_pointer_array_clear_array		(DPointerArray* array);
  */
 void    d_pointer_array_destroy		(DPointerArray** array);
 
+/**
+ * @brief Sets the growth policy of a dynamic pointer array.
+ *
+ * Copies `policy` into the `DPointerArray`, every further growth of the array will follow it.
+ * Passing NULL restores `D_GROWTH_POLICY_DEFAULT`.
+ *
+ * @param array A pointer to the `DPointerArray` whose growth policy is modified. Must not be NULL.
+ * @param policy A pointer to the new policy, or NULL for the default one.
+ *
+ * @return DPointerArray* A pointer to the updated `DPointerArray`. Returns NULL if the policy is invalid,
+ *         in which case the array is left untouched.
+ */
+DPointerArray	*d_pointer_array_set_growth_policy	(DPointerArray* array, const DGrowthPolicy* policy);
+
+/**
+ * @brief Retrieves how many times the buffer of a dynamic pointer array has been reallocated.
+ *
+ * @param array A pointer to the `DPointerArray`. Must not be NULL.
+ *
+ * @return usize The number of reallocations of the array's buffer, the initial allocation is not counted.
+ */
+usize			d_pointer_array_get_realloc_count	(DPointerArray* array);
+
+/**
+ * @brief Retrieves the allocator a dynamic pointer array was created with.
+ *
+ * @param array A pointer to the `DPointerArray`. Must not be NULL.
+ *
+ * @return const DAllocator* The allocator of the array, NULL when it uses libc.
+ */
+const DAllocator*	d_pointer_array_get_allocator	(DPointerArray* array);
+
 #endif
\ No newline at end of file
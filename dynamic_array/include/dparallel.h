@@ -0,0 +1,174 @@
+#ifndef __D_PARALLEL_H
+#define __D_PARALLEL_H
+
+#include <dtypes.h>
+#include <darray.h>
+#include <dsort.h>
+#include <dthread_pool.h>
+
+typedef struct _DParallelOptions	DParallelOptions;
+
+/**
+ * Default size of a chunk in bytes, a multiple of the cache line small enough to sit in the L2 cache of a core
+ * while it is worked on, and large enough for the cost of claiming it to vanish.
+ */
+#define D_PARALLEL_CHUNK_BYTES (64 * 1024)
+
+/**
+ * Default number of elements under which an algorithm runs on the calling thread, in one chunk.
+ */
+#define D_PARALLEL_SERIAL_THRESHOLD 32768
+
+/**
+ * Number of sorted runs `d_parallel_sort` cuts an array into by default, at most, before merging them.
+ */
+#define D_PARALLEL_SORT_RUNS 64
+
+/**
+ * DParallelOptions:
+ * @param pool the pool running the chunks, NULL for `d_thread_pool_get_shared`.
+ * @param grain the number of elements per chunk, 0 for `D_PARALLEL_CHUNK_BYTES` bytes. It is rounded up so that a
+ *     chunk is a whole number of 64-byte cache lines: the chunks of an array aligned on a cache line never share one.
+ * @param serial_threshold the number of elements under which everything runs on the calling thread, as a single
+ *     chunk. 0 for `D_PARALLEL_SERIAL_THRESHOLD`, `MAX_SIZE_T_VALUE` to never use the pool.
+ *
+ * How the `d_parallel_` functions cut an array and run it. A NULL `DParallelOptions*` means the defaults of
+ * every field.
+ *
+ * The chunks only depend on the length of the array, the element size and these options, never on the pool:
+ * reductions and scans combine the results of the chunks in their order, and sorts merge their runs in a fixed
+ * order, so the results of every function are the same from one run to another whatever the number of threads,
+ * even for operations such as floating point sums that are not associative.
+ */
+struct _DParallelOptions {
+	DThreadPool*	pool;
+	usize			grain;
+	usize			serial_threshold;
+};
+
+/**
+ * @brief Called on an element by `d_parallel_for_each`, which it may modify.
+ */
+typedef void(*DParallelForEachFunc)(void* elem, void* ctx);
+
+/**
+ * @brief Writes to `out` the result of an element of the source array of `d_parallel_map`.
+ */
+typedef void(*DParallelMapFunc)(const void* elem, void* out, void* ctx);
+
+/**
+ * @brief Combines `value` into `acc`, as `acc = acc op value` with an associative `op`.
+ */
+typedef void(*DParallelCombineFunc)(void* acc, const void* value, void* ctx);
+
+/**
+ * @brief Tells whether `d_parallel_filter` keeps an element.
+ */
+typedef bool(*DParallelFilterFunc)(const void* elem, void* ctx);
+
+/**
+ * @brief Calls `func` on every element of the array, from several threads.
+ *
+ * `func` may be called on the elements in any order and concurrently, it must only modify the element it is
+ * given.
+ *
+ * @param array The array. Must not be NULL.
+ * @param func Called on every element.
+ * @param ctx Given to `func`.
+ * @param options How the array is cut, NULL for the defaults.
+ */
+void	d_parallel_for_each		(DArray* array, DParallelForEachFunc func, void* ctx, const DParallelOptions* options);
+
+/**
+ * @brief Creates an array of the results of `func` on every element of the array, in the same order.
+ *
+ * The new array has the length of `array`, elements of `out_elem_size` bytes, and the allocator of `array`.
+ *
+ * @param array The source array. Must not be NULL.
+ * @param out_elem_size The size of an element of the new array, must not be 0.
+ * @param func Writes the result of an element, it may be called concurrently.
+ * @param ctx Given to `func`.
+ * @param options How the array is cut, NULL for the defaults.
+ *
+ * @return DArray* The new array, NULL if the allocation fails or if `out_elem_size` is 0.
+ */
+DArray*	d_parallel_map			(DArray* array, usize out_elem_size, DParallelMapFunc func, void* ctx,
+								const DParallelOptions* options);
+
+/**
+ * @brief Reduces the elements of the array into `result`.
+ *
+ * Every chunk starts from a copy of the identity held by `result`, and `accumulate` adds each of its elements in
+ * order. The results of the chunks are then combined into `result` in the order of the chunks with `combine`.
+ * An array of a single chunk is accumulated into `result` directly.
+ *
+ * @code
+ * double sum = 0.0;
+ * d_parallel_reduce(prices, &sum, sizeof(double), add_double, add_double, NULL, NULL);
+ * @endcode
+ *
+ * @param array The array. Must not be NULL.
+ * @param result Holds the identity of the reduction, `result_size` bytes, and receives the result.
+ * @param result_size The size of `result`, which may differ from the size of an element.
+ * @param accumulate Adds an element of the array to a partial result.
+ * @param combine Adds a partial result to another, `accumulate` may be given when both have the same type.
+ * @param ctx Given to `accumulate` and `combine`.
+ * @param options How the array is cut, NULL for the defaults.
+ *
+ * @return bool true on success, false if the allocation of the partial results fails. `result` is left as it
+ * was on failure.
+ */
+bool	d_parallel_reduce		(DArray* array, void* result, usize result_size, DParallelCombineFunc accumulate,
+								DParallelCombineFunc combine, void* ctx, const DParallelOptions* options);
+
+/**
+ * @brief Creates an array of the elements for which `func` is true, in the same order.
+ *
+ * `func` is called once per element, from several threads. The new array has the element size and the
+ * allocator of `array`.
+ *
+ * @param array The source array. Must not be NULL.
+ * @param func Tells whether an element is kept.
+ * @param ctx Given to `func`.
+ * @param options How the array is cut, NULL for the defaults.
+ *
+ * @return DArray* The new array, NULL if an allocation fails.
+ */
+DArray*	d_parallel_filter		(DArray* array, DParallelFilterFunc func, void* ctx, const DParallelOptions* options);
+
+/**
+ * @brief Replaces every element of the array by the combination of the elements up to it, itself included.
+ *
+ * An inclusive scan in place: element `i` becomes `e0 op e1 op ... op ei`. Every chunk is scanned on its own,
+ * the totals of the chunks are scanned in order on the calling thread, then every chunk but the first one
+ * combines the total of the chunks before it with each of its elements.
+ *
+ * @param array The array. Must not be NULL.
+ * @param combine `acc = acc op value`, with elements of the array as both operands.
+ * @param ctx Given to `combine`.
+ * @param options How the array is cut, NULL for the defaults.
+ *
+ * @return bool true on success, false if the allocation of the totals of the chunks fails, the array is left
+ * untouched then.
+ */
+bool	d_parallel_prefix_sum	(DArray* array, DParallelCombineFunc combine, void* ctx, const DParallelOptions* options);
+
+/**
+ * @brief Sorts the array with `cmp`, from several threads.
+ *
+ * The array is cut into runs sorted by `d_sort` in parallel, up to `D_PARALLEL_SORT_RUNS` of them with the
+ * default grain, then the runs are merged two by two in passes between the array and a buffer of the same size.
+ * Each merge is itself cut into pieces of a chunk of output, whose sources are found by a binary search along
+ * the merge path, so that the last passes use every thread too.
+ * Merges take the element of the left run first on ties, and the runs only depend on the options: elements that
+ * compare equal end up in the same order on every run.
+ *
+ * @param array The array. Must not be NULL.
+ * @param cmp Compares two elements, as for `qsort`.
+ * @param options How the array is cut, NULL for the defaults. A `grain` sets the length of the runs.
+ *
+ * @return bool true on success, false if the allocation of the merge buffer fails, the array is left untouched then.
+ */
+bool	d_parallel_sort			(DArray* array, DCompareFunc cmp, const DParallelOptions* options);
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef __D_RING_BUFFER_H
+#define __D_RING_BUFFER_H
+
+#include <dtypes.h>
+#include <dalloc.h>
+
+typedef struct _DRingBuffer		DRingBuffer;
+
+/**
+ * DRingBufferMode:
+ * @param D_RING_BUFFER_SPSC a single thread pushes and a single thread pops, at a time.
+ * @param D_RING_BUFFER_MPMC any number of threads push and pop.
+ *
+ * The concurrency a #DRingBuffer is created for.
+ */
+typedef enum {
+	D_RING_BUFFER_SPSC,
+	D_RING_BUFFER_MPMC
+} DRingBufferMode;
+
+/**
+ * DRingBuffer:
+ * @param capacity the number of elements the buffer holds when it is full, a power of two.
+ * @param elem_size the size of an element in bytes.
+ *
+ * Contains the public fields of a bounded, lock-free FIFO ring buffer of elements of `elem_size` bytes, copied in
+ * and out of a single buffer as the elements of a #DArray are, to hand records from producer threads to consumer
+ * threads without allocating nor reordering them. A push on a full buffer and a pop on an empty one fail instead
+ * of waiting, the caller decides whether to retry, spin or sleep.
+ * The position the producers write and the one the consumers write each have a cache line of their own.
+ * In `D_RING_BUFFER_SPSC` mode, each side only reads the position of the other side when the copy it keeps of it
+ * says the buffer is full (or empty), and a push or a pop is a copy and a release store: no read-modify-write.
+ * In `D_RING_BUFFER_MPMC` mode, every slot has a sequence number telling the lap it is ready for, and a thread
+ * claims slots with a compare-and-swap on its position: producers and consumers never wait on each other except
+ * for the slots they are about to use.
+ * The batch functions copy up to N elements for the cost of a single claim, in at most two contiguous copies.
+ */
+struct _DRingBuffer {
+	usize	capacity;
+	usize	elem_size;
+};
+
+/**
+ * @brief Creates a new, empty ring buffer.
+ *
+ * @param elem_size The size of an element in bytes, must not be 0.
+ * @param capacity The minimum number of elements the buffer holds, rounded up to a power of two. Must not be 0.
+ * @param mode The concurrency the buffer is used with.
+ *
+ * @return DRingBuffer* A pointer to the new buffer, NULL if the allocation fails or if a parameter is invalid.
+ */
+DRingBuffer	*d_ring_buffer_new					(usize elem_size, usize capacity, DRingBufferMode mode);
+
+/**
+ * @brief Creates a new ring buffer whose header and buffer are allocated with `allocator`.
+ *
+ * Same as `d_ring_buffer_new`, `allocator` must outlive the buffer and NULL means libc.
+ */
+DRingBuffer	*d_ring_buffer_new_with_allocator	(usize elem_size, usize capacity, DRingBufferMode mode,
+												const DAllocator* allocator);
+
+/**
+ * @brief Appends a copy of `elem` to the buffer.
+ *
+ * @param ring The buffer. Must not be NULL.
+ * @param elem The element, `elem_size` bytes. Must not be NULL.
+ *
+ * @return bool true on success, false if the buffer is full.
+ */
+bool		d_ring_buffer_push					(DRingBuffer* ring, const void* elem);
+
+/**
+ * @brief Removes the oldest element of the buffer.
+ *
+ * @param ring The buffer. Must not be NULL.
+ * @param elem Receives the element, `elem_size` bytes. Must not be NULL.
+ *
+ * @return bool true on success, false if the buffer is empty.
+ */
+bool		d_ring_buffer_pop					(DRingBuffer* ring, void* elem);
+
+/**
+ * @brief Appends copies of as many of the `count` elements of `elems` as there is room for, in order.
+ *
+ * The elements pushed by one call are contiguous in the buffer: no element of another producer sits between them.
+ *
+ * @param elems The elements, `count * elem_size` bytes.
+ *
+ * @return usize The number of elements pushed, the first ones of `elems`, 0 if the buffer is full.
+ */
+usize		d_ring_buffer_push_batch			(DRingBuffer* ring, const void* elems, usize count);
+
+/**
+ * @brief Removes up to `max` of the oldest elements of the buffer.
+ *
+ * @param elems Receives the elements in order, room for `max * elem_size` bytes.
+ *
+ * @return usize The number of elements removed, 0 if the buffer is empty.
+ */
+usize		d_ring_buffer_pop_batch				(DRingBuffer* ring, void* elems, usize max);
+
+/**
+ * @brief Counts the elements of the buffer. Only a hint while other threads use it.
+ */
+usize		d_ring_buffer_get_len				(DRingBuffer* ring);
+
+/**
+ * @brief Frees the buffer and sets its pointer to NULL. No other thread may still use it.
+ *
+ * @param ring A pointer to the buffer pointer. Nothing is done if it or the buffer is NULL.
+ */
+void		d_ring_buffer_destroy				(DRingBuffer** ring);
+
+#endif
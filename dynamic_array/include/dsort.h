@@ -0,0 +1,333 @@
+#ifndef __D_SORT_H
+#define __D_SORT_H
+
+#include <dtypes.h>
+#include <dalloc.h>
+#include <darray.h>
+
+/**
+ * @brief Compares the elements `a` and `b` point to, as `qsort` does.
+ *
+ * @return int32 A negative value if `a` sorts before `b`, 0 if they are equivalent, a positive value otherwise.
+ */
+typedef int32(*DCompareFunc)(const void* a, const void* b);
+
+/**
+ * DRadixKey:
+ * @param D_RADIX_UNSIGNED the elements are unsigned integers (`u32` or `u64`).
+ * @param D_RADIX_SIGNED the elements are two's complement signed integers (`int32` or `int64`).
+ * @param D_RADIX_FLOAT the elements are IEEE 754 floating point numbers (`float` or `double`).
+ *
+ * How the bits of the elements given to `d_radix_sort` are ordered.
+ * Floats are sorted in the IEEE 754 total order: -NaN < -inf < ... < -0 < +0 < ... < +inf < +NaN.
+ */
+typedef enum {
+	D_RADIX_UNSIGNED,
+	D_RADIX_SIGNED,
+	D_RADIX_FLOAT
+} DRadixKey;
+
+//Below this number of elements, a partition is sorted by insertion
+#define D_SORT_INSERTION_THRESHOLD 24
+//Above this number of elements, the pivot is the median of 3 medians of 3 (Tukey's ninther)
+#define D_SORT_NINTHER_THRESHOLD 128
+//Number of elements a partial insertion sort may move before it gives up on an almost sorted partition
+#define D_SORT_PARTIAL_INSERTION_LIMIT 8
+//Below this number of elements, d_radix_sort uses the comparison sort of the type, the histograms cost more
+#define D_RADIX_SORT_THRESHOLD 256
+
+/**
+ * @brief Sorts `len` elements of `elem_size` bytes in place with pattern-defeating quicksort.
+ *
+ * pdqsort (Orson Peters) is an introsort: a quicksort whose pivot is a median of 3, or a ninther on large
+ * partitions, falling back to insertion sort on small partitions and to heapsort when too many partitions are
+ * unbalanced, so it is O(n log n) in the worst case. On top of that, it partitions the elements equal to the
+ * previous pivot in linear time (many duplicates sort in O(n k)), it detects the partitions that were already
+ * sorted (sorted and reverse-sorted-then-partitioned inputs are linear), and it shuffles a few elements after an
+ * unbalanced partition to break the patterns that defeat the median selection. The sort is not stable.
+ *
+ * `cmp` is called through a pointer for every comparison: when the type is known at compile time, the functions
+ * generated by `D_SORT_DEFINE` inline the comparison instead, and are usually several times faster.
+ *
+ * @param base The first element. May be NULL if `len` is 0.
+ * @param len The number of elements.
+ * @param elem_size The size of an element in bytes.
+ * @param cmp The comparison, a strict weak ordering.
+ */
+void	d_sort					(void* base, usize len, usize elem_size, DCompareFunc cmp);
+
+/**
+ * @brief Sorts the elements of a dynamic array with `d_sort`.
+ */
+void	d_array_sort			(DArray* array, DCompareFunc cmp);
+
+/**
+ * @brief Sorts the pointers of a dynamic pointer array with `d_sort`.
+ *
+ * As with `qsort`, `cmp` receives the addresses of two elements: `*(void* const*)a` is the pointer to compare.
+ * The null terminator of a null-terminated array is not part of `len` and stays in place.
+ */
+void	d_pointer_array_sort	(DPointerArray* array, DCompareFunc cmp);
+
+/**
+ * @brief Ascending pdqsort of the common key types, generated with `D_SORT_DEFINE`.
+ *
+ * `d_sort_f32` and `d_sort_f64` use the IEEE 754 total order described for `DRadixKey`, so NaNs do not break
+ * the ordering.
+ */
+void	d_sort_i32				(int32* base, usize len);
+void	d_sort_u32				(u32* base, usize len);
+void	d_sort_i64				(int64* base, usize len);
+void	d_sort_u64				(u64* base, usize len);
+void	d_sort_f32				(float* base, usize len);
+void	d_sort_f64				(double* base, usize len);
+
+/**
+ * @brief Sorts `len` integers or floats of 4 or 8 bytes in place with a least significant digit radix sort.
+ *
+ * The keys are read 8 bits at a time: one pass over the elements fills the histograms of every digit, then each
+ * digit is a stable scatter between `base` and a scratch buffer of the same size. A digit all the elements share
+ * (the high bytes of small integers for instance) is skipped. O(n) for any input, which beats a comparison sort
+ * from a few thousand elements. Stable.
+ *
+ * @param base The first element. May be NULL if `len` is 0.
+ * @param len The number of elements.
+ * @param elem_size 4 or 8.
+ * @param key How the bits of an element are ordered.
+ * @param allocator The allocator of the scratch buffer, `len * elem_size` bytes, NULL for libc.
+ *
+ * @return bool true on success, false if `elem_size` or `key` is invalid or if the scratch buffer can not be
+ *         allocated. The elements are left untouched on failure.
+ */
+bool	d_radix_sort			(void* base, usize len, usize elem_size, DRadixKey key, const DAllocator* allocator);
+
+/**
+ * @brief Sorts the elements of a dynamic array with `d_radix_sort`, the scratch buffer comes from its allocator.
+ */
+bool	d_array_radix_sort		(DArray* array, DRadixKey key);
+
+/**
+ * @brief The default `less` of `D_SORT_DEFINE`: the `<` operator, for arithmetic types and pointers.
+ */
+#define d_sort_less(a, b) ((a) < (b))
+
+/**
+ * @brief Defines `static inline void name(type* base, usize len)`, a pdqsort of `type` values whose comparison is
+ * inlined.
+ *
+ * Same algorithm as `d_sort`, the elements are moved by assignment. `less` is a function or a function-like macro
+ * taking two `type` values, true when the first one sorts before the second: a strict weak ordering.
+ * The helpers it needs are defined next to it, prefixed by `name`.
+ *
+ * @code
+ * #define point_less(a, b) ((a).x < (b).x || ((a).x == (b).x && (a).y < (b).y))
+ * D_SORT_DEFINE(sort_points, Point, point_less)
+ * ...
+ * sort_points(points -> data, points -> len);
+ * @endcode
+ *
+ * @param name The name of the sort function.
+ * @param type The type of the elements.
+ * @param less The comparison.
+ */
+#define D_SORT_DEFINE(name, type, less)																	\
+	static inline void	name##_swap(type* a, type* b)													\
+	{																									\
+		type tmp = *a;																					\
+		*a = *b;																						\
+		*b = tmp;																						\
+	}																									\
+																										\
+	static inline void	name##_sort2(type* a, type* b)													\
+	{																									\
+		if (less(*b, *a))																				\
+			name##_swap(a, b);																			\
+	}																									\
+																										\
+	static inline void	name##_sort3(type* a, type* b, type* c)											\
+	{																									\
+		name##_sort2(a, b);																				\
+		name##_sort2(b, c);																				\
+		name##_sort2(a, b);																				\
+	}																									\
+																										\
+	/* `guarded` is false when an element before `begin` is not greater than any element of the range */	\
+	static inline usize	name##_insertion(type* begin, type* end, bool guarded, usize limit)				\
+	{																									\
+		usize moved = 0;																				\
+		for (type* cur = begin + 1; cur < end; ++cur)													\
+		{																								\
+			type* sift = cur;																			\
+			if (less(*sift, sift[-1]) == false)															\
+				continue;																				\
+			type tmp = *sift;																			\
+			do																							\
+			{																							\
+				*sift = sift[-1];																		\
+				--sift;																					\
+			} while ((guarded == false || sift != begin) && less(tmp, sift[-1]));						\
+			*sift = tmp;																				\
+			moved += cur - sift;																		\
+			if (moved > limit)																			\
+				return moved;																			\
+		}																								\
+		return moved;																					\
+	}																									\
+																										\
+	static inline void	name##_sift_down(type* base, usize root, usize len)								\
+	{																									\
+		type tmp = base[root];																			\
+		for (usize child; (child = 2 * root + 1) < len; root = child)									\
+		{																								\
+			if (child + 1 < len && less(base[child], base[child + 1]))									\
+				++child;																				\
+			if (less(tmp, base[child]) == false)														\
+				break;																					\
+			base[root] = base[child];																	\
+		}																								\
+		base[root] = tmp;																				\
+	}																									\
+																										\
+	static inline void	name##_heapsort(type* begin, type* end)											\
+	{																									\
+		usize len = end - begin;																		\
+		for (usize i = len / 2; i-- > 0;)																\
+			name##_sift_down(begin, i, len);															\
+		for (usize i = len; i-- > 1;)																	\
+		{																								\
+			name##_swap(begin, begin + i);																\
+			name##_sift_down(begin, 0, i);																\
+		}																								\
+	}																									\
+																										\
+	/* puts the elements lower than the pivot `*begin` before it, tells whether none had to move */		\
+	static inline type*	name##_partition_right(type* begin, type* end, bool* already_partitioned)		\
+	{																									\
+		type pivot = *begin;																			\
+		type* first = begin;																			\
+		type* last = end;																				\
+		while (less(*++first, pivot));																	\
+		if (first - 1 == begin)																			\
+			while (first < last && less(*--last, pivot) == false);										\
+		else																							\
+			while (less(*--last, pivot) == false);														\
+		*already_partitioned = first >= last;															\
+		while (first < last)																			\
+		{																								\
+			name##_swap(first, last);																	\
+			while (less(*++first, pivot));																\
+			while (less(*--last, pivot) == false);														\
+		}																								\
+		type* pivot_pos = first - 1;																	\
+		*begin = *pivot_pos;																			\
+		*pivot_pos = pivot;																				\
+		return pivot_pos;																				\
+	}																									\
+																										\
+	/* puts the elements equal to the pivot `*begin` before it, used when it equals the previous pivot */	\
+	static inline type*	name##_partition_left(type* begin, type* end)									\
+	{																									\
+		type pivot = *begin;																			\
+		type* first = begin;																			\
+		type* last = end;																				\
+		while (less(pivot, *--last));																	\
+		if (last + 1 == end)																			\
+			while (first < last && less(pivot, *++first) == false);										\
+		else																							\
+			while (less(pivot, *++first) == false);														\
+		while (first < last)																			\
+		{																								\
+			name##_swap(first, last);																	\
+			while (less(pivot, *--last));																\
+			while (less(pivot, *++first) == false);														\
+		}																								\
+		*begin = *last;																					\
+		*last = pivot;																					\
+		return last;																					\
+	}																									\
+																										\
+	/* swaps a few elements of a partition at a quarter of its ends, to break the pattern that unbalanced it */ \
+	static inline void	name##_break_patterns(type* begin, type* end)									\
+	{																									\
+		usize size = end - begin;																		\
+		if (size < D_SORT_INSERTION_THRESHOLD)															\
+			return;																						\
+		name##_swap(begin, begin + size / 4);															\
+		name##_swap(end - 1, end - size / 4);															\
+		if (size > D_SORT_NINTHER_THRESHOLD)															\
+		{																								\
+			name##_swap(begin + 1, begin + (size / 4 + 1));												\
+			name##_swap(begin + 2, begin + (size / 4 + 2));												\
+			name##_swap(end - 2, end - (size / 4 + 1));													\
+			name##_swap(end - 3, end - (size / 4 + 2));													\
+		}																								\
+	}																									\
+																										\
+	static inline void	name##_loop(type* begin, type* end, u32 bad_allowed, bool leftmost)				\
+	{																									\
+		for (;;)																						\
+		{																								\
+			usize size = end - begin;																	\
+			if (size < D_SORT_INSERTION_THRESHOLD)														\
+			{																							\
+				name##_insertion(begin, end, leftmost, MAX_SIZE_T_VALUE);								\
+				return;																					\
+			}																							\
+			usize half = size / 2;																		\
+			if (size > D_SORT_NINTHER_THRESHOLD)														\
+			{																							\
+				name##_sort3(begin, begin + half, end - 1);												\
+				name##_sort3(begin + 1, begin + (half - 1), end - 2);									\
+				name##_sort3(begin + 2, begin + (half + 1), end - 3);									\
+				name##_sort3(begin + (half - 1), begin + half, begin + (half + 1));						\
+				name##_swap(begin, begin + half);														\
+			}																							\
+			else																						\
+				name##_sort3(begin + half, begin, end - 1);												\
+			if (leftmost == false && less(begin[-1], *begin) == false)									\
+			{																							\
+				begin = name##_partition_left(begin, end) + 1;											\
+				continue;																				\
+			}																							\
+			bool already_partitioned;																	\
+			type* pivot = name##_partition_right(begin, end, &already_partitioned);						\
+			usize left = pivot - begin;																	\
+			usize right = end - (pivot + 1);															\
+			if (left < size / 8 || right < size / 8)													\
+			{																							\
+				if (--bad_allowed == 0)																	\
+				{																						\
+					name##_heapsort(begin, end);														\
+					return;																				\
+				}																						\
+				name##_break_patterns(begin, pivot);													\
+				name##_break_patterns(pivot + 1, end);													\
+			}																							\
+			else if (already_partitioned																\
+				&& name##_insertion(begin, pivot, leftmost, D_SORT_PARTIAL_INSERTION_LIMIT)				\
+					<= D_SORT_PARTIAL_INSERTION_LIMIT													\
+				&& name##_insertion(pivot + 1, end, false, D_SORT_PARTIAL_INSERTION_LIMIT)				\
+					<= D_SORT_PARTIAL_INSERTION_LIMIT)													\
+				return;																					\
+			/* recursing on the smaller side bounds the stack to log2(len) frames */					\
+			if (left < right)																			\
+			{																							\
+				name##_loop(begin, pivot, bad_allowed, leftmost);										\
+				begin = pivot + 1;																		\
+				leftmost = false;																		\
+			}																							\
+			else																						\
+			{																							\
+				name##_loop(pivot + 1, end, bad_allowed, false);										\
+				end = pivot;																			\
+			}																							\
+		}																								\
+	}																									\
+																										\
+	static inline void	name(type* base, usize len)														\
+	{																									\
+		if (len > 1)																					\
+			name##_loop(base, base + len, 64 - __builtin_clzll(len), true);								\
+	}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef __D_THREAD_POOL_H
+#define __D_THREAD_POOL_H
+
+#include <dtypes.h>
+
+typedef struct _DThreadPool	DThreadPool;
+
+/**
+ * @brief Largest number of chunks of a job. Chunk indexes are 32 bits, so that two of them fit in the word of a
+ * range.
+ */
+#define D_THREAD_POOL_MAX_CHUNKS 0xFFFFFFFFULL
+
+/**
+ * @brief Runs the chunk `chunk` of a job, the elements of indexes `begin` to `end` excluded.
+ *
+ * @param ctx The context given to `d_thread_pool_run`.
+ * @param chunk The index of the chunk, from 0 to the number of chunks excluded.
+ * @param begin The index of the first element of the chunk, `chunk * chunk_len`.
+ * @param end The index after the last element of the chunk, `len` for the last chunk.
+ */
+typedef void(*DThreadPoolTask)(void* ctx, usize chunk, usize begin, usize end);
+
+/**
+ * DThreadPool:
+ *
+ * A fixed set of worker threads running data-parallel jobs: a job is a range of `len` elements cut into chunks
+ * of `chunk_len` elements, and a task called once per chunk.
+ * The chunks are dealt out evenly to the calling thread and the workers, which all take part in the job. Each
+ * participant takes its chunks one by one from the front of its own range, and once it is empty steals the back
+ * half of the range of another participant: a participant slowed down by costlier chunks or by the system hands
+ * its work over instead of holding the job back. Ranges are two 32-bit chunk indexes in one word, claimed with a
+ * compare-and-swap, and each sits on its own cache line.
+ * Idle workers sleep on a futex and cost nothing between jobs.
+ * One job runs at a time: a call made while the pool is busy, from another thread or from inside a task, runs its
+ * chunks on the calling thread instead of waiting for the pool, so that nested calls never deadlock.
+ */
+
+/**
+ * @brief Creates a pool of `thread_count` worker threads.
+ *
+ * @param thread_count The number of workers, the thread calling `d_thread_pool_run` comes on top of them.
+ * 0 creates a pool that runs every job on the calling thread.
+ *
+ * @return DThreadPool* The new pool, NULL if an allocation or the creation of a thread fails.
+ */
+DThreadPool	*d_thread_pool_new				(usize thread_count);
+
+/**
+ * @brief Returns the pool shared by the whole process, created on the first call.
+ *
+ * It has one worker per online CPU but one, since the calling thread works too. It is never destroyed.
+ *
+ * @return DThreadPool* The shared pool, NULL if its creation failed.
+ */
+DThreadPool	*d_thread_pool_get_shared		(void);
+
+/**
+ * @brief Returns the number of threads taking part in a job of `pool`: its workers plus the calling thread.
+ */
+usize		d_thread_pool_get_thread_count	(DThreadPool* pool);
+
+/**
+ * @brief Runs `task` on every chunk of `chunk_len` elements of a range of `len` elements, and returns when all are done.
+ *
+ * The chunks run in no particular order and on any thread, but a chunk is always the same set of elements for a
+ * given `len` and `chunk_len`: tasks that only write their own chunk, or the slot of their chunk index, give the
+ * same results whatever the number of threads and the scheduling. Everything the tasks wrote is visible to the
+ * caller on return.
+ *
+ * @param pool The pool, NULL runs every chunk on the calling thread, in order.
+ * @param len The number of elements, nothing is done if it is 0.
+ * @param chunk_len The number of elements per chunk, 0 makes a single chunk of `len` elements. It is enlarged
+ * when `len` would give more than `D_THREAD_POOL_MAX_CHUNKS` chunks, a caller laying out per-chunk data must
+ * apply the same cap beforehand.
+ * @param task The function called on each chunk.
+ * @param ctx Given to `task`.
+ */
+void		d_thread_pool_run				(DThreadPool* pool, usize len, usize chunk_len, DThreadPoolTask task, void* ctx);
+
+/**
+ * @brief Stops and joins the workers, frees the pool and sets its pointer to NULL.
+ *
+ * No job may be running. The shared pool must not be destroyed.
+ *
+ * @param pool A pointer to the pool pointer. Nothing is done if it or the pool is NULL.
+ */
+void		d_thread_pool_destroy			(DThreadPool** pool);
+
+#endif
@@ -4,50 +4,95 @@
 
 #define CAPACITY 4
 
+//SMALLEST AND FINEST SPACING BETWEEN TWO ALLOCATOR SIZE CLASSES, MATCHES THE MALLOC ALIGNMENT
+#define SIZE_CLASS_QUANTUM 16
+
 typedef struct _DRealArray DRealArray;
 
 //REAL D_ARRAY STRUCTURE ALLOCATED
 struct _DRealArray {
 	void  *data;
 	usize   len;
-	usize   capacity;
+	usize   capacity; /* total number of elements the buffer can hold */
 	usize   elem_size;
+	usize	realloc_count;
+	DGrowthPolicy	growth;
+	const DAllocator*	allocator; /* allocator of the buffer and of the header, NULL for libc */
 	bool  clear: 1;
+	bool  inline_storage: 1; /* data points to the caller's storage, it must not be reallocated nor freed */
+	bool  embedded: 1; /* the header lives in a DArrayHeader owned by the caller */
 };
 
+_Static_assert(sizeof(DRealArray) <= D_ARRAY_HEADER_SIZE, "DArrayHeader is too small to hold a DRealArray");
+
 #define d_array_elt_len(array,i) ((array)->elem_size * (i))
 //UTILITY MACRO TO GET TO WHICH OFFSET FROM THE START OF THE ARRAY A D_ARRAY ELEMENT IS
 #define d_array_elt_pos(array,i) ((array)->data + d_array_elt_len((array),(i)))
+//NUMBER OF ELEMENTS THE HEAP BUFFER WAS ALLOCATED WITH, A 0 CAPACITY STILL OWNS A 1 ELEMENT BUFFER
+#define d_array_buffer_capacity(array) ((array)->capacity + ((array)->capacity == 0))
 
 static bool d_array_try_expand(DRealArray *array, usize len);
 
 DArray  *d_array_new				(bool	clear,		usize elem_size, usize reserved_elem)
 {
-	DRealArray  *array = malloc(sizeof(DRealArray) * 1);
+	return d_array_new_with_allocator(clear, elem_size, reserved_elem, NULL);
+}
+
+DArray  *d_array_new_with_allocator	(bool	clear,		usize elem_size, usize reserved_elem, const DAllocator* allocator)
+{
+	DRealArray  *array = d_alloc(allocator, sizeof(DRealArray) * 1);
 	if (array == NULL)
 		return (NULL);
 	array -> capacity = ((reserved_elem > 0) * reserved_elem) + ((reserved_elem == 0) * (usize)CAPACITY);
 	array -> clear = clear;
 	array -> elem_size = elem_size;
-	array -> data = malloc(elem_size * array -> capacity);
+	array -> realloc_count = 0;
+	array -> growth = D_GROWTH_POLICY_DEFAULT;
+	array -> inline_storage = false;
+	array -> embedded = false;
+	array -> allocator = allocator;
+	array -> data = d_alloc_array(allocator, array -> capacity, elem_size);
 	array -> len = 0;
 	if (array -> data == NULL)
 	{
-		free(array);
+		d_free(allocator, array, sizeof(DRealArray));
 		return NULL;
 	}
 	if (clear == true)
-		memset(array->data, 0, elem_size * reserved_elem);
+		memset(array->data, 0, d_array_elt_len(array, array -> capacity));
+	return (DArray*) array;
+}
+
+DArray  *d_array_init_inline		(DArrayHeader* header, bool clear, usize elem_size, void* storage, usize inline_capacity)
+{
+	DRealArray  *array = (DRealArray*)header;
+	array -> data = storage;
+	array -> len = 0;
+	array -> capacity = inline_capacity;
+	array -> elem_size = elem_size;
+	array -> realloc_count = 0;
+	array -> growth = D_GROWTH_POLICY_DEFAULT;
+	array -> clear = clear;
+	array -> inline_storage = true;
+	array -> embedded = true;
+	array -> allocator = NULL;
+	if (clear == true)
+		memset(storage, 0, d_array_elt_len(array, inline_capacity));
 	return (DArray*) array;
 }
 
+bool	d_array_is_inline			(DArray* arr)
+{
+	DRealArray* array = (DRealArray*)arr;
+	return array -> inline_storage;
+}
+
 DArray  *d_array_append_vals		(DArray *arr, 	const void *data,		usize len)
 {
 	DRealArray  *array = (DRealArray*) arr;
-	if (array -> capacity < len && d_array_try_expand(array, len) == false)
+	if (array -> capacity - array -> len < len && d_array_try_expand(array, len) == false)
 		return NULL;
 	memcpy(d_array_elt_pos(array,array->len), data, d_array_elt_len(array, len));
-	array->capacity -= len;
 	array->len += len;
 	return arr;
 }
@@ -55,7 +100,10 @@ DArray  *d_array_append_vals		(DArray *arr, 	const void *data,		usize len)
 DArray	*d_array_copy(DArray* array)
 {
 	DRealArray* rarray = (DRealArray*)array;
-	DArray* new_array = d_array_new(rarray -> clear, rarray -> elem_size, rarray -> len * 2);
+	DArray* new_array = d_array_new_with_allocator(rarray -> clear, rarray -> elem_size, rarray -> capacity, rarray -> allocator);
+	if (new_array == NULL)
+		return NULL;
+	((DRealArray*)new_array) -> growth = rarray -> growth;
 	d_array_append_vals(new_array, rarray -> data, rarray -> len);
 	return new_array;
 }
@@ -71,10 +119,32 @@ DArray* d_array_modify_capacity(DArray* array, usize new_capacity)
 	DRealArray* rarray = (DRealArray*) array;
 	if (new_capacity == rarray -> capacity)
 		return array;
-	rarray -> capacity = new_capacity;
-	array -> data = reallocarray(array -> data, rarray -> len + new_capacity, rarray -> elem_size);
-	if (array -> data == NULL)
+	//the inline storage cannot shrink, only the elements past the new capacity are dropped
+	if (rarray -> inline_storage == true && new_capacity < rarray -> capacity)
+	{
+		rarray -> len = rarray -> len > new_capacity ? new_capacity : rarray -> len;
+		return array;
+	}
+	void* data;
+	usize old_capacity = rarray -> capacity;
+	if (rarray -> inline_storage == true)
+	{
+		if ((data = d_alloc_array(rarray -> allocator, new_capacity, rarray -> elem_size)) != NULL)
+			memcpy(data, rarray -> data, d_array_elt_len(rarray, rarray -> len));
+		old_capacity = rarray -> len;
+	}
+	else //never ask for a 0 bytes buffer, reallocarray would be allowed to free it
+		data = d_realloc_array(rarray -> allocator, rarray -> data, d_array_buffer_capacity(rarray),
+			new_capacity + (new_capacity == 0), rarray -> elem_size);
+	if (data == NULL)
 		return NULL;
+	rarray -> inline_storage = false;
+	if (rarray -> clear == true && new_capacity > old_capacity)
+		memset(data + d_array_elt_len(rarray, old_capacity), 0, d_array_elt_len(rarray, new_capacity - old_capacity));
+	rarray -> data = data;
+	rarray -> capacity = new_capacity;
+	rarray -> len = rarray -> len > new_capacity ? new_capacity : rarray -> len;
+	++rarray -> realloc_count;
 	return array;
 }
 
@@ -91,7 +161,6 @@ DArray  *d_array_remove_index_fast	(DArray	*arr, 	usize	index)
 	if (index >= array -> len)
 		return NULL;
 	memcpy(d_array_elt_pos(array, index), d_array_elt_pos(array, array -> len - 1), d_array_elt_len(array, 1));
-	array -> capacity++;
 	array -> len--;
 	return arr;
 }
@@ -101,31 +170,130 @@ void    d_array_destroy		(DArray** arr)
 	if (arr == NULL || *arr == NULL)
 		return;
 	DRealArray*	array = (DRealArray*)(*arr);
-	free(array->data);
-	free(array);
+	if (array -> inline_storage == false)
+		d_free(array -> allocator, array -> data, d_array_elt_len(array, d_array_buffer_capacity(array)));
+	if (array -> embedded == false)
+		d_free(array -> allocator, array, sizeof(DRealArray));
 	*arr = NULL;
 }
 
 DArray  *d_array_clear_array		(DArray* arr)
 {
 	DRealArray* array = (DRealArray*)arr;
-	array -> capacity = array -> len;
 	array->len = 0;
 	return arr;
 }
 
+DArray	*d_array_set_growth_policy	(DArray* arr, const DGrowthPolicy* policy)
+{
+	DRealArray* array = (DRealArray*)arr;
+	if (policy != NULL && d_growth_policy_is_valid(policy) == false)
+		return NULL;
+	array -> growth = policy == NULL ? D_GROWTH_POLICY_DEFAULT : *policy;
+	return arr;
+}
+
+usize	d_array_get_realloc_count	(DArray* arr)
+{
+	DRealArray* array = (DRealArray*)arr;
+	return array -> realloc_count;
+}
+
+const DAllocator*	d_array_get_allocator	(DArray* arr)
+{
+	DRealArray* array = (DRealArray*)arr;
+	return array -> allocator;
+}
 
-bool d_array_try_expand(DRealArray *arr, usize len)
+usize	d_array_get_elem_size		(DArray* arr)
 {
 	DRealArray* array = (DRealArray*)arr;
-	usize arr_len = array -> len;
-	usize new_arr_size = ((len == 1) * arr_len * 2) + ((len > 1) * (len + (arr_len * 2)));
-	new_arr_size += (new_arr_size % 2) == 1;
-	array->capacity = new_arr_size - arr_len;
-	array -> data = reallocarray(array->data, new_arr_size, array->elem_size);
-	if (array -> data != NULL && array -> clear == true)
-		memset(d_array_elt_pos(array, arr_len + len), 0, d_array_elt_len(array, new_arr_size - (arr_len + len)));
-	return array -> data != NULL;
+	return array -> elem_size;
+}
+
+bool d_array_try_expand(DRealArray *array, usize len)
+{
+	usize old_capacity = array -> capacity;
+	usize required = array -> len + len;
+	if (required < array -> len)
+		return false;
+	if (required <= old_capacity)
+		return true;
+	usize new_capacity = d_growth_policy_next_capacity(&array -> growth, old_capacity, required, array -> elem_size);
+	if (new_capacity == 0)
+		return false;
+	void* data;
+	if (array -> inline_storage == true)
+	{
+		//first spill out of the inline storage, the elements are moved to the heap
+		if ((data = d_alloc_array(array -> allocator, new_capacity, array -> elem_size)) == NULL)
+			return false;
+		memcpy(data, array -> data, d_array_elt_len(array, array -> len));
+		array -> inline_storage = false;
+		old_capacity = array -> len;
+	}
+	else if ((data = d_realloc_array(array -> allocator, array -> data, d_array_buffer_capacity(array), new_capacity, array -> elem_size)) == NULL)
+		return false;
+	array -> data = data;
+	if (array -> clear == true)
+		memset(d_array_elt_pos(array, old_capacity), 0, d_array_elt_len(array, new_capacity - old_capacity));
+	array -> capacity = new_capacity;
+	++array -> realloc_count;
+	return true;
+}
+
+/*-------------------------------------------------DGrowthPolicy-------------------------------------------------*/
+
+/*
+** Rounds a size in bytes up to the next size class of a jemalloc-like allocator: 4 classes
+** between two consecutive powers of two, never closer than SIZE_CLASS_QUANTUM bytes.
+** glibc malloc rounds to 16 bytes, so the result never asks it for more than one extra chunk.
+*/
+static usize d_size_class_round_up(usize bytes)
+{
+	if (bytes <= SIZE_CLASS_QUANTUM)
+		return SIZE_CLASS_QUANTUM;
+	usize log2 = (sizeof(usize) * 8 - 1) - (usize)__builtin_clzl(bytes - 1);
+	usize spacing = (usize)1 << (log2 - 2);
+	spacing = spacing < SIZE_CLASS_QUANTUM ? SIZE_CLASS_QUANTUM : spacing;
+	if (bytes > MAX_SIZE_T_VALUE - spacing)
+		return bytes;
+	return (bytes + spacing - 1) & ~(spacing - 1);
+}
+
+bool	d_growth_policy_is_valid		(const DGrowthPolicy* policy)
+{
+	return policy -> factor_den != 0
+		&& policy -> factor_num > policy -> factor_den
+		&& policy -> min_step != 0
+		&& (policy -> max_step == 0 || policy -> max_step >= policy -> min_step);
+}
+
+usize	d_growth_policy_next_capacity	(const DGrowthPolicy* policy, usize capacity, usize required, usize elem_size)
+{
+	usize num = policy -> factor_num;
+	usize den = policy -> factor_den;
+	usize step;
+
+	//capacity * num / den without overflowing the intermediate product
+	if (capacity / den > (MAX_SIZE_T_VALUE - capacity) / num)
+		step = MAX_SIZE_T_VALUE - capacity;
+	else
+		step = (capacity / den) * num + ((capacity % den) * num) / den - capacity;
+	step = step < policy -> min_step ? policy -> min_step : step;
+	step = policy -> max_step != 0 && step > policy -> max_step ? policy -> max_step : step;
+
+	usize new_capacity = capacity + step;
+	if (new_capacity < capacity)
+		new_capacity = MAX_SIZE_T_VALUE;
+	new_capacity = new_capacity < required ? required : new_capacity;
+	if (elem_size == 0)
+		return new_capacity;
+	if (new_capacity > MAX_SIZE_T_VALUE / elem_size)
+		return required <= MAX_SIZE_T_VALUE / elem_size ? required : 0;
+	if (policy -> round_to_size_class == true)
+		new_capacity = d_size_class_round_up(new_capacity * elem_size) / elem_size;
+	return new_capacity;
 }
 
 /*-------------------------------------------------DPointerArray-------------------------------------------------*/
@@ -136,28 +304,42 @@ struct _DRealPointerArray
 {
   	void**       	pdata;
   	usize         	len;
-	usize				capacity;
+	usize				capacity; /* number of pointers the buffer can hold, not counting the NULL terminator */
   	u8          	null_terminated : 1; /* always either 0 or 1, so it can be added to array lengths */
 	DestroyElemFunc	free_func; /*if not null will be used on each element when de-allocating or clearing the array*/
 	usize	refcount;
+	usize	realloc_count;
+	DGrowthPolicy	growth;
+	const DAllocator*	allocator; /* allocator of the buffer and of the header, NULL for libc */
 };
 
+//NUMBER OF POINTERS THE BUFFER WAS ALLOCATED WITH, THE NULL TERMINATOR SLOT INCLUDED
+#define d_pointer_array_buffer_capacity(array) ((array)->capacity + (array)->null_terminated)
+
 static bool d_pointer_array_try_expand(DPointerArray *array, usize len);
 
 DPointerArray  *d_pointer_array_new	(usize reserved_elem, bool null_terminated, DestroyElemFunc free_func)
 {
-	DRealPointerArray  *array = malloc(sizeof(DRealPointerArray) * 1);
+	return d_pointer_array_new_with_allocator(reserved_elem, null_terminated, free_func, NULL);
+}
+
+DPointerArray  *d_pointer_array_new_with_allocator	(usize reserved_elem, bool null_terminated, DestroyElemFunc free_func, const DAllocator* allocator)
+{
+	DRealPointerArray  *array = d_alloc(allocator, sizeof(DRealPointerArray) * 1);
 	if (array == NULL)
 		return (NULL);
 	array -> free_func = free_func;
 	array -> null_terminated = (usize)null_terminated;
-	array -> capacity = ((reserved_elem > 0) * reserved_elem) + ((reserved_elem == 0) * (usize)CAPACITY) + (usize)null_terminated;
-	array -> pdata = malloc(sizeof(void*) * array -> capacity);
+	array -> capacity = ((reserved_elem > 0) * reserved_elem) + ((reserved_elem == 0) * (usize)CAPACITY);
+	array -> allocator = allocator;
+	array -> pdata = d_alloc_array(allocator, d_pointer_array_buffer_capacity(array), sizeof(void*));
 	array -> len = 0;
 	array -> refcount = 1;
+	array -> realloc_count = 0;
+	array -> growth = D_GROWTH_POLICY_DEFAULT;
 	if (array -> pdata == NULL)
 	{
-		free(array);
+		d_free(allocator, array, sizeof(DRealPointerArray));
 		return NULL;
 	}
 	if (array -> null_terminated)
@@ -168,10 +350,9 @@ DPointerArray  *d_pointer_array_new	(usize reserved_elem, bool null_terminated,
 DPointerArray  *d_pointer_array_append_vals		(DPointerArray *arr, const void **data,	usize len)
 {
 	DRealPointerArray* array = (DRealPointerArray*) arr;
-	if (array -> capacity < len && d_pointer_array_try_expand(arr, len) == false)
+	if (array -> capacity - array -> len < len && d_pointer_array_try_expand(arr, len) == false)
 		return NULL;
 	memcpy(array -> pdata + array -> len, data, sizeof(void*) * len);
-	array -> capacity -= len;
 	array -> len += len;
 	if (array -> null_terminated)
 		array -> pdata[array -> len] = NULL;
@@ -187,22 +368,36 @@ usize 			d_pointer_array_get_capacity				(DPointerArray* array)
 DPointerArray*	d_pointer_array_modify_capacity(DPointerArray* array, usize new_capacity)
 {
 	DRealPointerArray* rarray = (DRealPointerArray*)array;
-	if (new_capacity == 0)
+	if (new_capacity == 0 || new_capacity == rarray -> capacity)
 		return array;
+	//the dropped elements are released while they are still in the buffer
+	if (rarray -> len > new_capacity)
+	{
+		for (usize i = new_capacity; rarray -> free_func != NULL && i < rarray -> len; i++)
+			rarray -> free_func(rarray -> pdata[i]);
+		rarray -> len = new_capacity;
+		if (rarray -> null_terminated)
+			rarray -> pdata[rarray -> len] = NULL;
+	}
+	void** pdata = d_realloc_array(rarray -> allocator, rarray -> pdata, d_pointer_array_buffer_capacity(rarray),
+		new_capacity + rarray -> null_terminated, sizeof(void*));
+	if (pdata == NULL)
+		return NULL;
+	rarray -> pdata = pdata;
 	rarray -> capacity = new_capacity;
-	array -> pdata = reallocarray(array -> pdata, array -> len + new_capacity, sizeof(void*));
+	++rarray -> realloc_count;
+	if (rarray -> null_terminated)
+		pdata[rarray -> len] = NULL;
 	return array;
 }
 
 DPointerArray  *d_pointer_array_push_back		(DPointerArray *arr, 	const void *data)
 {
 	DRealPointerArray* array = (DRealPointerArray*)arr;
-	usize	null_terminated = (usize)array -> null_terminated;
-	if (array -> capacity - null_terminated == 0 && d_pointer_array_try_expand(arr, 1) == false)
+	if (array -> len == array -> capacity && d_pointer_array_try_expand(arr, 1) == false)
 		return NULL;
 	array -> pdata[array -> len++] = (void*)data;
-	--array -> capacity;
-	if (null_terminated)
+	if (array -> null_terminated)
 		array -> pdata[array -> len] = NULL;
 	return arr;
 }
@@ -218,7 +413,6 @@ DPointerArray  *d_pointer_array_remove_index_fast	(DPointerArray	*arr, 	usize	in
 	if (free_func != NULL)
 		free_func(tmp);
 	array -> pdata[array -> len - 1] = NULL;
-	++array -> capacity;
 	--array -> len;
 	return arr;
 }
@@ -236,8 +430,8 @@ void    d_pointer_array_destroy		(DPointerArray** arr)
 			free_func(array->pdata[i]);
 		}
 	}
-	free(array->pdata);
-	free(array);
+	d_free(array -> allocator, array -> pdata, sizeof(void*) * d_pointer_array_buffer_capacity(array));
+	d_free(array -> allocator, array, sizeof(DRealPointerArray));
 	*arr = NULL;
 }
 
@@ -256,16 +450,50 @@ DPointerArray  *d_pointer_array_clear_array		(DPointerArray* arr)
 	}
 
 	array->len = 0;
+	if (array -> null_terminated)
+		array -> pdata[0] = NULL;
+	return arr;
+}
+
+DPointerArray	*d_pointer_array_set_growth_policy	(DPointerArray* arr, const DGrowthPolicy* policy)
+{
+	DRealPointerArray* array = (DRealPointerArray*)arr;
+	if (policy != NULL && d_growth_policy_is_valid(policy) == false)
+		return NULL;
+	array -> growth = policy == NULL ? D_GROWTH_POLICY_DEFAULT : *policy;
 	return arr;
 }
 
+usize			d_pointer_array_get_realloc_count	(DPointerArray* arr)
+{
+	DRealPointerArray* array = (DRealPointerArray*)arr;
+	return array -> realloc_count;
+}
+
+const DAllocator*	d_pointer_array_get_allocator	(DPointerArray* arr)
+{
+	DRealPointerArray* array = (DRealPointerArray*)arr;
+	return array -> allocator;
+}
 
 bool d_pointer_array_try_expand(DPointerArray *arr, usize len)
 {
 	DRealPointerArray* array = (DRealPointerArray*)arr;
-	usize arr_len = array -> len;
-	usize new_arr_size = ((len == 1) * arr_len * 2) + (len > 1) * (len + (arr_len * 2)) + array -> null_terminated;
-	array->capacity = new_arr_size - arr_len;
-	array -> pdata = reallocarray(array->pdata, new_arr_size, sizeof(void*));
-	return array -> pdata != NULL;
+	usize required = array -> len + len;
+	if (required < array -> len)
+		return false;
+	if (required <= array -> capacity)
+		return true;
+	//the terminator slot is part of the allocation, size classes are computed on the whole buffer
+	usize null_terminated = array -> null_terminated;
+	usize new_capacity = d_growth_policy_next_capacity(&array -> growth, array -> capacity + null_terminated, required + null_terminated, sizeof(void*));
+	if (new_capacity == 0)
+		return false;
+	void** pdata = d_realloc_array(array -> allocator, array -> pdata, d_pointer_array_buffer_capacity(array), new_capacity, sizeof(void*));
+	if (pdata == NULL)
+		return false;
+	array -> pdata = pdata;
+	array -> capacity = new_capacity - null_terminated;
+	++array -> realloc_count;
+	return true;
 }
\ No newline at end of file
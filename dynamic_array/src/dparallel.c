@@ -0,0 +1,419 @@
+#include <dparallel.h>
+#include <string.h>
+
+//SIZE OF A CACHE LINE, CHUNKS ARE A WHOLE NUMBER OF THEM
+#define D_PARALLEL_LINE 64
+
+#define d_parallel_elem(base, index, elem_size) ((u8*)(base) + (index) * (elem_size))
+
+static usize	d_parallel_gcd(usize a, usize b)
+{
+	while (b != 0)
+	{
+		usize tmp = a % b;
+		a = b;
+		b = tmp;
+	}
+	return a;
+}
+
+static inline DThreadPool*	d_parallel_get_pool(const DParallelOptions* options)
+{
+	if (options != NULL && options -> pool != NULL)
+		return options -> pool;
+	return d_thread_pool_get_shared();
+}
+
+//Number of elements per chunk, `len` below the serial threshold so that everything runs as one chunk. Chunks are
+//enlarged to at most `D_THREAD_POOL_MAX_CHUNKS` of them, as the pool would: the per-chunk partials, carries and
+//runs are laid out with the same chunks as the pool runs
+static usize	d_parallel_chunk_len(const DParallelOptions* options, usize len, usize elem_size)
+{
+	usize threshold = D_PARALLEL_SERIAL_THRESHOLD;
+	if (options != NULL && options -> serial_threshold != 0)
+		threshold = options -> serial_threshold;
+	if (len < threshold)
+		return len;
+	usize grain = D_PARALLEL_CHUNK_BYTES / elem_size;
+	if (options != NULL && options -> grain != 0)
+		grain = options -> grain;
+	usize line = D_PARALLEL_LINE / d_parallel_gcd(elem_size, D_PARALLEL_LINE);
+	if (grain == 0)
+		grain = 1;
+	usize least = (len - 1) / D_THREAD_POOL_MAX_CHUNKS + 1;
+	if (grain < least)
+		grain = least;
+	if (grain > MAX_SIZE_T_VALUE - line)
+		return len;
+	return (grain + line - 1) / line * line;
+}
+
+static inline usize	d_parallel_chunk_count(usize len, usize chunk_len)
+{
+	return len == 0 ? 0 : (len - 1) / chunk_len + 1;
+}
+
+//FOR EACH
+
+typedef struct {
+	u8*						data;
+	usize					elem_size;
+	DParallelForEachFunc	func;
+	void*					ctx;
+} DParallelForEachCtx;
+
+static void	d_parallel_for_each_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelForEachCtx* job = arg;
+	(void)chunk;
+	for (usize i = begin; i < end; ++i)
+		job -> func(d_parallel_elem(job -> data, i, job -> elem_size), job -> ctx);
+}
+
+void	d_parallel_for_each		(DArray* array, DParallelForEachFunc func, void* ctx, const DParallelOptions* options)
+{
+	usize elem_size = d_array_get_elem_size(array);
+	DParallelForEachCtx job = { array -> data, elem_size, func, ctx };
+	d_thread_pool_run(d_parallel_get_pool(options), array -> len, d_parallel_chunk_len(options, array -> len, elem_size),
+		d_parallel_for_each_task, &job);
+}
+
+//MAP
+
+typedef struct {
+	const u8*			src;
+	u8*					dst;
+	usize				src_size;
+	usize				dst_size;
+	DParallelMapFunc	func;
+	void*				ctx;
+} DParallelMapCtx;
+
+static void	d_parallel_map_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelMapCtx* job = arg;
+	(void)chunk;
+	for (usize i = begin; i < end; ++i)
+		job -> func(d_parallel_elem(job -> src, i, job -> src_size), d_parallel_elem(job -> dst, i, job -> dst_size), job -> ctx);
+}
+
+DArray*	d_parallel_map			(DArray* array, usize out_elem_size, DParallelMapFunc func, void* ctx,
+								const DParallelOptions* options)
+{
+	if (out_elem_size == 0)
+		return NULL;
+	usize len = array -> len;
+	DArray* out = d_array_new_with_allocator(false, out_elem_size, len, d_array_get_allocator(array));
+	if (out == NULL)
+		return NULL;
+	usize elem_size = d_array_get_elem_size(array);
+	DParallelMapCtx job = { array -> data, out -> data, elem_size, out_elem_size, func, ctx };
+	d_thread_pool_run(d_parallel_get_pool(options), len, d_parallel_chunk_len(options, len, elem_size),
+		d_parallel_map_task, &job);
+	out -> len = len;
+	return out;
+}
+
+//REDUCE
+
+typedef struct {
+	const u8*				data;
+	usize					elem_size;
+	u8*						partials; /* one result per chunk */
+	const void*				identity;
+	usize					result_size;
+	DParallelCombineFunc	accumulate;
+	void*					ctx;
+} DParallelReduceCtx;
+
+static void	d_parallel_reduce_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelReduceCtx* job = arg;
+	void* acc = job -> partials + chunk * job -> result_size;
+	memcpy(acc, job -> identity, job -> result_size);
+	for (usize i = begin; i < end; ++i)
+		job -> accumulate(acc, d_parallel_elem(job -> data, i, job -> elem_size), job -> ctx);
+}
+
+bool	d_parallel_reduce		(DArray* array, void* result, usize result_size, DParallelCombineFunc accumulate,
+								DParallelCombineFunc combine, void* ctx, const DParallelOptions* options)
+{
+	usize len = array -> len;
+	usize elem_size = d_array_get_elem_size(array);
+	usize chunk_len = d_parallel_chunk_len(options, len, elem_size);
+	usize chunks = d_parallel_chunk_count(len, chunk_len);
+	if (chunks <= 1)
+	{
+		for (usize i = 0; i < len; ++i)
+			accumulate(result, d_parallel_elem(array -> data, i, elem_size), ctx);
+		return true;
+	}
+	const DAllocator* allocator = d_array_get_allocator(array);
+	u8* partials = d_alloc_array(allocator, chunks, result_size);
+	if (partials == NULL)
+		return false;
+	DParallelReduceCtx job = { array -> data, elem_size, partials, result, result_size, accumulate, ctx };
+	d_thread_pool_run(d_parallel_get_pool(options), len, chunk_len, d_parallel_reduce_task, &job);
+	for (usize chunk = 0; chunk < chunks; ++chunk)
+		combine(result, partials + chunk * result_size, ctx);
+	d_free(allocator, partials, chunks * result_size);
+	return true;
+}
+
+//FILTER
+
+typedef struct {
+	const u8*			data;
+	usize				elem_size;
+	u8*					keep; /* one flag per element */
+	usize*				counts; /* kept elements per chunk, then index of the first one in `out` */
+	u8*					out;
+	DParallelFilterFunc	func;
+	void*				ctx;
+} DParallelFilterCtx;
+
+static void	d_parallel_filter_count_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelFilterCtx* job = arg;
+	usize count = 0;
+	for (usize i = begin; i < end; ++i)
+	{
+		job -> keep[i] = job -> func(d_parallel_elem(job -> data, i, job -> elem_size), job -> ctx);
+		count += job -> keep[i];
+	}
+	job -> counts[chunk] = count;
+}
+
+//Copies the kept elements of the chunk, by runs of consecutive ones
+static void	d_parallel_filter_copy_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelFilterCtx* job = arg;
+	u8* out = d_parallel_elem(job -> out, job -> counts[chunk], job -> elem_size);
+	usize i = begin;
+	while (i < end)
+	{
+		while (i < end && job -> keep[i] == 0)
+			++i;
+		usize run = i;
+		while (i < end && job -> keep[i] != 0)
+			++i;
+		memcpy(out, d_parallel_elem(job -> data, run, job -> elem_size), (i - run) * job -> elem_size);
+		out += (i - run) * job -> elem_size;
+	}
+}
+
+DArray*	d_parallel_filter		(DArray* array, DParallelFilterFunc func, void* ctx, const DParallelOptions* options)
+{
+	usize len = array -> len;
+	usize elem_size = d_array_get_elem_size(array);
+	usize chunk_len = d_parallel_chunk_len(options, len, elem_size);
+	usize chunks = d_parallel_chunk_count(len, chunk_len);
+	const DAllocator* allocator = d_array_get_allocator(array);
+	DThreadPool* pool = d_parallel_get_pool(options);
+	DParallelFilterCtx job = { array -> data, elem_size, NULL, NULL, NULL, func, ctx };
+	job.keep = d_alloc(allocator, len + 1);
+	job.counts = d_alloc_array(allocator, chunks + 1, sizeof(usize));
+	DArray* out = NULL;
+	if (job.keep != NULL && job.counts != NULL)
+	{
+		d_thread_pool_run(pool, len, chunk_len, d_parallel_filter_count_task, &job);
+		usize total = 0;
+		for (usize chunk = 0; chunk < chunks; ++chunk)
+		{
+			usize count = job.counts[chunk];
+			job.counts[chunk] = total;
+			total += count;
+		}
+		out = d_array_new_with_allocator(false, elem_size, total, allocator);
+		if (out != NULL)
+		{
+			job.out = out -> data;
+			d_thread_pool_run(pool, len, chunk_len, d_parallel_filter_copy_task, &job);
+			out -> len = total;
+		}
+	}
+	d_free(allocator, job.keep, len + 1);
+	d_free(allocator, job.counts, (chunks + 1) * sizeof(usize));
+	return out;
+}
+
+//PREFIX SUM
+
+typedef struct {
+	u8*						data;
+	usize					elem_size;
+	u8*						totals; /* total of each chunk, then scratch of the chunk */
+	u8*						carries; /* combination of the chunks before each chunk */
+	DParallelCombineFunc	combine;
+	void*					ctx;
+} DParallelScanCtx;
+
+static void	d_parallel_scan_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelScanCtx* job = arg;
+	usize elem_size = job -> elem_size;
+	u8* acc = job -> totals + chunk * elem_size;
+	memcpy(acc, d_parallel_elem(job -> data, begin, elem_size), elem_size);
+	for (usize i = begin + 1; i < end; ++i)
+	{
+		u8* elem = d_parallel_elem(job -> data, i, elem_size);
+		job -> combine(acc, elem, job -> ctx);
+		memcpy(elem, acc, elem_size);
+	}
+}
+
+static void	d_parallel_scan_carry_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelScanCtx* job = arg;
+	usize elem_size = job -> elem_size;
+	if (chunk == 0)
+		return;
+	u8* acc = job -> totals + chunk * elem_size;
+	const u8* carry = job -> carries + chunk * elem_size;
+	for (usize i = begin; i < end; ++i)
+	{
+		u8* elem = d_parallel_elem(job -> data, i, elem_size);
+		memcpy(acc, carry, elem_size);
+		job -> combine(acc, elem, job -> ctx);
+		memcpy(elem, acc, elem_size);
+	}
+}
+
+bool	d_parallel_prefix_sum	(DArray* array, DParallelCombineFunc combine, void* ctx, const DParallelOptions* options)
+{
+	usize len = array -> len;
+	if (len < 2)
+		return true;
+	usize elem_size = d_array_get_elem_size(array);
+	usize chunk_len = d_parallel_chunk_len(options, len, elem_size);
+	usize chunks = d_parallel_chunk_count(len, chunk_len);
+	const DAllocator* allocator = d_array_get_allocator(array);
+	u8* buffer = d_alloc_array(allocator, 2 * chunks, elem_size);
+	if (buffer == NULL)
+		return false;
+	DThreadPool* pool = d_parallel_get_pool(options);
+	DParallelScanCtx job = { array -> data, elem_size, buffer, buffer + chunks * elem_size, combine, ctx };
+	d_thread_pool_run(pool, len, chunk_len, d_parallel_scan_task, &job);
+	if (chunks > 1)
+	{
+		memcpy(job.carries + elem_size, job.totals, elem_size);
+		for (usize chunk = 2; chunk < chunks; ++chunk)
+		{
+			u8* carry = job.carries + chunk * elem_size;
+			memcpy(carry, carry - elem_size, elem_size);
+			combine(carry, job.totals + (chunk - 1) * elem_size, ctx);
+		}
+		d_thread_pool_run(pool, len, chunk_len, d_parallel_scan_carry_task, &job);
+	}
+	d_free(allocator, buffer, 2 * chunks * elem_size);
+	return true;
+}
+
+//SORT
+
+typedef struct {
+	const u8*		src;
+	u8*				dst;
+	usize			len;
+	usize			elem_size;
+	usize			width; /* length of the sorted runs of `src` */
+	DCompareFunc	cmp;
+} DParallelSortCtx;
+
+static void	d_parallel_sort_run_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelSortCtx* job = arg;
+	(void)chunk;
+	d_sort(d_parallel_elem(job -> dst, begin, job -> elem_size), end - begin, job -> elem_size, job -> cmp);
+}
+
+//Number of elements of `a` among the `k` first elements of the merge of `a` and `b`, ties going to `a`
+static usize	d_parallel_merge_rank(const DParallelSortCtx* job, const u8* a, usize a_len, const u8* b, usize b_len, usize k)
+{
+	usize low = k > b_len ? k - b_len : 0;
+	usize high = k < a_len ? k : a_len;
+	while (low < high)
+	{
+		usize mid = low + (high - low) / 2;
+		if (job -> cmp(d_parallel_elem(a, mid, job -> elem_size), d_parallel_elem(b, k - mid - 1, job -> elem_size)) <= 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+//Writes the elements `begin` to `end` of the merge of the pair of runs they belong to
+static void	d_parallel_sort_merge_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelSortCtx* job = arg;
+	usize elem_size = job -> elem_size;
+	(void)chunk;
+	usize pair = begin / (2 * job -> width) * (2 * job -> width);
+	usize middle = job -> len - pair > job -> width ? pair + job -> width : job -> len;
+	usize pair_end = job -> len - middle > job -> width ? middle + job -> width : job -> len;
+	const u8* a = d_parallel_elem(job -> src, pair, elem_size);
+	const u8* b = d_parallel_elem(job -> src, middle, elem_size);
+	usize a_len = middle - pair;
+	usize b_len = pair_end - middle;
+	usize i = d_parallel_merge_rank(job, a, a_len, b, b_len, begin - pair);
+	usize j = begin - pair - i;
+	u8* out = d_parallel_elem(job -> dst, begin, elem_size);
+	for (usize k = begin; k < end; ++k, out += elem_size)
+	{
+		if (j >= b_len || (i < a_len && job -> cmp(d_parallel_elem(a, i, elem_size), d_parallel_elem(b, j, elem_size)) <= 0))
+			memcpy(out, d_parallel_elem(a, i++, elem_size), elem_size);
+		else
+			memcpy(out, d_parallel_elem(b, j++, elem_size), elem_size);
+	}
+}
+
+static void	d_parallel_sort_copy_task(void* arg, usize chunk, usize begin, usize end)
+{
+	DParallelSortCtx* job = arg;
+	(void)chunk;
+	memcpy(d_parallel_elem(job -> dst, begin, job -> elem_size), d_parallel_elem(job -> src, begin, job -> elem_size),
+		(end - begin) * job -> elem_size);
+}
+
+bool	d_parallel_sort			(DArray* array, DCompareFunc cmp, const DParallelOptions* options)
+{
+	usize len = array -> len;
+	usize elem_size = d_array_get_elem_size(array);
+	usize piece_len = d_parallel_chunk_len(options, len, elem_size);
+	//Runs are a whole number of pieces, so that a piece of merge output never spans two pairs of runs
+	usize run_len = piece_len;
+	if ((options == NULL || options -> grain == 0) && run_len < len)
+	{
+		usize target = (len - 1) / D_PARALLEL_SORT_RUNS + 1;
+		run_len = (target + piece_len - 1) / piece_len * piece_len;
+	}
+	if (run_len >= len)
+	{
+		d_sort(array -> data, len, elem_size, cmp);
+		return true;
+	}
+	const DAllocator* allocator = d_array_get_allocator(array);
+	u8* buffer = d_alloc_array(allocator, len, elem_size);
+	if (buffer == NULL)
+		return false;
+	DThreadPool* pool = d_parallel_get_pool(options);
+	DParallelSortCtx job = { NULL, array -> data, len, elem_size, run_len, cmp };
+	d_thread_pool_run(pool, len, run_len, d_parallel_sort_run_task, &job);
+	job.src = array -> data;
+	job.dst = buffer;
+	for (; job.width < len; job.width *= 2)
+	{
+		d_thread_pool_run(pool, len, piece_len, d_parallel_sort_merge_task, &job);
+		u8* tmp = (u8*)job.src;
+		job.src = job.dst;
+		job.dst = tmp;
+	}
+	if (job.src != array -> data)
+	{
+		job.dst = array -> data;
+		d_thread_pool_run(pool, len, piece_len, d_parallel_sort_copy_task, &job);
+	}
+	d_free(allocator, buffer, len * elem_size);
+	return true;
+}
@@ -0,0 +1,233 @@
+#include <dring_buffer.h>
+#include <string.h>
+#include <stdint.h>
+
+typedef struct _DRealRingBuffer DRealRingBuffer;
+
+//SIZE OF A CACHE LINE, THE POSITION OF EACH SIDE STARTS A LINE OF ITS OWN, SHARED WITH NOTHING BUT THE COPY IT
+//KEEPS OF THE OTHER POSITION, AWAY FROM THE HEADER AND FROM THE OTHER SIDE
+#define D_RING_BUFFER_LINE 64
+
+//The header is allocated with room to align it on a cache line, the allocators giving no alignment guarantee
+#define D_RING_BUFFER_BLOCK_SIZE (sizeof(DRealRingBuffer) + D_RING_BUFFER_LINE - 1)
+
+//REAL RING BUFFER STRUCTURE ALLOCATED
+struct _DRealRingBuffer {
+	usize				capacity;
+	usize				elem_size;
+	usize				mask; /* capacity - 1, positions are never wrapped, only their slot index is */
+	DRingBufferMode		mode;
+	const DAllocator*	allocator; /* allocator of the buffer and of the header, NULL for libc */
+	u8*					data;
+	usize*				seqs; /* MPMC only, lap each slot is ready for: position + 1 once filled */
+	void*				block; /* block the header was allocated in, before alignment */
+	__attribute__((aligned(D_RING_BUFFER_LINE)))
+	usize				head; /* position of the next push */
+	usize				cached_tail; /* SPSC only, last tail the producer read */
+	__attribute__((aligned(D_RING_BUFFER_LINE)))
+	usize				tail; /* position of the next pop */
+	usize				cached_head; /* SPSC only, last head the consumer read */
+};
+
+#define d_ring_buffer_slot(ring, pos) ((ring) -> data + ((pos) & (ring) -> mask) * (ring) -> elem_size)
+
+DRingBuffer	*d_ring_buffer_new					(usize elem_size, usize capacity, DRingBufferMode mode)
+{
+	return d_ring_buffer_new_with_allocator(elem_size, capacity, mode, NULL);
+}
+
+DRingBuffer	*d_ring_buffer_new_with_allocator	(usize elem_size, usize capacity, DRingBufferMode mode,
+												const DAllocator* allocator)
+{
+	if (elem_size == 0 || capacity == 0 || capacity > MAX_SIZE_T_VALUE / 2
+		|| (mode != D_RING_BUFFER_SPSC && mode != D_RING_BUFFER_MPMC))
+		return NULL;
+	usize rounded = 1;
+	while (rounded < capacity)
+		rounded <<= 1;
+	u8* block = d_alloc(allocator, D_RING_BUFFER_BLOCK_SIZE);
+	if (block == NULL)
+		return NULL;
+	DRealRingBuffer* ring = (DRealRingBuffer*)(((uintptr_t)block + D_RING_BUFFER_LINE - 1) & ~(uintptr_t)(D_RING_BUFFER_LINE - 1));
+	memset(ring, 0, sizeof(DRealRingBuffer));
+	ring -> block = block;
+	ring -> capacity = rounded;
+	ring -> elem_size = elem_size;
+	ring -> mask = rounded - 1;
+	ring -> mode = mode;
+	ring -> allocator = allocator;
+	ring -> data = d_alloc_array(allocator, rounded, elem_size);
+	if (ring -> data != NULL && mode == D_RING_BUFFER_MPMC)
+	{
+		ring -> seqs = d_alloc_array(allocator, rounded, sizeof(usize));
+		if (ring -> seqs != NULL)
+			for (usize i = 0; i < rounded; ++i)
+				ring -> seqs[i] = i;
+	}
+	if (ring -> data == NULL || (mode == D_RING_BUFFER_MPMC && ring -> seqs == NULL))
+	{
+		DRingBuffer* partial = (DRingBuffer*)ring;
+		d_ring_buffer_destroy(&partial);
+		return NULL;
+	}
+	return (DRingBuffer*)ring;
+}
+
+//Copies `count` elements from `elems` into the slots from `pos`, in two parts if they wrap around the buffer
+static void	d_ring_buffer_copy_in(DRealRingBuffer* ring, usize pos, const u8* elems, usize count)
+{
+	usize first = ring -> capacity - (pos & ring -> mask);
+	if (first > count)
+		first = count;
+	memcpy(d_ring_buffer_slot(ring, pos), elems, first * ring -> elem_size);
+	memcpy(ring -> data, elems + first * ring -> elem_size, (count - first) * ring -> elem_size);
+}
+
+static void	d_ring_buffer_copy_out(DRealRingBuffer* ring, usize pos, u8* elems, usize count)
+{
+	usize first = ring -> capacity - (pos & ring -> mask);
+	if (first > count)
+		first = count;
+	memcpy(elems, d_ring_buffer_slot(ring, pos), first * ring -> elem_size);
+	memcpy(elems + first * ring -> elem_size, ring -> data, (count - first) * ring -> elem_size);
+}
+
+static usize	d_ring_buffer_spsc_push(DRealRingBuffer* ring, const void* elems, usize count)
+{
+	usize head = __atomic_load_n(&ring -> head, __ATOMIC_RELAXED);
+	usize room = ring -> capacity - (head - ring -> cached_tail);
+	if (room < count)
+	{
+		ring -> cached_tail = __atomic_load_n(&ring -> tail, __ATOMIC_ACQUIRE);
+		room = ring -> capacity - (head - ring -> cached_tail);
+	}
+	if (count > room)
+		count = room;
+	if (count == 0)
+		return 0;
+	d_ring_buffer_copy_in(ring, head, elems, count);
+	__atomic_store_n(&ring -> head, head + count, __ATOMIC_RELEASE);
+	return count;
+}
+
+static usize	d_ring_buffer_spsc_pop(DRealRingBuffer* ring, void* elems, usize max)
+{
+	usize tail = __atomic_load_n(&ring -> tail, __ATOMIC_RELAXED);
+	usize available = ring -> cached_head - tail;
+	if (available < max)
+	{
+		ring -> cached_head = __atomic_load_n(&ring -> head, __ATOMIC_ACQUIRE);
+		available = ring -> cached_head - tail;
+	}
+	if (max > available)
+		max = available;
+	if (max == 0)
+		return 0;
+	d_ring_buffer_copy_out(ring, tail, elems, max);
+	__atomic_store_n(&ring -> tail, tail + max, __ATOMIC_RELEASE);
+	return max;
+}
+
+//Claims up to `count` slots from `*position` whose sequence number is `pos + lap`, lap being 0 for the producers
+//and 1 for the consumers, and returns the first of them in `pos`. 0 when the first slot is not ready
+static usize	d_ring_buffer_mpmc_claim(DRealRingBuffer* ring, usize* position, usize lap, usize count, usize* pos)
+{
+	usize current = __atomic_load_n(position, __ATOMIC_RELAXED);
+	for (;;)
+	{
+		usize ready = 0;
+		usize seq = 0;
+		while (ready < count)
+		{
+			seq = __atomic_load_n(&ring -> seqs[(current + ready) & ring -> mask], __ATOMIC_ACQUIRE);
+			if (seq != current + ready + lap)
+				break;
+			++ready;
+		}
+		if (ready == 0)
+		{
+			//behind the expected lap, the slot is still used by the other side: full or empty
+			if ((int64)(seq - (current + lap)) < 0)
+				return 0;
+			current = __atomic_load_n(position, __ATOMIC_RELAXED);
+			continue;
+		}
+		if (__atomic_compare_exchange_n(position, &current, current + ready, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+			*pos = current;
+			return ready;
+		}
+	}
+}
+
+static usize	d_ring_buffer_mpmc_push(DRealRingBuffer* ring, const void* elems, usize count)
+{
+	usize pos;
+	count = d_ring_buffer_mpmc_claim(ring, &ring -> head, 0, count, &pos);
+	d_ring_buffer_copy_in(ring, pos, elems, count);
+	for (usize i = 0; i < count; ++i)
+		__atomic_store_n(&ring -> seqs[(pos + i) & ring -> mask], pos + i + 1, __ATOMIC_RELEASE);
+	return count;
+}
+
+static usize	d_ring_buffer_mpmc_pop(DRealRingBuffer* ring, void* elems, usize max)
+{
+	usize pos;
+	max = d_ring_buffer_mpmc_claim(ring, &ring -> tail, 1, max, &pos);
+	d_ring_buffer_copy_out(ring, pos, elems, max);
+	for (usize i = 0; i < max; ++i)
+		__atomic_store_n(&ring -> seqs[(pos + i) & ring -> mask], pos + i + ring -> capacity, __ATOMIC_RELEASE);
+	return max;
+}
+
+usize		d_ring_buffer_push_batch			(DRingBuffer* ring_, const void* elems, usize count)
+{
+	DRealRingBuffer* ring = (DRealRingBuffer*)ring_;
+	if (count == 0)
+		return 0;
+	if (ring -> mode == D_RING_BUFFER_SPSC)
+		return d_ring_buffer_spsc_push(ring, elems, count);
+	return d_ring_buffer_mpmc_push(ring, elems, count);
+}
+
+usize		d_ring_buffer_pop_batch				(DRingBuffer* ring_, void* elems, usize max)
+{
+	DRealRingBuffer* ring = (DRealRingBuffer*)ring_;
+	if (max == 0)
+		return 0;
+	if (ring -> mode == D_RING_BUFFER_SPSC)
+		return d_ring_buffer_spsc_pop(ring, elems, max);
+	return d_ring_buffer_mpmc_pop(ring, elems, max);
+}
+
+bool		d_ring_buffer_push					(DRingBuffer* ring, const void* elem)
+{
+	return d_ring_buffer_push_batch(ring, elem, 1) == 1;
+}
+
+bool		d_ring_buffer_pop					(DRingBuffer* ring, void* elem)
+{
+	return d_ring_buffer_pop_batch(ring, elem, 1) == 1;
+}
+
+usize		d_ring_buffer_get_len				(DRingBuffer* ring_)
+{
+	DRealRingBuffer* ring = (DRealRingBuffer*)ring_;
+	usize tail = __atomic_load_n(&ring -> tail, __ATOMIC_ACQUIRE);
+	usize head = __atomic_load_n(&ring -> head, __ATOMIC_ACQUIRE);
+	if ((int64)(head - tail) <= 0)
+		return 0;
+	return head - tail > ring -> capacity ? ring -> capacity : head - tail;
+}
+
+void		d_ring_buffer_destroy				(DRingBuffer** ring_)
+{
+	if (ring_ == NULL || *ring_ == NULL)
+		return;
+	DRealRingBuffer* ring = (DRealRingBuffer*)*ring_;
+	const DAllocator* allocator = ring -> allocator;
+	d_free(allocator, ring -> data, ring -> capacity * ring -> elem_size);
+	d_free(allocator, ring -> seqs, ring -> capacity * sizeof(usize));
+	d_free(allocator, ring -> block, D_RING_BUFFER_BLOCK_SIZE);
+	*ring_ = NULL;
+}
@@ -0,0 +1,440 @@
+#include <dsort.h>
+#include <string.h>
+
+//Elements are swapped through a stack buffer of this size, larger ones in several steps
+#define D_SORT_SWAP_CHUNK 64
+
+//GENERIC PDQSORT: THE SAME ALGORITHM AS D_SORT_DEFINE ON ELEMENTS OF A RUNTIME SIZE. THE PIVOT IS NEVER COPIED,
+//IT STAYS IN FRONT OF THE PARTITION UNTIL IT IS SWAPPED TO ITS FINAL PLACE, AND INSERTIONS SWAP NEIGHBOURS
+
+typedef struct {
+	usize			size;
+	DCompareFunc	cmp;
+} DSortCtx;
+
+static inline void	d_sort_swap(char* a, char* b, usize size)
+{
+	if (size == sizeof(u64))
+	{
+		u64 tmp;
+		memcpy(&tmp, a, sizeof(u64));
+		memcpy(a, b, sizeof(u64));
+		memcpy(b, &tmp, sizeof(u64));
+		return;
+	}
+	if (size == sizeof(u32))
+	{
+		u32 tmp;
+		memcpy(&tmp, a, sizeof(u32));
+		memcpy(a, b, sizeof(u32));
+		memcpy(b, &tmp, sizeof(u32));
+		return;
+	}
+	char tmp[D_SORT_SWAP_CHUNK];
+	while (size > 0)
+	{
+		usize chunk = size < D_SORT_SWAP_CHUNK ? size : D_SORT_SWAP_CHUNK;
+		memcpy(tmp, a, chunk);
+		memcpy(a, b, chunk);
+		memcpy(b, tmp, chunk);
+		a += chunk;
+		b += chunk;
+		size -= chunk;
+	}
+}
+
+#define d_sort_lt(ctx, a, b) ((ctx) -> cmp((a), (b)) < 0)
+
+static inline void	d_sort_sort2(const DSortCtx* ctx, char* a, char* b)
+{
+	if (d_sort_lt(ctx, b, a))
+		d_sort_swap(a, b, ctx -> size);
+}
+
+static inline void	d_sort_sort3(const DSortCtx* ctx, char* a, char* b, char* c)
+{
+	d_sort_sort2(ctx, a, b);
+	d_sort_sort2(ctx, b, c);
+	d_sort_sort2(ctx, a, b);
+}
+
+static usize	d_sort_insertion(const DSortCtx* ctx, char* begin, char* end, bool guarded, usize limit)
+{
+	usize size = ctx -> size;
+	usize moved = 0;
+	for (char* cur = begin + size; cur < end; cur += size)
+	{
+		char* sift = cur;
+		while ((guarded == false || sift != begin) && d_sort_lt(ctx, sift, sift - size))
+		{
+			d_sort_swap(sift, sift - size, size);
+			sift -= size;
+		}
+		moved += (cur - sift) / size;
+		if (moved > limit)
+			return moved;
+	}
+	return moved;
+}
+
+static void	d_sort_sift_down(const DSortCtx* ctx, char* base, usize root, usize len)
+{
+	usize size = ctx -> size;
+	for (usize child; (child = 2 * root + 1) < len; root = child)
+	{
+		if (child + 1 < len && d_sort_lt(ctx, base + child * size, base + (child + 1) * size))
+			++child;
+		if (d_sort_lt(ctx, base + root * size, base + child * size) == false)
+			return;
+		d_sort_swap(base + root * size, base + child * size, size);
+	}
+}
+
+static void	d_sort_heapsort(const DSortCtx* ctx, char* begin, char* end)
+{
+	usize len = (end - begin) / ctx -> size;
+	for (usize i = len / 2; i-- > 0;)
+		d_sort_sift_down(ctx, begin, i, len);
+	for (usize i = len; i-- > 1;)
+	{
+		d_sort_swap(begin, begin + i * ctx -> size, ctx -> size);
+		d_sort_sift_down(ctx, begin, 0, i);
+	}
+}
+
+static char*	d_sort_partition_right(const DSortCtx* ctx, char* begin, char* end, bool* already_partitioned)
+{
+	usize size = ctx -> size;
+	char* first = begin;
+	char* last = end;
+	do
+		first += size;
+	while (d_sort_lt(ctx, first, begin));
+	if (first - size == begin)
+	{
+		while (first < last)
+		{
+			last -= size;
+			if (d_sort_lt(ctx, last, begin))
+				break;
+		}
+	}
+	else
+	{
+		do
+			last -= size;
+		while (d_sort_lt(ctx, last, begin) == false);
+	}
+	*already_partitioned = first >= last;
+	while (first < last)
+	{
+		d_sort_swap(first, last, size);
+		do
+			first += size;
+		while (d_sort_lt(ctx, first, begin));
+		do
+			last -= size;
+		while (d_sort_lt(ctx, last, begin) == false);
+	}
+	char* pivot = first - size;
+	d_sort_swap(begin, pivot, size);
+	return pivot;
+}
+
+static char*	d_sort_partition_left(const DSortCtx* ctx, char* begin, char* end)
+{
+	usize size = ctx -> size;
+	char* first = begin;
+	char* last = end;
+	do
+		last -= size;
+	while (d_sort_lt(ctx, begin, last));
+	if (last + size == end)
+	{
+		while (first < last)
+		{
+			first += size;
+			if (d_sort_lt(ctx, begin, first))
+				break;
+		}
+	}
+	else
+	{
+		do
+			first += size;
+		while (d_sort_lt(ctx, begin, first) == false);
+	}
+	while (first < last)
+	{
+		d_sort_swap(first, last, size);
+		do
+			last -= size;
+		while (d_sort_lt(ctx, begin, last));
+		do
+			first += size;
+		while (d_sort_lt(ctx, begin, first) == false);
+	}
+	d_sort_swap(begin, last, size);
+	return last;
+}
+
+static void	d_sort_break_patterns(const DSortCtx* ctx, char* begin, char* end)
+{
+	usize size = ctx -> size;
+	usize len = (end - begin) / size;
+	if (len < D_SORT_INSERTION_THRESHOLD)
+		return;
+	usize quarter = len / 4;
+	d_sort_swap(begin, begin + quarter * size, size);
+	d_sort_swap(end - size, end - quarter * size, size);
+	if (len > D_SORT_NINTHER_THRESHOLD)
+	{
+		d_sort_swap(begin + size, begin + (quarter + 1) * size, size);
+		d_sort_swap(begin + 2 * size, begin + (quarter + 2) * size, size);
+		d_sort_swap(end - 2 * size, end - (quarter + 1) * size, size);
+		d_sort_swap(end - 3 * size, end - (quarter + 2) * size, size);
+	}
+}
+
+static void	d_sort_loop(const DSortCtx* ctx, char* begin, char* end, u32 bad_allowed, bool leftmost)
+{
+	usize size = ctx -> size;
+	for (;;)
+	{
+		usize len = (end - begin) / size;
+		if (len < D_SORT_INSERTION_THRESHOLD)
+		{
+			d_sort_insertion(ctx, begin, end, leftmost, MAX_SIZE_T_VALUE);
+			return;
+		}
+		char* middle = begin + (len / 2) * size;
+		if (len > D_SORT_NINTHER_THRESHOLD)
+		{
+			d_sort_sort3(ctx, begin, middle, end - size);
+			d_sort_sort3(ctx, begin + size, middle - size, end - 2 * size);
+			d_sort_sort3(ctx, begin + 2 * size, middle + size, end - 3 * size);
+			d_sort_sort3(ctx, middle - size, middle, middle + size);
+			d_sort_swap(begin, middle, size);
+		}
+		else
+			d_sort_sort3(ctx, middle, begin, end - size);
+		if (leftmost == false && d_sort_lt(ctx, begin - size, begin) == false)
+		{
+			begin = d_sort_partition_left(ctx, begin, end) + size;
+			continue;
+		}
+		bool already_partitioned;
+		char* pivot = d_sort_partition_right(ctx, begin, end, &already_partitioned);
+		usize left = (pivot - begin) / size;
+		usize right = (end - pivot) / size - 1;
+		if (left < len / 8 || right < len / 8)
+		{
+			if (--bad_allowed == 0)
+			{
+				d_sort_heapsort(ctx, begin, end);
+				return;
+			}
+			d_sort_break_patterns(ctx, begin, pivot);
+			d_sort_break_patterns(ctx, pivot + size, end);
+		}
+		else if (already_partitioned
+			&& d_sort_insertion(ctx, begin, pivot, leftmost, D_SORT_PARTIAL_INSERTION_LIMIT) <= D_SORT_PARTIAL_INSERTION_LIMIT
+			&& d_sort_insertion(ctx, pivot + size, end, false, D_SORT_PARTIAL_INSERTION_LIMIT) <= D_SORT_PARTIAL_INSERTION_LIMIT)
+			return;
+		if (left < right)
+		{
+			d_sort_loop(ctx, begin, pivot, bad_allowed, leftmost);
+			begin = pivot + size;
+			leftmost = false;
+		}
+		else
+		{
+			d_sort_loop(ctx, pivot + size, end, bad_allowed, false);
+			end = pivot;
+		}
+	}
+}
+
+void	d_sort					(void* base, usize len, usize elem_size, DCompareFunc cmp)
+{
+	if (len < 2 || elem_size == 0)
+		return;
+	DSortCtx ctx = { elem_size, cmp };
+	d_sort_loop(&ctx, base, (char*)base + len * elem_size, 64 - __builtin_clzll(len), true);
+}
+
+void	d_array_sort			(DArray* array, DCompareFunc cmp)
+{
+	d_sort(array -> data, array -> len, d_array_get_elem_size(array), cmp);
+}
+
+void	d_pointer_array_sort	(DPointerArray* array, DCompareFunc cmp)
+{
+	d_sort(array -> pdata, array -> len, sizeof(void*), cmp);
+}
+
+//RADIX KEYS: THE BITS OF AN ELEMENT MAPPED TO AN UNSIGNED INTEGER OF THE SAME ORDER. A NEGATIVE FLOAT HAS ALL
+//ITS BITS FLIPPED (ITS MAGNITUDE ORDER IS REVERSED), A POSITIVE ONE ONLY ITS SIGN SO IT SORTS AFTER THEM
+
+static inline u32	d_radix_key_32(u32 bits, DRadixKey key)
+{
+	if (key == D_RADIX_SIGNED)
+		return bits ^ 0x80000000u;
+	if (key == D_RADIX_FLOAT)
+		return bits ^ ((u32)-(int32)(bits >> 31) | 0x80000000u);
+	return bits;
+}
+
+static inline u64	d_radix_key_64(u64 bits, DRadixKey key)
+{
+	if (key == D_RADIX_SIGNED)
+		return bits ^ 0x8000000000000000ULL;
+	if (key == D_RADIX_FLOAT)
+		return bits ^ ((u64)-(int64)(bits >> 63) | 0x8000000000000000ULL);
+	return bits;
+}
+
+static inline u32	d_sort_f32_key(float f)
+{
+	u32 bits;
+	memcpy(&bits, &f, sizeof(u32));
+	return d_radix_key_32(bits, D_RADIX_FLOAT);
+}
+
+static inline u64	d_sort_f64_key(double d)
+{
+	u64 bits;
+	memcpy(&bits, &d, sizeof(u64));
+	return d_radix_key_64(bits, D_RADIX_FLOAT);
+}
+
+#define d_sort_f32_less(a, b) (d_sort_f32_key(a) < d_sort_f32_key(b))
+#define d_sort_f64_less(a, b) (d_sort_f64_key(a) < d_sort_f64_key(b))
+
+D_SORT_DEFINE(d_sort_i32_impl, int32, d_sort_less)
+D_SORT_DEFINE(d_sort_u32_impl, u32, d_sort_less)
+D_SORT_DEFINE(d_sort_i64_impl, int64, d_sort_less)
+D_SORT_DEFINE(d_sort_u64_impl, u64, d_sort_less)
+D_SORT_DEFINE(d_sort_f32_impl, float, d_sort_f32_less)
+D_SORT_DEFINE(d_sort_f64_impl, double, d_sort_f64_less)
+
+void	d_sort_i32				(int32* base, usize len)
+{
+	d_sort_i32_impl(base, len);
+}
+
+void	d_sort_u32				(u32* base, usize len)
+{
+	d_sort_u32_impl(base, len);
+}
+
+void	d_sort_i64				(int64* base, usize len)
+{
+	d_sort_i64_impl(base, len);
+}
+
+void	d_sort_u64				(u64* base, usize len)
+{
+	d_sort_u64_impl(base, len);
+}
+
+void	d_sort_f32				(float* base, usize len)
+{
+	d_sort_f32_impl(base, len);
+}
+
+void	d_sort_f64				(double* base, usize len)
+{
+	d_sort_f64_impl(base, len);
+}
+
+//One histogram per byte of the keys, filled in a single pass. The digits every key shares are skipped, the data
+//goes back and forth between `data` and `buffer` and is copied back if it ends in `buffer`
+#define D_RADIX_SORT_DEFINE(bits)																		\
+	static void	d_radix_sort_##bits(u##bits* data, u##bits* buffer, usize len, DRadixKey key)			\
+	{																									\
+		usize counts[bits / 8][256];																	\
+		memset(counts, 0, sizeof(counts));																\
+		for (usize i = 0; i < len; ++i)																	\
+		{																								\
+			u##bits k = d_radix_key_##bits(data[i], key);												\
+			for (u32 digit = 0; digit < bits / 8; ++digit)												\
+				++counts[digit][(k >> (digit * 8)) & 0xFF];												\
+		}																								\
+		u##bits* src = data;																			\
+		u##bits* dst = buffer;																			\
+		u##bits first = d_radix_key_##bits(data[0], key);												\
+		for (u32 digit = 0; digit < bits / 8; ++digit)													\
+		{																								\
+			usize* count = counts[digit];																\
+			u32 shift = digit * 8;																		\
+			if (count[(first >> shift) & 0xFF] == len)													\
+				continue;																				\
+			usize offset = 0;																			\
+			for (u32 b = 0; b < 256; ++b)																\
+			{																							\
+				usize n = count[b];																		\
+				count[b] = offset;																		\
+				offset += n;																			\
+			}																							\
+			for (usize i = 0; i < len; ++i)																\
+				dst[count[(d_radix_key_##bits(src[i], key) >> shift) & 0xFF]++] = src[i];				\
+			u##bits* tmp = src;																			\
+			src = dst;																					\
+			dst = tmp;																					\
+		}																								\
+		if (src != data)																				\
+			memcpy(data, src, len * sizeof(u##bits));													\
+	}
+
+D_RADIX_SORT_DEFINE(32)
+D_RADIX_SORT_DEFINE(64)
+
+//Small inputs go to the comparison sort of the same order
+static void	d_radix_sort_small(void* base, usize len, usize elem_size, DRadixKey key)
+{
+	if (elem_size == sizeof(u32))
+	{
+		if (key == D_RADIX_UNSIGNED)
+			d_sort_u32(base, len);
+		else if (key == D_RADIX_SIGNED)
+			d_sort_i32(base, len);
+		else
+			d_sort_f32(base, len);
+	}
+	else
+	{
+		if (key == D_RADIX_UNSIGNED)
+			d_sort_u64(base, len);
+		else if (key == D_RADIX_SIGNED)
+			d_sort_i64(base, len);
+		else
+			d_sort_f64(base, len);
+	}
+}
+
+bool	d_radix_sort			(void* base, usize len, usize elem_size, DRadixKey key, const DAllocator* allocator)
+{
+	if ((elem_size != sizeof(u32) && elem_size != sizeof(u64))
+		|| (key != D_RADIX_UNSIGNED && key != D_RADIX_SIGNED && key != D_RADIX_FLOAT))
+		return false;
+	if (len < D_RADIX_SORT_THRESHOLD)
+	{
+		d_radix_sort_small(base, len, elem_size, key);
+		return true;
+	}
+	void* buffer = d_alloc_array(allocator, len, elem_size);
+	if (buffer == NULL)
+		return false;
+	if (elem_size == sizeof(u32))
+		d_radix_sort_32(base, buffer, len, key);
+	else
+		d_radix_sort_64(base, buffer, len, key);
+	d_free(allocator, buffer, len * elem_size);
+	return true;
+}
+
+bool	d_array_radix_sort		(DArray* array, DRadixKey key)
+{
+	return d_radix_sort(array -> data, array -> len, d_array_get_elem_size(array), key, d_array_get_allocator(array));
+}
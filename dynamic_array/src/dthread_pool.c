@@ -0,0 +1,318 @@
+#include <dthread_pool.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#ifdef __linux__
+# include <linux/futex.h>
+# include <sys/syscall.h>
+#endif
+
+//SIZE OF A CACHE LINE, EVERY RANGE AND THE WORDS THE PARTICIPANTS OF A JOB WRITE HAVE ONE OF THEIR OWN
+#define D_THREAD_POOL_LINE 64
+
+//Rounds a size up to whole cache lines, as aligned_alloc wants
+#define D_THREAD_POOL_LINES(size) (((size) + D_THREAD_POOL_LINE - 1) / D_THREAD_POOL_LINE * D_THREAD_POOL_LINE)
+
+//Layout of `state`: the generation of the job in the high half, then whether it may still be joined and the
+//number of workers that joined it
+#define D_THREAD_POOL_OPEN			(1ULL << 31)
+#define D_THREAD_POOL_ACTIVE_MASK	(D_THREAD_POOL_OPEN - 1)
+
+//Polls of a word before sleeping on it, or yielding, back-to-back jobs are picked up without a system call
+#define D_THREAD_POOL_SPINS 2048
+
+typedef struct _DThreadPoolWorker	DThreadPoolWorker;
+
+//THE CHUNKS NOT CLAIMED YET OF A PARTICIPANT: FIRST << 32 | END
+typedef struct {
+	u64	range;
+	u8	pad[D_THREAD_POOL_LINE - sizeof(u64)];
+} DThreadPoolSlot;
+
+struct _DThreadPoolWorker {
+	pthread_t		thread;
+	DThreadPool*	pool;
+	usize			slot; /* index of its range, 0 is the range of the calling thread */
+};
+
+//THREAD POOL STRUCTURE ALLOCATED
+struct _DThreadPool {
+	usize				thread_count; /* workers, without the calling thread */
+	DThreadPoolWorker*	workers;
+	DThreadPoolSlot*	slots; /* thread_count + 1 ranges */
+	pthread_mutex_t		lock; /* held by the thread running a job */
+	DThreadPoolTask		task;
+	void*				ctx;
+	usize				len;
+	usize				chunk_len;
+	u8					pad_job[D_THREAD_POOL_LINE];
+	u32					generation; /* futex word of the idle workers, incremented for each job and to stop */
+	u32					stop;
+	u64					state; /* see D_THREAD_POOL_OPEN */
+	u64					remaining; /* chunks of the job not done yet */
+	u8					pad_end[D_THREAD_POOL_LINE];
+};
+
+//Sleeps as long as `*word` is `value`, or until a wake up that may be spurious
+static void	d_thread_pool_futex_wait(u32* word, u32 value)
+{
+#ifdef __linux__
+	syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+#else
+	(void)word;
+	(void)value;
+	sched_yield();
+#endif
+}
+
+static void	d_thread_pool_futex_wake_all(u32* word)
+{
+#ifdef __linux__
+	syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 0x7FFFFFFF, NULL, NULL, 0);
+#else
+	(void)word;
+#endif
+}
+
+static inline void	d_thread_pool_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+//Spins then yields until `*word` is 0 once masked by `mask`
+static void	d_thread_pool_wait_zero(u64* word, u64 mask)
+{
+	for (usize spins = 0; (__atomic_load_n(word, __ATOMIC_ACQUIRE) & mask) != 0; ++spins)
+	{
+		if (spins < D_THREAD_POOL_SPINS)
+			d_thread_pool_pause();
+		else
+			sched_yield();
+	}
+}
+
+//Claims the first chunk of a range
+static bool	d_thread_pool_pop(DThreadPoolSlot* slot, u32* chunk)
+{
+	u64 range = __atomic_load_n(&slot -> range, __ATOMIC_RELAXED);
+	for (;;)
+	{
+		u32 first = (u32)(range >> 32);
+		u32 end = (u32)range;
+		if (first >= end)
+			return false;
+		if (__atomic_compare_exchange_n(&slot -> range, &range, ((u64)(first + 1) << 32) | end, true,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+			*chunk = first;
+			return true;
+		}
+	}
+}
+
+//Moves the back half of the first range found that is not empty into the empty range of `self`. A thief only ever
+//shrinks a range from its end and an owner from its first chunk, so a range holds the same chunks as long as
+//its word did not change, and a successful compare-and-swap is enough to own them
+static bool	d_thread_pool_steal(DThreadPool* pool, usize self)
+{
+	usize participants = pool -> thread_count + 1;
+	for (usize i = 1; i < participants; ++i)
+	{
+		DThreadPoolSlot* victim = &pool -> slots[(self + i) % participants];
+		u64 range = __atomic_load_n(&victim -> range, __ATOMIC_RELAXED);
+		for (;;)
+		{
+			u32 first = (u32)(range >> 32);
+			u32 end = (u32)range;
+			if (first >= end)
+				break;
+			u32 split = end - (end - first + 1) / 2;
+			if (__atomic_compare_exchange_n(&victim -> range, &range, ((u64)first << 32) | split, true,
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				__atomic_store_n(&pool -> slots[self].range, ((u64)split << 32) | end, __ATOMIC_RELAXED);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//Runs chunks until no range has any left
+static void	d_thread_pool_work(DThreadPool* pool, usize self)
+{
+	usize done = 0;
+	u32 chunk;
+	while (d_thread_pool_pop(&pool -> slots[self], &chunk)
+		|| (d_thread_pool_steal(pool, self) && d_thread_pool_pop(&pool -> slots[self], &chunk)))
+	{
+		usize begin = (usize)chunk * pool -> chunk_len;
+		usize end = pool -> len - begin > pool -> chunk_len ? begin + pool -> chunk_len : pool -> len;
+		pool -> task(pool -> ctx, chunk, begin, end);
+		++done;
+	}
+	if (done > 0)
+		__atomic_fetch_sub(&pool -> remaining, done, __ATOMIC_RELEASE);
+}
+
+//Joins the job of `generation` if it is still open
+static bool	d_thread_pool_join(DThreadPool* pool, u32 generation)
+{
+	u64 state = __atomic_load_n(&pool -> state, __ATOMIC_ACQUIRE);
+	while ((u32)(state >> 32) == generation && (state & D_THREAD_POOL_OPEN) != 0)
+	{
+		if (__atomic_compare_exchange_n(&pool -> state, &state, state + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+			return true;
+	}
+	return false;
+}
+
+static void*	d_thread_pool_worker(void* arg)
+{
+	DThreadPoolWorker* worker = arg;
+	DThreadPool* pool = worker -> pool;
+	u32 seen = 0;
+	for (;;)
+	{
+		u32 generation;
+		for (usize spins = 0; (generation = __atomic_load_n(&pool -> generation, __ATOMIC_ACQUIRE)) == seen; ++spins)
+		{
+			if (spins < D_THREAD_POOL_SPINS)
+				d_thread_pool_pause();
+			else
+				d_thread_pool_futex_wait(&pool -> generation, seen);
+		}
+		seen = generation;
+		if (__atomic_load_n(&pool -> stop, __ATOMIC_ACQUIRE))
+			return NULL;
+		if (d_thread_pool_join(pool, generation))
+		{
+			d_thread_pool_work(pool, worker -> slot);
+			__atomic_fetch_sub(&pool -> state, 1, __ATOMIC_RELEASE);
+		}
+	}
+}
+
+//Stops the `started` first workers and frees everything
+static void	d_thread_pool_free(DThreadPool* pool, usize started)
+{
+	__atomic_store_n(&pool -> stop, 1, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&pool -> generation, 1, __ATOMIC_RELEASE);
+	d_thread_pool_futex_wake_all(&pool -> generation);
+	for (usize i = 0; i < started; ++i)
+		pthread_join(pool -> workers[i].thread, NULL);
+	pthread_mutex_destroy(&pool -> lock);
+	free(pool -> workers);
+	free(pool -> slots);
+	free(pool);
+}
+
+DThreadPool	*d_thread_pool_new				(usize thread_count)
+{
+	if (thread_count >= D_THREAD_POOL_MAX_CHUNKS / 2)
+		return NULL;
+	DThreadPool* pool = aligned_alloc(D_THREAD_POOL_LINE, D_THREAD_POOL_LINES(sizeof(DThreadPool)));
+	if (pool == NULL)
+		return NULL;
+	memset(pool, 0, sizeof(DThreadPool));
+	pool -> thread_count = thread_count;
+	pool -> slots = aligned_alloc(D_THREAD_POOL_LINE, (thread_count + 1) * sizeof(DThreadPoolSlot));
+	pool -> workers = calloc(thread_count + 1, sizeof(DThreadPoolWorker));
+	if (pool -> slots == NULL || pool -> workers == NULL || pthread_mutex_init(&pool -> lock, NULL) != 0)
+	{
+		free(pool -> slots);
+		free(pool -> workers);
+		free(pool);
+		return NULL;
+	}
+	memset(pool -> slots, 0, (thread_count + 1) * sizeof(DThreadPoolSlot));
+	for (usize i = 0; i < thread_count; ++i)
+	{
+		pool -> workers[i].pool = pool;
+		pool -> workers[i].slot = i + 1;
+		if (pthread_create(&pool -> workers[i].thread, NULL, d_thread_pool_worker, &pool -> workers[i]) != 0)
+		{
+			d_thread_pool_free(pool, i);
+			return NULL;
+		}
+	}
+	return pool;
+}
+
+static DThreadPool*		g_shared_pool = NULL;
+static pthread_once_t	g_shared_pool_once = PTHREAD_ONCE_INIT;
+
+static void	d_thread_pool_create_shared(void)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	g_shared_pool = d_thread_pool_new(cpus > 1 ? (usize)cpus - 1 : 0);
+}
+
+DThreadPool	*d_thread_pool_get_shared		(void)
+{
+	pthread_once(&g_shared_pool_once, d_thread_pool_create_shared);
+	return g_shared_pool;
+}
+
+usize		d_thread_pool_get_thread_count	(DThreadPool* pool)
+{
+	return pool -> thread_count + 1;
+}
+
+void		d_thread_pool_run				(DThreadPool* pool, usize len, usize chunk_len, DThreadPoolTask task, void* ctx)
+{
+	if (len == 0)
+		return;
+	if (chunk_len == 0 || chunk_len > len)
+		chunk_len = len;
+	usize chunks = (len - 1) / chunk_len + 1;
+	if (chunks > D_THREAD_POOL_MAX_CHUNKS)
+	{
+		chunk_len = (len - 1) / D_THREAD_POOL_MAX_CHUNKS + 1;
+		chunks = (len - 1) / chunk_len + 1;
+	}
+	//Alone, or the pool is busy with another job: the chunks run here, in order
+	if (pool == NULL || pool -> thread_count == 0 || chunks == 1 || pthread_mutex_trylock(&pool -> lock) != 0)
+	{
+		for (usize chunk = 0; chunk < chunks; ++chunk)
+		{
+			usize begin = chunk * chunk_len;
+			task(ctx, chunk, begin, len - begin > chunk_len ? begin + chunk_len : len);
+		}
+		return;
+	}
+	pool -> task = task;
+	pool -> ctx = ctx;
+	pool -> len = len;
+	pool -> chunk_len = chunk_len;
+	pool -> remaining = chunks;
+	usize participants = pool -> thread_count + 1;
+	for (usize i = 0; i < participants; ++i)
+	{
+		u64 first = chunks * i / participants;
+		u64 end = chunks * (i + 1) / participants;
+		__atomic_store_n(&pool -> slots[i].range, (first << 32) | end, __ATOMIC_RELAXED);
+	}
+	u32 generation = pool -> generation + 1;
+	__atomic_store_n(&pool -> state, ((u64)generation << 32) | D_THREAD_POOL_OPEN, __ATOMIC_RELEASE);
+	__atomic_store_n(&pool -> generation, generation, __ATOMIC_RELEASE);
+	d_thread_pool_futex_wake_all(&pool -> generation);
+	d_thread_pool_work(pool, 0);
+	d_thread_pool_wait_zero(&pool -> remaining, ~0ULL);
+	//Workers still inside the job only find empty ranges, they are waited for before the job is replaced
+	__atomic_fetch_and(&pool -> state, ~D_THREAD_POOL_OPEN, __ATOMIC_ACQ_REL);
+	d_thread_pool_wait_zero(&pool -> state, D_THREAD_POOL_ACTIVE_MASK);
+	pthread_mutex_unlock(&pool -> lock);
+}
+
+void		d_thread_pool_destroy			(DThreadPool** pool)
+{
+	if (pool == NULL || *pool == NULL)
+		return;
+	d_thread_pool_free(*pool, (*pool) -> thread_count);
+	*pool = NULL;
+}
@@ -2,6 +2,11 @@
 #include <stdio.h>
 #include <dtest.h>
 #include <darray.h>
+#include <dring_buffer.h>
+#include <dsort.h>
+#include <dparallel.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <general_lib.h>
 #include <string.h>
@@ -13,6 +18,11 @@ char*   itoa_usize(void *nb)
     return d_itoa_usize(*(usize*)nb);
 }
 
+char*   itoa_bool(void *b)
+{
+    return d_itoa_usize(*(bool*)b);
+}
+
 usize get_nb_len(int nb)
 {
     bool neg = nb < 0;
@@ -492,6 +502,170 @@ void    test_d_array_clear_array(void)
 }
 
 
+void    test_d_array_push_back_on_empty_capacity(void)
+{
+    DArray* array = d_array_new(false, sizeof(int), 1);
+    d_array_modify_capacity(array, 0);
+    int arr[] = {1, 2, 3};
+    g_arr_len = 3;
+    for (int32 i = 1; i <= 3; i++)
+    {
+        d_array_push_back(array, i);
+    }
+    assert_eq_custom(array -> data, arr, sizeof(int) * g_arr_len, print_int_array);
+    assert_eq_custom(&array -> len, &g_arr_len, sizeof(usize), itoa_usize);
+    d_array_destroy(&array);
+}
+
+void    test_d_array_realloc_count(void)
+{
+    DArray* array = d_array_new(false, sizeof(int), 0);
+    usize expected = 0;
+    usize count = d_array_get_realloc_count(array);
+    assert_eq_custom(&count, &expected, sizeof(usize), itoa_usize);
+
+    usize pushes = 1000000;
+    for (usize i = 0; i < pushes; i++)
+    {
+        int32 value = (int32)i;
+        d_array_push_back(array, value);
+    }
+    count = d_array_get_realloc_count(array);
+    usize max_reallocs = 40; //log1.5(1000000 / 4) is about 31
+    d_assert(count > 0 && count <= max_reallocs, &count, &max_reallocs, itoa_usize);
+    assert_eq_custom(&array -> len, &pushes, sizeof(usize), itoa_usize);
+    usize capacity = d_array_get_capacity(array);
+    d_assert(capacity >= pushes, &capacity, &pushes, itoa_usize);
+
+    d_array_modify_capacity(array, pushes);
+    ++expected;
+    expected += count;
+    count = d_array_get_realloc_count(array);
+    assert_eq_custom(&count, &expected, sizeof(usize), itoa_usize);
+    d_array_destroy(&array);
+}
+
+void    test_d_array_set_growth_policy(void)
+{
+    DArray* array = d_array_new(false, sizeof(int), 0);
+    DGrowthPolicy policy = {.factor_num = 2, .factor_den = 1, .min_step = 1, .max_step = 0, .round_to_size_class = false};
+    d_array_set_growth_policy(array, &policy);
+    for (int32 i = 0; i < 5; i++)
+    {
+        d_array_push_back(array, i);
+    }
+    usize capacity = d_array_get_capacity(array);
+    usize expected = 8; // 4 * 2
+    assert_eq_custom(&capacity, &expected, sizeof(usize), itoa_usize);
+
+    policy.max_step = 2;
+    d_array_set_growth_policy(array, &policy);
+    for (int32 i = 0; i < 4; i++)
+    {
+        d_array_push_back(array, i);
+    }
+    capacity = d_array_get_capacity(array);
+    expected = 10; // 8 + max_step
+    assert_eq_custom(&capacity, &expected, sizeof(usize), itoa_usize);
+
+    DGrowthPolicy invalid = {.factor_num = 1, .factor_den = 1, .min_step = 1, .max_step = 0, .round_to_size_class = false};
+    DArray* res = d_array_set_growth_policy(array, &invalid);
+    assert_eq_null(res);
+    d_array_destroy(&array);
+}
+
+void    test_d_growth_policy_next_capacity(void)
+{
+    DGrowthPolicy policy = D_GROWTH_POLICY_DEFAULT;
+    usize capacity = d_growth_policy_next_capacity(&policy, 0, 1, sizeof(int));
+    usize min = 1;
+    d_assert(capacity >= 4, &capacity, &min, itoa_usize);
+
+    capacity = d_growth_policy_next_capacity(&policy, 100, 101, 1);
+    usize expected = 160; // 150 rounded up to the 160 bytes size class
+    assert_eq_custom(&capacity, &expected, sizeof(usize), itoa_usize);
+
+    capacity = d_growth_policy_next_capacity(&policy, 100, 1000, 1);
+    expected = 1024;
+    assert_eq_custom(&capacity, &expected, sizeof(usize), itoa_usize);
+
+    capacity = d_growth_policy_next_capacity(&policy, 4, MAX_SIZE_T_VALUE, sizeof(int));
+    expected = 0;
+    assert_eq_custom(&capacity, &expected, sizeof(usize), itoa_usize);
+}
+
+void    test_d_small_array(void)
+{
+    D_SMALL_ARRAY(int, 8) small;
+    DArray* array = d_small_array_init(&small, false);
+    int arr[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    usize expected = 0;
+    bool is_inline;
+    bool expected_inline = true;
+
+    for (int32 i = 1; i <= 8; i++)
+    {
+        d_array_push_back(array, i);
+    }
+    g_arr_len = 8;
+    is_inline = d_array_is_inline(array);
+    assert_eq_custom(&is_inline, &expected_inline, sizeof(bool), NULL);
+    assert_eq_custom(array -> data, arr, sizeof(int) * g_arr_len, print_int_array);
+    assert_eq_custom(small.inline_data, arr, sizeof(int) * g_arr_len, print_int_array);
+    usize count = d_array_get_realloc_count(array);
+    assert_eq_custom(&count, &expected, sizeof(usize), itoa_usize);
+
+    d_array_append_vals(array, arr + 8, 2);
+    g_arr_len = 10;
+    expected_inline = false;
+    is_inline = d_array_is_inline(array);
+    assert_eq_custom(&is_inline, &expected_inline, sizeof(bool), NULL);
+    assert_eq_custom(array -> data, arr, sizeof(int) * g_arr_len, print_int_array);
+    assert_eq_custom(&array -> len, &g_arr_len, sizeof(usize), itoa_usize);
+
+    d_array_pop_back(array);
+    g_arr_len = 9;
+    int last = d_array_get_val_by_index(array, int, array -> len - 1);
+    int expected_last = 9;
+    assert_eq_custom(&last, &expected_last, sizeof(int), NULL);
+    assert_eq_custom(&array -> len, &g_arr_len, sizeof(usize), itoa_usize);
+    d_array_destroy(&array);
+    assert_eq_null(array);
+}
+
+void    test_d_small_array_embedded(void)
+{
+    struct {
+        int                     id;
+        D_SMALL_ARRAY(usize, 4) values;
+    } owner;
+
+    owner.id = 42;
+    DArray* array = d_small_array_init(&owner.values, true);
+    usize zero = 0;
+    assert_eq_custom(owner.values.inline_data, &zero, sizeof(usize), itoa_usize);
+    for (usize i = 0; i < 4; i++)
+    {
+        d_array_push_back(array, i);
+    }
+    d_array_shrink_to_fit(array);
+    usize capacity = d_array_get_capacity(array);
+    usize expected = 4;
+    assert_eq_custom(&capacity, &expected, sizeof(usize), itoa_usize);
+    d_array_modify_capacity(array, 100);
+    capacity = d_array_get_capacity(array);
+    expected = 100;
+    assert_eq_custom(&capacity, &expected, sizeof(usize), itoa_usize);
+    usize third = d_array_get_val_by_index(array, usize, 3);
+    expected = 3;
+    assert_eq_custom(&third, &expected, sizeof(usize), itoa_usize);
+    usize cleared = d_array_get_val_by_index(array, usize, 99);
+    assert_eq_custom(&cleared, &zero, sizeof(usize), itoa_usize);
+    d_array_destroy(&array);
+    int id = 42;
+    assert_eq_custom(&owner.id, &id, sizeof(int), NULL);
+}
+
 void    test_d_pointer_array_new(void)
 {
     usize len = 4;
@@ -592,6 +766,23 @@ void    test_d_pointer_array_remove_index_fast(void)
     d_pointer_array_destroy(&array);
 }
 
+void    test_d_pointer_array_realloc_count(void)
+{
+    DPointerArray* array = d_pointer_array_new(0, true, NULL);
+    char *str = "dieri";
+    usize pushes = 100000;
+    for (size_t i = 0; i < pushes; i++)
+    {
+        d_pointer_array_push_back(array, str);
+    }
+    usize count = d_pointer_array_get_realloc_count(array);
+    usize max_reallocs = 30;
+    d_assert(count > 0 && count <= max_reallocs, &count, &max_reallocs, itoa_usize);
+    assert_eq_custom(&array -> len, &pushes, sizeof(usize), itoa_usize);
+    assert_eq_null(array -> pdata[pushes]);
+    d_pointer_array_destroy(&array);
+}
+
 void    test_d_pointer_array_clear_array(void)
 {
     DPointerArray* array = d_pointer_array_new(4, true, NULL);
@@ -604,6 +795,856 @@ void    test_d_pointer_array_clear_array(void)
     d_pointer_array_destroy(&array);
 }
 
+//Allocator recording the size of every block in front of it, so that the sizes the arrays give back can be checked
+typedef struct {
+    usize   allocs;
+    usize   frees;
+    usize   live_bytes;
+    usize   size_mismatches;
+} CountingAllocator;
+
+void*   counting_alloc(void* ctx, usize size)
+{
+    CountingAllocator* counter = ctx;
+    usize* block = malloc(sizeof(usize) * 2 + size);
+    if (block == NULL)
+        return NULL;
+    block[0] = size;
+    ++counter -> allocs;
+    counter -> live_bytes += size;
+    return block + 2;
+}
+
+void    counting_free(void* ctx, void* ptr, usize size)
+{
+    CountingAllocator* counter = ctx;
+    usize* block = (usize*)ptr - 2;
+    counter -> size_mismatches += block[0] != size;
+    ++counter -> frees;
+    counter -> live_bytes -= block[0];
+    free(block);
+}
+
+void*   counting_realloc(void* ctx, void* ptr, usize old_size, usize new_size)
+{
+    void* new_ptr = counting_alloc(ctx, new_size);
+    if (new_ptr == NULL || ptr == NULL)
+        return new_ptr;
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    counting_free(ctx, ptr, old_size);
+    return new_ptr;
+}
+
+void    test_d_array_allocator(void)
+{
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    DArray* array = d_array_new_with_allocator(true, sizeof(int), 0, &allocator);
+    bool valid = array != NULL && d_array_get_allocator(array) == &allocator && counter.allocs == 2;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    for (int i = 0; i < 1000; ++i)
+        d_array_push_back(array, i);
+    DArray* copy = d_array_copy(array);
+    valid = d_array_get_allocator(copy) == &allocator && copy -> len == 1000
+        && memcmp(copy -> data, array -> data, sizeof(int) * 1000) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_array_modify_capacity(copy, 0);
+    d_array_shrink_to_fit(array);
+    d_array_modify_capacity(array, 2000);
+    valid = d_array_get_val_by_index(array, int, 999) == 999 && counter.allocs > 4;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_array_destroy(&array);
+    d_array_destroy(&copy);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.size_mismatches, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.allocs, &counter.frees, sizeof(usize), itoa_usize);
+    //the default allocator is libc
+    array = d_array_new(false, sizeof(int), 0);
+    assert_eq_null(d_array_get_allocator(array));
+    d_array_destroy(&array);
+}
+
+void    test_d_pointer_array_allocator(void)
+{
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    DPointerArray* array = d_pointer_array_new_with_allocator(0, true, free, &allocator);
+    bool valid = array != NULL && d_pointer_array_get_allocator(array) == &allocator && counter.allocs == 2;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    for (usize i = 0; i < 500; ++i)
+        d_pointer_array_push_back(array, d_itoa_usize(i));
+    d_pointer_array_modify_capacity(array, 400);
+    valid = array -> len == 400 && array -> pdata[400] == NULL && strcmp(array -> pdata[399], "399") == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_pointer_array_destroy(&array);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.size_mismatches, &zero, sizeof(usize), itoa_usize);
+    array = d_pointer_array_new(0, false, NULL);
+    assert_eq_null(d_pointer_array_get_allocator(array));
+    d_pointer_array_destroy(&array);
+}
+
+void    test_d_ring_buffer(void)
+{
+    bool expected = true;
+    bool valid = d_ring_buffer_new(0, 8, D_RING_BUFFER_SPSC) == NULL && d_ring_buffer_new(8, 0, D_RING_BUFFER_MPMC) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    DRingBufferMode modes[] = {D_RING_BUFFER_SPSC, D_RING_BUFFER_MPMC};
+    for (usize m = 0; m < 2; ++m)
+    {
+        //3 byte elements, the capacity is rounded up to 8
+        DRingBuffer* ring = d_ring_buffer_new(3, 5, modes[m]);
+        u8 elem[3];
+        u8 elems[3 * 16];
+        valid = ring != NULL && ring -> capacity == 8 && ring -> elem_size == 3 && d_ring_buffer_get_len(ring) == 0
+            && d_ring_buffer_pop(ring, elem) == false;
+        assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+        //single elements then batches, wrapping around the buffer many times
+        u8 next_in = 0;
+        u8 next_out = 0;
+        for (usize round = 0; round < 50 && valid; ++round)
+        {
+            for (usize i = 0; i < 3; ++i, ++next_in)
+            {
+                memset(elem, next_in, 3);
+                valid = valid && d_ring_buffer_push(ring, elem);
+            }
+            usize count = (round % 7) + 1;
+            for (usize i = 0; i < count; ++i)
+                memset(elems + 3 * i, next_in + i, 3);
+            usize pushed = d_ring_buffer_push_batch(ring, elems, count);
+            valid = valid && pushed == (count < 5 ? count : 5) && d_ring_buffer_get_len(ring) == 3 + pushed;
+            next_in += pushed;
+            usize popped = d_ring_buffer_pop_batch(ring, elems, 16);
+            valid = valid && popped == 3 + pushed && d_ring_buffer_pop_batch(ring, elems, 16) == 0;
+            for (usize i = 0; i < popped; ++i, ++next_out)
+                valid = valid && elems[3 * i] == next_out && elems[3 * i + 2] == next_out;
+        }
+        assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+        //a full buffer refuses pushes until an element is popped
+        for (usize i = 0; i < 8; ++i)
+            valid = valid && d_ring_buffer_push(ring, elem);
+        valid = valid && d_ring_buffer_push(ring, elem) == false && d_ring_buffer_push_batch(ring, elems, 4) == 0
+            && d_ring_buffer_get_len(ring) == 8 && d_ring_buffer_pop(ring, elem) && d_ring_buffer_push(ring, elem);
+        assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+        d_ring_buffer_destroy(&ring);
+        assert_eq_null(ring);
+    }
+}
+
+#define RING_RECORDS 200000
+
+typedef struct {
+    u32 producer;
+    u32 seq;
+} RingRecord;
+
+typedef struct {
+    DRingBuffer*    ring;
+    u32             id;
+    usize           count; /* records pushed, or popped */
+    usize           errors;
+    usize*          last; /* consumers only, last seq seen from each producer plus one */
+} RingWorker;
+
+void*   ring_producer(void* arg)
+{
+    RingWorker* worker = arg;
+    RingRecord batch[8];
+    u32 seq = 0;
+    while (seq < worker -> count)
+    {
+        //alternates single pushes and batches of up to 8
+        usize count = seq % 3 == 0 ? 1 : 8;
+        if (count > worker -> count - seq)
+            count = worker -> count - seq;
+        for (usize i = 0; i < count; ++i)
+            batch[i] = (RingRecord){worker -> id, seq + i};
+        usize pushed = count == 1 ? d_ring_buffer_push(worker -> ring, batch) : d_ring_buffer_push_batch(worker -> ring, batch, count);
+        if (pushed == 0)
+            sched_yield();
+        seq += pushed;
+    }
+    return NULL;
+}
+
+usize   g_ring_popped = 0;
+
+void*   ring_consumer(void* arg)
+{
+    RingWorker* worker = arg;
+    RingRecord batch[5];
+    while (__atomic_load_n(&g_ring_popped, __ATOMIC_RELAXED) < RING_RECORDS)
+    {
+        usize count = d_ring_buffer_pop_batch(worker -> ring, batch, 1 + worker -> count % 5);
+        if (count == 0)
+        {
+            sched_yield();
+            continue;
+        }
+        //the records of a producer reach a consumer in the order they were pushed
+        for (usize i = 0; i < count; ++i)
+        {
+            worker -> errors += batch[i].seq < worker -> last[batch[i].producer];
+            worker -> last[batch[i].producer] = batch[i].seq + 1;
+        }
+        worker -> count += count;
+        __atomic_add_fetch(&g_ring_popped, count, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+//Runs `producers` producers and `consumers` consumers over a ring of `mode`, RING_RECORDS records overall
+usize   ring_run(DRingBufferMode mode, usize producers, usize consumers)
+{
+    DRingBuffer* ring = d_ring_buffer_new(sizeof(RingRecord), 64, mode);
+    pthread_t threads[8];
+    RingWorker workers[8];
+    usize last[8][4] = {{0}};
+    g_ring_popped = 0;
+    for (usize t = 0; t < producers + consumers; ++t)
+    {
+        bool producer = t < producers;
+        workers[t] = (RingWorker){ring, t, producer ? RING_RECORDS / producers : 0, 0, last[t]};
+        pthread_create(threads + t, NULL, producer ? ring_producer : ring_consumer, workers + t);
+    }
+    for (usize t = 0; t < producers + consumers; ++t)
+        pthread_join(threads[t], NULL);
+    usize errors = d_ring_buffer_get_len(ring) != 0;
+    usize popped = 0;
+    for (usize t = producers; t < producers + consumers; ++t)
+    {
+        errors += workers[t].errors;
+        popped += workers[t].count;
+    }
+    d_ring_buffer_destroy(&ring);
+    return errors + (popped != RING_RECORDS);
+}
+
+void    test_d_ring_buffer_threads(void)
+{
+    usize zero = 0;
+    usize errors = ring_run(D_RING_BUFFER_SPSC, 1, 1);
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+    errors = ring_run(D_RING_BUFFER_MPMC, 4, 4);
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+    errors = ring_run(D_RING_BUFFER_MPMC, 1, 3);
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+}
+
+//xorshift64, the same inputs on every run
+u64 sort_rand(u64* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+#define SORT_PATTERNS 7
+
+//Fills `values` with one of the inputs pdqsort treats specially
+void    sort_fill(u64* values, usize len, usize pattern, u64* state)
+{
+    for (usize i = 0; i < len; ++i)
+    {
+        switch (pattern)
+        {
+            case 0: values[i] = sort_rand(state); break;
+            case 1: values[i] = i; break;
+            case 2: values[i] = len - i; break;
+            case 3: values[i] = sort_rand(state) % 4; break;
+            case 4: values[i] = i < len / 2 ? i : len - i; break;
+            case 5: values[i] = i % 16; break;
+            default: values[i] = (i % 100 == 0) ? sort_rand(state) : i; break;
+        }
+    }
+}
+
+int32   cmp_i32(const void* a, const void* b)
+{
+    int32 x = *(const int32*)a;
+    int32 y = *(const int32*)b;
+    return (x > y) - (x < y);
+}
+
+int32   cmp_u32(const void* a, const void* b)
+{
+    u32 x = *(const u32*)a;
+    u32 y = *(const u32*)b;
+    return (x > y) - (x < y);
+}
+
+int32   cmp_i64(const void* a, const void* b)
+{
+    int64 x = *(const int64*)a;
+    int64 y = *(const int64*)b;
+    return (x > y) - (x < y);
+}
+
+int32   cmp_u64(const void* a, const void* b)
+{
+    u64 x = *(const u64*)a;
+    u64 y = *(const u64*)b;
+    return (x > y) - (x < y);
+}
+
+//IEEE total order, on the bits of the floats
+int32   cmp_f32_total(const void* a, const void* b)
+{
+    int32 x;
+    int32 y;
+    memcpy(&x, a, sizeof(int32));
+    memcpy(&y, b, sizeof(int32));
+    x ^= (int32)((u32)(x >> 31) >> 1);
+    y ^= (int32)((u32)(y >> 31) >> 1);
+    return (x > y) - (x < y);
+}
+
+int32   cmp_f64_total(const void* a, const void* b)
+{
+    int64 x;
+    int64 y;
+    memcpy(&x, a, sizeof(int64));
+    memcpy(&y, b, sizeof(int64));
+    x ^= (int64)((u64)(x >> 63) >> 1);
+    y ^= (int64)((u64)(y >> 63) >> 1);
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    u32     key;
+    u32     payload[24]; /* larger than the swap chunk of d_sort */
+} SortRecord;
+
+int32   cmp_record(const void* a, const void* b)
+{
+    return cmp_u32(&((const SortRecord*)a) -> key, &((const SortRecord*)b) -> key);
+}
+
+int32   cmp_str(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static const usize g_sort_lens[] = {0, 1, 2, 3, 23, 24, 25, 100, 128, 129, 1000, 4099, 30000};
+
+void    test_d_sort(void)
+{
+    bool expected = true;
+    bool valid = true;
+    u64 state = 88172645463325252ULL;
+    usize max_len = g_sort_lens[sizeof(g_sort_lens) / sizeof(*g_sort_lens) - 1];
+    u64* values = malloc(max_len * sizeof(u64));
+    int32* got = malloc(max_len * sizeof(int32));
+    int32* want = malloc(max_len * sizeof(int32));
+    for (usize l = 0; l < sizeof(g_sort_lens) / sizeof(*g_sort_lens); ++l)
+    {
+        usize len = g_sort_lens[l];
+        for (usize pattern = 0; pattern < SORT_PATTERNS; ++pattern)
+        {
+            sort_fill(values, len, pattern, &state);
+            for (usize i = 0; i < len; ++i)
+                want[i] = (int32)values[i];
+            memcpy(got, want, len * sizeof(int32));
+            qsort(want, len, sizeof(int32), cmp_i32);
+            d_sort(got, len, sizeof(int32), cmp_i32);
+            valid = valid && memcmp(got, want, len * sizeof(int32)) == 0;
+            for (usize i = 0; i < len; ++i)
+                got[i] = (int32)values[i];
+            d_sort_i32(got, len);
+            valid = valid && memcmp(got, want, len * sizeof(int32)) == 0;
+        }
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //elements larger than a swap chunk, the payload moves along with its key
+    SortRecord* records = malloc(4099 * sizeof(SortRecord));
+    for (usize pattern = 0; pattern < SORT_PATTERNS; ++pattern)
+    {
+        sort_fill(values, 4099, pattern, &state);
+        for (usize i = 0; i < 4099; ++i)
+        {
+            records[i].key = (u32)values[i] % 1000;
+            for (usize j = 0; j < 24; ++j)
+                records[i].payload[j] = records[i].key * 3 + (u32)j;
+        }
+        d_sort(records, 4099, sizeof(SortRecord), cmp_record);
+        for (usize i = 0; i < 4099; ++i)
+            valid = valid && (i == 0 || records[i - 1].key <= records[i].key)
+                && records[i].payload[0] == records[i].key * 3 && records[i].payload[23] == records[i].key * 3 + 23;
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    free(records);
+    free(values);
+    free(got);
+    free(want);
+}
+
+void    test_d_sort_specialized(void)
+{
+    bool expected = true;
+    bool valid = true;
+    u64 state = 0x9E3779B97F4A7C15ULL;
+    usize len = 5000;
+    u64* values = malloc(len * sizeof(u64));
+    u64* got = malloc(len * sizeof(u64));
+    u64* want = malloc(len * sizeof(u64));
+    for (usize pattern = 0; pattern < SORT_PATTERNS; ++pattern)
+    {
+        sort_fill(values, len, pattern, &state);
+        //u32
+        for (usize i = 0; i < len; ++i)
+            ((u32*)want)[i] = ((u32*)got)[i] = (u32)values[i];
+        qsort(want, len, sizeof(u32), cmp_u32);
+        d_sort_u32((u32*)got, len);
+        valid = valid && memcmp(got, want, len * sizeof(u32)) == 0;
+        //i64 and u64, with the sign bit set on the high values
+        for (usize i = 0; i < len; ++i)
+            want[i] = got[i] = values[i] * 0x8000000000000001ULL;
+        qsort(want, len, sizeof(int64), cmp_i64);
+        d_sort_i64((int64*)got, len);
+        valid = valid && memcmp(got, want, len * sizeof(int64)) == 0;
+        qsort(want, len, sizeof(u64), cmp_u64);
+        d_sort_u64(got, len);
+        valid = valid && memcmp(got, want, len * sizeof(u64)) == 0;
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //floats, with both zeros, infinities and NaNs of both signs
+    float specials_f32[] = {0.0f, -0.0f, 1.0f / 0.0f, -1.0f / 0.0f, 0.0f / 0.0f, -(0.0f / 0.0f), 1e-40f, -1e-40f};
+    double specials_f64[] = {0.0, -0.0, 1.0 / 0.0, -1.0 / 0.0, 0.0 / 0.0, -(0.0 / 0.0), 5e-324, -5e-324};
+    for (usize i = 0; i < len; ++i)
+    {
+        u64 r = sort_rand(&state);
+        float f = (float)((int64)r) / 1e15f;
+        double d = (double)((int64)r) / 1e15;
+        if (r % 10 == 0)
+        {
+            f = specials_f32[(r >> 8) % 8];
+            d = specials_f64[(r >> 8) % 8];
+        }
+        ((float*)want)[i] = ((float*)got)[i] = f;
+        ((double*)values)[i] = d;
+    }
+    qsort(want, len, sizeof(float), cmp_f32_total);
+    d_sort_f32((float*)got, len);
+    valid = valid && memcmp(got, want, len * sizeof(float)) == 0;
+    memcpy(want, values, len * sizeof(double));
+    memcpy(got, values, len * sizeof(double));
+    qsort(want, len, sizeof(double), cmp_f64_total);
+    d_sort_f64((double*)got, len);
+    valid = valid && memcmp(got, want, len * sizeof(double)) == 0;
+    //-NaN first, then -inf, -0 before +0, +inf then NaN last
+    double* sorted = (double*)got;
+    valid = valid && sorted[0] != sorted[0] && sorted[len - 1] != sorted[len - 1] && (got[0] >> 63) == 1 && (got[len - 1] >> 63) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    free(values);
+    free(got);
+    free(want);
+}
+
+void    test_d_array_sort(void)
+{
+    bool expected = true;
+    DArray* array = d_array_new(false, sizeof(int32), 0);
+    u64 state = 42;
+    for (usize i = 0; i < 3000; ++i)
+    {
+        int32 value = (int32)(sort_rand(&state) % 2000) - 1000;
+        d_array_push_back(array, value);
+    }
+    d_array_sort(array, cmp_i32);
+    bool valid = array -> len == 3000;
+    for (usize i = 1; i < array -> len; ++i)
+        valid = valid && d_array_get_val_by_index(array, int32, i - 1) <= d_array_get_val_by_index(array, int32, i);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_array_destroy(&array);
+    //the terminating NULL of the pointer array stays in place
+    DPointerArray* strings = d_pointer_array_new(0, true, free);
+    for (usize i = 0; i < 1000; ++i)
+        d_pointer_array_push_back(strings, d_itoa_usize(sort_rand(&state) % 5000));
+    d_pointer_array_sort(strings, cmp_str);
+    valid = strings -> len == 1000 && strings -> pdata[1000] == NULL;
+    for (usize i = 1; i < strings -> len; ++i)
+        valid = valid && strcmp(strings -> pdata[i - 1], strings -> pdata[i]) <= 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_pointer_array_destroy(&strings);
+}
+
+void    test_d_radix_sort(void)
+{
+    bool expected = true;
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    //only 4 and 8 byte keys of a known kind
+    u64 dummy[4] = {3, 2, 1, 0};
+    bool valid = d_radix_sort(dummy, 4, 2, D_RADIX_UNSIGNED, NULL) == false
+        && d_radix_sort(dummy, 4, 8, (DRadixKey)7, NULL) == false && dummy[0] == 3;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    usize lens[] = {0, 1, 255, 256, 1000, 70000};
+    DCompareFunc cmps_32[] = {cmp_u32, cmp_i32, cmp_f32_total};
+    DCompareFunc cmps_64[] = {cmp_u64, cmp_i64, cmp_f64_total};
+    DRadixKey keys[] = {D_RADIX_UNSIGNED, D_RADIX_SIGNED, D_RADIX_FLOAT};
+    u64 state = 7;
+    u64* got = malloc(70000 * sizeof(u64));
+    u64* want = malloc(70000 * sizeof(u64));
+    for (usize l = 0; l < sizeof(lens) / sizeof(*lens); ++l)
+    {
+        usize len = lens[l];
+        for (usize k = 0; k < 3; ++k)
+        {
+            for (usize pattern = 0; pattern < SORT_PATTERNS; pattern += 3)
+            {
+                //spread over all the bytes, with a NaN now and then for the floats
+                sort_fill(want, len, pattern, &state);
+                for (usize i = 0; i < len; ++i)
+                    want[i] = pattern == 0 ? want[i] : want[i] * 0x9E3779B97F4A7C15ULL;
+                memcpy(got, want, len * sizeof(u64));
+                qsort(want, len, sizeof(u64), cmps_64[k]);
+                valid = valid && d_radix_sort(got, len, sizeof(u64), keys[k], &allocator)
+                    && memcmp(got, want, len * sizeof(u64)) == 0;
+                memcpy(got, want, len * sizeof(u64));
+                qsort(want, len, sizeof(u32), cmps_32[k]);
+                valid = valid && d_radix_sort(got, len, sizeof(u32), keys[k], &allocator)
+                    && memcmp(got, want, len * sizeof(u32)) == 0;
+            }
+        }
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    //the scratch buffer comes from the allocator of the array
+    DArray* array = d_array_new_with_allocator(false, sizeof(int64), 0, &allocator);
+    for (int64 i = 0; i < 1000; ++i)
+    {
+        int64 value = (i % 2) ? i : -i;
+        d_array_push_back(array, value);
+    }
+    usize allocs = counter.allocs;
+    valid = d_array_radix_sort(array, D_RADIX_SIGNED) && counter.allocs == allocs + 1
+        && d_array_get_val_by_index(array, int64, 0) == -998 && d_array_get_val_by_index(array, int64, 999) == 999;
+    for (usize i = 1; i < array -> len; ++i)
+        valid = valid && d_array_get_val_by_index(array, int64, i - 1) < d_array_get_val_by_index(array, int64, i);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_array_destroy(&array);
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    free(got);
+    free(want);
+}
+
+typedef struct {
+    u32*    hits; /* times each element was visited */
+    usize   chunks; /* sum of the chunk indexes seen */
+    usize   bad_bounds;
+    DThreadPool* nested; /* pool called again from inside the tasks, or NULL */
+} PoolJob;
+
+void    pool_inner_task(void* arg, usize chunk, usize begin, usize end)
+{
+    (void)chunk;
+    __atomic_fetch_add((usize*)arg, end - begin, __ATOMIC_RELAXED);
+}
+
+void    pool_task(void* arg, usize chunk, usize begin, usize end)
+{
+    PoolJob* job = arg;
+    if (begin != chunk * 100 || end <= begin || end - begin > 100)
+        __atomic_fetch_add(&job -> bad_bounds, 1, __ATOMIC_RELAXED);
+    for (usize i = begin; i < end; ++i)
+        ++job -> hits[i];
+    __atomic_fetch_add(&job -> chunks, chunk, __ATOMIC_RELAXED);
+    if (job -> nested != NULL)
+    {
+        usize inner = 0;
+        d_thread_pool_run(job -> nested, 1000, 10, pool_inner_task, &inner);
+        if (inner != 1000)
+            __atomic_fetch_add(&job -> bad_bounds, 1, __ATOMIC_RELAXED);
+    }
+}
+
+//Runs a job of 100003 elements in chunks of 100 and tells whether every element was visited once
+bool    pool_run_job(DThreadPool* pool, bool nested)
+{
+    usize len = 100003;
+    PoolJob job = { calloc(len, sizeof(u32)), 0, 0, nested ? pool : NULL };
+    d_thread_pool_run(pool, len, 100, pool_task, &job);
+    bool valid = job.bad_bounds == 0 && job.chunks == 1000 * 1001 / 2;
+    for (usize i = 0; i < len; ++i)
+        valid = valid && job.hits[i] == 1;
+    free(job.hits);
+    return valid;
+}
+
+void*   pool_caller(void* arg)
+{
+    bool* valid = arg;
+    for (usize i = 0; i < 20; ++i)
+        *valid = *valid && pool_run_job(d_thread_pool_get_shared(), false);
+    return NULL;
+}
+
+void    test_d_thread_pool(void)
+{
+    bool expected = true;
+    DThreadPool* pools[] = { NULL, d_thread_pool_new(0), d_thread_pool_new(1), d_thread_pool_new(4) };
+    bool valid = pools[1] != NULL && pools[2] != NULL && pools[3] != NULL
+        && d_thread_pool_get_thread_count(pools[1]) == 1 && d_thread_pool_get_thread_count(pools[3]) == 5;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //many jobs in a row, then tasks calling the pool they run on
+    for (usize p = 0; p < 4; ++p)
+        for (usize i = 0; i < 50; ++i)
+            valid = valid && pool_run_job(pools[p], i % 10 == 9);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //a single chunk, and nothing to do
+    usize inner = 0;
+    d_thread_pool_run(pools[3], 500, 0, pool_inner_task, &inner);
+    d_thread_pool_run(pools[3], 0, 10, pool_inner_task, &inner);
+    valid = inner == 500;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //several threads sharing a pool
+    DThreadPool* shared = d_thread_pool_get_shared();
+    valid = shared != NULL && shared == d_thread_pool_get_shared() && d_thread_pool_get_thread_count(shared) >= 1;
+    bool results[3] = { true, true, true };
+    pthread_t threads[3];
+    for (usize i = 0; i < 3; ++i)
+        pthread_create(&threads[i], NULL, pool_caller, &results[i]);
+    for (usize i = 0; i < 3; ++i)
+        pthread_join(threads[i], NULL);
+    valid = valid && results[0] && results[1] && results[2];
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    for (usize p = 1; p < 4; ++p)
+    {
+        d_thread_pool_destroy(&pools[p]);
+        assert_eq_null(pools[p]);
+    }
+}
+
+void    parallel_double(void* elem, void* ctx)
+{
+    (void)ctx;
+    *(u32*)elem *= 2;
+}
+
+void    parallel_square(const void* elem, void* out, void* ctx)
+{
+    *(u64*)out = (u64)*(const u32*)elem * *(const u32*)elem + *(const u64*)ctx;
+}
+
+bool    parallel_is_multiple(const void* elem, void* ctx)
+{
+    return *(const u32*)elem % *(const u32*)ctx == 0;
+}
+
+void    parallel_add_double(void* acc, const void* value, void* ctx)
+{
+    (void)ctx;
+    *(double*)acc += *(const double*)value;
+}
+
+void    parallel_add_u32_to_u64(void* acc, const void* value, void* ctx)
+{
+    (void)ctx;
+    *(u64*)acc += *(const u32*)value;
+}
+
+void    parallel_add_u64(void* acc, const void* value, void* ctx)
+{
+    (void)ctx;
+    *(u64*)acc += *(const u64*)value;
+}
+
+//x -> a * x + b, combined as "apply acc then value": associative but not commutative
+typedef struct {
+    u64 a;
+    u64 b;
+} Affine;
+
+void    parallel_compose(void* acc, const void* value, void* ctx)
+{
+    Affine* f = acc;
+    const Affine* g = value;
+    (void)ctx;
+    f -> b = g -> a * f -> b + g -> b;
+    f -> a = g -> a * f -> a;
+}
+
+void    test_d_parallel_algorithms(void)
+{
+    bool expected = true;
+    DThreadPool* pool = d_thread_pool_new(3);
+    //the pool of the options, the shared one, and the calling thread only
+    DParallelOptions options[] = {
+        { pool, 1000, 2000 },
+        { NULL, 0, 1 },
+        { pool, 0, MAX_SIZE_T_VALUE },
+        { d_thread_pool_new(0), 777, 1 },
+    };
+    usize len = 200003;
+    DArray* array = d_array_new(false, sizeof(u32), len);
+    u64 state = 1234;
+    for (usize i = 0; i < len; ++i)
+    {
+        u32 value = (u32)(sort_rand(&state) % 1000000);
+        d_array_push_back(array, value);
+    }
+    u32 divisor = 3;
+    u64 offset = 5;
+    bool valid = true;
+    for (usize o = 0; o < 4; ++o)
+    {
+        DArray* copy = d_array_copy(array);
+        d_parallel_for_each(copy, parallel_double, NULL, &options[o]);
+        for (usize i = 0; i < len; ++i)
+            valid = valid && d_array_get_val_by_index(copy, u32, i) == 2 * d_array_get_val_by_index(array, u32, i);
+        DArray* squares = d_parallel_map(array, sizeof(u64), parallel_square, &offset, &options[o]);
+        valid = valid && squares != NULL && squares -> len == len && d_array_get_elem_size(squares) == sizeof(u64);
+        for (usize i = 0; valid && i < len; ++i)
+        {
+            u64 v = d_array_get_val_by_index(array, u32, i);
+            valid = d_array_get_val_by_index(squares, u64, i) == v * v + offset;
+        }
+        DArray* kept = d_parallel_filter(array, parallel_is_multiple, &divisor, &options[o]);
+        usize k = 0;
+        for (usize i = 0; valid && i < len; ++i)
+        {
+            u32 v = d_array_get_val_by_index(array, u32, i);
+            if (v % divisor == 0)
+                valid = k < kept -> len && d_array_get_val_by_index(kept, u32, k++) == v;
+        }
+        valid = valid && kept -> len == k;
+        u64 sum = 0;
+        u64 serial_sum = 0;
+        for (usize i = 0; i < len; ++i)
+            serial_sum += d_array_get_val_by_index(array, u32, i);
+        valid = valid && d_parallel_reduce(array, &sum, sizeof(u64), parallel_add_u32_to_u64, parallel_add_u64, NULL, &options[o])
+            && sum == serial_sum;
+        d_array_destroy(&copy);
+        d_array_destroy(&squares);
+        d_array_destroy(&kept);
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //floating point sums and scans give the same bits whatever the pool, for a given grain
+    DArray* doubles = d_array_new(false, sizeof(double), len);
+    for (usize i = 0; i < len; ++i)
+    {
+        double value = (double)(int64)sort_rand(&state) / 1e12;
+        d_array_push_back(doubles, value);
+    }
+    double sums[4];
+    DArray* scans[4];
+    for (usize o = 0; o < 4; ++o)
+    {
+        DParallelOptions same_grain = options[o];
+        same_grain.grain = 1000;
+        same_grain.serial_threshold = 1;
+        sums[o] = 0.0;
+        valid = valid && d_parallel_reduce(doubles, &sums[o], sizeof(double), parallel_add_double, parallel_add_double, NULL, &same_grain);
+        scans[o] = d_array_copy(doubles);
+        valid = valid && d_parallel_prefix_sum(scans[o], parallel_add_double, NULL, &same_grain);
+    }
+    for (usize o = 1; o < 4; ++o)
+        valid = valid && memcmp(&sums[o], &sums[0], sizeof(double)) == 0
+            && memcmp(scans[o] -> data, scans[0] -> data, len * sizeof(double)) == 0;
+    for (usize o = 0; o < 4; ++o)
+        d_array_destroy(&scans[o]);
+    d_array_destroy(&doubles);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //a scan of an operation that is not commutative
+    DArray* affines = d_array_new(false, sizeof(Affine), len);
+    for (usize i = 0; i < len; ++i)
+    {
+        Affine f = { sort_rand(&state) | 1, sort_rand(&state) };
+        d_array_push_back(affines, f);
+    }
+    Affine* serial = malloc(len * sizeof(Affine));
+    memcpy(serial, affines -> data, len * sizeof(Affine));
+    for (usize i = 1; i < len; ++i)
+    {
+        Affine acc = serial[i - 1];
+        parallel_compose(&acc, &serial[i], NULL);
+        serial[i] = acc;
+    }
+    for (usize o = 0; o < 4; ++o)
+    {
+        DArray* scan = d_array_copy(affines);
+        valid = valid && d_parallel_prefix_sum(scan, parallel_compose, NULL, &options[o])
+            && memcmp(scan -> data, serial, len * sizeof(Affine)) == 0;
+        d_array_destroy(&scan);
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    free(serial);
+    d_array_destroy(&affines);
+    d_array_destroy(&array);
+    d_thread_pool_destroy(&options[3].pool);
+    d_thread_pool_destroy(&pool);
+}
+
+typedef struct {
+    u32 key;
+    u32 index;
+} ParallelRecord;
+
+int32   cmp_parallel_record(const void* a, const void* b)
+{
+    return cmp_u32(&((const ParallelRecord*)a) -> key, &((const ParallelRecord*)b) -> key);
+}
+
+void    test_d_parallel_sort(void)
+{
+    bool expected = true;
+    bool valid = true;
+    DThreadPool* pool = d_thread_pool_new(3);
+    DThreadPool* alone = d_thread_pool_new(0);
+    usize lens[] = {0, 1, 1000, 100003, 1000000};
+    u64 state = 99;
+    for (usize l = 0; l < sizeof(lens) / sizeof(*lens); ++l)
+    {
+        usize len = lens[l];
+        DArray* array = d_array_new(false, sizeof(ParallelRecord), len);
+        for (usize i = 0; i < len; ++i)
+        {
+            ParallelRecord record = { (u32)(sort_rand(&state) % (len / 4 + 1)), (u32)i };
+            d_array_push_back(array, record);
+        }
+        //odd numbers of runs, the default runs, and the same runs on one thread
+        DParallelOptions options[] = {
+            { pool, 1000, 1 },
+            { alone, 1000, 1 },
+            { pool, 0, 1 },
+            { NULL, 0, 1 },
+            { alone, 0, 1 },
+        };
+        DArray* sorted[5];
+        for (usize o = 0; o < 5; ++o)
+        {
+            sorted[o] = d_array_copy(array);
+            valid = valid && d_parallel_sort(sorted[o], cmp_parallel_record, &options[o]);
+            ParallelRecord* records = sorted[o] -> data;
+            for (usize i = 1; i < len; ++i)
+                valid = valid && records[i - 1].key <= records[i].key;
+        }
+        //every record once
+        u8* seen = calloc(len + 1, 1);
+        for (usize i = 0; i < len; ++i)
+            seen[d_array_get_val_by_index(sorted[0], ParallelRecord, i).index]++;
+        for (usize i = 0; i < len; ++i)
+            valid = valid && seen[i] == 1;
+        free(seen);
+        valid = valid && memcmp(sorted[0] -> data, sorted[1] -> data, len * sizeof(ParallelRecord)) == 0
+            && memcmp(sorted[2] -> data, sorted[3] -> data, len * sizeof(ParallelRecord)) == 0
+            && memcmp(sorted[2] -> data, sorted[4] -> data, len * sizeof(ParallelRecord)) == 0;
+        for (usize o = 0; o < 5; ++o)
+            d_array_destroy(&sorted[o]);
+        d_array_destroy(&array);
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_thread_pool_destroy(&pool);
+    d_thread_pool_destroy(&alone);
+}
+
 int main(void)
 {
     TEST("test_d_array_destroy", test_d_array_destroy(););
@@ -615,6 +1656,12 @@ int main(void)
     TEST("test_d_array_remove_index_fast", test_d_array_remove_index_fast(););
     TEST("test_d_array_pop_back", test_d_array_pop_back(););
     TEST("test_d_array_clear_array", test_d_array_clear_array(););
+    TEST("test_d_array_push_back_on_empty_capacity", test_d_array_push_back_on_empty_capacity(););
+    TEST("test_d_array_realloc_count", test_d_array_realloc_count(););
+    TEST("test_d_array_set_growth_policy", test_d_array_set_growth_policy(););
+    TEST("test_d_growth_policy_next_capacity", test_d_growth_policy_next_capacity(););
+    TEST("test_d_small_array", test_d_small_array(););
+    TEST("test_d_small_array_embedded", test_d_small_array_embedded(););
     TEST("test_d_pointer_array_destroy", test_d_pointer_array_destroy(););
     TEST("test_d_pointer_array_new", test_d_pointer_array_new(););
     TEST("test_d_pointer_array_append_vals", test_d_pointer_array_append_vals(););
@@ -622,5 +1669,17 @@ int main(void)
     TEST("test_d_pointer_array_get_capacity", test_d_pointer_array_get_capacity(););
     TEST("test_d_pointer_array_modify_capacity",test_d_pointer_array_modify_capacity(););
     TEST("test_d_pointer_array_remove_index_fast", test_d_pointer_array_remove_index_fast(););
+    TEST("test_d_pointer_array_realloc_count", test_d_pointer_array_realloc_count(););
     TEST("test_d_pointer_array_clear_array", test_d_pointer_array_clear_array(););
+    TEST("test_d_array_allocator", test_d_array_allocator(););
+    TEST("test_d_pointer_array_allocator", test_d_pointer_array_allocator(););
+    TEST("test_d_ring_buffer", test_d_ring_buffer(););
+    TEST("test_d_ring_buffer_threads", test_d_ring_buffer_threads(););
+    TEST("test_d_sort", test_d_sort(););
+    TEST("test_d_sort_specialized", test_d_sort_specialized(););
+    TEST("test_d_array_sort", test_d_array_sort(););
+    TEST("test_d_radix_sort", test_d_radix_sort(););
+    TEST("test_d_thread_pool", test_d_thread_pool(););
+    TEST("test_d_parallel_algorithms", test_d_parallel_algorithms(););
+    TEST("test_d_parallel_sort", test_d_parallel_sort(););
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "general_lib.h"
+
+/*
+ * Number conversion benchmark of the d_itoa, d_atoi, d_dtoa and d_strtod families.
+ *
+ * The same random u64 values, of a uniformly random number of bits so that every length from 1 to 20 digits
+ * shows up, are formatted with d_u64_to_chars and snprintf, then the resulting strings are parsed back with
+ * d_atoi_u64 and strtoull. Short numbers, 1 to 4 digits as counters and sizes mostly are, get their own pass.
+ * Doubles of random bits, then the same values rounded to floats, are formatted with d_double_to_chars and
+ * d_float_to_chars against snprintf with 17 and 9 digits, the precision libc needs to round-trip, and the
+ * shortest strings are parsed back with d_strtod and strtod. Prices, with 2 decimals, get their own pass.
+ */
+
+#define VALUES 2000000
+
+static double	now_in_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void	bench_values(const char* name, const u64* values, char (*strings)[D_ITOA_BUFFER_SIZE], usize* lens)
+{
+    usize total = 0;
+    double start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        total += lens[i] = d_u64_to_chars(values[i], strings[i]);
+    double d_format = now_in_seconds() - start;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        total += snprintf(strings[i], D_ITOA_BUFFER_SIZE, "%" PRIu64, values[i]);
+    double libc_format = now_in_seconds() - start;
+    u64 sum = 0;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+    {
+        u64 value;
+        d_atoi_u64(strings[i], lens[i], &value);
+        sum += value;
+    }
+    double d_parse = now_in_seconds() - start;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        sum -= strtoull(strings[i], NULL, 10);
+    double libc_parse = now_in_seconds() - start;
+    printf("%s (%.1f digits on average)\n", name, (double)total / (2 * VALUES));
+    printf("  d_u64_to_chars %8.2f ns   snprintf %8.2f ns\n", d_format * 1e9 / VALUES, libc_format * 1e9 / VALUES);
+    printf("  d_atoi_u64     %8.2f ns   strtoull %8.2f ns   (checksum %s)\n", d_parse * 1e9 / VALUES,
+        libc_parse * 1e9 / VALUES, sum == 0 ? "ok" : "MISMATCH");
+}
+
+static void	bench_doubles(const char* name, const double* values, char (*strings)[D_DTOA_BUFFER_SIZE], usize* lens)
+{
+    usize total = 0;
+    double start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        total += lens[i] = d_double_to_chars(values[i], strings[i]);
+    double d_format = now_in_seconds() - start;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        d_float_to_chars((float)values[i], strings[i]);
+    double d_format_float = now_in_seconds() - start;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        snprintf(strings[i], D_DTOA_BUFFER_SIZE, "%.9g", (float)values[i]);
+    double libc_format_float = now_in_seconds() - start;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        snprintf(strings[i], D_DTOA_BUFFER_SIZE, "%.17g", values[i]);
+    double libc_format = now_in_seconds() - start;
+    for (usize i = 0; i < VALUES; ++i)
+        d_double_to_chars(values[i], strings[i]);
+    usize mismatches = 0;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+    {
+        double value;
+        d_strtod(strings[i], lens[i], &value);
+        mismatches += value != values[i];
+    }
+    double d_parse = now_in_seconds() - start;
+    start = now_in_seconds();
+    for (usize i = 0; i < VALUES; ++i)
+        mismatches += strtod(strings[i], NULL) != values[i];
+    double libc_parse = now_in_seconds() - start;
+    printf("%s (%.1f characters on average)\n", name, (double)total / VALUES);
+    printf("  d_double_to_chars %8.2f ns   snprintf %%.17g %8.2f ns\n", d_format * 1e9 / VALUES,
+        libc_format * 1e9 / VALUES);
+    printf("  d_float_to_chars  %8.2f ns   snprintf %%.9g  %8.2f ns\n", d_format_float * 1e9 / VALUES,
+        libc_format_float * 1e9 / VALUES);
+    printf("  d_strtod          %8.2f ns   strtod         %8.2f ns   (round trip %s)\n", d_parse * 1e9 / VALUES,
+        libc_parse * 1e9 / VALUES, mismatches == 0 ? "ok" : "MISMATCH");
+}
+
+int main(void)
+{
+    u64* values = malloc(VALUES * sizeof(u64));
+    char (*strings)[D_ITOA_BUFFER_SIZE] = malloc(VALUES * D_ITOA_BUFFER_SIZE);
+    usize* lens = malloc(VALUES * sizeof(usize));
+    u64 state = 1;
+    for (usize i = 0; i < VALUES; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        values[i] = state >> (state & 63);
+    }
+    bench_values("Any length", values, strings, lens);
+    for (usize i = 0; i < VALUES; ++i)
+        values[i] %= 10000;
+    bench_values("1 to 4 digits", values, strings, lens);
+    double* doubles = malloc(VALUES * sizeof(double));
+    char (*double_strings)[D_DTOA_BUFFER_SIZE] = malloc(VALUES * D_DTOA_BUFFER_SIZE);
+    for (usize i = 0; i < VALUES; ++i)
+    {
+        //random bits, without the NaNs and infinities of an all ones exponent
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 bits = (state ^ (state >> 29)) & ~(1ULL << 62);
+        memcpy(&doubles[i], &bits, sizeof(double));
+    }
+    bench_doubles("Random doubles", doubles, double_strings, lens);
+    for (usize i = 0; i < VALUES; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        doubles[i] = (double)((state >> 33) % 1000000) / 100;
+    }
+    bench_doubles("Prices, 2 decimals", doubles, double_strings, lens);
+    free(doubles);
+    free(double_strings);
+    free(values);
+    free(strings);
+    free(lens);
+    return 0;
+}
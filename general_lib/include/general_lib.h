@@ -44,6 +44,41 @@ char    *d_substr(const char* str, usize pos, usize len);
  */
 char    *d_strdup(const char* str);
 
+/**
+ * @brief Size of a buffer large enough for any integer formatted by the functions below, null terminator included:
+ *        the 20 digits of the largest u64, or the sign and 19 digits of the smallest int64.
+ */
+#define D_ITOA_BUFFER_SIZE 21
+
+/**
+ * @brief Counts the decimal digits of `nb`, 1 for 0.
+ *
+ * No division: the bit length of `nb`, from a count of its leading zeros, gives the number of digits up to one,
+ * and a table of powers of 10 settles it.
+ */
+usize   d_count_digits_u64(u64 nb);
+
+/**
+ * @brief Writes the decimal representation of `nb` and a null terminator into `buffer`.
+ *
+ * The digits are written two at a time from a table of the 100 pairs "00" to "99", right to left from the
+ * length `d_count_digits_u64` gives, so there is one division by 100 per pair and nothing to reverse.
+ * Every `d_itoa_*` function goes through it or through `d_i64_to_chars`.
+ *
+ * @param buffer Room for `D_ITOA_BUFFER_SIZE` bytes.
+ *
+ * @return usize The number of characters written, the null terminator excluded.
+ */
+usize   d_u64_to_chars(u64 nb, char* buffer);
+
+/**
+ * @brief Writes the decimal representation of `nb`, with a leading '-' if it is negative, and a null terminator
+ *        into `buffer`. See `d_u64_to_chars`.
+ *
+ * @return usize The number of characters written, the null terminator excluded.
+ */
+usize   d_i64_to_chars(int64 nb, char* buffer);
+
 /**
  * @brief Converts a 32-bit integer to a string.
  *
@@ -100,4 +135,154 @@ char    *d_itoa_usize(usize nb);
  *       For 32-bit platforms, a minimum of 12 bytes is sufficient.
  */
 char    *d_itoa_usize_no_alloc(usize nb, char* buffer);
+
+/**
+ * @brief Converts an unsigned 32-bit integer to an allocated string, NULL if the allocation fails.
+ */
+char    *d_itoa_u32(u32 nb);
+
+/**
+ * @brief Converts an unsigned 32-bit integer to a string in `buffer`, at least 11 bytes, and returns `buffer`.
+ */
+char    *d_itoa_u32_no_alloc(u32 nb, char* buffer);
+
+/**
+ * @brief Converts a 64-bit integer to an allocated string, NULL if the allocation fails.
+ */
+char    *d_itoa_i64(int64 nb);
+
+/**
+ * @brief Converts a 64-bit integer to a string in `buffer`, at least `D_ITOA_BUFFER_SIZE` bytes, and returns `buffer`.
+ */
+char    *d_itoa_i64_no_alloc(int64 nb, char* buffer);
+
+/**
+ * @brief Converts an unsigned 64-bit integer to an allocated string, NULL if the allocation fails.
+ */
+char    *d_itoa_u64(u64 nb);
+
+/**
+ * @brief Converts an unsigned 64-bit integer to a string in `buffer`, at least `D_ITOA_BUFFER_SIZE` bytes, and
+ *        returns `buffer`.
+ */
+char    *d_itoa_u64_no_alloc(u64 nb, char* buffer);
+
+/**
+ * @brief Parses the unsigned decimal integer at the start of `str`.
+ *
+ * Reads an optional '+' then as many digits as there are, stopping at the first other character or after `len`
+ * characters: neither whitespace nor a null terminator is needed, the parse is exact on a slice of a larger buffer
+ * (a `DStringView` for instance). Leading zeros are accepted.
+ * While 8 characters remain, they are checked and converted 8 at a time as a single 64-bit word (SWAR): no loop
+ * and 3 multiplications per 8 digits, twice at most since 16 digits can not overflow; the rest goes digit by digit
+ * with an overflow check.
+ *
+ * @param str The characters. If NULL, nothing is parsed.
+ * @param len The number of characters that may be read.
+ * @param value Receives the number, left untouched on failure. Must not be NULL.
+ *
+ * @return usize The number of characters parsed, sign included. 0 if there is no digit or if the number
+ *               overflows a u64, in which case nothing is written to `value`.
+ */
+usize   d_atoi_u64(const char* str, usize len, u64* value);
+
+/**
+ * @brief Parses the unsigned decimal integer at the start of `str`, see `d_atoi_u64`.
+ *
+ * @return usize The number of characters parsed, 0 if there is no digit or if the number overflows a u32.
+ */
+usize   d_atoi_u32(const char* str, usize len, u32* value);
+
+/**
+ * @brief Parses the unsigned decimal integer at the start of `str`, see `d_atoi_u64`.
+ *
+ * @return usize The number of characters parsed, 0 if there is no digit or if the number overflows a usize.
+ */
+usize   d_atoi_usize(const char* str, usize len, usize* value);
+
+/**
+ * @brief Parses the decimal integer at the start of `str`, with an optional '-' or '+' sign, see `d_atoi_u64`.
+ *
+ * @return usize The number of characters parsed, sign included. 0 if there is no digit or if the number does not
+ *               fit an int64.
+ */
+usize   d_atoi_i64(const char* str, usize len, int64* value);
+
+/**
+ * @brief Parses the decimal integer at the start of `str`, with an optional '-' or '+' sign, see `d_atoi_u64`.
+ *
+ * @return usize The number of characters parsed, sign included. 0 if there is no digit or if the number does not
+ *               fit an int32.
+ */
+usize   d_atoi_i32(const char* str, usize len, int32* value);
+
+/**
+ * @brief Size of a buffer large enough for any double or float formatted by the functions below, null terminator
+ *        included: the longest output is the 25 characters of a negative number such as "-0.000012345678901234567".
+ */
+#define D_DTOA_BUFFER_SIZE 26
+
+/**
+ * @brief Writes the shortest decimal representation of `nb` that reads back as `nb`, and a null terminator,
+ *        into `buffer`.
+ *
+ * The digits are the fewest that round-trip through `d_strtod` or `strtod`, the closest to `nb` when several are
+ * as short (the Ryu algorithm: 128-bit multiplications by tabulated powers of 5, no big integers, no loop over
+ * candidate precisions as with `printf("%.17g")`). They are written without an exponent when the decimal point
+ * falls at most 21 digits after the first one or at most 5 zeros before it, as "1234.5", "100" or "0.00012", and
+ * in scientific notation otherwise, as "1.5e-7" or "1e+21". The special values are "nan", "inf", "-inf" and "-0".
+ * The output does not depend on the locale.
+ *
+ * @param buffer Room for `D_DTOA_BUFFER_SIZE` bytes.
+ *
+ * @return usize The number of characters written, the null terminator excluded.
+ */
+usize   d_double_to_chars(double nb, char* buffer);
+
+/**
+ * @brief Writes the shortest decimal representation of `nb` that reads back as the same float, see
+ *        `d_double_to_chars`. At most 9 significant digits are written.
+ *
+ * @return usize The number of characters written, the null terminator excluded.
+ */
+usize   d_float_to_chars(float nb, char* buffer);
+
+/**
+ * @brief Converts a double to an allocated string, see `d_double_to_chars`. NULL if the allocation fails.
+ */
+char    *d_dtoa(double nb);
+
+/**
+ * @brief Converts a double to a string in `buffer`, at least `D_DTOA_BUFFER_SIZE` bytes, and returns `buffer`.
+ */
+char    *d_dtoa_no_alloc(double nb, char* buffer);
+
+/**
+ * @brief Converts a float to an allocated string, see `d_float_to_chars`. NULL if the allocation fails.
+ */
+char    *d_ftoa(float nb);
+
+/**
+ * @brief Converts a float to a string in `buffer`, at least `D_DTOA_BUFFER_SIZE` bytes, and returns `buffer`.
+ */
+char    *d_ftoa_no_alloc(float nb, char* buffer);
+
+/**
+ * @brief Parses the decimal floating point number at the start of `str`, correctly rounded to the nearest double.
+ *
+ * Reads an optional sign, digits with at most one '.', at least one digit on either side, and an optional
+ * exponent made of 'e' or 'E', an optional sign and digits ("1e" only consumes the "1"). "inf", "infinity" and
+ * "nan" are recognized whatever their case. Unlike `strtod` the decimal point is always '.', whatever the locale,
+ * no whitespace is skipped, hexadecimal is not accepted and `str` needs no null terminator.
+ * Numbers of up to 19 significant digits are converted with at most two 64x64-bit multiplications
+ * (Eisel-Lemire); the very rare ones the product can not round, and the longer ones whose extra digits change
+ * the result, go through libc's `strtod`. Out of range numbers give an infinity or a zero.
+ *
+ * @param str The characters. If NULL, nothing is parsed.
+ * @param len The number of characters that may be read.
+ * @param value Receives the number, left untouched on failure. Must not be NULL.
+ *
+ * @return usize The number of characters parsed, 0 if there is no number at `str`.
+ */
+usize   d_strtod(const char* str, usize len, double* value);
 #endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <general_lib.h>
+
+#define D_ATOI_ONES 0x0101010101010101ULL
+
+// Tells whether the 8 bytes of `chunk` are all ASCII digits: the high nibbles are 3, and adding 6 keeps them 3
+static inline bool  d_atoi_are_8_digits(u64 chunk)
+{
+    return ((chunk & (0xF0 * D_ATOI_ONES)) | (((chunk + 0x06 * D_ATOI_ONES) & (0xF0 * D_ATOI_ONES)) >> 4)) == 0x33 * D_ATOI_ONES;
+}
+
+// Value of the 8 digits of `chunk`, the first one in its lowest byte: pairs, then quads, then the whole in 3 multiplications
+static inline u64   d_atoi_parse_8_digits(u64 chunk)
+{
+    chunk -= 0x30 * D_ATOI_ONES;
+    chunk = (chunk * 10) + (chunk >> 8);
+    return (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+        + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+}
+
+// Parses the digits from `str` to at most `end` into `*value`, failing with 0 past `limit` or without any digit.
+// Up to two blocks of 8 digits go through the SWAR path first: 16 digits never overflow a u64
+static usize    d_atoi_digits(const char* str, const char* end, u64 limit, u64* value)
+{
+    const char* p = str;
+    u64 result = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (u32 blocks = 0; blocks < 2 && end - p >= 8; ++blocks)
+    {
+        u64 chunk;
+        memcpy(&chunk, p, sizeof(u64));
+        if (d_atoi_are_8_digits(chunk) == false)
+            break;
+        result = result * 100000000ULL + d_atoi_parse_8_digits(chunk);
+        p += 8;
+    }
+#endif
+    for (; p < end && (u8)(*p - '0') <= 9; ++p)
+    {
+        u64 digit = *p - '0';
+        if (result > (limit - digit) / 10)
+            return 0;
+        result = result * 10 + digit;
+    }
+    if (p == str || result > limit)
+        return 0;
+    *value = result;
+    return p - str;
+}
+
+// Parses an optional sign and the digits of a number whose magnitude is at most `positive_limit`, or
+// `negative_limit` when it is negative: 0 for unsigned numbers, which take no '-'
+static usize    d_atoi_signed(const char* str, usize len, u64 positive_limit, u64 negative_limit, bool* negative, u64* magnitude)
+{
+    if (str == NULL || len == 0)
+        return 0;
+    usize sign = (str[0] == '-' && negative_limit != 0) || str[0] == '+';
+    *negative = sign && str[0] == '-';
+    usize digits = d_atoi_digits(str + sign, str + len, *negative ? negative_limit : positive_limit, magnitude);
+    return digits == 0 ? 0 : sign + digits;
+}
+
+usize   d_atoi_u64(const char* str, usize len, u64* value)
+{
+    bool negative;
+    return d_atoi_signed(str, len, 0xFFFFFFFFFFFFFFFFULL, 0, &negative, value);
+}
+
+usize   d_atoi_u32(const char* str, usize len, u32* value)
+{
+    bool negative;
+    u64 magnitude;
+    usize consumed = d_atoi_signed(str, len, 0xFFFFFFFFULL, 0, &negative, &magnitude);
+    if (consumed != 0)
+        *value = (u32)magnitude;
+    return consumed;
+}
+
+usize   d_atoi_usize(const char* str, usize len, usize* value)
+{
+    bool negative;
+    u64 magnitude;
+    usize consumed = d_atoi_signed(str, len, MAX_SIZE_T_VALUE, 0, &negative, &magnitude);
+    if (consumed != 0)
+        *value = (usize)magnitude;
+    return consumed;
+}
+
+usize   d_atoi_i64(const char* str, usize len, int64* value)
+{
+    bool negative;
+    u64 magnitude;
+    usize consumed = d_atoi_signed(str, len, 0x7FFFFFFFFFFFFFFFULL, 0x8000000000000000ULL, &negative, &magnitude);
+    if (consumed != 0)
+        *value = negative ? (int64)(0 - magnitude) : (int64)magnitude;
+    return consumed;
+}
+
+usize   d_atoi_i32(const char* str, usize len, int32* value)
+{
+    bool negative;
+    u64 magnitude;
+    usize consumed = d_atoi_signed(str, len, 0x7FFFFFFFULL, 0x80000000ULL, &negative, &magnitude);
+    if (consumed != 0)
+        *value = negative ? (int32)(0 - magnitude) : (int32)magnitude;
+    return consumed;
+}
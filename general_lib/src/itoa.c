@@ -1,92 +1,131 @@
 #include <general_lib.h>
 
-int32   get_number_len_int32(int32 nb)
-{
-    int32   len = 0;
-    int32   to_add = (nb <= 0);
+// "00" to "99": two digits are written per division by 100, which halves the divisions of a digit by digit loop
+static const char g_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
 
-    while (nb != 0)
-    {
-        nb /= 10;
-        ++len;
-    }
+static const u64 g_powers_of_10[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
 
-    return len + to_add;
+usize   d_count_digits_u64(u64 nb)
+{
+    // 1233 / 4096 is a bit more than log10(2): the bit length gives the number of digits, or one too few
+    u32 guess = ((64 - __builtin_clzll(nb | 1)) * 1233) >> 12;
+    return guess + (nb >= g_powers_of_10[guess]) + (nb == 0);
 }
 
-int32   get_number_len_usize(usize nb)
+// Writes the digits of `nb` backwards, the last one right before `end`
+static inline void  d_write_digits(u64 nb, char* end)
 {
-    int32 len = (nb == 0);
-
-    while (nb != 0)
+    while (nb >= 100)
+    {
+        const char* pair = g_digit_pairs + (nb % 100) * 2;
+        nb /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (nb >= 10)
     {
-        nb /= 10;
-        ++len;
+        *--end = g_digit_pairs[nb * 2 + 1];
+        *--end = g_digit_pairs[nb * 2];
     }
+    else
+        *--end = '0' + nb;
+}
 
+usize   d_u64_to_chars(u64 nb, char* buffer)
+{
+    usize len = d_count_digits_u64(nb);
+    d_write_digits(nb, buffer + len);
+    buffer[len] = 0;
     return len;
 }
 
-char* d_itoa_i32(int32 nb)
+usize   d_i64_to_chars(int64 nb, char* buffer)
+{
+    // the magnitude is computed unsigned, so that INT64_MIN does not overflow
+    u64 magnitude = nb < 0 ? -(u64)nb : (u64)nb;
+    buffer[0] = '-';
+    return (nb < 0) + d_u64_to_chars(magnitude, buffer + (nb < 0));
+}
+
+// Copies the digits formatted in a stack buffer to an allocated string of the right size
+static char*    d_itoa_dup(const char* digits, usize len)
 {
-    int64 nbr = nb; // storing int32 into int64 so further operation won't overflow
-    int32 len = get_number_len_int32(nbr);
-    int32 stop = (nbr < 0); // if nb < 0 stop = 1 else stop = 0
-    nbr = (nbr > 0) * nbr + -(nbr < 0) * nbr; // that line just transform nbr into a positive number if it was negative
     char* str = malloc(sizeof(char) * (len + 1));
     if (str == NULL)
         return NULL;
-
-    str[len--] = 0; //adding null bytes at end of str
-    str[0] = '-'; // adding '-' char at index 0 by default it will be overwritten if stop = 0
-    for (int32 i = len; i >= stop; --i)
-    {
-        str[i] = (nbr % 10) + 48; // nbr % 10 will get the last unit of the numer and adding 48 will get us the ascii value of that number
-        nbr /= 10;
-    }
+    memcpy(str, digits, len + 1);
     return str;
 }
 
+char* d_itoa_i32(int32 nb)
+{
+    char buffer[D_ITOA_BUFFER_SIZE];
+    return d_itoa_dup(buffer, d_i64_to_chars(nb, buffer));
+}
+
 char* d_itoa_i32_no_alloc(int32 nb, char* buffer)
 {
-    int64 nbr = nb; // storing int32 into int64 so further operation won't overflow
-    int32 len = get_number_len_int32(nbr);
-    int32 stop = (nbr < 0); // if nb < 0 stop = 1 else stop = 0
-    nbr = (nbr > 0) * nbr + -(nbr < 0) * nbr; // that line just transform nbr into a positive number if it was negative
-    
-    buffer[len--] = 0; //adding null bytes at end of buffer
-    buffer[0] = '-'; // adding '-' char at index 0 by default it will be overwritten if stop = 0
-    for (int32 i = len; i >= stop; --i)
-    {
-        buffer[i] = (nbr % 10) + 48; // nbr % 10 will get the last unit of the numer and adding 48 will get us the ascii value of that number
-        nbr /= 10;
-    }
+    d_i64_to_chars(nb, buffer);
+    return buffer;
+}
+
+char* d_itoa_u32(u32 nb)
+{
+    char buffer[D_ITOA_BUFFER_SIZE];
+    return d_itoa_dup(buffer, d_u64_to_chars(nb, buffer));
+}
+
+char* d_itoa_u32_no_alloc(u32 nb, char* buffer)
+{
+    d_u64_to_chars(nb, buffer);
+    return buffer;
+}
+
+char* d_itoa_i64(int64 nb)
+{
+    char buffer[D_ITOA_BUFFER_SIZE];
+    return d_itoa_dup(buffer, d_i64_to_chars(nb, buffer));
+}
+
+char* d_itoa_i64_no_alloc(int64 nb, char* buffer)
+{
+    d_i64_to_chars(nb, buffer);
+    return buffer;
+}
+
+char* d_itoa_u64(u64 nb)
+{
+    char buffer[D_ITOA_BUFFER_SIZE];
+    return d_itoa_dup(buffer, d_u64_to_chars(nb, buffer));
+}
+
+char* d_itoa_u64_no_alloc(u64 nb, char* buffer)
+{
+    d_u64_to_chars(nb, buffer);
     return buffer;
 }
 
 char *d_itoa_usize(usize nb)
 {
-    int32 len = get_number_len_usize(nb);
-    char* str = malloc(sizeof(char) * (len + 1));
-    if (str == NULL)
-        return NULL;
-    str[len--] = 0;
-    for (int32 i = len; i >= 0; --i)
-    {
-        str[i] = (nb % 10) + 48; // nb % 10 will get the last unit of the numer and adding 48 will get us the ascii value of that number
-        nb /= 10;
-    }
-    return str;
+    return d_itoa_u64(nb);
 }
 
 char* d_itoa_usize_no_alloc(usize nb, char* buffer)
 {
-    int32 len = get_number_len_usize(nb);
-    buffer[len--] = 0;
-    for (int32 i = len; i >= 0; --i)
-    {
-        buffer[i] = (nb % 10) + 48; // nb % 10 will get the last unit of the numer and adding 48 will get us the ascii value of that number
-        nb /= 10;
-    }
-    return buffer;
-}
\ No newline at end of file
+    return d_itoa_u64_no_alloc(nb, buffer);
+}
@@ -2,12 +2,20 @@
 #include <dtypes.h>
 #include <general_lib.h>
 #include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <math.h>
 
 char*   itoa_usize(void* data)
 {
     return d_itoa_usize(*((usize*)data));
 }
 
+char*   itoa_bool(void* data)
+{
+    return d_itoa_usize(*((bool*)data));
+}
+
 char*   itoa_i32(void* data)
 {
     return d_itoa_i32(*((int32*)data));
@@ -116,6 +124,234 @@ void test_d_substr(void)
     free(sub_str);
 }
 
+//Tells whether the 64-bit formatters agree with printf on `nb`, as unsigned and as signed
+bool    itoa_matches_printf(u64 nb)
+{
+    char expected[32];
+    char buffer[D_ITOA_BUFFER_SIZE];
+    char* allocated;
+    snprintf(expected, sizeof(expected), "%" PRIu64, nb);
+    bool valid = d_u64_to_chars(nb, buffer) == strlen(expected) && strcmp(buffer, expected) == 0
+        && d_count_digits_u64(nb) == strlen(expected)
+        && strcmp(d_itoa_u64_no_alloc(nb, buffer), expected) == 0;
+    allocated = d_itoa_u64(nb);
+    valid = valid && strcmp(allocated, expected) == 0;
+    free(allocated);
+    snprintf(expected, sizeof(expected), "%" PRId64, (int64)nb);
+    valid = valid && d_i64_to_chars((int64)nb, buffer) == strlen(expected) && strcmp(buffer, expected) == 0;
+    allocated = d_itoa_i64((int64)nb);
+    valid = valid && strcmp(allocated, expected) == 0 && strcmp(d_itoa_i64_no_alloc((int64)nb, buffer), expected) == 0;
+    free(allocated);
+    snprintf(expected, sizeof(expected), "%" PRIu32, (u32)nb);
+    allocated = d_itoa_u32((u32)nb);
+    valid = valid && strcmp(allocated, expected) == 0 && strcmp(d_itoa_u32_no_alloc((u32)nb, buffer), expected) == 0;
+    free(allocated);
+    return valid;
+}
+
+void test_d_itoa_64(void)
+{
+    bool expected = true;
+    bool valid = true;
+    //every digit count boundary, on both sides
+    u64 power = 1;
+    for (usize digits = 1; digits <= 20; ++digits)
+    {
+        valid = valid && itoa_matches_printf(power) && itoa_matches_printf(power - 1) && itoa_matches_printf(power + 1);
+        if (digits < 20)
+            power *= 10;
+    }
+    valid = valid && itoa_matches_printf(0) && itoa_matches_printf(0xFFFFFFFFFFFFFFFFULL)
+        && itoa_matches_printf(0x8000000000000000ULL) && itoa_matches_printf(0x7FFFFFFFFFFFFFFFULL)
+        && itoa_matches_printf(0xFFFFFFFFULL) && itoa_matches_printf(0x80000000ULL);
+    u64 state = 42;
+    for (usize i = 0; i < 100000 && valid; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        valid = itoa_matches_printf(state >> (state & 63));
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
+void test_d_atoi(void)
+{
+    bool expected = true;
+    u64 u;
+    u32 u_32;
+    int64 i;
+    int32 i_32;
+    usize us;
+    bool valid = d_atoi_u64("18446744073709551615", 20, &u) == 20 && u == 0xFFFFFFFFFFFFFFFFULL
+        && d_atoi_u64("18446744073709551616", 20, &u) == 0 && u == 0xFFFFFFFFFFFFFFFFULL
+        && d_atoi_u64("99999999999999999999", 20, &u) == 0
+        && d_atoi_u64("+0000000000000000000000000000042", 32, &u) == 32 && u == 42
+        && d_atoi_u64("1234567890123456", 16, &u) == 16 && u == 1234567890123456ULL
+        && d_atoi_u64("12345678901234567", 17, &u) == 17 && u == 12345678901234567ULL
+        && d_atoi_u64("12345678x", 9, &u) == 8 && u == 12345678
+        && d_atoi_u64("1234567x9", 9, &u) == 7 && u == 1234567
+        && d_atoi_u64("123456789", 4, &u) == 4 && u == 1234
+        && d_atoi_u64("-1", 2, &u) == 0 && d_atoi_u64("", 0, &u) == 0 && d_atoi_u64("+", 1, &u) == 0
+        && d_atoi_u64(NULL, 3, &u) == 0 && d_atoi_u64("/:", 2, &u) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    valid = d_atoi_i64("-9223372036854775808", 20, &i) == 20 && i == (int64)0x8000000000000000ULL
+        && d_atoi_i64("-9223372036854775809", 20, &i) == 0
+        && d_atoi_i64("9223372036854775807", 19, &i) == 19 && i == 0x7FFFFFFFFFFFFFFFLL
+        && d_atoi_i64("9223372036854775808", 19, &i) == 0 && d_atoi_i64("-", 1, &i) == 0
+        && d_atoi_i64("+17 apples", 10, &i) == 3 && i == 17 && d_atoi_i64("-0", 2, &i) == 2 && i == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    valid = d_atoi_i32("-2147483648", 11, &i_32) == 11 && i_32 == -2147483647 - 1
+        && d_atoi_i32("-2147483649", 11, &i_32) == 0 && d_atoi_i32("2147483647", 10, &i_32) == 10
+        && i_32 == 2147483647 && d_atoi_i32("2147483648", 10, &i_32) == 0
+        && d_atoi_i32("1234567890123456", 16, &i_32) == 0
+        && d_atoi_u32("4294967295", 10, &u_32) == 10 && u_32 == 4294967295U
+        && d_atoi_u32("4294967296", 10, &u_32) == 0 && d_atoi_u32("-5", 2, &u_32) == 0
+        && d_atoi_usize("1000000", 7, &us) == 7 && us == 1000000;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //round trips of random numbers of every length, followed by a delimiter
+    u64 state = 7;
+    char buffer[D_ITOA_BUFFER_SIZE + 1];
+    for (usize n = 0; n < 100000 && valid; ++n)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 nb = state >> (state & 63);
+        usize len = d_u64_to_chars(nb, buffer);
+        buffer[len] = ',';
+        valid = d_atoi_u64(buffer, len + 1, &u) == len && u == nb;
+        len = d_i64_to_chars((int64)nb, buffer);
+        valid = valid && d_atoi_i64(buffer, len, &i) == len && i == (int64)nb;
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
+//Tells whether `nb` is written as `text` and whether both d_strtod and strtod read `text` back as `nb`
+bool    dtoa_matches(double nb, const char* text)
+{
+    char buffer[D_DTOA_BUFFER_SIZE];
+    double parsed;
+    usize len = d_double_to_chars(nb, buffer);
+    char* allocated = d_dtoa(nb);
+    bool valid = len == strlen(text) && strcmp(buffer, text) == 0 && strcmp(allocated, text) == 0
+        && strcmp(d_dtoa_no_alloc(nb, buffer), text) == 0
+        && d_strtod(text, len, &parsed) == len && memcmp(&parsed, &nb, sizeof(double)) == 0
+        && strtod(text, NULL) == nb;
+    free(allocated);
+    return valid;
+}
+
+void test_d_dtoa(void)
+{
+    bool expected = true;
+    bool valid = dtoa_matches(0.0, "0") && dtoa_matches(-0.0, "-0") && dtoa_matches(1.0, "1")
+        && dtoa_matches(0.1, "0.1") && dtoa_matches(0.3, "0.3") && dtoa_matches(2.0 / 3, "0.6666666666666666")
+        && dtoa_matches(-2.5, "-2.5") && dtoa_matches(100, "100") && dtoa_matches(12345.678, "12345.678")
+        && dtoa_matches(1e21, "1e+21") && dtoa_matches(123456789012345680000.0, "123456789012345680000")
+        && dtoa_matches(0.000001, "0.000001") && dtoa_matches(1e-7, "1e-7") && dtoa_matches(1.5e-7, "1.5e-7")
+        && dtoa_matches(1e100, "1e+100") && dtoa_matches(5e-324, "5e-324")
+        && dtoa_matches(1.7976931348623157e308, "1.7976931348623157e+308")
+        && dtoa_matches(2.2250738585072014e-308, "2.2250738585072014e-308")
+        && dtoa_matches(9007199254740993.0, "9007199254740992")
+        && dtoa_matches(-0.000012345678901234568, "-0.000012345678901234568");
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    char buffer[D_DTOA_BUFFER_SIZE];
+    d_double_to_chars(NAN, buffer);
+    valid = strcmp(buffer, "nan") == 0;
+    d_double_to_chars(-INFINITY, buffer);
+    valid = valid && strcmp(buffer, "-inf") == 0;
+    //floats get the digits of the float, not of the double it converts to
+    char* allocated = d_ftoa(0.1f);
+    valid = valid && strcmp(allocated, "0.1") == 0 && strcmp(d_ftoa_no_alloc(3.4028235e38f, buffer), "3.4028235e+38") == 0
+        && d_float_to_chars(1e-45f, buffer) == 5 && strcmp(buffer, "1e-45") == 0
+        && d_float_to_chars(16777216.0f, buffer) == 8 && strcmp(buffer, "16777216") == 0
+        && d_float_to_chars(-INFINITY, buffer) == 4;
+    free(allocated);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //random bit patterns: the shortest digits round-trip, and there is no shorter string that does
+    u64 state = 3;
+    for (usize i = 0; i < 20000 && valid; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 bits = state ^ (state >> 29);
+        double nb;
+        memcpy(&nb, &bits, sizeof(double));
+        if (isnan(nb) || isinf(nb))
+            continue;
+        usize len = d_double_to_chars(nb, buffer);
+        double parsed;
+        valid = strtod(buffer, NULL) == nb && d_strtod(buffer, len, &parsed) == len && parsed == nb;
+        char shorter[32];
+        //significant digits, without the leading zeros of "0.000x" nor the trailing ones of an integer
+        usize digits = 0;
+        usize zeros = 0;
+        for (usize c = 0; buffer[c] != 0 && buffer[c] != 'e'; ++c)
+        {
+            if (buffer[c] < '0' || buffer[c] > '9' || (digits == 0 && buffer[c] == '0'))
+                continue;
+            zeros = buffer[c] == '0' ? zeros + 1 : 0;
+            ++digits;
+        }
+        digits -= zeros;
+        snprintf(shorter, sizeof(shorter), "%.*e", (int)(digits > 2 ? digits - 2 : 0), nb);
+        valid = valid && (digits <= 1 || strtod(shorter, NULL) != nb || nb == 0);
+        float f = (float)nb;
+        if (isinf(f) == false)
+        {
+            d_float_to_chars(f, buffer);
+            valid = valid && strtof(buffer, NULL) == f;
+        }
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
+//Tells whether d_strtod reads the `consumed` first characters of `text` as strtod does
+bool    strtod_matches(const char* text, usize consumed)
+{
+    double parsed = -1;
+    double expected = strtod(text, NULL);
+    usize len = d_strtod(text, strlen(text), &parsed);
+    return len == consumed && (consumed == 0 ? parsed == -1 : memcmp(&parsed, &expected, sizeof(double)) == 0);
+}
+
+void test_d_strtod(void)
+{
+    bool expected = true;
+    bool valid = strtod_matches("1e", 1) && strtod_matches(".5", 2) && strtod_matches("5.", 2)
+        && strtod_matches("-.e1", 0) && strtod_matches("e5", 0) && strtod_matches("-", 0) && strtod_matches("", 0)
+        && strtod_matches("3.14abc", 4) && strtod_matches("+0.0e+0", 7) && strtod_matches("1E5", 3)
+        && strtod_matches("1e-400", 6) && strtod_matches("1e400", 5) && strtod_matches("1.5e+9999999999999", 18)
+        && strtod_matches("4.9e-324", 8) && strtod_matches("2.4703282292062327e-324", 23)
+        && strtod_matches("2.4703282292062328e-324", 23) && strtod_matches("2.2250738585072011e-308", 23)
+        && strtod_matches("1.7976931348623158e308", 22) && strtod_matches("1.7976931348623159e308", 22)
+        && strtod_matches("9007199254740993", 16) && strtod_matches("9007199254740993.0000000000001", 30)
+        && strtod_matches("0000000000000000000000000000000000000001", 40) && strtod_matches("1e23", 4)
+        && strtod_matches("123456789012345678901234567890e-10", 34)
+        && strtod_matches("1.00000000000000011102230246251565404236316680908203125", 55)
+        && strtod_matches("1.00000000000000011102230246251565404236316680908203126", 55)
+        && strtod_matches("-inf", 4) && strtod_matches("InFinity", 8);
+    double parsed;
+    valid = valid && d_strtod("nan", 3, &parsed) == 3 && isnan(parsed) && d_strtod("12.5", 2, &parsed) == 2
+        && parsed == 12 && d_strtod(NULL, 4, &parsed) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //random digit strings, up to 40 digits so that the slow path is taken too
+    u64 state = 11;
+    char text[64];
+    for (usize i = 0; i < 50000 && valid; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        usize digits = 1 + (state >> 33) % 40;
+        usize point = (state >> 13) % (digits + 1);
+        char* p = text;
+        for (usize d = 0; d < digits; ++d)
+        {
+            if (d == point)
+                *p++ = '.';
+            *p++ = '0' + (state >> (d % 50)) % 10;
+        }
+        sprintf(p, "e%d", (int)((state >> 40) % 700) - 350);
+        valid = strtod_matches(text, strlen(text));
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
 int main()
 {
     TEST("test_d_itoa_i32", test_d_itoa_i32(););
@@ -123,4 +359,8 @@ int main()
     TEST("test_d_itoa_i32_no_alloc", test_d_itoa_i32_no_alloc(););
     TEST("test_d_itoa_usize_no_alloc", test_d_itoa_usize_no_alloc(););
     TEST("test_d_substr", test_d_substr(););
+    TEST("test_d_itoa_64", test_d_itoa_64(););
+    TEST("test_d_atoi", test_d_atoi(););
+    TEST("test_d_dtoa", test_d_dtoa(););
+    TEST("test_d_strtod", test_d_strtod(););
 }
\ No newline at end of file
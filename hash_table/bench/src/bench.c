@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dhash_func.h"
+#include "dstring.h"
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+#endif
+
+/*
+ * Throughput benchmark of the hash functions.
+ *
+ * Every input size is hashed from a 1 MiB buffer, each hash starting where the previous one stopped so the inputs
+ * are independent and come from the cache like hash table keys usually do. The results are in GB/s and in cycles
+ * per hash, the cycles being the ones of the time stamp counter (the nominal frequency of the core).
+ * FNV-1a, the byte at a time hash most hand written tables use, is measured as the baseline.
+ * The batch benchmarks hash a DPointerArray of DString keys of a given length, once with a loop of d_hash_bytes
+ * and once with d_hash_dstrings.
+ */
+
+#define BUFFER_SIZE (1 << 20)
+#define TOTAL_BYTES (1ULL << 30)
+#define BATCH_KEYS 4096
+#define BATCH_ROUNDS 512
+
+static u8*	g_buffer = NULL;
+
+static double	now_in_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static u64	now_in_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static u64	fnv1a(const void* data, usize len, u64 seed)
+{
+    const u8* p = data;
+    u64 h = 14695981039346656037ULL ^ seed;
+    for (usize i = 0; i < len; ++i)
+        h = (h ^ p[i]) * 1099511628211ULL;
+    return h;
+}
+
+static void	report(const char* name, usize size, double elapsed, u64 cycles, usize hashes)
+{
+    printf("  %-18s %6zu bytes %8.2f GB/s %10.2f cycles/hash %8.2f ns/hash\n",
+        name, size, (double)size * hashes / elapsed / 1e9, (double)cycles / hashes, elapsed * 1e9 / hashes);
+}
+
+static u64	bench_bytes(const char* name, u64(*hash)(const void*, usize, u64), usize size)
+{
+    usize hashes = TOTAL_BYTES / size / (hash == fnv1a ? 8 : 1);
+    usize positions = BUFFER_SIZE - size;
+    u64 checksum = 0;
+    usize offset = 0;
+    double start = now_in_seconds();
+    u64 start_cycles = now_in_cycles();
+    for (usize i = 0; i < hashes; ++i)
+    {
+        checksum += hash(g_buffer + offset, size, 0);
+        offset += size;
+        if (offset > positions)
+            offset = 0;
+    }
+    u64 cycles = now_in_cycles() - start_cycles;
+    report(name, size, now_in_seconds() - start, cycles, hashes);
+    return checksum;
+}
+
+static u64	bench_batch(usize size)
+{
+    DPointerArray* keys = d_pointer_array_new(BATCH_KEYS, false, NULL);
+    for (usize i = 0; i < BATCH_KEYS; ++i)
+    {
+        DString* key = d_string_new_with_reserve(size);
+        for (usize k = 0; k < size; ++k)
+            d_string_push_char(key, 'a' + (i * 7 + k * 13) % 26);
+        d_pointer_array_push_back(keys, key);
+    }
+    u64* hashes = malloc(BATCH_KEYS * sizeof(u64));
+    u64 checksum = 0;
+    double start = now_in_seconds();
+    u64 start_cycles = now_in_cycles();
+    for (usize round = 0; round < BATCH_ROUNDS; ++round)
+    {
+        for (usize i = 0; i < BATCH_KEYS; ++i)
+        {
+            DString* key = keys -> pdata[i];
+            hashes[i] = d_hash_bytes(key -> string, key -> len, round);
+        }
+        checksum += hashes[round % BATCH_KEYS];
+    }
+    u64 cycles = now_in_cycles() - start_cycles;
+    report("loop of bytes", size, now_in_seconds() - start, cycles, BATCH_KEYS * BATCH_ROUNDS);
+    start = now_in_seconds();
+    start_cycles = now_in_cycles();
+    for (usize round = 0; round < BATCH_ROUNDS; ++round)
+    {
+        d_hash_dstrings(keys, hashes, round);
+        checksum += hashes[round % BATCH_KEYS];
+    }
+    cycles = now_in_cycles() - start_cycles;
+    report("d_hash_dstrings", size, now_in_seconds() - start, cycles, BATCH_KEYS * BATCH_ROUNDS);
+    for (usize i = 0; i < BATCH_KEYS; ++i)
+    {
+        DString* key = keys -> pdata[i];
+        d_string_destroy(&key);
+    }
+    d_pointer_array_destroy(&keys);
+    free(hashes);
+    return checksum;
+}
+
+int main(void)
+{
+    static const usize sizes[] = {8, 16, 64, 4096};
+    u64 checksum = 0;
+    g_buffer = malloc(BUFFER_SIZE);
+    srand(1);
+    for (usize i = 0; i < BUFFER_SIZE; ++i)
+        g_buffer[i] = rand();
+    printf("Hash benchmark, %llu MiB hashed per size (%llu MiB for fnv1a)\n", TOTAL_BYTES >> 20, TOTAL_BYTES >> 23);
+    for (usize s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        checksum += bench_bytes("fnv1a", fnv1a, sizes[s]);
+        checksum += bench_bytes("d_hash_bytes", d_hash_bytes, sizes[s]);
+    }
+    printf("Batch of %d DString keys, %d rounds\n", BATCH_KEYS, BATCH_ROUNDS);
+    for (usize s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+        checksum += bench_batch(sizes[s]);
+    printf("  checksum %llu\n", (unsigned long long)checksum);
+    free(g_buffer);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "dconcurrent_map.h"
+#include "dhash.h"
+#include "dhash_func.h"
+
+/*
+ * Scaling benchmark of DConcurrentMap.
+ *
+ * From 1 to N threads (the number of online cores, or the first argument), every thread runs the same number of
+ * operations on random u64 keys of a map prefilled with half of the key space. A read is a get, a write is an insert
+ * or a remove with the same probability, so the size of the map stays stable. Two mixes are run: 90% reads and 10%
+ * writes, then 50% of each. The same workload on a DHashMap behind a single mutex is the baseline.
+ * The throughput is the total number of operations per second, the scaling is relative to one thread.
+ */
+
+#define KEY_SPACE (1 << 20)
+#define OPS_PER_THREAD 2000000
+
+typedef struct {
+    DConcurrentMap*     concurrent;
+    DHashMap*           locked;
+    pthread_mutex_t*    lock;
+    u32                 read_percent;
+    u64                 seed;
+    u64                 found;
+} Worker;
+
+static double	now_in_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline u64	next_random(u64* state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return d_hash_u64(*state);
+}
+
+static void*	run_concurrent(void* arg)
+{
+    Worker* worker = arg;
+    u64 value = 0;
+    for (usize i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        u64 r = next_random(&worker -> seed);
+        u64 key = r % KEY_SPACE;
+        if ((r >> 32) % 100 < worker -> read_percent)
+            worker -> found += d_concurrent_map_get(worker -> concurrent, &key, &value);
+        else if ((r >> 40) & 1)
+            d_concurrent_map_insert(worker -> concurrent, &key, &key);
+        else
+            d_concurrent_map_remove(worker -> concurrent, &key);
+    }
+    return NULL;
+}
+
+static void*	run_locked(void* arg)
+{
+    Worker* worker = arg;
+    for (usize i = 0; i < OPS_PER_THREAD; ++i)
+    {
+        u64 r = next_random(&worker -> seed);
+        u64 key = r % KEY_SPACE;
+        pthread_mutex_lock(worker -> lock);
+        if ((r >> 32) % 100 < worker -> read_percent)
+            worker -> found += d_hash_map_get(worker -> locked, &key) != NULL;
+        else if ((r >> 40) & 1)
+            d_hash_map_insert(worker -> locked, &key, &key);
+        else
+            d_hash_map_remove(worker -> locked, &key);
+        pthread_mutex_unlock(worker -> lock);
+    }
+    return NULL;
+}
+
+static double	run(void*(*fn)(void*), usize thread_count, u32 read_percent)
+{
+    DConcurrentMap* concurrent = d_concurrent_map_new(sizeof(u64), sizeof(u64), 0);
+    DHashMap* locked = d_hash_map_new(sizeof(u64), sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL, NULL);
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    for (u64 key = 0; key < KEY_SPACE; key += 2)
+    {
+        d_concurrent_map_insert(concurrent, &key, &key);
+        d_hash_map_insert(locked, &key, &key);
+    }
+    pthread_t* threads = malloc(thread_count * sizeof(pthread_t));
+    Worker* workers = malloc(thread_count * sizeof(Worker));
+    double start = now_in_seconds();
+    for (usize i = 0; i < thread_count; ++i)
+    {
+        workers[i] = (Worker){ concurrent, locked, &lock, read_percent, i + 1, 0 };
+        pthread_create(threads + i, NULL, fn, workers + i);
+    }
+    for (usize i = 0; i < thread_count; ++i)
+        pthread_join(threads[i], NULL);
+    double elapsed = now_in_seconds() - start;
+    free(threads);
+    free(workers);
+    d_concurrent_map_destroy(&concurrent);
+    d_hash_map_destroy(&locked);
+    return (double)OPS_PER_THREAD * thread_count / elapsed / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+    usize max_threads = argc > 1 ? (usize)atoi(argv[1]) : (usize)sysconf(_SC_NPROCESSORS_ONLN);
+    static const u32 mixes[] = {90, 50};
+    if (max_threads == 0)
+        max_threads = 1;
+    printf("Concurrent map benchmark, %d keys, %d operations per thread, up to %zu threads\n",
+        KEY_SPACE, OPS_PER_THREAD, max_threads);
+    for (usize m = 0; m < 2; ++m)
+    {
+        printf("%u%% reads, %u%% writes\n", mixes[m], 100 - mixes[m]);
+        double base = 0;
+        for (usize threads = 1; threads <= max_threads; threads = threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2)
+        {
+            double concurrent = run(run_concurrent, threads, mixes[m]);
+            double locked = run(run_locked, threads, mixes[m]);
+            if (threads == 1)
+                base = concurrent;
+            printf("  %3zu threads  DConcurrentMap %8.2f Mops/s (x%5.2f)  mutex + DHashMap %8.2f Mops/s\n",
+                threads, concurrent, concurrent / base, locked);
+            if (threads == max_threads)
+                break;
+        }
+    }
+    return 0;
+}
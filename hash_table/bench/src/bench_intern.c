@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dintern.h"
+#include "dhash_func.h"
+
+/*
+ * Identifier comparison benchmark of DInternPool.
+ *
+ * A few thousand identifiers sharing long prefixes, as the names of a program usually do, are compared by random
+ * pairs: once as DStrings with d_string_compare, once as interned strings with a pointer compare. Interning the
+ * identifiers again, a hit on every call, shows the cost of turning a string into its canonical pointer, and the
+ * footprint of the pool is reported at the end.
+ */
+
+#define IDENTIFIERS 4096
+#define COMPARISONS 20000000
+
+static double	now_in_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+    DString** dstrings = malloc(IDENTIFIERS * sizeof(DString*));
+    const char** interned = malloc(IDENTIFIERS * sizeof(const char*));
+    u32* pairs = malloc(2 * COMPARISONS * sizeof(u32));
+    DInternPool* pool = d_intern_pool_new(false);
+    char buffer[64];
+    for (usize i = 0; i < IDENTIFIERS; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), "module_component_identifier_%zu", i % (IDENTIFIERS / 2));
+        dstrings[i] = d_string_new_from_c_string(buffer);
+        interned[i] = d_intern_pool_intern(pool, buffer);
+    }
+    u64 state = 1;
+    for (usize i = 0; i < 2 * COMPARISONS; ++i)
+        pairs[i] = d_hash_u64(state++) % IDENTIFIERS;
+    printf("Intern benchmark, %d identifiers (half of them distinct), %d comparisons\n", IDENTIFIERS, COMPARISONS);
+    usize equal = 0;
+    double start = now_in_seconds();
+    for (usize i = 0; i < COMPARISONS; ++i)
+        equal += d_string_compare(dstrings[pairs[2 * i]], dstrings[pairs[2 * i + 1]]) == 0;
+    double elapsed = now_in_seconds() - start;
+    printf("  d_string_compare   %8.2f ns/comparison (%zu equal)\n", elapsed * 1e9 / COMPARISONS, equal);
+    equal = 0;
+    start = now_in_seconds();
+    for (usize i = 0; i < COMPARISONS; ++i)
+        equal += interned[pairs[2 * i]] == interned[pairs[2 * i + 1]];
+    elapsed = now_in_seconds() - start;
+    printf("  interned pointers  %8.2f ns/comparison (%zu equal)\n", elapsed * 1e9 / COMPARISONS, equal);
+    const char* last = NULL;
+    start = now_in_seconds();
+    for (usize i = 0; i < COMPARISONS / 10; ++i)
+        last = d_intern_pool_intern_dstring(pool, dstrings[pairs[i]]);
+    elapsed = now_in_seconds() - start;
+    printf("  interning (hits)   %8.2f ns/string (last %s)\n", elapsed * 1e9 / (COMPARISONS / 10), last);
+    DInternStats stats;
+    d_intern_pool_get_stats(pool, &stats);
+    printf("  footprint          %zu strings, %zu string bytes, %zu arena, %zu table, %zu ids, %zu total bytes\n",
+        stats.strings, stats.string_bytes, stats.arena_bytes, stats.table_bytes, stats.id_bytes, stats.total_bytes);
+    for (usize i = 0; i < IDENTIFIERS; ++i)
+        d_string_destroy(&dstrings[i]);
+    d_intern_pool_destroy(&pool);
+    free(dstrings);
+    free(interned);
+    free(pairs);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#ifndef __D_CONCURRENT_MAP__H
+#define __D_CONCURRENT_MAP__H
+
+#include <dtypes.h>
+typedef struct _DConcurrentMap	DConcurrentMap;
+
+/**
+ * @brief Number of shards of a map created with a `shard_count` of 0.
+ */
+#define D_CONCURRENT_MAP_DEFAULT_SHARDS 64
+
+/**
+ * @brief Called by `d_concurrent_map_update` on the value of a key while its shard is locked.
+ *
+ * @param value The value inside the map, zeroed if the key was just inserted.
+ * @param inserted true if the key was not present before the call.
+ * @param ctx The context given to `d_concurrent_map_update`.
+ */
+typedef void(*DConcurrentUpdateFunc)(void* value, bool inserted, void* ctx);
+
+/**
+ * DConcurrentMap:
+ * @param key_size the size of a key in bytes.
+ * @param value_size the size of a value in bytes.
+ *
+ * A hash map that any number of threads can read and write at the same time.
+ * The keys are split into independent shards by bits of their hash, each shard being a table with the groups and
+ * the SIMD probing of #DHashMap, its own lock and its own growth: growing a shard only makes the threads using
+ * that shard wait, never the whole map.
+ * Reads take no lock and write nothing shared: each shard is guarded by a sequence lock, a reader notes the sequence
+ * number of the shard, probes the table, copies the value out and starts again if a writer went through the shard
+ * in the meantime. Writers of a shard are serialized by making its sequence number odd, so readers of other shards,
+ * and of that shard outside of writes, never contend.
+ * Because a reader may look at a table while it is being replaced, the tables a shard outgrows are kept and reused
+ * by the shard instead of being freed: each size is kept at most twice, which bounds them by three times the live
+ * table, and they are released by `d_concurrent_map_destroy`.
+ * The keys are plain bytes, hashed with `d_hash_u64` when they are 8 bytes long and `d_hash_bytes` otherwise,
+ * and compared with `memcmp`: a reader may see a key that is being written, which is harmless for bytes but not
+ * for pointers a user function would follow. Integer ids, fixed-size structures without padding, or fixed-size
+ * strings fit. Values are copied in and out by value.
+ */
+struct _DConcurrentMap {
+	usize	key_size;
+	usize	value_size;
+};
+
+/**
+ * @brief Creates a new, empty concurrent map.
+ *
+ * @param key_size The size of a key in bytes, must not be 0.
+ * @param value_size The size of a value in bytes, 0 turns the map into a set.
+ * @param shard_count The number of shards, rounded up to a power of two, 0 for `D_CONCURRENT_MAP_DEFAULT_SHARDS`.
+ *                    A few times the number of writing threads keeps them from waiting on each other.
+ *
+ * @return DConcurrentMap* A pointer to the new map, NULL if the allocation fails or if `key_size` is 0.
+ */
+DConcurrentMap*	d_concurrent_map_new		(usize key_size, usize value_size, usize shard_count);
+
+/**
+ * @brief Inserts a copy of `key` and `value`, or overwrites the value of `key` if it is already present.
+ *
+ * @param map The map. Must not be NULL.
+ * @param key A pointer to the key, `key_size` bytes are copied.
+ * @param value A pointer to the value, `value_size` bytes are copied. If NULL the value is zeroed.
+ *
+ * @return bool true on success, false if the shard needed to grow and the allocation failed.
+ */
+bool			d_concurrent_map_insert		(DConcurrentMap* map, const void* key, const void* value);
+
+/**
+ * @brief Calls `update` on the value of `key` while its shard is locked, inserting the key with a zeroed value
+ *        if it is not present.
+ *
+ * Lets several threads modify the same value without losing updates, counting for instance. `update` must be short,
+ * it holds the shard, and must not use the map.
+ *
+ * @return bool true on success, false if the shard needed to grow and the allocation failed.
+ */
+bool			d_concurrent_map_update		(DConcurrentMap* map, const void* key, DConcurrentUpdateFunc update,
+												void* ctx);
+
+/**
+ * @brief Finds `key` and copies its value to `value`, without taking any lock.
+ *
+ * @param map The map. Must not be NULL.
+ * @param key A pointer to the key.
+ * @param value If not NULL, receives a copy of the value. It is a consistent snapshot: never a mix of two writes.
+ *
+ * @return bool true if `key` is present, false otherwise.
+ */
+bool			d_concurrent_map_get		(DConcurrentMap* map, const void* key, void* value);
+
+/**
+ * @brief Removes `key` and its value from the map.
+ *
+ * @return bool true if the key was present, false otherwise.
+ */
+bool			d_concurrent_map_remove		(DConcurrentMap* map, const void* key);
+
+/**
+ * @brief Retrieves the number of entries of the map.
+ *
+ * The shards are summed one after the other: while other threads write, the result is only an estimate.
+ */
+usize			d_concurrent_map_get_len	(DConcurrentMap* map);
+
+/**
+ * @brief Frees the map and every entry, then sets its pointer to NULL. No other thread may use the map anymore.
+ *
+ * @param map A pointer to the map pointer. Nothing is done if it or the map is NULL.
+ */
+void			d_concurrent_map_destroy	(DConcurrentMap** map);
+
+#endif
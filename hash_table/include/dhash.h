@@ -1,4 +1,238 @@
 #ifndef __D_HASH__H
 #define __D_HASH__H
 
-#endif
\ No newline at end of file
+#include <dtypes.h>
+#include <dalloc.h>
+#include <darray.h>
+typedef struct _DHashMap		DHashMap;
+typedef struct _DHashMapIter	DHashMapIter;
+
+/**
+ * @brief Hashes a key, the map mixes the result again so a plain identity is acceptable for integer keys.
+ */
+typedef u64(*DHashFunc)(const void* key);
+
+/**
+ * @brief Tells whether two keys are equal.
+ */
+typedef bool(*DEqualFunc)(const void* key1, const void* key2);
+
+/**
+ * @brief Number of slots of a group, their control bytes are probed at once with a single 16 bytes SIMD compare.
+ */
+#define D_HASH_GROUP_SLOTS 15
+
+/**
+ * @brief Maximum load factor of a map, as the fraction `D_HASH_MAX_LOAD_NUM / D_HASH_MAX_LOAD_DEN`.
+ */
+#define D_HASH_MAX_LOAD_NUM 7
+#define D_HASH_MAX_LOAD_DEN 8
+
+/**
+ * DHashMap:
+ * @param len the number of entries of the map.
+ *
+ * Contains the public fields of a hash map.
+ * Keys and values are copied inline into the map, `key_size` and `value_size` bytes each, as the elements of a
+ * #DArray are. The slots are split into groups of `D_HASH_GROUP_SLOTS`, each group having 16 bytes of metadata:
+ * one control byte per slot (0 when the slot is empty, a 7-bit tag of the key hash with the high bit set otherwise)
+ * and an overflow byte. A lookup compares the tag against a whole group in one SIMD instruction and only compares
+ * the keys whose tag matches, so a hit usually costs the metadata line plus the slot line.
+ * When an insertion has to go past a full group it sets a bit of the group overflow byte, chosen by the key hash,
+ * and a lookup stops at the first group whose overflow byte does not have its bit. Deleting an entry therefore
+ * only empties its control byte: there are no tombstones, and the load factor can go up to 7/8.
+ */
+struct _DHashMap {
+	usize	len;
+};
+
+/**
+ * DHashMapIter:
+ *
+ * An iterator over the entries of a map, see `d_hash_map_iter_init`. Its fields are private.
+ * Entries are visited in an unspecified order, the map must not be modified while it is iterated,
+ * except through `d_hash_map_iter_remove`.
+ */
+struct _DHashMapIter {
+	DHashMap*	map;
+	usize		group;
+	u32			mask;
+	usize		slot;
+};
+
+/**
+ * @brief Creates a new, empty hash map.
+ *
+ * No memory is allocated for the slots until the first insertion.
+ *
+ * @param key_size The size of a key in bytes, must not be 0.
+ * @param value_size The size of a value in bytes, 0 turns the map into a set.
+ * @param hash The hash function of the keys. Must not be NULL.
+ * @param equal The equality function of the keys. Must not be NULL.
+ * @param key_destroy If not NULL, called on the address of every key the map drops (removal, clear, destruction,
+ *                    or the key given to an insertion of a key already present).
+ * @param value_destroy If not NULL, called on the address of every value the map drops or overwrites.
+ *
+ * @return DHashMap* A pointer to the new map, NULL if the allocation fails or if `key_size` is 0.
+ */
+DHashMap*	d_hash_map_new				(usize key_size, usize value_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc key_destroy, DestroyElemFunc value_destroy);
+
+/**
+ * @brief Same as `d_hash_map_new` with the map memory allocated with `allocator`, NULL meaning libc.
+ *
+ * The map only keeps a pointer to `allocator`, so it must outlive the map.
+ */
+DHashMap*	d_hash_map_new_with_allocator(usize key_size, usize value_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc key_destroy, DestroyElemFunc value_destroy,
+											const DAllocator* allocator);
+
+/**
+ * @brief Inserts a copy of `key` and `value`, or overwrites the value of `key` if it is already present.
+ *
+ * When the key is already present the map keeps its own copy of the key, `key_destroy` is called on `key`
+ * and `value_destroy` on the previous value.
+ *
+ * @param map The map. Must not be NULL.
+ * @param key A pointer to the key, `key_size` bytes are copied.
+ * @param value A pointer to the value, `value_size` bytes are copied. If NULL the value is zeroed.
+ *
+ * @return void* A pointer to the value inside the map, valid until the next insertion or removal.
+ *         NULL if the map needed to grow and the allocation failed.
+ */
+void*		d_hash_map_insert			(DHashMap* map, const void* key, const void* value);
+
+/**
+ * @brief Finds the value of `key`, inserting it with a zeroed value if it is not present.
+ *
+ * Lets counting or grouping code hash each key once: `++*(usize*)d_hash_map_emplace(map, &key, NULL)`.
+ *
+ * @param map The map. Must not be NULL.
+ * @param key A pointer to the key, copied only if it is inserted.
+ * @param inserted If not NULL, set to true when the key was inserted and to false when it was already present.
+ *
+ * @return void* A pointer to the value inside the map, NULL if the map needed to grow and the allocation failed.
+ */
+void*		d_hash_map_emplace			(DHashMap* map, const void* key, bool* inserted);
+
+/**
+ * @brief Finds the value of `key`.
+ *
+ * @return void* A pointer to the value inside the map, NULL if `key` is not present. For a set (`value_size` 0)
+ *         the pointer is only meant to be compared to NULL.
+ */
+void*		d_hash_map_get				(DHashMap* map, const void* key);
+
+/**
+ * @brief Finds the copy of `key` stored in the map.
+ *
+ * @return void* A pointer to the key inside the map, NULL if `key` is not present.
+ */
+void*		d_hash_map_get_key			(DHashMap* map, const void* key);
+
+/**
+ * @brief Tells whether `key` is present in the map.
+ */
+bool		d_hash_map_contains			(DHashMap* map, const void* key);
+
+/**
+ * @brief Removes `key` and its value from the map, calling the destroy functions on them.
+ *
+ * @return bool true if the key was present, false otherwise.
+ */
+bool		d_hash_map_remove			(DHashMap* map, const void* key);
+
+/**
+ * @brief Makes sure `count` entries fit in the map without any further growth.
+ *
+ * @return DHashMap* The map, NULL if the allocation failed (the map is then left untouched).
+ */
+DHashMap*	d_hash_map_reserve			(DHashMap* map, usize count);
+
+/**
+ * @brief Retrieves the number of entries the map can hold before it grows.
+ */
+usize		d_hash_map_get_capacity		(DHashMap* map);
+
+/**
+ * @brief Removes every entry of the map, calling the destroy functions on them. The slots are kept.
+ */
+void		d_hash_map_clear			(DHashMap* map);
+
+/**
+ * @brief Frees the map and every entry, calling the destroy functions on them, then sets its pointer to NULL.
+ *
+ * @param map A pointer to the map pointer. Nothing is done if it or the map is NULL.
+ */
+void		d_hash_map_destroy			(DHashMap** map);
+
+/**
+ * @brief Starts an iteration over the entries of a map.
+ *
+ * The iteration scans the control bytes a group at a time and only touches the full slots.
+ *
+ * @code
+ * DHashMapIter it;
+ * void* key;
+ * void* value;
+ * d_hash_map_iter_init(&it, map);
+ * while (d_hash_map_iter_next(&it, &key, &value))
+ *     ...
+ * @endcode
+ *
+ * @param it The iterator to initialize. Must not be NULL.
+ * @param map The map to iterate. Must not be NULL.
+ */
+void		d_hash_map_iter_init		(DHashMapIter* it, DHashMap* map);
+
+/**
+ * @brief Moves an iterator to the next entry.
+ *
+ * @param it The iterator. Must not be NULL.
+ * @param key If not NULL, receives a pointer to the key inside the map.
+ * @param value If not NULL, receives a pointer to the value inside the map.
+ *
+ * @return bool true if an entry was found, false when the iteration is over.
+ */
+bool		d_hash_map_iter_next		(DHashMapIter* it, void** key, void** value);
+
+/**
+ * @brief Removes the entry the iterator is on, calling the destroy functions on it.
+ *
+ * The iteration can go on with `d_hash_map_iter_next`, no entry is skipped or visited twice.
+ */
+void		d_hash_map_iter_remove		(DHashMapIter* it);
+
+/**
+ * @brief Hashes a `u64` key, to be given to `d_hash_map_new` for maps keyed by `u64`.
+ */
+u64			d_hash_u64_key				(const void* key);
+
+/**
+ * @brief Compares two `u64` keys, to be given to `d_hash_map_new` for maps keyed by `u64`.
+ */
+bool		d_equal_u64_key				(const void* key1, const void* key2);
+
+/**
+ * @brief Hashes a `char*` key by the chars it points to, for maps and sets keyed by C strings, the tokens of
+ *        `d_string_split_by_char` for instance.
+ */
+u64			d_hash_c_string_key			(const void* key);
+
+/**
+ * @brief Compares two `char*` keys by the chars they point to.
+ */
+bool		d_equal_c_string_key		(const void* key1, const void* key2);
+
+/**
+ * @brief Hashes a `DString*` key by its content, for maps and sets keyed by the strings of the string module.
+ *        The cached length is used, nothing is scanned.
+ */
+u64			d_hash_dstring_key			(const void* key);
+
+/**
+ * @brief Compares two `DString*` keys by their content, their lengths first.
+ */
+bool		d_equal_dstring_key			(const void* key1, const void* key2);
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef __D_HASH_FUNC__H
+#define __D_HASH_FUNC__H
+
+#include <dtypes.h>
+#include <darray.h>
+
+/**
+ * Non-cryptographic hash functions, fast enough to be computed on every lookup of a hash table.
+ * None of them resists an attacker choosing the keys: use a random `seed` kept secret when the keys come
+ * from the outside.
+ */
+
+/**
+ * @brief Inputs of at least this many bytes are hashed by the SIMD striped loop of `d_hash_bytes`.
+ *
+ * Below it a scalar loop consuming 48 bytes per iteration with 64x64->128 bits multiplications is faster,
+ * since its setup and finalization are much cheaper.
+ */
+#define D_HASH_BULK_THRESHOLD 512
+
+/**
+ * @brief Hashes `len` bytes.
+ *
+ * Inputs up to 16 bytes are read with at most two pairs of overlapping loads and mixed with two 64x64->128 bits
+ * multiplications, with no loop nor byte-wise branch. Longer inputs below `D_HASH_BULK_THRESHOLD` go through three
+ * independent multiplication lanes of 16 bytes each. Bulk inputs are accumulated 64 bytes at a time into eight 64-bit
+ * lanes with 32x32->64 bits SIMD multiplications and scrambled every kilobyte: AVX2 is used when the CPU has it
+ * (checked at run time, the library does not need to be built for it), SSE2 otherwise, and a scalar loop giving
+ * the same result on other targets.
+ * The result only depends on the bytes, their number and `seed`, never on the alignment of `data`.
+ *
+ * @param data The bytes to hash. May be NULL if `len` is 0.
+ * @param len The number of bytes.
+ * @param seed Any value, different seeds give unrelated hash functions.
+ *
+ * @return u64 The hash.
+ */
+u64		d_hash_bytes		(const void* data, usize len, u64 seed);
+
+/**
+ * @brief Hashes a null-terminated string, the same as `d_hash_bytes(str, strlen(str), seed)`.
+ */
+u64		d_hash_c_string		(const char* str, u64 seed);
+
+/**
+ * @brief Hashes every C string of `strings` into `hashes`.
+ *
+ * The keys are taken four at a time and the four hash computations are interleaved, so the latency of the
+ * multiplications of one key is hidden behind the others and the loads of the next keys are issued early.
+ * `hashes[i]` is the same as `d_hash_c_string(strings -> pdata[i], seed)`.
+ *
+ * @param strings The strings, every element must be a non NULL `char*`. Must not be NULL.
+ * @param hashes Receives `strings -> len` hashes. Must not be NULL.
+ * @param seed The seed given to every hash.
+ */
+void	d_hash_c_strings	(const DPointerArray* strings, u64* hashes, u64 seed);
+
+/**
+ * @brief Same as `d_hash_c_strings` for a pointer array whose elements are `DString*`, as the split functions of
+ *        the string module return. Their cached lengths are used, nothing is scanned for a null terminator.
+ */
+void	d_hash_dstrings		(const DPointerArray* strings, u64* hashes, u64 seed);
+
+/**
+ * @brief Mixes a `u32` into a well distributed `u32`, every input bit affecting every output bit.
+ *
+ * The function is a bijection: distinct keys never collide, which makes it a good hash for integer keys,
+ * and a good fix for sequential or strided ids.
+ */
+static inline u32	d_hash_u32(u32 key)
+{
+	key ^= key >> 16;
+	key *= 0x7feb352dU;
+	key ^= key >> 15;
+	key *= 0x846ca68bU;
+	key ^= key >> 16;
+	return key;
+}
+
+/**
+ * @brief Mixes a `u64` into a well distributed `u64`, a bijection as `d_hash_u32` is.
+ */
+static inline u64	d_hash_u64(u64 key)
+{
+	key ^= key >> 30;
+	key *= 0xbf58476d1ce4e5b9ULL;
+	key ^= key >> 27;
+	key *= 0x94d049bb133111ebULL;
+	key ^= key >> 31;
+	return key;
+}
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef __D_HASH_SET__H
+#define __D_HASH_SET__H
+
+#include <dtypes.h>
+#include <dalloc.h>
+#include <darray.h>
+#include <dhash.h>
+typedef struct _DHashSet		DHashSet;
+typedef struct _DHashSetIter	DHashSetIter;
+
+/**
+ * @brief Number of elements `d_hash_set_insert_many` hashes and prefetches before probing for any of them.
+ */
+#define D_HASH_SET_PREFETCH_BATCH 16
+
+/**
+ * DHashSet:
+ * @param len the number of elements of the set.
+ * @param elem_size the size of an element in bytes.
+ *
+ * Contains the public fields of a hash set.
+ * Elements are copied inline into a single array of buckets, `elem_size` bytes each, as the elements of a #DArray
+ * are: there is no per-element pointer nor allocation. Next to the buckets, an array of 16-bit metadata holds for
+ * each bucket an 8-bit fingerprint of the hash and the distance of the element to its home bucket, 0 meaning empty.
+ * Collisions are resolved with Robin Hood linear probing: an insertion walks forward from the home bucket and takes
+ * the place of the first element that is closer to its own home than the new one would be, shifting the rest of the
+ * run by one bucket. Runs therefore stay sorted by home bucket, which keeps probe lengths short and even at a load
+ * factor of 7/8 and lets a lookup stop as soon as it meets an element closer to its home than the key would be.
+ * Deletions shift the following elements of the run back by one bucket instead of leaving tombstones, so a set that
+ * sees many insertions and removals never degrades nor needs to be rebuilt.
+ * A lookup reads the metadata, which holds 32 buckets per cache line, and only compares the elements whose
+ * fingerprint and distance both match.
+ * Distances are stored on 8 bits: if a run would push one past 254 the set grows, and an insertion fails if that
+ * happens while the set is less than a quarter full, which only a hash function mapping many elements to the same
+ * value can cause.
+ */
+struct _DHashSet {
+	usize	len;
+	usize	elem_size;
+};
+
+/**
+ * DHashSetIter:
+ *
+ * An iterator over the elements of a set, see `d_hash_set_iter_init`. Its fields are private.
+ * Elements are visited in an unspecified order, the set must not be modified while it is iterated.
+ */
+struct _DHashSetIter {
+	DHashSet*	set;
+	usize		bucket;
+};
+
+/**
+ * @brief Creates a new, empty hash set.
+ *
+ * No memory is allocated for the buckets until the first insertion.
+ *
+ * @param elem_size The size of an element in bytes, must not be 0.
+ * @param hash The hash function of the elements. Must not be NULL.
+ * @param equal The equality function of the elements. Must not be NULL.
+ * @param elem_destroy If not NULL, called on the address of every element the set drops (removal, clear,
+ *                     destruction, or the element given to an insertion of an element already present).
+ *
+ * @return DHashSet* A pointer to the new set, NULL if the allocation fails or if `elem_size` is 0.
+ */
+DHashSet*	d_hash_set_new				(usize elem_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc elem_destroy);
+
+/**
+ * @brief Same as `d_hash_set_new` with the set memory allocated with `allocator`, NULL meaning libc.
+ *
+ * The set only keeps a pointer to `allocator`, so it must outlive the set.
+ */
+DHashSet*	d_hash_set_new_with_allocator(usize elem_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc elem_destroy, const DAllocator* allocator);
+
+/**
+ * @brief Inserts a copy of `elem` if no equal element is present.
+ *
+ * When an equal element is already present the set keeps its own copy and `elem_destroy` is called on `elem`,
+ * so ownership of `elem` always goes to the set.
+ *
+ * @param set The set. Must not be NULL.
+ * @param elem A pointer to the element, `elem_size` bytes are copied.
+ * @param inserted If not NULL, set to true when the element was inserted and to false when it was already present.
+ *
+ * @return void* A pointer to the element inside the set, valid until the next insertion or removal.
+ *         NULL if the set needed to grow and the allocation failed, or if the hash function is degenerate.
+ */
+void*		d_hash_set_insert			(DHashSet* set, const void* elem, bool* inserted);
+
+/**
+ * @brief Inserts a copy of each of `count` elements stored one after the other, `elem_size` bytes apart.
+ *
+ * Same as calling `d_hash_set_insert` on each element, but the elements are taken `D_HASH_SET_PREFETCH_BATCH` at
+ * a time: the set first grows if the batch may need it, then all of them are hashed and the metadata and buckets
+ * they will probe are prefetched before the first probe, so the cache misses of a batch overlap instead of being
+ * paid one after the other.
+ * Deduplicating the tokens of `d_string_split_by_char` is `d_hash_set_insert_many(set, tokens -> pdata, tokens -> len)`
+ * on a set of `char*` using `d_hash_c_string_key` and `d_equal_c_string_key`.
+ *
+ * @param set The set. Must not be NULL.
+ * @param elems The elements. May be NULL if `count` is 0.
+ * @param count The number of elements.
+ *
+ * @return usize The number of elements that were not present and got inserted, MAX_SIZE_T_VALUE if an insertion
+ *         failed (the elements before it are inserted, the ones after it are left untouched).
+ */
+usize		d_hash_set_insert_many		(DHashSet* set, const void* elems, usize count);
+
+/**
+ * @brief Finds the copy of `elem` stored in the set.
+ *
+ * @return void* A pointer to the element inside the set, NULL if `elem` is not present.
+ */
+void*		d_hash_set_get				(DHashSet* set, const void* elem);
+
+/**
+ * @brief Tells whether `elem` is present in the set.
+ */
+bool		d_hash_set_contains			(DHashSet* set, const void* elem);
+
+/**
+ * @brief Removes `elem` from the set, calling `elem_destroy` on the copy the set held.
+ *
+ * @return bool true if the element was present, false otherwise.
+ */
+bool		d_hash_set_remove			(DHashSet* set, const void* elem);
+
+/**
+ * @brief Makes sure `count` elements fit in the set without any further growth.
+ *
+ * @return DHashSet* The set, NULL if the allocation failed (the set is then left untouched).
+ */
+DHashSet*	d_hash_set_reserve			(DHashSet* set, usize count);
+
+/**
+ * @brief Retrieves the number of elements the set can hold before it grows.
+ */
+usize		d_hash_set_get_capacity		(DHashSet* set);
+
+/**
+ * @brief Removes every element of the set, calling `elem_destroy` on them. The buckets are kept.
+ */
+void		d_hash_set_clear			(DHashSet* set);
+
+/**
+ * @brief Frees the set and every element, calling `elem_destroy` on them, then sets its pointer to NULL.
+ *
+ * @param set A pointer to the set pointer. Nothing is done if it or the set is NULL.
+ */
+void		d_hash_set_destroy			(DHashSet** set);
+
+/**
+ * @brief Starts an iteration over the elements of a set.
+ *
+ * @code
+ * DHashSetIter it;
+ * void* elem;
+ * d_hash_set_iter_init(&it, set);
+ * while (d_hash_set_iter_next(&it, &elem))
+ *     ...
+ * @endcode
+ *
+ * @param it The iterator to initialize. Must not be NULL.
+ * @param set The set to iterate. Must not be NULL.
+ */
+void		d_hash_set_iter_init		(DHashSetIter* it, DHashSet* set);
+
+/**
+ * @brief Moves an iterator to the next element.
+ *
+ * @param it The iterator. Must not be NULL.
+ * @param elem If not NULL, receives a pointer to the element inside the set.
+ *
+ * @return bool true if an element was found, false when the iteration is over.
+ */
+bool		d_hash_set_iter_next		(DHashSetIter* it, void** elem);
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef __D_INTERN__H
+#define __D_INTERN__H
+
+#include <dtypes.h>
+#include <dstring.h>
+#include <dstring_view.h>
+typedef struct _DInternPool		DInternPool;
+typedef struct _DInternStats	DInternStats;
+
+/**
+ * @brief Id returned when a string could not be interned, never given to a string.
+ */
+#define D_INTERN_INVALID_ID ((u32)-1)
+
+/**
+ * @brief Number of shards of a thread-safe pool, each with its own lock, table and arena.
+ */
+#define D_INTERN_POOL_SHARDS 16
+
+/**
+ * DInternPool:
+ * @param thread_safe whether the pool can be used from several threads at once.
+ *
+ * A string interning pool: it keeps a single copy of every distinct string it is given and returns that copy,
+ * the canonical string, for every string equal to it. Two interned strings are equal if and only if their
+ * pointers are equal, so code comparing the same identifiers over and over can replace `strcmp`, or
+ * `d_string_compare`, by a pointer compare once the strings are interned.
+ * Each canonical string also has an id: ids are given in the order the strings are interned, from 0, and are
+ * dense (unless an allocation failed), so they can index plain arrays of per-string data.
+ * The canonical strings are null-terminated and stored in an arena, never moved nor freed before the pool is
+ * destroyed: the pointers stay valid for the whole life of the pool. A small header before each of them holds its
+ * id and its length, both read in O(1) by `d_intern_pool_string_id` and `d_intern_pool_string_len`.
+ * The strings are found through a #DHashSet of entries holding a pointer to the canonical string, its length and
+ * its hash, so a lookup hashes the string once and only compares the bytes of an entry whose hash matches.
+ * A thread-safe pool is split into `D_INTERN_POOL_SHARDS` shards picked by bits of the hash, each guarded by a spin
+ * lock, so threads interning different strings rarely wait on each other. The id to string table is read without
+ * any lock.
+ */
+struct _DInternPool {
+	bool	thread_safe;
+};
+
+/**
+ * DInternStats:
+ * @param strings the number of distinct strings in the pool.
+ * @param string_bytes the bytes of the strings themselves, null terminators included.
+ * @param arena_bytes the bytes of the arena chunks holding the strings and their headers.
+ * @param table_bytes the bytes of the hash tables finding the strings.
+ * @param id_bytes the bytes of the table giving the string of an id.
+ * @param total_bytes all the memory of the pool, the pool structure included.
+ *
+ * The memory footprint of a pool, filled by `d_intern_pool_get_stats`. `string_bytes` over `total_bytes` is how
+ * much of the memory goes to the strings themselves.
+ */
+struct _DInternStats {
+	usize	strings;
+	usize	string_bytes;
+	usize	arena_bytes;
+	usize	table_bytes;
+	usize	id_bytes;
+	usize	total_bytes;
+};
+
+/**
+ * @brief Creates a new, empty interning pool.
+ *
+ * No memory is allocated for the strings until the first one is interned.
+ *
+ * @param thread_safe If true the pool can be used from several threads at once, see #DInternPool.
+ *
+ * @return DInternPool* A pointer to the new pool, NULL if the allocation fails.
+ */
+DInternPool*	d_intern_pool_new			(bool thread_safe);
+
+/**
+ * @brief Interns the null-terminated string `str`.
+ *
+ * @param pool The pool. Must not be NULL.
+ * @param str The string, copied only if no equal string was interned before. Must not be NULL.
+ *
+ * @return const char* The canonical string equal to `str`, valid until the pool is destroyed.
+ *         NULL if the allocation failed or if `str` is longer than 4 GiB.
+ */
+const char*		d_intern_pool_intern		(DInternPool* pool, const char* str);
+
+/**
+ * @brief Same as `d_intern_pool_intern` for the bytes of a view, which need not be null-terminated.
+ *        The canonical string is, and it may be a view of the pool itself.
+ */
+const char*		d_intern_pool_intern_view	(DInternPool* pool, DStringView view);
+
+/**
+ * @brief Same as `d_intern_pool_intern` for a #DString, whose cached length is used.
+ */
+const char*		d_intern_pool_intern_dstring(DInternPool* pool, const DString* dstring);
+
+/**
+ * @brief Interns the bytes of a view and returns the id of the canonical string.
+ *
+ * @return u32 The id, `D_INTERN_INVALID_ID` if the allocation failed or if the pool ran out of ids.
+ */
+u32				d_intern_pool_intern_id		(DInternPool* pool, DStringView view);
+
+/**
+ * @brief Finds the canonical string equal to the bytes of a view, without interning them.
+ *
+ * @return const char* The canonical string, NULL if no equal string was interned.
+ */
+const char*		d_intern_pool_find			(DInternPool* pool, DStringView view);
+
+/**
+ * @brief Retrieves the canonical string of an id.
+ *
+ * Takes no lock. In a thread-safe pool an id is only guaranteed to be visible to the threads the interning thread
+ * handed it to, as any other value it wrote.
+ *
+ * @return const char* The canonical string, NULL if no string has the id.
+ */
+const char*		d_intern_pool_get_string	(DInternPool* pool, u32 id);
+
+/**
+ * @brief Retrieves the id of a canonical string, in O(1).
+ *
+ * @param interned A string returned by the pool. Any other pointer is undefined behavior.
+ */
+u32				d_intern_pool_string_id		(const char* interned);
+
+/**
+ * @brief Retrieves the length of a canonical string, in O(1).
+ *
+ * @param interned A string returned by the pool. Any other pointer is undefined behavior.
+ */
+usize			d_intern_pool_string_len	(const char* interned);
+
+/**
+ * @brief Retrieves the number of distinct strings of the pool.
+ *
+ * While other threads intern strings in a thread-safe pool, the result is only an estimate.
+ */
+usize			d_intern_pool_get_len		(DInternPool* pool);
+
+/**
+ * @brief Fills `stats` with the memory footprint of the pool.
+ *
+ * The shards of a thread-safe pool are measured one after the other, while other threads intern strings
+ * the result is only an estimate.
+ *
+ * @param pool The pool. Must not be NULL.
+ * @param stats Receives the footprint. Must not be NULL.
+ */
+void			d_intern_pool_get_stats		(DInternPool* pool, DInternStats* stats);
+
+/**
+ * @brief Frees the pool and every canonical string, then sets its pointer to NULL.
+ *        No other thread may use the pool, nor any of its strings, anymore.
+ *
+ * @param pool A pointer to the pool pointer. Nothing is done if it or the pool is NULL.
+ */
+void			d_intern_pool_destroy		(DInternPool** pool);
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef __D_STRING_MAP__H
+#define __D_STRING_MAP__H
+
+#include <dtypes.h>
+#include <dalloc.h>
+#include <darray.h>
+#include <dstring_view.h>
+typedef struct _DStringMap		DStringMap;
+typedef struct _DStringMapIter	DStringMapIter;
+
+/**
+ * DStringMap:
+ * @param len the number of entries of the map.
+ *
+ * Contains the public fields of a hash map keyed by strings.
+ * It uses the groups and the SIMD probing of #DHashMap, but every slot also stores the length and the full 64-bit
+ * hash of its key next to a pointer to the chars. A lookup is therefore done on a #DStringView (a pointer plus a
+ * length, see `d_string_view_from_c_string` and `d_string_view_from_dstring`) without any allocation nor `strlen`,
+ * a slot is rejected by its 7-bit tag, then by its hash and its length, and only a slot that matches all of them
+ * has its chars compared. The keys are hashed with `d_hash_bytes` and growing the map never hashes them again.
+ * The map owns a null-terminated copy of every key, allocated with the allocator of the map.
+ */
+struct _DStringMap {
+	usize	len;
+};
+
+/**
+ * DStringMapIter:
+ *
+ * An iterator over the entries of a string map, see `d_string_map_iter_init`. Its fields are private.
+ * Entries are visited in an unspecified order, the map must not be modified while it is iterated,
+ * except through `d_string_map_iter_remove`.
+ */
+struct _DStringMapIter {
+	DStringMap*	map;
+	usize		group;
+	u32			mask;
+	usize		slot;
+};
+
+/**
+ * @brief Creates a new, empty string map.
+ *
+ * No memory is allocated for the slots until the first insertion.
+ *
+ * @param value_size The size of a value in bytes, 0 turns the map into a set of strings.
+ * @param value_destroy If not NULL, called on the address of every value the map drops or overwrites.
+ *
+ * @return DStringMap* A pointer to the new map, NULL if the allocation fails.
+ */
+DStringMap*	d_string_map_new				(usize value_size, DestroyElemFunc value_destroy);
+
+/**
+ * @brief Same as `d_string_map_new` with the map memory, keys included, allocated with `allocator`, NULL meaning libc.
+ *
+ * The map only keeps a pointer to `allocator`, so it must outlive the map.
+ */
+DStringMap*	d_string_map_new_with_allocator	(usize value_size, DestroyElemFunc value_destroy,
+												const DAllocator* allocator);
+
+/**
+ * @brief Inserts a copy of `key` and `value`, or overwrites the value of `key` if it is already present.
+ *
+ * @param map The map. Must not be NULL.
+ * @param key The key, its chars are copied only if it is not present yet. Its data must not be NULL.
+ * @param value A pointer to the value, `value_size` bytes are copied. If NULL the value is zeroed.
+ *
+ * @return void* A pointer to the value inside the map, valid until the next insertion or removal.
+ *         NULL if an allocation failed.
+ */
+void*		d_string_map_insert				(DStringMap* map, DStringView key, const void* value);
+
+/**
+ * @brief Finds the value of `key`, inserting it with a zeroed value if it is not present.
+ *
+ * Counting the words of a text this way hashes each word once and copies it only the first time it is seen:
+ * `++*(usize*)d_string_map_emplace(map, word, NULL)`.
+ *
+ * @param map The map. Must not be NULL.
+ * @param key The key, its chars are copied only if it is inserted.
+ * @param inserted If not NULL, set to true when the key was inserted and to false when it was already present.
+ *
+ * @return void* A pointer to the value inside the map, NULL if an allocation failed.
+ */
+void*		d_string_map_emplace			(DStringMap* map, DStringView key, bool* inserted);
+
+/**
+ * @brief Finds the value of `key`.
+ *
+ * @return void* A pointer to the value inside the map, NULL if `key` is not present. For a set (`value_size` 0)
+ *         the pointer is only meant to be compared to NULL.
+ */
+void*		d_string_map_get				(DStringMap* map, DStringView key);
+
+/**
+ * @brief Finds the copy of `key` owned by the map.
+ *
+ * @return const char* The null-terminated key inside the map, valid until it is removed. NULL if `key` is not present.
+ */
+const char*	d_string_map_get_key			(DStringMap* map, DStringView key);
+
+/**
+ * @brief Tells whether `key` is present in the map.
+ */
+bool		d_string_map_contains			(DStringMap* map, DStringView key);
+
+/**
+ * @brief Removes `key` and its value from the map, freeing its copy of the key and calling `value_destroy`.
+ *
+ * @return bool true if the key was present, false otherwise.
+ */
+bool		d_string_map_remove				(DStringMap* map, DStringView key);
+
+/**
+ * @brief Makes sure `count` entries fit in the map without any further growth.
+ *
+ * @return DStringMap* The map, NULL if the allocation failed (the map is then left untouched).
+ */
+DStringMap*	d_string_map_reserve			(DStringMap* map, usize count);
+
+/**
+ * @brief Retrieves the number of entries the map can hold before it grows.
+ */
+usize		d_string_map_get_capacity		(DStringMap* map);
+
+/**
+ * @brief Removes every entry of the map. The slots are kept.
+ */
+void		d_string_map_clear				(DStringMap* map);
+
+/**
+ * @brief Frees the map and every entry, then sets its pointer to NULL.
+ *
+ * @param map A pointer to the map pointer. Nothing is done if it or the map is NULL.
+ */
+void		d_string_map_destroy			(DStringMap** map);
+
+/**
+ * @brief Starts an iteration over the entries of a string map, see `d_hash_map_iter_init`.
+ *
+ * @param it The iterator to initialize. Must not be NULL.
+ * @param map The map to iterate. Must not be NULL.
+ */
+void		d_string_map_iter_init			(DStringMapIter* it, DStringMap* map);
+
+/**
+ * @brief Moves an iterator to the next entry.
+ *
+ * @param it The iterator. Must not be NULL.
+ * @param key If not NULL, receives a view over the key inside the map.
+ * @param value If not NULL, receives a pointer to the value inside the map.
+ *
+ * @return bool true if an entry was found, false when the iteration is over.
+ */
+bool		d_string_map_iter_next			(DStringMapIter* it, DStringView* key, void** value);
+
+/**
+ * @brief Removes the entry the iterator is on.
+ *
+ * The iteration can go on with `d_string_map_iter_next`, no entry is skipped or visited twice.
+ */
+void		d_string_map_iter_remove		(DStringMapIter* it);
+
+#endif
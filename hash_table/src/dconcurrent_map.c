@@ -0,0 +1,314 @@
+#include <dconcurrent_map.h>
+#include <dhash_func.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dhash_group.h"
+
+typedef struct _DRealConcurrentMap	DRealConcurrentMap;
+typedef struct _DConcurrentShard	DConcurrentShard;
+typedef struct _DConcurrentTable	DConcurrentTable;
+
+//HEADER OF A TABLE BLOCK, FOLLOWED BY THE METADATA OF ITS GROUPS AND ITS SLOTS
+struct _DConcurrentTable {
+	usize				groups; /* never changes once the block is allocated, readers rely on it */
+	DConcurrentTable*	next; /* next retired table of the shard */
+};
+
+//A SHARD ON ITS OWN CACHE LINE, SO WRITERS OF ONE SHARD DO NOT SLOW DOWN THE READERS OF ITS NEIGHBOURS
+struct _DConcurrentShard {
+	u64					seq; /* odd while a writer holds the shard */
+	DConcurrentTable*	table; /* NULL before the first insertion */
+	usize				len;
+	usize				max_load;
+	DConcurrentTable*	retired; /* tables the shard outgrew, readers may still be looking at them */
+} __attribute__((aligned(64)));
+
+//REAL CONCURRENT MAP STRUCTURE ALLOCATED
+struct _DRealConcurrentMap {
+	usize				key_size;
+	usize				value_size;
+	usize				value_offset; /* offset of the value inside a slot */
+	usize				slot_size;
+	usize				shard_mask;
+	DConcurrentShard*	shards;
+};
+
+//THE SHARD IS PICKED WITH HASH BITS THAT NEITHER THE TAG, THE OVERFLOW BIT NOR THE HOME GROUP OF A SMALL SHARD USE
+#define D_CONCURRENT_SHARD_SHIFT 35
+#define D_CONCURRENT_MAX_SHARDS ((usize)1 << 20)
+
+#define d_concurrent_ctrl(table) ((u8*)(table) + sizeof(DConcurrentTable))
+#define d_concurrent_group_ctrl(table, g) (d_concurrent_ctrl(table) + (g) * D_HASH_GROUP_SIZE)
+#define d_concurrent_slot(map, table, i) (d_concurrent_ctrl(table) + (table) -> groups * D_HASH_GROUP_SIZE + (i) * (map) -> slot_size)
+#define d_concurrent_shard(map, h) ((map) -> shards + (((h) >> D_CONCURRENT_SHARD_SHIFT) & (map) -> shard_mask))
+
+//Number of pauses a thread spins for before it yields its core, a writer that got preempted may take a while
+#define D_CONCURRENT_SPINS 64
+
+static inline void	d_concurrent_pause(u32* spins)
+{
+	if (++*spins % D_CONCURRENT_SPINS == 0)
+	{
+		sched_yield();
+		return;
+	}
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+//The keys of 8 bytes, ids for the most part, go through the cheaper integer mixer
+static inline u64	d_concurrent_hash(DRealConcurrentMap* map, const void* key)
+{
+	if (map -> key_size == sizeof(u64))
+	{
+		u64 k;
+		memcpy(&k, key, sizeof(u64));
+		return d_hash_u64(k);
+	}
+	return d_hash_bytes(key, map -> key_size, 0);
+}
+
+//Takes the shard for writing: its sequence number goes from even to odd, which also tells readers to retry
+static inline void	d_concurrent_shard_lock(DConcurrentShard* shard)
+{
+	u32 spins = 0;
+	for (;;)
+	{
+		u64 seq = __atomic_load_n(&shard -> seq, __ATOMIC_RELAXED);
+		if ((seq & 1) == 0 && __atomic_compare_exchange_n(&shard -> seq, &seq, seq + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			break;
+		d_concurrent_pause(&spins);
+	}
+	//the writes of the critical section must not become visible before the odd sequence number
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void	d_concurrent_shard_unlock(DConcurrentShard* shard)
+{
+	__atomic_store_n(&shard -> seq, shard -> seq + 1, __ATOMIC_RELEASE);
+}
+
+DConcurrentMap*	d_concurrent_map_new		(usize key_size, usize value_size, usize shard_count)
+{
+	if (key_size == 0 || key_size > MAX_SIZE_T_VALUE / 4 || value_size > MAX_SIZE_T_VALUE / 4
+		|| shard_count > D_CONCURRENT_MAX_SHARDS)
+		return NULL;
+	if (shard_count == 0)
+		shard_count = D_CONCURRENT_MAP_DEFAULT_SHARDS;
+	usize shards = 1;
+	while (shards < shard_count)
+		shards *= 2;
+	DRealConcurrentMap* map = malloc(sizeof(DRealConcurrentMap));
+	if (map == NULL)
+		return NULL;
+	void* memory;
+	if (posix_memalign(&memory, sizeof(DConcurrentShard), shards * sizeof(DConcurrentShard)) != 0)
+	{
+		free(map);
+		return NULL;
+	}
+	memset(memory, 0, shards * sizeof(DConcurrentShard));
+	usize key_alignment = d_hash_alignment(key_size);
+	usize value_alignment = value_size == 0 ? 1 : d_hash_alignment(value_size);
+	usize slot_alignment = key_alignment > value_alignment ? key_alignment : value_alignment;
+	map -> key_size = key_size;
+	map -> value_size = value_size;
+	map -> value_offset = (key_size + value_alignment - 1) & ~(value_alignment - 1);
+	map -> slot_size = (map -> value_offset + value_size + slot_alignment - 1) & ~(slot_alignment - 1);
+	map -> shard_mask = shards - 1;
+	map -> shards = memory;
+	return (DConcurrentMap*)map;
+}
+
+//Index of the slot holding `key`, MAX_SIZE_T_VALUE if it is not present. Called by readers without the lock: the
+//table is published with a release store and loaded with an acquire one, so its size is always the one it was
+//built with, which never changes afterwards and keeps the probes within its bounds
+static inline usize	d_concurrent_find(DRealConcurrentMap* map, DConcurrentTable* table, const void* key, u64 h)
+{
+	const u8* ctrl = d_concurrent_ctrl(table);
+	DHashProbe probe;
+	d_hash_probe_init(&probe, ctrl, table -> groups, h);
+	usize slot;
+	while ((slot = d_hash_probe_next(&probe, ctrl)) != MAX_SIZE_T_VALUE
+		&& memcmp(d_concurrent_slot(map, table, slot), key, map -> key_size) != 0)
+		;
+	return slot;
+}
+
+//Moves the entries of the shard to a table of `groups` groups, a retired table of that size if there is one.
+//The shard must be locked
+static bool	d_concurrent_rehash(DRealConcurrentMap* map, DConcurrentShard* shard, usize groups)
+{
+	DConcurrentTable* table = NULL;
+	for (DConcurrentTable** link = &shard -> retired; *link != NULL; link = &(*link) -> next)
+	{
+		if ((*link) -> groups == groups)
+		{
+			table = *link;
+			*link = table -> next;
+			break;
+		}
+	}
+	if (table == NULL)
+	{
+		usize size = d_hash_block_size(groups, map -> slot_size, sizeof(DConcurrentTable));
+		if (groups == 0 || size == 0 || (table = malloc(size)) == NULL)
+			return false;
+		table -> groups = groups;
+	}
+	memset(d_concurrent_ctrl(table), 0, groups * D_HASH_GROUP_SIZE);
+	DConcurrentTable* old = shard -> table;
+	usize old_groups = old == NULL ? 0 : old -> groups;
+	usize group = 0;
+	u32 full = old == NULL ? 0 : d_hash_first_full(d_concurrent_ctrl(old), old_groups);
+	for (usize i; old != NULL && (i = d_hash_next_full(d_concurrent_ctrl(old), old_groups, &group, &full)) != MAX_SIZE_T_VALUE;)
+	{
+		u8* entry = d_concurrent_slot(map, old, i);
+		u64 h = d_concurrent_hash(map, entry);
+		usize slot = d_hash_find_empty(d_concurrent_ctrl(table), groups, h);
+		d_hash_set_ctrl(d_concurrent_ctrl(table), slot, d_hash_tag(h));
+		memcpy(d_concurrent_slot(map, table, slot), entry, map -> slot_size);
+	}
+	//Release: a reader that sees the new table also sees its size, ctrl bytes and slots
+	__atomic_store_n(&shard -> table, table, __ATOMIC_RELEASE);
+	shard -> max_load = d_hash_max_load(groups);
+	if (old != NULL)
+	{
+		old -> next = shard -> retired;
+		shard -> retired = old;
+	}
+	return true;
+}
+
+//Finds the slot of `key` in a locked shard, inserting a copy of the key in an empty slot if it is not present
+static u8*	d_concurrent_find_or_insert(DRealConcurrentMap* map, DConcurrentShard* shard, const void* key, u64 h,
+											bool* inserted)
+{
+	DConcurrentTable* table = shard -> table;
+	usize slot = table == NULL ? MAX_SIZE_T_VALUE : d_concurrent_find(map, table, key, h);
+	if (slot != MAX_SIZE_T_VALUE)
+	{
+		*inserted = false;
+		return d_concurrent_slot(map, table, slot);
+	}
+	if (shard -> len >= shard -> max_load
+		&& d_concurrent_rehash(map, shard, d_hash_groups_for(shard -> len + shard -> len / 8 + 1)) == false)
+		return NULL;
+	table = shard -> table;
+	slot = d_hash_find_empty(d_concurrent_ctrl(table), table -> groups, h);
+	d_hash_set_ctrl(d_concurrent_ctrl(table), slot, d_hash_tag(h));
+	u8* entry = d_concurrent_slot(map, table, slot);
+	memcpy(entry, key, map -> key_size);
+	memset(entry + map -> value_offset, 0, map -> value_size);
+	__atomic_store_n(&shard -> len, shard -> len + 1, __ATOMIC_RELAXED);
+	*inserted = true;
+	return entry;
+}
+
+bool			d_concurrent_map_insert		(DConcurrentMap* map_, const void* key, const void* value)
+{
+	DRealConcurrentMap* map = (DRealConcurrentMap*)map_;
+	u64 h = d_concurrent_hash(map, key);
+	DConcurrentShard* shard = d_concurrent_shard(map, h);
+	bool inserted;
+	d_concurrent_shard_lock(shard);
+	u8* entry = d_concurrent_find_or_insert(map, shard, key, h, &inserted);
+	if (entry != NULL && value != NULL)
+		memcpy(entry + map -> value_offset, value, map -> value_size);
+	else if (entry != NULL && inserted == false)
+		memset(entry + map -> value_offset, 0, map -> value_size);
+	d_concurrent_shard_unlock(shard);
+	return entry != NULL;
+}
+
+bool			d_concurrent_map_update		(DConcurrentMap* map_, const void* key, DConcurrentUpdateFunc update,
+												void* ctx)
+{
+	DRealConcurrentMap* map = (DRealConcurrentMap*)map_;
+	u64 h = d_concurrent_hash(map, key);
+	DConcurrentShard* shard = d_concurrent_shard(map, h);
+	bool inserted;
+	d_concurrent_shard_lock(shard);
+	u8* entry = d_concurrent_find_or_insert(map, shard, key, h, &inserted);
+	if (entry != NULL)
+		update(entry + map -> value_offset, inserted, ctx);
+	d_concurrent_shard_unlock(shard);
+	return entry != NULL;
+}
+
+bool			d_concurrent_map_get		(DConcurrentMap* map_, const void* key, void* value)
+{
+	DRealConcurrentMap* map = (DRealConcurrentMap*)map_;
+	u64 h = d_concurrent_hash(map, key);
+	DConcurrentShard* shard = d_concurrent_shard(map, h);
+	u32 spins = 0;
+	for (;;)
+	{
+		u64 seq = __atomic_load_n(&shard -> seq, __ATOMIC_ACQUIRE);
+		if (seq & 1)
+		{
+			d_concurrent_pause(&spins);
+			continue;
+		}
+		DConcurrentTable* table = __atomic_load_n(&shard -> table, __ATOMIC_ACQUIRE);
+		usize slot = table == NULL ? MAX_SIZE_T_VALUE : d_concurrent_find(map, table, key, h);
+		if (slot != MAX_SIZE_T_VALUE && value != NULL)
+			memcpy(value, d_concurrent_slot(map, table, slot) + map -> value_offset, map -> value_size);
+		//the reads above must be done before the sequence number is checked again
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&shard -> seq, __ATOMIC_RELAXED) == seq)
+			return slot != MAX_SIZE_T_VALUE;
+	}
+}
+
+bool			d_concurrent_map_remove		(DConcurrentMap* map_, const void* key)
+{
+	DRealConcurrentMap* map = (DRealConcurrentMap*)map_;
+	u64 h = d_concurrent_hash(map, key);
+	DConcurrentShard* shard = d_concurrent_shard(map, h);
+	d_concurrent_shard_lock(shard);
+	DConcurrentTable* table = shard -> table;
+	usize slot = table == NULL ? MAX_SIZE_T_VALUE : d_concurrent_find(map, table, key, h);
+	if (slot != MAX_SIZE_T_VALUE)
+	{
+		//see `d_hash_erase` for the overflow bytes
+		d_hash_set_ctrl(d_concurrent_ctrl(table), slot, 0);
+		__atomic_store_n(&shard -> len, shard -> len - 1, __ATOMIC_RELAXED);
+		if (d_concurrent_group_ctrl(table, slot / D_HASH_GROUP_SLOTS)[D_HASH_OVERFLOW] != 0)
+			--shard -> max_load;
+	}
+	d_concurrent_shard_unlock(shard);
+	return slot != MAX_SIZE_T_VALUE;
+}
+
+usize			d_concurrent_map_get_len	(DConcurrentMap* map_)
+{
+	DRealConcurrentMap* map = (DRealConcurrentMap*)map_;
+	usize len = 0;
+	for (usize i = 0; i <= map -> shard_mask; ++i)
+		len += __atomic_load_n(&map -> shards[i].len, __ATOMIC_RELAXED);
+	return len;
+}
+
+void			d_concurrent_map_destroy	(DConcurrentMap** map_)
+{
+	if (map_ == NULL || *map_ == NULL)
+		return;
+	DRealConcurrentMap* map = (DRealConcurrentMap*)*map_;
+	for (usize i = 0; i <= map -> shard_mask; ++i)
+	{
+		DConcurrentShard* shard = map -> shards + i;
+		free(shard -> table);
+		while (shard -> retired != NULL)
+		{
+			DConcurrentTable* next = shard -> retired -> next;
+			free(shard -> retired);
+			shard -> retired = next;
+		}
+	}
+	free(map -> shards);
+	free(map);
+	*map_ = NULL;
+}
@@ -1 +1,323 @@
-#include "dhash.h"
\ No newline at end of file
+#include <dhash.h>
+#include <dhash_func.h>
+#include <dstring.h>
+#include <string.h>
+#include "dhash_group.h"
+
+typedef struct _DRealHashMap DRealHashMap;
+
+//REAL HASH MAP STRUCTURE ALLOCATED
+struct _DRealHashMap {
+	usize			len;
+	usize			groups; /* number of groups, always a power of two or 0 before the first insertion */
+	usize			max_load; /* number of entries the map can hold before it grows or cleans its overflow bytes */
+	u8*				ctrl; /* 16 bytes of metadata per group, followed by the slots */
+	u8*				slots;
+	usize			key_size;
+	usize			value_size;
+	usize			value_offset; /* offset of the value inside a slot */
+	usize			slot_size;
+	DHashFunc		hash;
+	DEqualFunc		equal;
+	DestroyElemFunc	key_destroy;
+	DestroyElemFunc	value_destroy;
+	const DAllocator*	allocator;
+};
+
+DHashMap*	d_hash_map_new				(usize key_size, usize value_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc key_destroy, DestroyElemFunc value_destroy)
+{
+	return d_hash_map_new_with_allocator(key_size, value_size, hash, equal, key_destroy, value_destroy, NULL);
+}
+
+DHashMap*	d_hash_map_new_with_allocator(usize key_size, usize value_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc key_destroy, DestroyElemFunc value_destroy,
+											const DAllocator* allocator)
+{
+	if (key_size == 0 || key_size > MAX_SIZE_T_VALUE / 4 || value_size > MAX_SIZE_T_VALUE / 4)
+		return NULL;
+	DRealHashMap* map = d_alloc(allocator, sizeof(DRealHashMap));
+	if (map == NULL)
+		return NULL;
+	usize key_alignment = d_hash_alignment(key_size);
+	usize value_alignment = value_size == 0 ? 1 : d_hash_alignment(value_size);
+	usize slot_alignment = key_alignment > value_alignment ? key_alignment : value_alignment;
+	map -> len = 0;
+	map -> groups = 0;
+	map -> max_load = 0;
+	map -> ctrl = NULL;
+	map -> slots = NULL;
+	map -> key_size = key_size;
+	map -> value_size = value_size;
+	map -> value_offset = (key_size + value_alignment - 1) & ~(value_alignment - 1);
+	map -> slot_size = (map -> value_offset + value_size + slot_alignment - 1) & ~(slot_alignment - 1);
+	map -> hash = hash;
+	map -> equal = equal;
+	map -> key_destroy = key_destroy;
+	map -> value_destroy = value_destroy;
+	map -> allocator = allocator;
+	return (DHashMap*)map;
+}
+
+//Moves every entry to a new block of `groups` groups, the overflow bytes are rebuilt from scratch
+static bool	d_hash_rehash(DRealHashMap* map, usize groups)
+{
+	usize size = d_hash_block_size(groups, map -> slot_size, 0);
+	if (groups == 0 || size == 0)
+		return false;
+	u8* block = d_alloc(map -> allocator, size);
+	if (block == NULL)
+		return false;
+	DRealHashMap old = *map;
+	memset(block, 0, groups * D_HASH_GROUP_SIZE);
+	map -> groups = groups;
+	map -> ctrl = block;
+	map -> slots = block + groups * D_HASH_GROUP_SIZE;
+	map -> max_load = d_hash_max_load(groups);
+	usize group = 0;
+	u32 full = d_hash_first_full(old.ctrl, old.groups);
+	for (usize i; (i = d_hash_next_full(old.ctrl, old.groups, &group, &full)) != MAX_SIZE_T_VALUE;)
+	{
+		u8* entry = d_hash_slot(&old, i);
+		u64 h = d_hash_mix(map -> hash(entry));
+		usize slot = d_hash_find_empty(map -> ctrl, groups, h);
+		d_hash_set_ctrl(map -> ctrl, slot, d_hash_tag(h));
+		memcpy(d_hash_slot(map, slot), entry, map -> slot_size);
+	}
+	if (old.ctrl != NULL)
+		d_free(map -> allocator, old.ctrl, d_hash_block_size(old.groups, old.slot_size, 0));
+	return true;
+}
+
+//Index of the slot holding `key`, MAX_SIZE_T_VALUE if it is not present
+static inline usize	d_hash_find(DRealHashMap* map, const void* key, u64 h)
+{
+	if (map -> groups == 0)
+		return MAX_SIZE_T_VALUE;
+	DHashProbe probe;
+	d_hash_probe_init(&probe, map -> ctrl, map -> groups, h);
+	usize slot;
+	while ((slot = d_hash_probe_next(&probe, map -> ctrl)) != MAX_SIZE_T_VALUE
+		&& map -> equal(key, d_hash_slot(map, slot)) == false)
+		;
+	return slot;
+}
+
+//Finds the slot of `key`, inserting a copy of the key in an empty slot if it is not present
+static u8*	d_hash_find_or_insert(DRealHashMap* map, const void* key, bool* inserted)
+{
+	u64 h = d_hash_mix(map -> hash(key));
+	usize slot = d_hash_find(map, key, h);
+	if (slot != MAX_SIZE_T_VALUE)
+	{
+		*inserted = false;
+		return d_hash_slot(map, slot);
+	}
+	//the slack keeps a rehash triggered by deletions from being followed by another one right away
+	if (map -> len >= map -> max_load && d_hash_rehash(map, d_hash_groups_for(map -> len + map -> len / 8 + 1)) == false)
+		return NULL;
+	slot = d_hash_find_empty(map -> ctrl, map -> groups, h);
+	d_hash_set_ctrl(map -> ctrl, slot, d_hash_tag(h));
+	u8* entry = d_hash_slot(map, slot);
+	memcpy(entry, key, map -> key_size);
+	++map -> len;
+	*inserted = true;
+	return entry;
+}
+
+void*		d_hash_map_insert			(DHashMap* map_, const void* key, const void* value)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	bool inserted;
+	u8* entry = d_hash_find_or_insert(map, key, &inserted);
+	if (entry == NULL)
+		return NULL;
+	void* slot_value = entry + map -> value_offset;
+	if (inserted == false)
+	{
+		if (map -> key_destroy != NULL)
+			map -> key_destroy((void*)key);
+		if (map -> value_destroy != NULL)
+			map -> value_destroy(slot_value);
+	}
+	if (value != NULL)
+		memcpy(slot_value, value, map -> value_size);
+	else
+		memset(slot_value, 0, map -> value_size);
+	return slot_value;
+}
+
+void*		d_hash_map_emplace			(DHashMap* map_, const void* key, bool* inserted)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	bool was_inserted;
+	u8* entry = d_hash_find_or_insert(map, key, &was_inserted);
+	if (entry == NULL)
+		return NULL;
+	if (was_inserted == true)
+		memset(entry + map -> value_offset, 0, map -> value_size);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return entry + map -> value_offset;
+}
+
+void*		d_hash_map_get				(DHashMap* map_, const void* key)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	usize slot = d_hash_find(map, key, d_hash_mix(map -> hash(key)));
+	return slot == MAX_SIZE_T_VALUE ? NULL : d_hash_slot(map, slot) + map -> value_offset;
+}
+
+void*		d_hash_map_get_key			(DHashMap* map_, const void* key)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	usize slot = d_hash_find(map, key, d_hash_mix(map -> hash(key)));
+	return slot == MAX_SIZE_T_VALUE ? NULL : d_hash_slot(map, slot);
+}
+
+bool		d_hash_map_contains			(DHashMap* map, const void* key)
+{
+	return d_hash_map_get_key(map, key) != NULL;
+}
+
+//Empties a slot. A group that overflowed may still be on the probe sequence of a key inserted past it, so its
+//overflow bit cannot be cleared: the map instead grows one step closer to a rehash, which rebuilds them
+static void	d_hash_erase(DRealHashMap* map, usize slot)
+{
+	u8* entry = d_hash_slot(map, slot);
+	if (map -> key_destroy != NULL)
+		map -> key_destroy(entry);
+	if (map -> value_destroy != NULL)
+		map -> value_destroy(entry + map -> value_offset);
+	d_hash_set_ctrl(map -> ctrl, slot, 0);
+	--map -> len;
+	if (d_hash_group_ctrl(map, slot / D_HASH_GROUP_SLOTS)[D_HASH_OVERFLOW] != 0)
+		--map -> max_load;
+}
+
+bool		d_hash_map_remove			(DHashMap* map_, const void* key)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	usize slot = d_hash_find(map, key, d_hash_mix(map -> hash(key)));
+	if (slot == MAX_SIZE_T_VALUE)
+		return false;
+	d_hash_erase(map, slot);
+	return true;
+}
+
+DHashMap*	d_hash_map_reserve			(DHashMap* map_, usize count)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	if (count <= map -> max_load)
+		return map_;
+	if (d_hash_rehash(map, d_hash_groups_for(count)) == false)
+		return NULL;
+	return map_;
+}
+
+usize		d_hash_map_get_capacity		(DHashMap* map_)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	return map -> max_load;
+}
+
+//Calls the destroy functions on every entry
+static void	d_hash_destroy_entries(DRealHashMap* map)
+{
+	if ((map -> key_destroy == NULL && map -> value_destroy == NULL) || map -> len == 0)
+		return;
+	usize group = 0;
+	u32 full = d_hash_first_full(map -> ctrl, map -> groups);
+	for (usize i; (i = d_hash_next_full(map -> ctrl, map -> groups, &group, &full)) != MAX_SIZE_T_VALUE;)
+	{
+		u8* entry = d_hash_slot(map, i);
+		if (map -> key_destroy != NULL)
+			map -> key_destroy(entry);
+		if (map -> value_destroy != NULL)
+			map -> value_destroy(entry + map -> value_offset);
+	}
+}
+
+void		d_hash_map_clear			(DHashMap* map_)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	d_hash_destroy_entries(map);
+	if (map -> groups != 0)
+		memset(map -> ctrl, 0, map -> groups * D_HASH_GROUP_SIZE);
+	map -> len = 0;
+	map -> max_load = d_hash_max_load(map -> groups);
+}
+
+void		d_hash_map_destroy			(DHashMap** map_)
+{
+	if (map_ == NULL || *map_ == NULL)
+		return;
+	DRealHashMap* map = (DRealHashMap*)*map_;
+	d_hash_destroy_entries(map);
+	if (map -> ctrl != NULL)
+		d_free(map -> allocator, map -> ctrl, d_hash_block_size(map -> groups, map -> slot_size, 0));
+	d_free(map -> allocator, map, sizeof(DRealHashMap));
+	*map_ = NULL;
+}
+
+void		d_hash_map_iter_init		(DHashMapIter* it, DHashMap* map_)
+{
+	DRealHashMap* map = (DRealHashMap*)map_;
+	it -> map = map_;
+	it -> group = 0;
+	it -> mask = d_hash_first_full(map -> ctrl, map -> groups);
+	it -> slot = MAX_SIZE_T_VALUE;
+}
+
+bool		d_hash_map_iter_next		(DHashMapIter* it, void** key, void** value)
+{
+	DRealHashMap* map = (DRealHashMap*)it -> map;
+	usize slot = d_hash_next_full(map -> ctrl, map -> groups, &it -> group, &it -> mask);
+	if (slot == MAX_SIZE_T_VALUE)
+		return false;
+	it -> slot = slot;
+	u8* entry = d_hash_slot(map, it -> slot);
+	if (key != NULL)
+		*key = entry;
+	if (value != NULL)
+		*value = entry + map -> value_offset;
+	return true;
+}
+
+void		d_hash_map_iter_remove		(DHashMapIter* it)
+{
+	d_hash_erase((DRealHashMap*)it -> map, it -> slot);
+}
+
+u64			d_hash_u64_key				(const void* key)
+{
+	return *(const u64*)key;
+}
+
+bool		d_equal_u64_key				(const void* key1, const void* key2)
+{
+	return *(const u64*)key1 == *(const u64*)key2;
+}
+
+u64			d_hash_c_string_key			(const void* key)
+{
+	return d_hash_c_string(*(const char* const*)key, 0);
+}
+
+bool		d_equal_c_string_key		(const void* key1, const void* key2)
+{
+	return strcmp(*(const char* const*)key1, *(const char* const*)key2) == 0;
+}
+
+u64			d_hash_dstring_key			(const void* key)
+{
+	const DString* dstring = *(const DString* const*)key;
+	return d_hash_bytes(dstring -> string, dstring -> len, 0);
+}
+
+bool		d_equal_dstring_key			(const void* key1, const void* key2)
+{
+	const DString* dstring1 = *(const DString* const*)key1;
+	const DString* dstring2 = *(const DString* const*)key2;
+	return dstring1 -> len == dstring2 -> len && memcmp(dstring1 -> string, dstring2 -> string, dstring1 -> len) == 0;
+}
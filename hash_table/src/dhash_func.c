@@ -0,0 +1,356 @@
+#include <dhash_func.h>
+#include <dstring.h>
+#include <string.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+# include <immintrin.h>
+# define D_HASH_AVX2
+#endif
+
+//CONSTANTS OF THE SHORT AND MEDIUM INPUTS (WYHASH)
+#define D_HASH_S0 0xa0761d6478bd642fULL
+#define D_HASH_S1 0xe7037ed1a0b428dbULL
+#define D_HASH_S2 0x8ebc6af09c88c6e3ULL
+#define D_HASH_S3 0x589965cc75374cc3ULL
+
+//CONSTANTS OF THE BULK INPUTS (XXH3)
+#define D_HASH_PRIME32_1 0x9e3779b1U
+#define D_HASH_PRIME32_2 0x85ebca77U
+#define D_HASH_PRIME32_3 0xc2b2ae3dU
+#define D_HASH_PRIME64_1 0x9e3779b185ebca87ULL
+#define D_HASH_PRIME64_2 0xc2b2ae3d27d4eb4fULL
+#define D_HASH_PRIME64_3 0x165667b19e3779f9ULL
+#define D_HASH_PRIME64_4 0x85ebca77c2b2ae63ULL
+#define D_HASH_PRIME64_5 0x27d4eb2f165667c5ULL
+
+//A STRIPE IS ACCUMULATED WITH THE SECRET SHIFTED BY 8 BYTES FROM THE PREVIOUS ONE, THE LAST 64 BYTES SCRAMBLE A BLOCK
+#define D_HASH_STRIPE 64
+#define D_HASH_STRIPES_PER_BLOCK 16
+#define D_HASH_BLOCK (D_HASH_STRIPE * D_HASH_STRIPES_PER_BLOCK)
+#define D_HASH_SECRET_SIZE 192
+#define D_HASH_SCRAMBLE_OFFSET (D_HASH_SECRET_SIZE - D_HASH_STRIPE)
+#define D_HASH_LAST_STRIPE_OFFSET (D_HASH_SECRET_SIZE - D_HASH_STRIPE - 7)
+
+static const u64	d_hash_secret[D_HASH_SECRET_SIZE / sizeof(u64)] = {
+	0x2cb0f69f4abea221ULL, 0x9417034723148989ULL, 0xdd555950609dfe03ULL, 0xdbafb150deb12800ULL,
+	0x7e789b2e6c442cb6ULL, 0xf41e5636c7e4f8c4ULL, 0x0959d150f8fba7e4ULL, 0xa97316f13cdb9eeaULL,
+	0x74cd8258f9520068ULL, 0x55c74a62e116868bULL, 0xd2f4c799a2023cbdULL, 0xdf98cb79a37b51b9ULL,
+	0x396f5885524f3905ULL, 0xaf1d56386ca3b276ULL, 0xa9ffbe6b5104e85aULL, 0x6bd0c51b9fd533b3ULL,
+	0x980ce91c50ab4b56ULL, 0x28ac395780fe62c5ULL, 0x768912e3a6bcedc7ULL, 0x50b3e8c9332c7c88ULL,
+	0xce3bbfe520bd47daULL, 0xcba6c8e8e0bb7c4fULL, 0xbf194db8434a346dULL, 0x7d8f2a7b60416d7fULL,
+};
+
+static inline u64	d_hash_read64(const u8* p)
+{
+	u64 v;
+	memcpy(&v, p, sizeof(u64));
+	return v;
+}
+
+static inline u64	d_hash_read32(const u8* p)
+{
+	u32 v;
+	memcpy(&v, p, sizeof(u32));
+	return v;
+}
+
+//64x64 -> 128 bits multiplication folded back to 64 bits
+static inline u64	d_hash_fold(u64 a, u64 b)
+{
+	__uint128_t r = (__uint128_t)a * b;
+	return (u64)r ^ (u64)(r >> 64);
+}
+
+//Seeds are mixed once, the batch functions do it for all their keys
+static inline u64	d_hash_seed(u64 seed)
+{
+	return seed ^ d_hash_fold(seed ^ D_HASH_S0, D_HASH_S1);
+}
+
+/* ========================================================================= */
+/*                               BULK INPUTS                                 */
+/* ========================================================================= */
+
+//Accumulates `stripes` consecutive stripes of 64 bytes into the eight lanes
+static inline void	d_hash_accumulate(u64* acc, const u8* p, usize stripes, const u8* secret)
+{
+#ifdef __SSE2__
+	__m128i lanes[4];
+	for (usize i = 0; i < 4; ++i)
+		lanes[i] = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+	for (usize s = 0; s < stripes; ++s, p += D_HASH_STRIPE, secret += sizeof(u64))
+	{
+		for (usize i = 0; i < 4; ++i)
+		{
+			__m128i data = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+			__m128i data_key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*)(secret + 16 * i)));
+			//multiplies the low and high halves of each 64-bit lane of data_key
+			__m128i product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+			//the raw data is added to the other lane so no input bit is lost when a half is zero
+			__m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+			lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+		}
+	}
+	for (usize i = 0; i < 4; ++i)
+		_mm_storeu_si128((__m128i*)(acc + 2 * i), lanes[i]);
+#else
+	for (usize s = 0; s < stripes; ++s, p += D_HASH_STRIPE, secret += sizeof(u64))
+	{
+		for (usize j = 0; j < 8; ++j)
+		{
+			u64 data = d_hash_read64(p + 8 * j);
+			u64 data_key = data ^ d_hash_read64(secret + 8 * j);
+			acc[j ^ 1] += data;
+			acc[j] += (data_key & 0xffffffffULL) * (data_key >> 32);
+		}
+	}
+#endif
+}
+
+//Scrambles the lanes at the end of a block, so no difference can cancel out through the additions
+static inline void	d_hash_scramble(u64* acc, const u8* secret)
+{
+#ifdef __SSE2__
+	__m128i prime = _mm_set1_epi32((int)D_HASH_PRIME32_1);
+	for (usize i = 0; i < 4; ++i)
+	{
+		__m128i lane = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+		lane = _mm_xor_si128(lane, _mm_srli_epi64(lane, 47));
+		lane = _mm_xor_si128(lane, _mm_loadu_si128((const __m128i*)(secret + 16 * i)));
+		__m128i low = _mm_mul_epu32(lane, prime);
+		__m128i high = _mm_mul_epu32(_mm_srli_epi64(lane, 32), prime);
+		_mm_storeu_si128((__m128i*)(acc + 2 * i), _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+	}
+#else
+	for (usize j = 0; j < 8; ++j)
+	{
+		u64 lane = acc[j];
+		lane ^= lane >> 47;
+		lane ^= d_hash_read64(secret + 8 * j);
+		acc[j] = lane * D_HASH_PRIME32_1;
+	}
+#endif
+}
+
+#ifdef D_HASH_AVX2
+//Same as `d_hash_accumulate` and `d_hash_scramble` with two lanes per register, built for AVX2 whatever the
+//flags of the library are and only called when the CPU supports it
+__attribute__((target("avx2")))
+static void	d_hash_accumulate_avx2(u64* acc, const u8* p, usize stripes, const u8* secret)
+{
+	__m256i lanes[2];
+	for (usize i = 0; i < 2; ++i)
+		lanes[i] = _mm256_loadu_si256((const __m256i*)(acc + 4 * i));
+	for (usize s = 0; s < stripes; ++s, p += D_HASH_STRIPE, secret += sizeof(u64))
+	{
+		for (usize i = 0; i < 2; ++i)
+		{
+			__m256i data = _mm256_loadu_si256((const __m256i*)(p + 32 * i));
+			__m256i data_key = _mm256_xor_si256(data, _mm256_loadu_si256((const __m256i*)(secret + 32 * i)));
+			__m256i product = _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+			__m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+			lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+		}
+	}
+	for (usize i = 0; i < 2; ++i)
+		_mm256_storeu_si256((__m256i*)(acc + 4 * i), lanes[i]);
+}
+
+__attribute__((target("avx2")))
+static void	d_hash_scramble_avx2(u64* acc, const u8* secret)
+{
+	__m256i prime = _mm256_set1_epi32((int)D_HASH_PRIME32_1);
+	for (usize i = 0; i < 2; ++i)
+	{
+		__m256i lane = _mm256_loadu_si256((const __m256i*)(acc + 4 * i));
+		lane = _mm256_xor_si256(lane, _mm256_srli_epi64(lane, 47));
+		lane = _mm256_xor_si256(lane, _mm256_loadu_si256((const __m256i*)(secret + 32 * i)));
+		__m256i low = _mm256_mul_epu32(lane, prime);
+		__m256i high = _mm256_mul_epu32(_mm256_srli_epi64(lane, 32), prime);
+		_mm256_storeu_si256((__m256i*)(acc + 4 * i), _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+	}
+}
+
+__attribute__((target("avx2")))
+static void	d_hash_blocks_avx2(u64* acc, const u8* p, usize blocks, const u8* secret)
+{
+	for (usize b = 0; b < blocks; ++b)
+	{
+		d_hash_accumulate_avx2(acc, p + b * D_HASH_BLOCK, D_HASH_STRIPES_PER_BLOCK, secret);
+		d_hash_scramble_avx2(acc, secret + D_HASH_SCRAMBLE_OFFSET);
+	}
+}
+#endif
+
+static u64	d_hash_bulk(const u8* p, usize len, u64 seed)
+{
+	const u8* secret = (const u8*)d_hash_secret;
+	u64 acc[8] = {
+		D_HASH_PRIME32_3 + seed, D_HASH_PRIME64_1 - seed, D_HASH_PRIME64_2 + seed, D_HASH_PRIME64_3 - seed,
+		D_HASH_PRIME64_4 + seed, D_HASH_PRIME32_2 - seed, D_HASH_PRIME64_5 + seed, D_HASH_PRIME32_1 - seed,
+	};
+	usize blocks = (len - 1) / D_HASH_BLOCK;
+#ifdef D_HASH_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		d_hash_blocks_avx2(acc, p, blocks, secret);
+	else
+#endif
+	for (usize b = 0; b < blocks; ++b)
+	{
+		d_hash_accumulate(acc, p + b * D_HASH_BLOCK, D_HASH_STRIPES_PER_BLOCK, secret);
+		d_hash_scramble(acc, secret + D_HASH_SCRAMBLE_OFFSET);
+	}
+	usize stripes = (len - 1 - blocks * D_HASH_BLOCK) / D_HASH_STRIPE;
+	d_hash_accumulate(acc, p + blocks * D_HASH_BLOCK, stripes, secret);
+	//the last stripe always ends on the last byte, overlapping the previous one if needed
+	d_hash_accumulate(acc, p + len - D_HASH_STRIPE, 1, secret + D_HASH_LAST_STRIPE_OFFSET);
+	u64 h = len * D_HASH_PRIME64_1 ^ seed;
+	for (usize i = 0; i < 4; ++i)
+		h += d_hash_fold(acc[2 * i] ^ d_hash_read64(secret + 11 + 16 * i), acc[2 * i + 1] ^ d_hash_read64(secret + 19 + 16 * i));
+	h ^= h >> 37;
+	h *= 0x165667919e3779f9ULL;
+	h ^= h >> 32;
+	return h;
+}
+
+/* ========================================================================= */
+/*                          SHORT AND MEDIUM INPUTS                          */
+/* ========================================================================= */
+
+//Loads an input of at most 16 bytes as two words, two pairs of overlapping loads cover any length from 4 to 16
+static inline void	d_hash_load_short(const u8* p, usize len, u64* a, u64* b)
+{
+	if (len >= 4)
+	{
+		usize shift = (len >> 3) << 2;
+		*a = (d_hash_read32(p) << 32) | d_hash_read32(p + shift);
+		*b = (d_hash_read32(p + len - 4) << 32) | d_hash_read32(p + len - 4 - shift);
+	}
+	else if (len > 0)
+	{
+		*a = ((u64)p[0] << 16) | ((u64)p[len >> 1] << 8) | p[len - 1];
+		*b = 0;
+	}
+	else
+		*a = *b = 0;
+}
+
+static inline u64	d_hash_finish(u64 a, u64 b, usize len, u64 seed)
+{
+	__uint128_t r = (__uint128_t)(a ^ D_HASH_S1) * (b ^ seed);
+	return d_hash_fold((u64)r ^ D_HASH_S0 ^ len, (u64)(r >> 64) ^ D_HASH_S1);
+}
+
+//Hash of `len` bytes with an already mixed seed
+static inline __attribute__((always_inline)) u64	d_hash_premixed(const u8* p, usize len, u64 seed)
+{
+	u64 a;
+	u64 b;
+	if (len <= 16)
+	{
+		d_hash_load_short(p, len, &a, &b);
+		return d_hash_finish(a, b, len, seed);
+	}
+	if (len >= D_HASH_BULK_THRESHOLD)
+		return d_hash_bulk(p, len, seed);
+	usize rest = len;
+	if (rest > 48)
+	{
+		//three independent lanes keep three multiplications in flight
+		u64 lane1 = seed;
+		u64 lane2 = seed;
+		do
+		{
+			seed = d_hash_fold(d_hash_read64(p) ^ D_HASH_S1, d_hash_read64(p + 8) ^ seed);
+			lane1 = d_hash_fold(d_hash_read64(p + 16) ^ D_HASH_S2, d_hash_read64(p + 24) ^ lane1);
+			lane2 = d_hash_fold(d_hash_read64(p + 32) ^ D_HASH_S3, d_hash_read64(p + 40) ^ lane2);
+			p += 48;
+			rest -= 48;
+		} while (rest > 48);
+		seed ^= lane1 ^ lane2;
+	}
+	for (; rest > 16; rest -= 16, p += 16)
+		seed = d_hash_fold(d_hash_read64(p) ^ D_HASH_S1, d_hash_read64(p + 8) ^ seed);
+	//the last 16 bytes of the input, overlapping the ones already mixed if needed
+	a = d_hash_read64(p + rest - 16);
+	b = d_hash_read64(p + rest - 8);
+	return d_hash_finish(a, b, len, seed);
+}
+
+u64		d_hash_bytes		(const void* data, usize len, u64 seed)
+{
+	return d_hash_premixed(data, len, d_hash_seed(seed));
+}
+
+u64		d_hash_c_string		(const char* str, u64 seed)
+{
+	return d_hash_premixed((const u8*)str, strlen(str), d_hash_seed(seed));
+}
+
+/* ========================================================================= */
+/*                                 BATCHES                                   */
+/* ========================================================================= */
+
+#define D_HASH_BATCH 4
+
+//Hashes the keys four at a time. When they are all short, which is the common case of identifiers and words,
+//the loads of the four keys are issued first and their multiplications run side by side
+static inline void	d_hash_batch(const u8** keys, const usize* lens, usize count, u64* hashes, u64 seed)
+{
+	if (count == D_HASH_BATCH && lens[0] <= 16 && lens[1] <= 16 && lens[2] <= 16 && lens[3] <= 16)
+	{
+		u64 a[D_HASH_BATCH];
+		u64 b[D_HASH_BATCH];
+		for (usize k = 0; k < D_HASH_BATCH; ++k)
+			d_hash_load_short(keys[k], lens[k], a + k, b + k);
+		for (usize k = 0; k < D_HASH_BATCH; ++k)
+			hashes[k] = d_hash_finish(a[k], b[k], lens[k], seed);
+		return;
+	}
+	for (usize i = 0; i < count; ++i)
+		hashes[i] = d_hash_premixed(keys[i], lens[i], seed);
+}
+
+void	d_hash_c_strings	(const DPointerArray* strings, u64* hashes, u64 seed)
+{
+	const u8* keys[D_HASH_BATCH];
+	usize lens[D_HASH_BATCH];
+	seed = d_hash_seed(seed);
+	for (usize i = 0; i < strings -> len; i += D_HASH_BATCH)
+	{
+		usize count = strings -> len - i < D_HASH_BATCH ? strings -> len - i : D_HASH_BATCH;
+		for (usize k = 0; k < count; ++k)
+		{
+			keys[k] = strings -> pdata[i + k];
+			lens[k] = strlen((const char*)keys[k]);
+		}
+		if (i + 2 * D_HASH_BATCH <= strings -> len)
+			for (usize k = 0; k < D_HASH_BATCH; ++k)
+				__builtin_prefetch(strings -> pdata[i + D_HASH_BATCH + k]);
+		d_hash_batch(keys, lens, count, hashes + i, seed);
+	}
+}
+
+void	d_hash_dstrings		(const DPointerArray* strings, u64* hashes, u64 seed)
+{
+	const u8* keys[D_HASH_BATCH];
+	usize lens[D_HASH_BATCH];
+	seed = d_hash_seed(seed);
+	for (usize i = 0; i < strings -> len; i += D_HASH_BATCH)
+	{
+		usize count = strings -> len - i < D_HASH_BATCH ? strings -> len - i : D_HASH_BATCH;
+		for (usize k = 0; k < count; ++k)
+		{
+			const DString* dstring = strings -> pdata[i + k];
+			keys[k] = (const u8*)dstring -> string;
+			lens[k] = dstring -> len;
+		}
+		//the headers of the next batch are needed first, their chars right after
+		if (i + 2 * D_HASH_BATCH <= strings -> len)
+			for (usize k = 0; k < D_HASH_BATCH; ++k)
+				__builtin_prefetch(strings -> pdata[i + D_HASH_BATCH + k]);
+		d_hash_batch(keys, lens, count, hashes + i, seed);
+	}
+}
@@ -0,0 +1,191 @@
+#ifndef __D_HASH_GROUP__H
+#define __D_HASH_GROUP__H
+
+/*
+ * Private to the hash_table module: the group metadata layout and the SIMD probing primitives
+ * shared by the maps of the module. See `DHashMap` for the description of the layout.
+ */
+
+#include <dtypes.h>
+#include <dhash.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+//SIZE OF THE METADATA OF A GROUP, THE LAST BYTE IS THE OVERFLOW BYTE
+#define D_HASH_GROUP_SIZE 16
+#define D_HASH_OVERFLOW D_HASH_GROUP_SLOTS
+#define D_HASH_GROUP_MASK ((1u << D_HASH_GROUP_SLOTS) - 1)
+
+//SLOTS AND METADATA OF A MAP, BOTH MAPS NAME THEIR FIELDS THE SAME WAY
+#define d_hash_slot(map, i) ((map) -> slots + (i) * (map) -> slot_size)
+#define d_hash_group_ctrl(map, g) ((map) -> ctrl + (g) * D_HASH_GROUP_SIZE)
+
+//THE HIGH BITS GIVE THE 7-BIT TAG, THE LOW BITS THE HOME GROUP, THE MIDDLE ONES THE OVERFLOW BIT
+#define d_hash_tag(h) ((u8)(((h) >> 57) | 0x80))
+#define d_hash_overflow_bit(h) ((u8)(1u << (((h) >> 32) & 7)))
+
+//Final mixer of murmur3, spreads the entropy of weak user hashes over the 64 bits
+static inline u64	d_hash_mix(u64 h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+//Mask of the slots of a group whose control byte is `tag`
+static inline u32	d_hash_group_match(const u8* ctrl, u8 tag)
+{
+#ifdef __SSE2__
+	__m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+	return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag))) & D_HASH_GROUP_MASK;
+#else
+	u32 mask = 0;
+	for (u32 i = 0; i < D_HASH_GROUP_SLOTS; ++i)
+		mask |= (u32)(ctrl[i] == tag) << i;
+	return mask;
+#endif
+}
+
+//Mask of the full slots of a group, their control byte has its high bit set
+static inline u32	d_hash_group_full(const u8* ctrl)
+{
+#ifdef __SSE2__
+	return (u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl)) & D_HASH_GROUP_MASK;
+#else
+	u32 mask = 0;
+	for (u32 i = 0; i < D_HASH_GROUP_SLOTS; ++i)
+		mask |= (u32)(ctrl[i] >> 7) << i;
+	return mask;
+#endif
+}
+
+#define d_hash_group_empty(ctrl) (~d_hash_group_full(ctrl) & D_HASH_GROUP_MASK)
+
+//Sets the control byte of a slot
+static inline void	d_hash_set_ctrl(u8* ctrl, usize slot, u8 value)
+{
+	ctrl[slot / D_HASH_GROUP_SLOTS * D_HASH_GROUP_SIZE + slot % D_HASH_GROUP_SLOTS] = value;
+}
+
+//Number of entries `groups` groups hold under the maximum load factor
+static inline usize	d_hash_max_load(usize groups)
+{
+	usize slots = groups * D_HASH_GROUP_SLOTS;
+	usize reserved = slots * (D_HASH_MAX_LOAD_DEN - D_HASH_MAX_LOAD_NUM);
+	return slots - (reserved + D_HASH_MAX_LOAD_DEN - 1) / D_HASH_MAX_LOAD_DEN;
+}
+
+//Smallest power of two number of groups holding `count` entries under the maximum load factor, 0 on overflow
+static inline usize	d_hash_groups_for(usize count)
+{
+	usize groups = 1;
+	while (d_hash_max_load(groups) < count)
+	{
+		if (groups > MAX_SIZE_T_VALUE / 2 / D_HASH_GROUP_SLOTS)
+			return 0;
+		groups *= 2;
+	}
+	return groups;
+}
+
+//Alignment a value of `size` bytes needs at most, the largest power of two dividing it up to 16
+static inline usize	d_hash_alignment(usize size)
+{
+	usize alignment = size & -size;
+	return alignment == 0 || alignment > 16 ? 16 : alignment;
+}
+
+//Number of bytes of a block of `header` bytes followed by the metadata and slots of `groups` groups, 0 on overflow
+static inline usize	d_hash_block_size(usize groups, usize slot_size, usize header)
+{
+	usize slots = groups * D_HASH_GROUP_SLOTS;
+	if (groups > MAX_SIZE_T_VALUE / D_HASH_GROUP_SIZE / D_HASH_GROUP_SLOTS
+		|| slots > (MAX_SIZE_T_VALUE - groups * D_HASH_GROUP_SIZE - header) / slot_size)
+		return 0;
+	return header + groups * D_HASH_GROUP_SIZE + slots * slot_size;
+}
+
+//Finds the first empty slot of the probe sequence of `h`, marking the overflow bit of the full groups passed
+static inline usize	d_hash_find_empty(u8* ctrl, usize groups, u64 h)
+{
+	usize mask = groups - 1;
+	usize g = h & mask;
+	for (usize step = 1; ; ++step)
+	{
+		u8* group = ctrl + g * D_HASH_GROUP_SIZE;
+		u32 empty = d_hash_group_empty(group);
+		if (empty != 0)
+			return g * D_HASH_GROUP_SLOTS + (usize)__builtin_ctz(empty);
+		group[D_HASH_OVERFLOW] |= d_hash_overflow_bit(h);
+		g = (g + step) & mask;
+	}
+}
+
+//POSITION IN THE PROBE SEQUENCE OF A HASH, THE SLOTS WHOSE TAG MATCHES ARE GIVEN ONE BY ONE BY d_hash_probe_next
+typedef struct {
+	usize	mask;
+	usize	group;
+	usize	step;
+	u32		match; /* slots of `group` left to give */
+	u8		tag;
+	u8		overflow;
+} DHashProbe;
+
+//Starts the probe sequence of `h` over `groups` groups, which must not be 0
+static inline void	d_hash_probe_init(DHashProbe* probe, const u8* ctrl, usize groups, u64 h)
+{
+	probe -> mask = groups - 1;
+	probe -> group = h & probe -> mask;
+	probe -> step = 1;
+	probe -> tag = d_hash_tag(h);
+	probe -> overflow = d_hash_overflow_bit(h);
+	probe -> match = d_hash_group_match(ctrl + probe -> group * D_HASH_GROUP_SIZE, probe -> tag);
+}
+
+//Next slot of the probe sequence whose tag matches, the map compares its key. MAX_SIZE_T_VALUE at the end of the
+//sequence: a group no key of this probe sequence ever went past, or after every group
+static inline usize	d_hash_probe_next(DHashProbe* probe, const u8* ctrl)
+{
+	while (probe -> match == 0)
+	{
+		const u8* group = ctrl + probe -> group * D_HASH_GROUP_SIZE;
+		if ((group[D_HASH_OVERFLOW] & probe -> overflow) == 0 || probe -> step > probe -> mask)
+			return MAX_SIZE_T_VALUE;
+		probe -> group = (probe -> group + probe -> step) & probe -> mask;
+		++probe -> step;
+		probe -> match = d_hash_group_match(ctrl + probe -> group * D_HASH_GROUP_SIZE, probe -> tag);
+	}
+	usize slot = probe -> group * D_HASH_GROUP_SLOTS + (usize)__builtin_ctz(probe -> match);
+	probe -> match &= probe -> match - 1;
+	return slot;
+}
+
+//Full slots of the first group, to start a walk over the full slots with d_hash_next_full
+static inline u32	d_hash_first_full(const u8* ctrl, usize groups)
+{
+	return groups == 0 ? 0 : d_hash_group_full(ctrl);
+}
+
+//Next full slot of a walk, `*group` being the group the walk is in and `*full` its full slots not given yet.
+//MAX_SIZE_T_VALUE once every group was walked, `*group` is `groups` then
+static inline usize	d_hash_next_full(const u8* ctrl, usize groups, usize* group, u32* full)
+{
+	while (*full == 0)
+	{
+		if (++*group >= groups)
+		{
+			*group = groups;
+			return MAX_SIZE_T_VALUE;
+		}
+		*full = d_hash_group_full(ctrl + *group * D_HASH_GROUP_SIZE);
+	}
+	usize slot = *group * D_HASH_GROUP_SLOTS + (usize)__builtin_ctz(*full);
+	*full &= *full - 1;
+	return slot;
+}
+
+#endif
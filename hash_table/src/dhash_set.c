@@ -0,0 +1,347 @@
+#include <dhash_set.h>
+#include <string.h>
+#include "dhash_group.h"
+
+typedef struct _DRealHashSet DRealHashSet;
+
+//REAL HASH SET STRUCTURE ALLOCATED
+struct _DRealHashSet {
+	usize			len;
+	usize			elem_size;
+	usize			buckets; /* number of buckets, always a power of two or 0 before the first insertion */
+	usize			max_load; /* number of elements the set can hold before it grows */
+	u16*			meta; /* fingerprint in the high byte, distance to the home bucket + 1 in the low byte, 0 if empty */
+	u8*				elems;
+	DHashFunc		hash;
+	DEqualFunc		equal;
+	DestroyElemFunc	elem_destroy;
+	const DAllocator*	allocator;
+};
+
+#define D_HASH_SET_MIN_BUCKETS 16
+#define D_HASH_SET_MAX_DISTANCE 0xff
+
+//THE LOW BITS GIVE THE HOME BUCKET, THE HIGH BYTE THE FINGERPRINT
+#define d_hash_set_elem(set, i) ((set) -> elems + (i) * (set) -> elem_size)
+#define d_hash_set_fingerprint(h) ((u16)(((h) >> 56) << 8))
+#define d_hash_set_distance(meta) ((meta) & D_HASH_SET_MAX_DISTANCE)
+
+DHashSet*	d_hash_set_new				(usize elem_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc elem_destroy)
+{
+	return d_hash_set_new_with_allocator(elem_size, hash, equal, elem_destroy, NULL);
+}
+
+DHashSet*	d_hash_set_new_with_allocator(usize elem_size, DHashFunc hash, DEqualFunc equal,
+											DestroyElemFunc elem_destroy, const DAllocator* allocator)
+{
+	if (elem_size == 0 || elem_size > MAX_SIZE_T_VALUE / 4)
+		return NULL;
+	DRealHashSet* set = d_alloc(allocator, sizeof(DRealHashSet));
+	if (set == NULL)
+		return NULL;
+	set -> len = 0;
+	set -> elem_size = elem_size;
+	set -> buckets = 0;
+	set -> max_load = 0;
+	set -> meta = NULL;
+	set -> elems = NULL;
+	set -> hash = hash;
+	set -> equal = equal;
+	set -> elem_destroy = elem_destroy;
+	set -> allocator = allocator;
+	return (DHashSet*)set;
+}
+
+static inline usize	d_hash_set_max_load(usize buckets)
+{
+	return buckets - buckets / D_HASH_MAX_LOAD_DEN * (D_HASH_MAX_LOAD_DEN - D_HASH_MAX_LOAD_NUM);
+}
+
+//Smallest number of buckets holding `count` elements, 0 on overflow
+static usize	d_hash_set_buckets_for(usize count)
+{
+	usize buckets = D_HASH_SET_MIN_BUCKETS;
+	while (d_hash_set_max_load(buckets) < count)
+	{
+		if (buckets > MAX_SIZE_T_VALUE / 4)
+			return 0;
+		buckets *= 2;
+	}
+	return buckets;
+}
+
+//Offset of the elements in a block, right after the metadata
+static inline usize	d_hash_set_elems_offset(DRealHashSet* set, usize buckets)
+{
+	usize alignment = d_hash_alignment(set -> elem_size);
+	return (buckets * sizeof(u16) + alignment - 1) & ~(alignment - 1);
+}
+
+//Number of bytes of the metadata and elements of `buckets` buckets, 0 on overflow
+static usize	d_hash_set_block_size(DRealHashSet* set, usize buckets)
+{
+	usize offset = d_hash_set_elems_offset(set, buckets);
+	if (buckets > (MAX_SIZE_T_VALUE - offset) / set -> elem_size)
+		return 0;
+	return offset + buckets * set -> elem_size;
+}
+
+//Index of the bucket holding `elem`, MAX_SIZE_T_VALUE if it is not present
+static inline usize	d_hash_set_find(DRealHashSet* set, const void* elem, u64 h)
+{
+	if (set -> buckets == 0)
+		return MAX_SIZE_T_VALUE;
+	usize mask = set -> buckets - 1;
+	usize i = h & mask;
+	u16 wanted = d_hash_set_fingerprint(h) | 1;
+	for (;;)
+	{
+		u16 meta = set -> meta[i];
+		//the run is sorted by home bucket: an element closer to its home means `elem` would have been before it
+		if (d_hash_set_distance(meta) < d_hash_set_distance(wanted))
+			return MAX_SIZE_T_VALUE;
+		if (meta == wanted && set -> equal(elem, d_hash_set_elem(set, i)))
+			return i;
+		if (d_hash_set_distance(wanted) == D_HASH_SET_MAX_DISTANCE)
+			return MAX_SIZE_T_VALUE;
+		i = (i + 1) & mask;
+		++wanted;
+	}
+}
+
+//Copies `elem`, known to be absent, into its Robin Hood position, shifting the rest of the run by one bucket.
+//Returns the bucket of the element, or MAX_SIZE_T_VALUE with the set untouched if a distance would not fit
+static usize	d_hash_set_place(DRealHashSet* set, const void* elem, u64 h)
+{
+	usize mask = set -> buckets - 1;
+	usize i = h & mask;
+	u16 distance = 1;
+	//elements of the same home are kept before it, closer ones have to make room
+	while (d_hash_set_distance(set -> meta[i]) >= distance)
+	{
+		if (distance == D_HASH_SET_MAX_DISTANCE)
+			return MAX_SIZE_T_VALUE;
+		i = (i + 1) & mask;
+		++distance;
+	}
+	//the load factor guarantees an empty bucket
+	usize empty = i;
+	while (set -> meta[empty] != 0)
+	{
+		if (d_hash_set_distance(set -> meta[empty]) == D_HASH_SET_MAX_DISTANCE)
+			return MAX_SIZE_T_VALUE;
+		empty = (empty + 1) & mask;
+	}
+	while (empty != i)
+	{
+		usize previous = (empty - 1) & mask;
+		set -> meta[empty] = set -> meta[previous] + 1;
+		memcpy(d_hash_set_elem(set, empty), d_hash_set_elem(set, previous), set -> elem_size);
+		empty = previous;
+	}
+	set -> meta[i] = d_hash_set_fingerprint(h) | distance;
+	memcpy(d_hash_set_elem(set, i), elem, set -> elem_size);
+	return i;
+}
+
+//Moves every element to a new block of `buckets` buckets, the set is left untouched on failure
+static bool	d_hash_set_rehash(DRealHashSet* set, usize buckets)
+{
+	usize size = d_hash_set_block_size(set, buckets);
+	if (buckets == 0 || size == 0)
+		return false;
+	u8* block = d_alloc(set -> allocator, size);
+	if (block == NULL)
+		return false;
+	DRealHashSet old = *set;
+	memset(block, 0, buckets * sizeof(u16));
+	set -> buckets = buckets;
+	set -> meta = (u16*)block;
+	set -> elems = block + d_hash_set_elems_offset(set, buckets);
+	set -> max_load = d_hash_set_max_load(buckets);
+	for (usize i = 0; i < old.buckets; ++i)
+	{
+		if (old.meta[i] == 0)
+			continue;
+		const u8* elem = d_hash_set_elem(&old, i);
+		if (d_hash_set_place(set, elem, d_hash_mix(set -> hash(elem))) == MAX_SIZE_T_VALUE)
+		{
+			d_free(set -> allocator, block, size);
+			*set = old;
+			return false;
+		}
+	}
+	if (old.meta != NULL)
+		d_free(set -> allocator, old.meta, d_hash_set_block_size(&old, old.buckets));
+	return true;
+}
+
+//Inserts `elem` of hash `h` if it is not present, see `d_hash_set_insert`
+static u8*	d_hash_set_insert_hashed(DRealHashSet* set, const void* elem, u64 h, bool* inserted)
+{
+	usize i = d_hash_set_find(set, elem, h);
+	if (i != MAX_SIZE_T_VALUE)
+	{
+		if (set -> elem_destroy != NULL)
+			set -> elem_destroy((void*)elem);
+		*inserted = false;
+		return d_hash_set_elem(set, i);
+	}
+	if (set -> len >= set -> max_load && d_hash_set_rehash(set, d_hash_set_buckets_for(set -> len + 1)) == false)
+		return NULL;
+	while ((i = d_hash_set_place(set, elem, h)) == MAX_SIZE_T_VALUE)
+	{
+		//a run too long for the distances is only expected from a degenerate hash at low load
+		if (set -> len < set -> buckets / 4 || d_hash_set_rehash(set, set -> buckets * 2) == false)
+			return NULL;
+	}
+	++set -> len;
+	*inserted = true;
+	return d_hash_set_elem(set, i);
+}
+
+void*		d_hash_set_insert			(DHashSet* set_, const void* elem, bool* inserted)
+{
+	DRealHashSet* set = (DRealHashSet*)set_;
+	bool was_inserted;
+	u8* stored = d_hash_set_insert_hashed(set, elem, d_hash_mix(set -> hash(elem)), &was_inserted);
+	if (stored != NULL && inserted != NULL)
+		*inserted = was_inserted;
+	return stored;
+}
+
+usize		d_hash_set_insert_many		(DHashSet* set_, const void* elems, usize count)
+{
+	DRealHashSet* set = (DRealHashSet*)set_;
+	const u8* elem = elems;
+	u64 hashes[D_HASH_SET_PREFETCH_BATCH];
+	usize added = 0;
+	while (count != 0)
+	{
+		usize batch = count < D_HASH_SET_PREFETCH_BATCH ? count : D_HASH_SET_PREFETCH_BATCH;
+		//growing now keeps the prefetched addresses valid for the whole batch
+		if (set -> len + batch > set -> max_load && d_hash_set_reserve(set_, set -> len + batch) == NULL)
+			return MAX_SIZE_T_VALUE;
+		usize mask = set -> buckets - 1;
+		for (usize k = 0; k < batch; ++k)
+		{
+			hashes[k] = d_hash_mix(set -> hash(elem + k * set -> elem_size));
+			__builtin_prefetch(set -> meta + (hashes[k] & mask));
+			__builtin_prefetch(d_hash_set_elem(set, hashes[k] & mask));
+		}
+		for (usize k = 0; k < batch; ++k)
+		{
+			bool inserted;
+			if (d_hash_set_insert_hashed(set, elem, hashes[k], &inserted) == NULL)
+				return MAX_SIZE_T_VALUE;
+			added += inserted;
+			elem += set -> elem_size;
+		}
+		count -= batch;
+	}
+	return added;
+}
+
+void*		d_hash_set_get				(DHashSet* set_, const void* elem)
+{
+	DRealHashSet* set = (DRealHashSet*)set_;
+	usize i = d_hash_set_find(set, elem, d_hash_mix(set -> hash(elem)));
+	return i == MAX_SIZE_T_VALUE ? NULL : d_hash_set_elem(set, i);
+}
+
+bool		d_hash_set_contains			(DHashSet* set, const void* elem)
+{
+	return d_hash_set_get(set, elem) != NULL;
+}
+
+bool		d_hash_set_remove			(DHashSet* set_, const void* elem)
+{
+	DRealHashSet* set = (DRealHashSet*)set_;
+	usize i = d_hash_set_find(set, elem, d_hash_mix(set -> hash(elem)));
+	if (i == MAX_SIZE_T_VALUE)
+		return false;
+	if (set -> elem_destroy != NULL)
+		set -> elem_destroy(d_hash_set_elem(set, i));
+	//backward shift: the rest of the run moves one bucket closer to home, up to an empty bucket or a home element
+	usize mask = set -> buckets - 1;
+	usize next = (i + 1) & mask;
+	while (d_hash_set_distance(set -> meta[next]) > 1)
+	{
+		set -> meta[i] = set -> meta[next] - 1;
+		memcpy(d_hash_set_elem(set, i), d_hash_set_elem(set, next), set -> elem_size);
+		i = next;
+		next = (next + 1) & mask;
+	}
+	set -> meta[i] = 0;
+	--set -> len;
+	return true;
+}
+
+DHashSet*	d_hash_set_reserve			(DHashSet* set_, usize count)
+{
+	DRealHashSet* set = (DRealHashSet*)set_;
+	if (count <= set -> max_load)
+		return set_;
+	if (d_hash_set_rehash(set, d_hash_set_buckets_for(count)) == false)
+		return NULL;
+	return set_;
+}
+
+usize		d_hash_set_get_capacity		(DHashSet* set_)
+{
+	DRealHashSet* set = (DRealHashSet*)set_;
+	return set -> max_load;
+}
+
+//Calls the destroy function on every element
+static void	d_hash_set_destroy_elems(DRealHashSet* set)
+{
+	if (set -> elem_destroy == NULL)
+		return;
+	for (usize i = 0; i < set -> buckets; ++i)
+	{
+		if (set -> meta[i] != 0)
+			set -> elem_destroy(d_hash_set_elem(set, i));
+	}
+}
+
+void		d_hash_set_clear			(DHashSet* set_)
+{
+	DRealHashSet* set = (DRealHashSet*)set_;
+	d_hash_set_destroy_elems(set);
+	if (set -> buckets != 0)
+		memset(set -> meta, 0, set -> buckets * sizeof(u16));
+	set -> len = 0;
+}
+
+void		d_hash_set_destroy			(DHashSet** set_)
+{
+	if (set_ == NULL || *set_ == NULL)
+		return;
+	DRealHashSet* set = (DRealHashSet*)*set_;
+	d_hash_set_destroy_elems(set);
+	if (set -> meta != NULL)
+		d_free(set -> allocator, set -> meta, d_hash_set_block_size(set, set -> buckets));
+	d_free(set -> allocator, set, sizeof(DRealHashSet));
+	*set_ = NULL;
+}
+
+void		d_hash_set_iter_init		(DHashSetIter* it, DHashSet* set)
+{
+	it -> set = set;
+	it -> bucket = 0;
+}
+
+bool		d_hash_set_iter_next		(DHashSetIter* it, void** elem)
+{
+	DRealHashSet* set = (DRealHashSet*)it -> set;
+	while (it -> bucket < set -> buckets && set -> meta[it -> bucket] == 0)
+		++it -> bucket;
+	if (it -> bucket >= set -> buckets)
+		return false;
+	if (elem != NULL)
+		*elem = d_hash_set_elem(set, it -> bucket);
+	++it -> bucket;
+	return true;
+}
@@ -0,0 +1,358 @@
+#include <dintern.h>
+#include <dhash_set.h>
+#include <dhash_func.h>
+#include <d_memory_alloc.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct _DRealInternPool	DRealInternPool;
+typedef struct _DInternShard	DInternShard;
+typedef struct _DInternEntry	DInternEntry;
+typedef struct _DInternHeader	DInternHeader;
+
+//ELEMENT OF THE HASH SETS, A QUERY POINTS TO THE GIVEN BYTES AND A STORED ENTRY TO THE CANONICAL STRING
+struct _DInternEntry {
+	const char*	str;
+	u32			len;
+	u32			hash;
+};
+
+//HEADER RIGHT BEFORE EVERY CANONICAL STRING
+struct _DInternHeader {
+	u32	id;
+	u32	len;
+};
+
+//A SHARD ON ITS OWN CACHE LINE, SO THREADS INTERNING IN ONE SHARD DO NOT SLOW DOWN THE OTHERS
+struct _DInternShard {
+	bool		lock;
+	DHashSet*	set;
+	DArena*		arena;
+	usize		table_bytes; /* counted by the allocator of the set */
+	usize		string_bytes;
+	DAllocator	allocator; /* the set keeps a pointer to it */
+} __attribute__((aligned(64)));
+
+//The id table is made of segments of 64, 128, 256... pointers, which never move once allocated
+#define D_INTERN_FIRST_SEGMENT_BITS 6
+#define D_INTERN_SEGMENTS (33 - D_INTERN_FIRST_SEGMENT_BITS)
+
+//REAL INTERN POOL STRUCTURE ALLOCATED
+struct _DRealInternPool {
+	bool			thread_safe;
+	usize			shard_mask;
+	DInternShard*	shards;
+	u64				next_id;
+	usize			len;
+	const char**	segments[D_INTERN_SEGMENTS];
+};
+
+//Chunks of the arenas, small enough for the 16 shards of a thread-safe pool holding a few identifiers each
+#define D_INTERN_CHUNK_SIZE (16 * 1024)
+//Number of pauses a thread spins for before it yields its core
+#define D_INTERN_SPINS 64
+//THE SHARD IS PICKED WITH THE HIGH BITS OF THE HASH, THE SETS ONLY SEE A 32-BIT FOLD OF IT
+#define D_INTERN_SHARD_SHIFT 60
+
+#define d_intern_header(interned) ((const DInternHeader*)(interned) - 1)
+
+static inline void	d_intern_shard_lock(DRealInternPool* pool, DInternShard* shard)
+{
+	if (pool -> thread_safe == false)
+		return;
+	u32 spins = 0;
+	while (__atomic_test_and_set(&shard -> lock, __ATOMIC_ACQUIRE))
+	{
+		while (__atomic_load_n(&shard -> lock, __ATOMIC_RELAXED))
+		{
+			if (++spins % D_INTERN_SPINS == 0)
+				sched_yield();
+#if defined(__x86_64__) || defined(__i386__)
+			else
+				__builtin_ia32_pause();
+#endif
+		}
+	}
+}
+
+static inline void	d_intern_shard_unlock(DRealInternPool* pool, DInternShard* shard)
+{
+	if (pool -> thread_safe == true)
+		__atomic_clear(&shard -> lock, __ATOMIC_RELEASE);
+}
+
+static u64	d_intern_entry_hash(const void* entry)
+{
+	return ((const DInternEntry*)entry) -> hash;
+}
+
+static bool	d_intern_entry_equal(const void* entry1, const void* entry2)
+{
+	const DInternEntry* e1 = entry1;
+	const DInternEntry* e2 = entry2;
+	return e1 -> hash == e2 -> hash && e1 -> len == e2 -> len && memcmp(e1 -> str, e2 -> str, e1 -> len) == 0;
+}
+
+//ALLOCATOR OF THE SETS, COUNTS THEIR BYTES IN THEIR SHARD
+
+static void*	d_intern_table_alloc(void* ctx, usize size)
+{
+	void* ptr = malloc(size);
+	if (ptr != NULL)
+		((DInternShard*)ctx) -> table_bytes += size;
+	return ptr;
+}
+
+static void*	d_intern_table_realloc(void* ctx, void* ptr, usize old_size, usize new_size)
+{
+	void* new_ptr = realloc(ptr, new_size);
+	if (new_ptr != NULL)
+		((DInternShard*)ctx) -> table_bytes += new_size - old_size;
+	return new_ptr;
+}
+
+static void	d_intern_table_free(void* ctx, void* ptr, usize size)
+{
+	((DInternShard*)ctx) -> table_bytes -= size;
+	free(ptr);
+}
+
+static bool	d_intern_init_shard(DInternShard* shard)
+{
+	shard -> allocator = (DAllocator){ d_intern_table_alloc, d_intern_table_realloc, d_intern_table_free, shard };
+	shard -> arena = d_arena_new(D_INTERN_CHUNK_SIZE);
+	if (shard -> arena == NULL)
+		return false;
+	shard -> set = d_hash_set_new_with_allocator(sizeof(DInternEntry), d_intern_entry_hash, d_intern_entry_equal,
+													NULL, &shard -> allocator);
+	return shard -> set != NULL;
+}
+
+static void	d_intern_free_shards(DInternShard* shards, usize count)
+{
+	for (usize i = 0; i < count; ++i)
+	{
+		d_hash_set_destroy(&shards[i].set);
+		d_arena_destroy(&shards[i].arena);
+	}
+	free(shards);
+}
+
+DInternPool*	d_intern_pool_new			(bool thread_safe)
+{
+	usize shard_count = thread_safe ? D_INTERN_POOL_SHARDS : 1;
+	DRealInternPool* pool = malloc(sizeof(DRealInternPool));
+	if (pool == NULL)
+		return NULL;
+	void* memory;
+	if (posix_memalign(&memory, sizeof(DInternShard), shard_count * sizeof(DInternShard)) != 0)
+	{
+		free(pool);
+		return NULL;
+	}
+	memset(memory, 0, shard_count * sizeof(DInternShard));
+	memset(pool, 0, sizeof(DRealInternPool));
+	pool -> thread_safe = thread_safe;
+	pool -> shard_mask = shard_count - 1;
+	pool -> shards = memory;
+	for (usize i = 0; i < shard_count; ++i)
+	{
+		if (d_intern_init_shard(pool -> shards + i) == false)
+		{
+			d_intern_free_shards(pool -> shards, i + 1);
+			free(pool);
+			return NULL;
+		}
+	}
+	return (DInternPool*)pool;
+}
+
+//Segment of the id table holding `id`, and the index of `id` inside it
+static inline usize	d_intern_segment_of(u64 id, usize* offset)
+{
+	u64 position = id + ((u64)1 << D_INTERN_FIRST_SEGMENT_BITS);
+	usize bits = 63 - (usize)__builtin_clzll(position);
+	*offset = position - ((u64)1 << bits);
+	return bits - D_INTERN_FIRST_SEGMENT_BITS;
+}
+
+static inline usize	d_intern_segment_len(usize segment)
+{
+	return (usize)1 << (segment + D_INTERN_FIRST_SEGMENT_BITS);
+}
+
+//Segment of the id table holding `id`, allocated if needed. Two threads may race to allocate it, one of them wins
+static const char**	d_intern_get_segment(DRealInternPool* pool, u64 id, usize* offset)
+{
+	usize segment = d_intern_segment_of(id, offset);
+	const char** table = __atomic_load_n(&pool -> segments[segment], __ATOMIC_ACQUIRE);
+	if (table != NULL)
+		return table;
+	const char** fresh = calloc(d_intern_segment_len(segment), sizeof(const char*));
+	if (fresh == NULL)
+		return NULL;
+	if (__atomic_compare_exchange_n(&pool -> segments[segment], &table, fresh, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return fresh;
+	free(fresh);
+	return table;
+}
+
+//Takes the next id, once the segment of the id table holding it exists. false if the ids are exhausted or the
+//segment cannot be allocated, no id is taken then
+static bool	d_intern_take_id(DRealInternPool* pool, u64* id, const char*** segment, usize* offset)
+{
+	u64 next = pool -> thread_safe ? __atomic_load_n(&pool -> next_id, __ATOMIC_RELAXED) : pool -> next_id;
+	do
+	{
+		if (next >= D_INTERN_INVALID_ID || (*segment = d_intern_get_segment(pool, next, offset)) == NULL)
+			return false;
+		if (pool -> thread_safe == false)
+		{
+			pool -> next_id = next + 1;
+			break;
+		}
+	} while (__atomic_compare_exchange_n(&pool -> next_id, &next, next + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false);
+	*id = next;
+	return true;
+}
+
+//Copies the string of `entry` in the arena of its shard, whose lock is held, and gives it the next id.
+//Every step that can fail comes before the id is taken, or is undone: a failed call leaves the pool as it was
+static const char*	d_intern_add(DRealInternPool* pool, DInternShard* shard, const DInternEntry* entry)
+{
+	if (d_hash_set_reserve(shard -> set, shard -> set -> len + 1) == NULL)
+		return NULL;
+	DArenaMark mark = d_arena_mark(shard -> arena);
+	DInternHeader* header = d_arena_alloc_aligned(shard -> arena, sizeof(DInternHeader) + entry -> len + 1,
+													alignof(DInternHeader));
+	if (header == NULL)
+		return NULL;
+	u64 id;
+	usize offset;
+	const char** segment;
+	if (d_intern_take_id(pool, &id, &segment, &offset) == false)
+	{
+		d_arena_rewind(shard -> arena, mark);
+		return NULL;
+	}
+	header -> id = (u32)id;
+	header -> len = entry -> len;
+	char* str = (char*)(header + 1);
+	memcpy(str, entry -> str, entry -> len);
+	str[entry -> len] = '\0';
+	//the room was reserved, the insertion cannot fail
+	DInternEntry stored = { str, entry -> len, entry -> hash };
+	d_hash_set_insert(shard -> set, &stored, NULL);
+	__atomic_store_n(segment + offset, str, __ATOMIC_RELEASE);
+	shard -> string_bytes += entry -> len + 1;
+	if (pool -> thread_safe)
+		__atomic_fetch_add(&pool -> len, 1, __ATOMIC_RELAXED);
+	else
+		++pool -> len;
+	return str;
+}
+
+//Finds the canonical string equal to `len` bytes of `data`, interning them if `insert` is true
+static const char*	d_intern_lookup(DRealInternPool* pool, const char* data, usize len, bool insert)
+{
+	if (len >= D_INTERN_INVALID_ID)
+		return NULL;
+	u64 h = d_hash_bytes(data, len, 0);
+	DInternShard* shard = pool -> shards + ((h >> D_INTERN_SHARD_SHIFT) & pool -> shard_mask);
+	DInternEntry entry = { data, (u32)len, (u32)(h ^ (h >> 32)) };
+	d_intern_shard_lock(pool, shard);
+	const DInternEntry* found = d_hash_set_get(shard -> set, &entry);
+	const char* interned = found != NULL ? found -> str : NULL;
+	if (interned == NULL && insert == true)
+		interned = d_intern_add(pool, shard, &entry);
+	d_intern_shard_unlock(pool, shard);
+	return interned;
+}
+
+const char*		d_intern_pool_intern		(DInternPool* pool, const char* str)
+{
+	return d_intern_lookup((DRealInternPool*)pool, str, strlen(str), true);
+}
+
+const char*		d_intern_pool_intern_view	(DInternPool* pool, DStringView view)
+{
+	return d_intern_lookup((DRealInternPool*)pool, view.data, view.len, true);
+}
+
+const char*		d_intern_pool_intern_dstring(DInternPool* pool, const DString* dstring)
+{
+	return d_intern_lookup((DRealInternPool*)pool, dstring -> string, dstring -> len, true);
+}
+
+u32				d_intern_pool_intern_id		(DInternPool* pool, DStringView view)
+{
+	const char* interned = d_intern_lookup((DRealInternPool*)pool, view.data, view.len, true);
+	return interned == NULL ? D_INTERN_INVALID_ID : d_intern_header(interned) -> id;
+}
+
+const char*		d_intern_pool_find			(DInternPool* pool, DStringView view)
+{
+	return d_intern_lookup((DRealInternPool*)pool, view.data, view.len, false);
+}
+
+const char*		d_intern_pool_get_string	(DInternPool* pool_, u32 id)
+{
+	DRealInternPool* pool = (DRealInternPool*)pool_;
+	if (id == D_INTERN_INVALID_ID)
+		return NULL;
+	usize offset;
+	usize segment = d_intern_segment_of(id, &offset);
+	const char** table = __atomic_load_n(&pool -> segments[segment], __ATOMIC_ACQUIRE);
+	return table == NULL ? NULL : __atomic_load_n(table + offset, __ATOMIC_ACQUIRE);
+}
+
+u32				d_intern_pool_string_id		(const char* interned)
+{
+	return d_intern_header(interned) -> id;
+}
+
+usize			d_intern_pool_string_len	(const char* interned)
+{
+	return d_intern_header(interned) -> len;
+}
+
+usize			d_intern_pool_get_len		(DInternPool* pool)
+{
+	return __atomic_load_n(&((DRealInternPool*)pool) -> len, __ATOMIC_RELAXED);
+}
+
+void			d_intern_pool_get_stats		(DInternPool* pool_, DInternStats* stats)
+{
+	DRealInternPool* pool = (DRealInternPool*)pool_;
+	memset(stats, 0, sizeof(DInternStats));
+	stats -> strings = d_intern_pool_get_len(pool_);
+	for (usize i = 0; i <= pool -> shard_mask; ++i)
+	{
+		DInternShard* shard = pool -> shards + i;
+		d_intern_shard_lock(pool, shard);
+		stats -> string_bytes += shard -> string_bytes;
+		stats -> arena_bytes += shard -> arena -> capacity;
+		stats -> table_bytes += shard -> table_bytes;
+		d_intern_shard_unlock(pool, shard);
+	}
+	for (usize segment = 0; segment < D_INTERN_SEGMENTS; ++segment)
+	{
+		if (__atomic_load_n(&pool -> segments[segment], __ATOMIC_ACQUIRE) != NULL)
+			stats -> id_bytes += d_intern_segment_len(segment) * sizeof(const char*);
+	}
+	stats -> total_bytes = stats -> arena_bytes + stats -> table_bytes + stats -> id_bytes
+		+ sizeof(DRealInternPool) + (pool -> shard_mask + 1) * sizeof(DInternShard);
+}
+
+void			d_intern_pool_destroy		(DInternPool** pool_)
+{
+	if (pool_ == NULL || *pool_ == NULL)
+		return;
+	DRealInternPool* pool = (DRealInternPool*)*pool_;
+	d_intern_free_shards(pool -> shards, pool -> shard_mask + 1);
+	for (usize segment = 0; segment < D_INTERN_SEGMENTS; ++segment)
+		free(pool -> segments[segment]);
+	free(pool);
+	*pool_ = NULL;
+}
@@ -0,0 +1,297 @@
+#include <dstring_map.h>
+#include <dhash_func.h>
+#include <string.h>
+#include "dhash_group.h"
+
+typedef struct _DRealStringMap		DRealStringMap;
+typedef struct _DStringMapEntry		DStringMapEntry;
+
+//REAL STRING MAP STRUCTURE ALLOCATED
+struct _DRealStringMap {
+	usize			len;
+	usize			groups; /* number of groups, always a power of two or 0 before the first insertion */
+	usize			max_load; /* number of entries the map can hold before it grows or cleans its overflow bytes */
+	u8*				ctrl; /* 16 bytes of metadata per group, followed by the slots */
+	u8*				slots;
+	usize			value_size;
+	usize			value_offset; /* offset of the value inside a slot */
+	usize			slot_size;
+	DestroyElemFunc	value_destroy;
+	const DAllocator*	allocator;
+};
+
+//HEAD OF EVERY SLOT, THE VALUE FOLLOWS AT value_offset
+struct _DStringMapEntry {
+	u64		hash;
+	usize	len;
+	char*	key; /* null-terminated copy of len + 1 bytes */
+};
+
+#define d_string_map_entry(map, i) ((DStringMapEntry*)d_hash_slot(map, i))
+
+DStringMap*	d_string_map_new				(usize value_size, DestroyElemFunc value_destroy)
+{
+	return d_string_map_new_with_allocator(value_size, value_destroy, NULL);
+}
+
+DStringMap*	d_string_map_new_with_allocator	(usize value_size, DestroyElemFunc value_destroy,
+												const DAllocator* allocator)
+{
+	if (value_size > MAX_SIZE_T_VALUE / 4)
+		return NULL;
+	DRealStringMap* map = d_alloc(allocator, sizeof(DRealStringMap));
+	if (map == NULL)
+		return NULL;
+	usize value_alignment = value_size == 0 ? 1 : d_hash_alignment(value_size);
+	usize slot_alignment = value_alignment > sizeof(u64) ? value_alignment : sizeof(u64);
+	map -> len = 0;
+	map -> groups = 0;
+	map -> max_load = 0;
+	map -> ctrl = NULL;
+	map -> slots = NULL;
+	map -> value_size = value_size;
+	map -> value_offset = (sizeof(DStringMapEntry) + value_alignment - 1) & ~(value_alignment - 1);
+	map -> slot_size = (map -> value_offset + value_size + slot_alignment - 1) & ~(slot_alignment - 1);
+	map -> value_destroy = value_destroy;
+	map -> allocator = allocator;
+	return (DStringMap*)map;
+}
+
+//Moves every entry to a new block of `groups` groups using their cached hash, the keys are neither hashed nor read
+static bool	d_string_map_rehash(DRealStringMap* map, usize groups)
+{
+	usize size = d_hash_block_size(groups, map -> slot_size, 0);
+	if (groups == 0 || size == 0)
+		return false;
+	u8* block = d_alloc(map -> allocator, size);
+	if (block == NULL)
+		return false;
+	DRealStringMap old = *map;
+	memset(block, 0, groups * D_HASH_GROUP_SIZE);
+	map -> groups = groups;
+	map -> ctrl = block;
+	map -> slots = block + groups * D_HASH_GROUP_SIZE;
+	map -> max_load = d_hash_max_load(groups);
+	usize group = 0;
+	u32 full = d_hash_first_full(old.ctrl, old.groups);
+	for (usize i; (i = d_hash_next_full(old.ctrl, old.groups, &group, &full)) != MAX_SIZE_T_VALUE;)
+	{
+		u8* entry = d_hash_slot(&old, i);
+		u64 h = ((DStringMapEntry*)entry) -> hash;
+		usize slot = d_hash_find_empty(map -> ctrl, groups, h);
+		d_hash_set_ctrl(map -> ctrl, slot, d_hash_tag(h));
+		memcpy(d_hash_slot(map, slot), entry, map -> slot_size);
+	}
+	if (old.ctrl != NULL)
+		d_free(map -> allocator, old.ctrl, d_hash_block_size(old.groups, old.slot_size, 0));
+	return true;
+}
+
+//Index of the slot holding `key`, MAX_SIZE_T_VALUE if it is not present
+static inline usize	d_string_map_find(DRealStringMap* map, DStringView key, u64 h)
+{
+	if (map -> groups == 0)
+		return MAX_SIZE_T_VALUE;
+	DHashProbe probe;
+	d_hash_probe_init(&probe, map -> ctrl, map -> groups, h);
+	for (usize slot; (slot = d_hash_probe_next(&probe, map -> ctrl)) != MAX_SIZE_T_VALUE;)
+	{
+		DStringMapEntry* entry = d_string_map_entry(map, slot);
+		if (entry -> hash == h && entry -> len == key.len && memcmp(entry -> key, key.data, key.len) == 0)
+			return slot;
+	}
+	return MAX_SIZE_T_VALUE;
+}
+
+//Finds the slot of `key`, inserting a copy of the key in an empty slot if it is not present
+static DStringMapEntry*	d_string_map_find_or_insert(DRealStringMap* map, DStringView key, bool* inserted)
+{
+	u64 h = d_hash_bytes(key.data, key.len, 0);
+	usize slot = d_string_map_find(map, key, h);
+	if (slot != MAX_SIZE_T_VALUE)
+	{
+		*inserted = false;
+		return d_string_map_entry(map, slot);
+	}
+	if (key.len == MAX_SIZE_T_VALUE)
+		return NULL;
+	char* copy = d_alloc(map -> allocator, key.len + 1);
+	if (copy == NULL)
+		return NULL;
+	//the slack keeps a rehash triggered by deletions from being followed by another one right away
+	if (map -> len >= map -> max_load && d_string_map_rehash(map, d_hash_groups_for(map -> len + map -> len / 8 + 1)) == false)
+	{
+		d_free(map -> allocator, copy, key.len + 1);
+		return NULL;
+	}
+	memcpy(copy, key.data, key.len);
+	copy[key.len] = '\0';
+	slot = d_hash_find_empty(map -> ctrl, map -> groups, h);
+	d_hash_set_ctrl(map -> ctrl, slot, d_hash_tag(h));
+	DStringMapEntry* entry = d_string_map_entry(map, slot);
+	entry -> hash = h;
+	entry -> len = key.len;
+	entry -> key = copy;
+	++map -> len;
+	*inserted = true;
+	return entry;
+}
+
+void*		d_string_map_insert				(DStringMap* map_, DStringView key, const void* value)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	bool inserted;
+	DStringMapEntry* entry = d_string_map_find_or_insert(map, key, &inserted);
+	if (entry == NULL)
+		return NULL;
+	void* slot_value = (u8*)entry + map -> value_offset;
+	if (inserted == false && map -> value_destroy != NULL)
+		map -> value_destroy(slot_value);
+	if (value != NULL)
+		memcpy(slot_value, value, map -> value_size);
+	else
+		memset(slot_value, 0, map -> value_size);
+	return slot_value;
+}
+
+void*		d_string_map_emplace			(DStringMap* map_, DStringView key, bool* inserted)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	bool was_inserted;
+	DStringMapEntry* entry = d_string_map_find_or_insert(map, key, &was_inserted);
+	if (entry == NULL)
+		return NULL;
+	if (was_inserted == true)
+		memset((u8*)entry + map -> value_offset, 0, map -> value_size);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return (u8*)entry + map -> value_offset;
+}
+
+void*		d_string_map_get				(DStringMap* map_, DStringView key)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	usize slot = d_string_map_find(map, key, d_hash_bytes(key.data, key.len, 0));
+	return slot == MAX_SIZE_T_VALUE ? NULL : d_hash_slot(map, slot) + map -> value_offset;
+}
+
+const char*	d_string_map_get_key			(DStringMap* map_, DStringView key)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	usize slot = d_string_map_find(map, key, d_hash_bytes(key.data, key.len, 0));
+	return slot == MAX_SIZE_T_VALUE ? NULL : d_string_map_entry(map, slot) -> key;
+}
+
+bool		d_string_map_contains			(DStringMap* map, DStringView key)
+{
+	return d_string_map_get_key(map, key) != NULL;
+}
+
+//Releases the key and the value of a slot
+static inline void	d_string_map_drop(DRealStringMap* map, DStringMapEntry* entry)
+{
+	d_free(map -> allocator, entry -> key, entry -> len + 1);
+	if (map -> value_destroy != NULL)
+		map -> value_destroy((u8*)entry + map -> value_offset);
+}
+
+//Empties a slot, see `d_hash_erase` for the overflow bytes
+static void	d_string_map_erase(DRealStringMap* map, usize slot)
+{
+	d_string_map_drop(map, d_string_map_entry(map, slot));
+	d_hash_set_ctrl(map -> ctrl, slot, 0);
+	--map -> len;
+	if (d_hash_group_ctrl(map, slot / D_HASH_GROUP_SLOTS)[D_HASH_OVERFLOW] != 0)
+		--map -> max_load;
+}
+
+bool		d_string_map_remove				(DStringMap* map_, DStringView key)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	usize slot = d_string_map_find(map, key, d_hash_bytes(key.data, key.len, 0));
+	if (slot == MAX_SIZE_T_VALUE)
+		return false;
+	d_string_map_erase(map, slot);
+	return true;
+}
+
+DStringMap*	d_string_map_reserve			(DStringMap* map_, usize count)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	if (count <= map -> max_load)
+		return map_;
+	if (d_string_map_rehash(map, d_hash_groups_for(count)) == false)
+		return NULL;
+	return map_;
+}
+
+usize		d_string_map_get_capacity		(DStringMap* map_)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	return map -> max_load;
+}
+
+//Releases every entry
+static void	d_string_map_drop_entries(DRealStringMap* map)
+{
+	if (map -> len == 0)
+		return;
+	usize group = 0;
+	u32 full = d_hash_first_full(map -> ctrl, map -> groups);
+	for (usize i; (i = d_hash_next_full(map -> ctrl, map -> groups, &group, &full)) != MAX_SIZE_T_VALUE;)
+		d_string_map_drop(map, d_string_map_entry(map, i));
+}
+
+void		d_string_map_clear				(DStringMap* map_)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	d_string_map_drop_entries(map);
+	if (map -> groups != 0)
+		memset(map -> ctrl, 0, map -> groups * D_HASH_GROUP_SIZE);
+	map -> len = 0;
+	map -> max_load = d_hash_max_load(map -> groups);
+}
+
+void		d_string_map_destroy			(DStringMap** map_)
+{
+	if (map_ == NULL || *map_ == NULL)
+		return;
+	DRealStringMap* map = (DRealStringMap*)*map_;
+	d_string_map_drop_entries(map);
+	if (map -> ctrl != NULL)
+		d_free(map -> allocator, map -> ctrl, d_hash_block_size(map -> groups, map -> slot_size, 0));
+	d_free(map -> allocator, map, sizeof(DRealStringMap));
+	*map_ = NULL;
+}
+
+void		d_string_map_iter_init			(DStringMapIter* it, DStringMap* map_)
+{
+	DRealStringMap* map = (DRealStringMap*)map_;
+	it -> map = map_;
+	it -> group = 0;
+	it -> mask = d_hash_first_full(map -> ctrl, map -> groups);
+	it -> slot = MAX_SIZE_T_VALUE;
+}
+
+bool		d_string_map_iter_next			(DStringMapIter* it, DStringView* key, void** value)
+{
+	DRealStringMap* map = (DRealStringMap*)it -> map;
+	usize slot = d_hash_next_full(map -> ctrl, map -> groups, &it -> group, &it -> mask);
+	if (slot == MAX_SIZE_T_VALUE)
+		return false;
+	it -> slot = slot;
+	DStringMapEntry* entry = d_string_map_entry(map, it -> slot);
+	if (key != NULL)
+	{
+		key -> data = entry -> key;
+		key -> len = entry -> len;
+	}
+	if (value != NULL)
+		*value = (u8*)entry + map -> value_offset;
+	return true;
+}
+
+void		d_string_map_iter_remove		(DStringMapIter* it)
+{
+	d_string_map_erase((DRealStringMap*)it -> map, it -> slot);
+}
@@ -0,0 +1,1281 @@
+#include <dhash.h>
+#include <dstring_map.h>
+#include <dhash_func.h>
+#include <dconcurrent_map.h>
+#include <dhash_set.h>
+#include <dintern.h>
+#include <pthread.h>
+#include <dtest.h>
+#include <dutils.h>
+#include <string.h>
+#include <general_lib.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+char*   itoa_usize(void* data)
+{
+    return d_itoa_usize(*((usize*)data));
+}
+
+char*   itoa_bool(void* data)
+{
+    return d_itoa_usize(*((bool*)data));
+}
+
+u64     hash_c_string(const void* key)
+{
+    const char* str = *(const char**)key;
+    u64 h = 14695981039346656037ULL;
+    while (*str)
+        h = (h ^ (u8)*str++) * 1099511628211ULL;
+    return h;
+}
+
+bool    equal_c_string(const void* key1, const void* key2)
+{
+    return strcmp(*(const char**)key1, *(const char**)key2) == 0;
+}
+
+//Every key collides, the probe sequences then go through every group
+u64     hash_constant(const void* key)
+{
+    (void)key;
+    return 42;
+}
+
+usize   g_destroyed = 0;
+
+void    free_c_string(void* key)
+{
+    ++g_destroyed;
+    free(*(char**)key);
+}
+
+void    count_destroyed(void* value)
+{
+    (void)value;
+    ++g_destroyed;
+}
+
+void    test_d_hash_map_insert(void)
+{
+    DHashMap* map = d_hash_map_new(sizeof(u64), sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL, NULL);
+    usize zero = 0;
+    assert_eq_custom(&map -> len, &zero, sizeof(usize), itoa_usize);
+    assert_eq_null(d_hash_map_get(map, &zero));
+    bool valid = true;
+    for (u64 key = 0; key < 10000; ++key)
+    {
+        u64 value = key * 3;
+        valid = valid && d_hash_map_insert(map, &key, &value) != NULL;
+    }
+    for (u64 key = 0; key < 10000 && valid; ++key)
+    {
+        u64* value = d_hash_map_get(map, &key);
+        valid = value != NULL && *value == key * 3;
+    }
+    for (u64 key = 10000; key < 20000 && valid; ++key)
+        valid = d_hash_map_get(map, &key) == NULL && d_hash_map_contains(map, &key) == false;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    usize len = 10000;
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    //inserting a present key overwrites its value
+    u64 key = 77;
+    u64 value = 1;
+    d_hash_map_insert(map, &key, &value);
+    valid = *(u64*)d_hash_map_get(map, &key) == 1 && *(u64*)d_hash_map_get_key(map, &key) == 77;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    //a NULL value is zeroed
+    key = 123456;
+    valid = *(u64*)d_hash_map_insert(map, &key, NULL) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_map_destroy(&map);
+    assert_eq_null(map);
+    d_hash_map_destroy(&map);
+    assert_eq_null(d_hash_map_new(0, 8, d_hash_u64_key, d_equal_u64_key, NULL, NULL));
+}
+
+void    test_d_hash_map_emplace(void)
+{
+    DHashMap* map = d_hash_map_new(sizeof(u64), sizeof(usize), d_hash_u64_key, d_equal_u64_key, NULL, NULL);
+    usize inserted_count = 0;
+    for (u64 i = 0; i < 1000; ++i)
+    {
+        u64 key = i % 10;
+        bool inserted;
+        ++*(usize*)d_hash_map_emplace(map, &key, &inserted);
+        inserted_count += inserted;
+    }
+    usize len = 10;
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    assert_eq_custom(&inserted_count, &len, sizeof(usize), itoa_usize);
+    bool expected = true;
+    bool valid = true;
+    for (u64 key = 0; key < 10; ++key)
+        valid = valid && *(usize*)d_hash_map_get(map, &key) == 100;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_map_destroy(&map);
+}
+
+void    test_d_hash_map_remove(void)
+{
+    DHashMap* map = d_hash_map_new(sizeof(u64), sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL, NULL);
+    for (u64 key = 0; key < 5000; ++key)
+        d_hash_map_insert(map, &key, &key);
+    bool valid = true;
+    for (u64 key = 0; key < 5000; key += 2)
+        valid = valid && d_hash_map_remove(map, &key);
+    u64 missing = 2;
+    valid = valid && d_hash_map_remove(map, &missing) == false;
+    for (u64 key = 0; key < 5000 && valid; ++key)
+        valid = (d_hash_map_get(map, &key) != NULL) == (key % 2 == 1);
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    usize len = 2500;
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    d_hash_map_destroy(&map);
+}
+
+//Random operations checked against a plain array indexed by the key
+void    test_d_hash_map_churn(void)
+{
+    DHashFunc hashes[] = {d_hash_u64_key, hash_constant};
+    usize key_ranges[] = {4096, 200};
+    bool expected = true;
+    for (usize h = 0; h < 2; ++h)
+    {
+        DHashMap* map = d_hash_map_new(sizeof(u64), sizeof(u64), hashes[h], d_equal_u64_key, NULL, NULL);
+        usize range = key_ranges[h];
+        u64* model = calloc(range, sizeof(u64));
+        usize model_len = 0;
+        usize mismatches = 0;
+        srand(11);
+        for (usize round = 0; round < 200000 / (1 + 20 * h); ++round)
+        {
+            u64 key = (u64)rand() % range;
+            //keys spread on high bits only, to check the mixing of weak hashes
+            u64 stored_key = key << 40;
+            if (rand() % 2)
+            {
+                u64 value = round + 1;
+                model_len += model[key] == 0;
+                model[key] = value;
+                d_hash_map_insert(map, &stored_key, &value);
+            }
+            else
+            {
+                mismatches += d_hash_map_remove(map, &stored_key) != (model[key] != 0);
+                model_len -= model[key] != 0;
+                model[key] = 0;
+            }
+        }
+        for (u64 key = 0; key < range; ++key)
+        {
+            u64 stored_key = key << 40;
+            u64* value = d_hash_map_get(map, &stored_key);
+            mismatches += model[key] == 0 ? value != NULL : value == NULL || *value != model[key];
+        }
+        mismatches += map -> len != model_len;
+        usize zero = 0;
+        assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+        //the deletions never let the map grow beyond what its entries need
+        bool valid = d_hash_map_get_capacity(map) <= 2 * range + D_HASH_GROUP_SLOTS;
+        assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+        free(model);
+        d_hash_map_destroy(&map);
+    }
+}
+
+void    test_d_hash_map_iter(void)
+{
+    DHashMap* map = d_hash_map_new(sizeof(u64), sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL, NULL);
+    DHashMapIter it;
+    d_hash_map_iter_init(&it, map);
+    bool expected = true;
+    bool valid = d_hash_map_iter_next(&it, NULL, NULL) == false;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    usize count = 3000;
+    for (u64 key = 0; key < count; ++key)
+    {
+        u64 value = key + 1;
+        d_hash_map_insert(map, &key, &value);
+    }
+    u8* seen = calloc(count, 1);
+    void* key;
+    void* value;
+    usize visited = 0;
+    valid = true;
+    d_hash_map_iter_init(&it, map);
+    while (d_hash_map_iter_next(&it, &key, &value))
+    {
+        u64 k = *(u64*)key;
+        valid = valid && k < count && seen[k] == 0 && *(u64*)value == k + 1;
+        seen[k < count ? k : 0] = 1;
+        ++visited;
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    assert_eq_custom(&visited, &count, sizeof(usize), itoa_usize);
+    //removing during the iteration skips nothing
+    d_hash_map_iter_init(&it, map);
+    visited = 0;
+    while (d_hash_map_iter_next(&it, &key, NULL))
+    {
+        ++visited;
+        if (*(u64*)key % 3 == 0)
+            d_hash_map_iter_remove(&it);
+    }
+    assert_eq_custom(&visited, &count, sizeof(usize), itoa_usize);
+    usize len = count - (count + 2) / 3;
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    free(seen);
+    d_hash_map_destroy(&map);
+}
+
+void    test_d_hash_map_destroy_funcs(void)
+{
+    g_destroyed = 0;
+    DHashMap* map = d_hash_map_new(sizeof(char*), sizeof(u64), hash_c_string, equal_c_string, free_c_string, count_destroyed);
+    const char* words[] = {"alpha", "beta", "gamma", "delta", "alpha"};
+    for (usize i = 0; i < 5; ++i)
+    {
+        char* word = d_strdup(words[i]);
+        u64 value = i;
+        d_hash_map_insert(map, &word, &value);
+    }
+    //the duplicated key and the overwritten value are dropped right away
+    usize destroyed = 2;
+    assert_eq_custom(&g_destroyed, &destroyed, sizeof(usize), itoa_usize);
+    const char* lookup = "alpha";
+    bool expected = true;
+    bool valid = *(u64*)d_hash_map_get(map, &lookup) == 4;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    lookup = "beta";
+    d_hash_map_remove(map, &lookup);
+    destroyed = 4;
+    assert_eq_custom(&g_destroyed, &destroyed, sizeof(usize), itoa_usize);
+    d_hash_map_clear(map);
+    destroyed = 10;
+    assert_eq_custom(&g_destroyed, &destroyed, sizeof(usize), itoa_usize);
+    usize zero = 0;
+    assert_eq_custom(&map -> len, &zero, sizeof(usize), itoa_usize);
+    char* word = d_strdup("epsilon");
+    d_hash_map_insert(map, &word, NULL);
+    d_hash_map_destroy(&map);
+    destroyed = 12;
+    assert_eq_custom(&g_destroyed, &destroyed, sizeof(usize), itoa_usize);
+}
+
+void    test_d_hash_map_set(void)
+{
+    DHashMap* set = d_hash_map_new(sizeof(u64), 0, d_hash_u64_key, d_equal_u64_key, NULL, NULL);
+    for (u64 key = 0; key < 100; ++key)
+        d_hash_map_insert(set, &key, NULL);
+    bool expected = true;
+    u64 key = 50;
+    bool valid = d_hash_map_contains(set, &key) && set -> len == 100;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_map_destroy(&set);
+}
+
+void    test_d_hash_map_reserve(void)
+{
+    DHashMap* map = d_hash_map_new(sizeof(u64), sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL, NULL);
+    usize zero = 0;
+    usize capacity = d_hash_map_get_capacity(map);
+    assert_eq_custom(&capacity, &zero, sizeof(usize), itoa_usize);
+    d_hash_map_reserve(map, 1000);
+    capacity = d_hash_map_get_capacity(map);
+    //the load factor goes up to 7/8 of the slots
+    bool expected = true;
+    bool valid = capacity >= 1000 && capacity < 2048;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    for (u64 key = 0; key < 1000; ++key)
+        d_hash_map_insert(map, &key, &key);
+    usize after = d_hash_map_get_capacity(map);
+    assert_eq_custom(&after, &capacity, sizeof(usize), itoa_usize);
+    d_hash_map_destroy(&map);
+}
+
+typedef struct {
+    usize   allocs;
+    usize   frees;
+    usize   live_bytes;
+    usize   size_mismatches;
+} CountingAllocator;
+
+void*   counting_alloc(void* ctx, usize size)
+{
+    CountingAllocator* counter = ctx;
+    usize* block = malloc(sizeof(usize) * 2 + size);
+    if (block == NULL)
+        return NULL;
+    block[0] = size;
+    ++counter -> allocs;
+    counter -> live_bytes += size;
+    return block + 2;
+}
+
+void    counting_free(void* ctx, void* ptr, usize size)
+{
+    CountingAllocator* counter = ctx;
+    usize* block = (usize*)ptr - 2;
+    counter -> size_mismatches += block[0] != size;
+    ++counter -> frees;
+    counter -> live_bytes -= block[0];
+    free(block);
+}
+
+void*   counting_realloc(void* ctx, void* ptr, usize old_size, usize new_size)
+{
+    void* new_ptr = counting_alloc(ctx, new_size);
+    if (new_ptr == NULL || ptr == NULL)
+        return new_ptr;
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    counting_free(ctx, ptr, old_size);
+    return new_ptr;
+}
+
+void    test_d_hash_map_allocator(void)
+{
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    DHashMap* map = d_hash_map_new_with_allocator(sizeof(u64), sizeof(u32), d_hash_u64_key, d_equal_u64_key,
+                                                    NULL, NULL, &allocator);
+    for (u64 key = 0; key < 2000; ++key)
+    {
+        u32 value = key;
+        d_hash_map_insert(map, &key, &value);
+    }
+    u64 key = 1999;
+    bool valid = counter.allocs > 1 && *(u32*)d_hash_map_get(map, &key) == 1999;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_map_destroy(&map);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.size_mismatches, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.frees, &counter.allocs, sizeof(usize), itoa_usize);
+}
+
+void    test_d_string_map_insert(void)
+{
+    DStringMap* map = d_string_map_new(sizeof(usize), NULL);
+    usize zero = 0;
+    assert_eq_custom(&map -> len, &zero, sizeof(usize), itoa_usize);
+    assert_eq_null(d_string_map_get(map, d_string_view_from_c_string("missing")));
+    char buffer[64];
+    for (usize i = 0; i < 5000; ++i)
+    {
+        d_itoa_usize_no_alloc(i, buffer);
+        d_string_map_insert(map, d_string_view_from_c_string(buffer), &i);
+    }
+    usize len = 5000;
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    bool valid = true;
+    for (usize i = 0; i < 5000 && valid; ++i)
+    {
+        d_itoa_usize_no_alloc(i, buffer);
+        usize* value = d_string_map_get(map, d_string_view_from_c_string(buffer));
+        valid = value != NULL && *value == i;
+    }
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //a view into a larger buffer needs no null terminator
+    const char* text = "1234567";
+    valid = *(usize*)d_string_map_get(map, d_string_view_from_buffer(text + 1, 3)) == 234
+        && d_string_map_get(map, d_string_view_from_buffer(text, 7)) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    DString* dstring = d_string_new_from_c_string("4999");
+    valid = *(usize*)d_string_map_get(map, d_string_view_from_dstring(dstring)) == 4999;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_string_destroy(&dstring);
+    //the map keeps the first copy of a key, overwriting only its value
+    const char* key = d_string_map_get_key(map, d_string_view_from_c_string("42"));
+    usize value = 1;
+    d_string_map_insert(map, d_string_view_from_c_string("42"), &value);
+    valid = d_string_map_get_key(map, d_string_view_from_c_string("42")) == key && strcmp(key, "42") == 0
+        && *(usize*)d_string_map_get(map, d_string_view_from_c_string("42")) == 1;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //the empty string is a key as any other
+    d_string_map_insert(map, d_string_view_from_c_string(""), &value);
+    valid = d_string_map_contains(map, d_string_view_from_buffer(text, 0)) && map -> len == 5001;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_string_map_destroy(&map);
+    assert_eq_null(map);
+}
+
+void    test_d_string_map_long_keys(void)
+{
+    DStringMap* map = d_string_map_new(sizeof(usize), NULL);
+    char key[200];
+    memset(key, 'a', sizeof(key));
+    //keys of every length up to 200 bytes, differing only by their length or their last byte
+    for (usize len = 1; len <= sizeof(key); ++len)
+    {
+        for (usize c = 0; c < 4; ++c)
+        {
+            key[len - 1] = 'a' + c;
+            usize value = len * 4 + c;
+            d_string_map_insert(map, d_string_view_from_buffer(key, len), &value);
+            key[len - 1] = 'a';
+        }
+    }
+    usize len = sizeof(key) * 4;
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    usize mismatches = 0;
+    for (usize l = 1; l <= sizeof(key); ++l)
+    {
+        for (usize c = 0; c < 4; ++c)
+        {
+            key[l - 1] = 'a' + c;
+            usize* value = d_string_map_get(map, d_string_view_from_buffer(key, l));
+            mismatches += value == NULL || *value != l * 4 + c;
+            key[l - 1] = 'a';
+        }
+    }
+    usize zero = 0;
+    assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+    d_string_map_destroy(&map);
+}
+
+void    test_d_string_map_emplace(void)
+{
+    DStringMap* map = d_string_map_new(sizeof(usize), NULL);
+    const char* text = "the cat and the dog and the bird";
+    const char* word = text;
+    while (*word)
+    {
+        usize len = strcspn(word, " ");
+        ++*(usize*)d_string_map_emplace(map, d_string_view_from_buffer(word, len), NULL);
+        word += len + (word[len] == ' ');
+    }
+    usize len = 5;
+    assert_eq_custom(&map -> len, &len, sizeof(usize), itoa_usize);
+    usize count = 3;
+    assert_eq_custom(d_string_map_get(map, d_string_view_from_c_string("the")), &count, sizeof(usize), itoa_usize);
+    count = 2;
+    assert_eq_custom(d_string_map_get(map, d_string_view_from_c_string("and")), &count, sizeof(usize), itoa_usize);
+    bool inserted = true;
+    d_string_map_emplace(map, d_string_view_from_c_string("cat"), &inserted);
+    bool expected = false;
+    assert_eq_custom(&inserted, &expected, sizeof(bool), itoa_bool);
+    d_string_map_destroy(&map);
+}
+
+void    test_d_string_map_remove(void)
+{
+    g_destroyed = 0;
+    DStringMap* map = d_string_map_new(sizeof(usize), count_destroyed);
+    char buffer[64];
+    usize* model = calloc(512, sizeof(usize));
+    usize model_len = 0;
+    usize mismatches = 0;
+    srand(5);
+    for (usize round = 1; round <= 100000; ++round)
+    {
+        usize key = (usize)rand() % 512;
+        d_itoa_usize_no_alloc(key, buffer);
+        DStringView view = d_string_view_from_c_string(buffer);
+        if (rand() % 2)
+        {
+            model_len += model[key] == 0;
+            model[key] = round;
+            d_string_map_insert(map, view, &round);
+        }
+        else
+        {
+            mismatches += d_string_map_remove(map, view) != (model[key] != 0);
+            model_len -= model[key] != 0;
+            model[key] = 0;
+        }
+    }
+    for (usize key = 0; key < 512; ++key)
+    {
+        d_itoa_usize_no_alloc(key, buffer);
+        usize* value = d_string_map_get(map, d_string_view_from_c_string(buffer));
+        mismatches += model[key] == 0 ? value != NULL : value == NULL || *value != model[key];
+    }
+    mismatches += map -> len != model_len;
+    usize zero = 0;
+    assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+    //every value overwritten or removed went through value_destroy
+    usize destroyed = g_destroyed;
+    d_string_map_clear(map);
+    destroyed += model_len;
+    assert_eq_custom(&g_destroyed, &destroyed, sizeof(usize), itoa_usize);
+    assert_eq_custom(&map -> len, &zero, sizeof(usize), itoa_usize);
+    free(model);
+    d_string_map_destroy(&map);
+}
+
+void    test_d_string_map_iter(void)
+{
+    DStringMap* set = d_string_map_new(0, NULL);
+    const char* words[] = {"one", "two", "three", "four", "five", "six"};
+    for (usize i = 0; i < 6; ++i)
+        d_string_map_insert(set, d_string_view_from_c_string(words[i]), NULL);
+    DStringMapIter it;
+    DStringView key;
+    usize visited = 0;
+    usize found = 0;
+    d_string_map_iter_init(&it, set);
+    while (d_string_map_iter_next(&it, &key, NULL))
+    {
+        ++visited;
+        for (usize i = 0; i < 6; ++i)
+            found += d_string_view_equals_c_string(key, words[i]) && key.data[key.len] == '\0';
+        if (key.len == 3)
+            d_string_map_iter_remove(&it);
+    }
+    usize count = 6;
+    assert_eq_custom(&visited, &count, sizeof(usize), itoa_usize);
+    assert_eq_custom(&found, &count, sizeof(usize), itoa_usize);
+    count = 3;
+    assert_eq_custom(&set -> len, &count, sizeof(usize), itoa_usize);
+    bool expected = true;
+    bool valid = d_string_map_contains(set, d_string_view_from_c_string("three"))
+        && d_string_map_contains(set, d_string_view_from_c_string("six")) == false;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_string_map_destroy(&set);
+}
+
+void    test_d_string_map_allocator(void)
+{
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    DStringMap* map = d_string_map_new_with_allocator(sizeof(u32), NULL, &allocator);
+    d_string_map_reserve(map, 100);
+    usize capacity = d_string_map_get_capacity(map);
+    char buffer[64];
+    for (u32 i = 0; i < 100; ++i)
+    {
+        d_itoa_usize_no_alloc(i, buffer);
+        d_string_map_insert(map, d_string_view_from_c_string(buffer), &i);
+    }
+    //the keys come from the allocator as well, the reserved slots were enough
+    bool valid = counter.allocs == 102 && d_string_map_get_capacity(map) == capacity;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_string_map_remove(map, d_string_view_from_c_string("7"));
+    d_string_map_destroy(&map);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.size_mismatches, &zero, sizeof(usize), itoa_usize);
+}
+
+int     compare_u64(const void* a, const void* b)
+{
+    u64 x = *(const u64*)a;
+    u64 y = *(const u64*)b;
+    return (x > y) - (x < y);
+}
+
+//Number of equal neighbours once sorted
+usize   count_collisions(u64* hashes, usize count)
+{
+    qsort(hashes, count, sizeof(u64), compare_u64);
+    usize collisions = 0;
+    for (usize i = 1; i < count; ++i)
+        collisions += hashes[i] == hashes[i - 1];
+    return collisions;
+}
+
+void    test_d_hash_bytes(void)
+{
+    usize max_len = 5000;
+    u8* data = malloc(max_len);
+    u8* shifted = malloc(max_len + 8);
+    srand(3);
+    for (usize i = 0; i < max_len; ++i)
+        data[i] = rand();
+    data[0] |= 1;
+    //the hash depends on the bytes only, not on their address
+    usize mismatches = 0;
+    for (usize len = 0; len <= max_len; len += len < 600 ? 1 : 997)
+    {
+        u64 h = d_hash_bytes(data, len, 0);
+        for (usize offset = 1; offset < 8; ++offset)
+        {
+            memcpy(shifted + offset, data, len);
+            mismatches += d_hash_bytes(shifted + offset, len, 0) != h;
+        }
+        mismatches += d_hash_bytes(data, len, 1) == h;
+    }
+    usize zero = 0;
+    assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+    //zero bytes of different lengths, and every prefix of the same buffer, all hash differently
+    u64 hashes[1200];
+    memset(shifted, 0, max_len);
+    for (usize len = 0; len < 600; ++len)
+    {
+        hashes[len] = d_hash_bytes(shifted, len, 0);
+        hashes[600 + len] = d_hash_bytes(data, len + 1, 0);
+    }
+    usize collisions = count_collisions(hashes, 1200);
+    assert_eq_custom(&collisions, &zero, sizeof(usize), itoa_usize);
+    u64 h = d_hash_c_string("hash me", 42);
+    bool expected = true;
+    bool valid = h == d_hash_bytes("hash me", 7, 42);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    free(data);
+    free(shifted);
+}
+
+void    test_d_hash_bytes_distribution(void)
+{
+    usize count = 200000;
+    u64* hashes = malloc(count * sizeof(u64));
+    char buffer[64];
+    for (usize i = 0; i < count; ++i)
+        hashes[i] = d_hash_c_string(d_itoa_usize_no_alloc(i, buffer), 0);
+    usize zero = 0;
+    usize collisions = count_collisions(hashes, count);
+    assert_eq_custom(&collisions, &zero, sizeof(usize), itoa_usize);
+    //flipping any input bit flips about half of the output bits
+    usize lens[] = {3, 8, 16, 64, 200, 4096};
+    u8* data = calloc(4096, 1);
+    bool expected = true;
+    for (usize l = 0; l < 6; ++l)
+    {
+        u64 h = d_hash_bytes(data, lens[l], 0);
+        usize flipped = 0;
+        usize bits = lens[l] * 8;
+        for (usize bit = 0; bit < bits; ++bit)
+        {
+            data[bit / 8] ^= 1 << (bit % 8);
+            flipped += __builtin_popcountll(h ^ d_hash_bytes(data, lens[l], 0));
+            data[bit / 8] ^= 1 << (bit % 8);
+        }
+        bool valid = flipped > bits * 30 && flipped < bits * 34;
+        assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    }
+    free(data);
+    free(hashes);
+}
+
+void    test_d_hash_batch(void)
+{
+    DPointerArray* c_strings = d_pointer_array_new(0, false, free);
+    DPointerArray* dstrings = d_pointer_array_new(0, false, NULL);
+    char buffer[1200];
+    //lengths spread over the short, medium and bulk paths, 1003 keys so the last batch is partial
+    for (usize i = 0; i < 1003; ++i)
+    {
+        usize len = i % 7 == 0 ? i : i % 23;
+        for (usize k = 0; k < len; ++k)
+            buffer[k] = 'a' + (i * 31 + k * 7) % 26;
+        buffer[len] = '\0';
+        d_pointer_array_push_back(c_strings, d_strdup(buffer));
+        d_pointer_array_push_back(dstrings, d_string_new_from_c_string(buffer));
+    }
+    u64* hashes = malloc(1003 * sizeof(u64));
+    u64* dhashes = malloc(1003 * sizeof(u64));
+    d_hash_c_strings(c_strings, hashes, 7);
+    d_hash_dstrings(dstrings, dhashes, 7);
+    usize mismatches = 0;
+    for (usize i = 0; i < 1003; ++i)
+        mismatches += hashes[i] != d_hash_c_string(c_strings -> pdata[i], 7) || dhashes[i] != hashes[i];
+    usize zero = 0;
+    assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+    for (usize i = 0; i < 1003; ++i)
+    {
+        DString* dstring = dstrings -> pdata[i];
+        d_string_destroy(&dstring);
+    }
+    free(hashes);
+    free(dhashes);
+    d_pointer_array_destroy(&c_strings);
+    d_pointer_array_destroy(&dstrings);
+}
+
+void    test_d_hash_mixers(void)
+{
+    usize count = 1 << 20;
+    u64* hashes = malloc(count * sizeof(u64));
+    //sequential and strided keys, the usual ids, never collide
+    for (usize i = 0; i < count; ++i)
+        hashes[i] = d_hash_u32(i);
+    usize zero = 0;
+    usize collisions = count_collisions(hashes, count);
+    assert_eq_custom(&collisions, &zero, sizeof(usize), itoa_usize);
+    for (usize i = 0; i < count; ++i)
+        hashes[i] = d_hash_u64((u64)i << 32);
+    collisions = count_collisions(hashes, count);
+    assert_eq_custom(&collisions, &zero, sizeof(usize), itoa_usize);
+    usize flipped32 = 0;
+    usize flipped64 = 0;
+    for (u32 bit = 0; bit < 32; ++bit)
+        flipped32 += __builtin_popcount(d_hash_u32(12345) ^ d_hash_u32(12345 ^ (1u << bit)));
+    for (u32 bit = 0; bit < 64; ++bit)
+        flipped64 += __builtin_popcountll(d_hash_u64(12345) ^ d_hash_u64(12345 ^ (1ULL << bit)));
+    bool expected = true;
+    bool valid = flipped32 > 32 * 12 && flipped32 < 32 * 20 && flipped64 > 64 * 26 && flipped64 < 64 * 38;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    free(hashes);
+}
+
+void    test_d_concurrent_map(void)
+{
+    DConcurrentMap* map = d_concurrent_map_new(sizeof(u64), sizeof(u64), 4);
+    u64* model = calloc(3000, sizeof(u64));
+    usize mismatches = 0;
+    srand(9);
+    for (u64 round = 1; round <= 100000; ++round)
+    {
+        u64 key = (u64)rand() % 3000;
+        if (rand() % 3)
+        {
+            model[key] = round;
+            mismatches += d_concurrent_map_insert(map, &key, &round) == false;
+        }
+        else
+        {
+            mismatches += d_concurrent_map_remove(map, &key) != (model[key] != 0);
+            model[key] = 0;
+        }
+    }
+    usize len = 0;
+    for (u64 key = 0; key < 3000; ++key)
+    {
+        u64 value = 0;
+        bool found = d_concurrent_map_get(map, &key, &value);
+        mismatches += found != (model[key] != 0) || value != model[key];
+        len += model[key] != 0;
+    }
+    usize zero = 0;
+    assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+    usize map_len = d_concurrent_map_get_len(map);
+    assert_eq_custom(&map_len, &len, sizeof(usize), itoa_usize);
+    u64 key = 5;
+    d_concurrent_map_insert(map, &key, NULL);
+    bool expected = true;
+    bool valid = d_concurrent_map_get(map, &key, NULL) && d_concurrent_map_get(map, &key, &key) && key == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    free(model);
+    d_concurrent_map_destroy(&map);
+    assert_eq_null(map);
+    assert_eq_null(d_concurrent_map_new(0, 8, 0));
+}
+
+//A value whose two halves are always written together, a torn read would break the relation
+typedef struct {
+    u64 key;
+    u64 version;
+    u64 check;
+} ConcurrentValue;
+
+#define CONCURRENT_THREADS 4
+#define CONCURRENT_KEYS 20000
+
+typedef struct {
+    DConcurrentMap* map;
+    u64             id;
+    usize           errors;
+    bool*           stop;
+} ConcurrentWorker;
+
+void*   concurrent_writer(void* arg)
+{
+    ConcurrentWorker* worker = arg;
+    //each writer owns the keys equal to its id modulo the number of threads
+    for (u64 round = 1; round <= 20; ++round)
+    {
+        for (u64 key = worker -> id; key < CONCURRENT_KEYS; key += CONCURRENT_THREADS)
+        {
+            ConcurrentValue value = { key, round, key * 31 + round };
+            worker -> errors += d_concurrent_map_insert(worker -> map, &key, &value) == false;
+        }
+        for (u64 key = worker -> id; key < CONCURRENT_KEYS; key += CONCURRENT_THREADS * 2)
+            worker -> errors += d_concurrent_map_remove(worker -> map, &key) == false;
+    }
+    return NULL;
+}
+
+void*   concurrent_reader(void* arg)
+{
+    ConcurrentWorker* worker = arg;
+    u64 key = worker -> id;
+    while (__atomic_load_n(worker -> stop, __ATOMIC_ACQUIRE) == false)
+    {
+        ConcurrentValue value;
+        key = (key * 6364136223846793005ULL + 1442695040888963407ULL);
+        u64 k = (key >> 33) % CONCURRENT_KEYS;
+        if (d_concurrent_map_get(worker -> map, &k, &value))
+            worker -> errors += value.key != k || value.check != k * 31 + value.version;
+    }
+    return NULL;
+}
+
+void    count_update(void* value, bool inserted, void* ctx)
+{
+    (void)ctx;
+    *(u64*)value += 1 + inserted * 1000000;
+}
+
+void*   concurrent_counter(void* arg)
+{
+    ConcurrentWorker* worker = arg;
+    for (u64 round = 0; round < 20000; ++round)
+    {
+        u64 key = round % 100;
+        worker -> errors += d_concurrent_map_update(worker -> map, &key, count_update, NULL) == false;
+    }
+    return NULL;
+}
+
+void    test_d_concurrent_map_threads(void)
+{
+    DConcurrentMap* map = d_concurrent_map_new(sizeof(u64), sizeof(ConcurrentValue), 8);
+    pthread_t threads[CONCURRENT_THREADS * 2];
+    ConcurrentWorker workers[CONCURRENT_THREADS * 2];
+    bool stop = false;
+    for (usize i = 0; i < CONCURRENT_THREADS * 2; ++i)
+    {
+        workers[i] = (ConcurrentWorker){ map, i % CONCURRENT_THREADS, 0, &stop };
+        pthread_create(threads + i, NULL, i < CONCURRENT_THREADS ? concurrent_writer : concurrent_reader, workers + i);
+    }
+    for (usize i = 0; i < CONCURRENT_THREADS; ++i)
+        pthread_join(threads[i], NULL);
+    __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+    usize errors = 0;
+    for (usize i = CONCURRENT_THREADS; i < CONCURRENT_THREADS * 2; ++i)
+        pthread_join(threads[i], NULL);
+    for (usize i = 0; i < CONCURRENT_THREADS * 2; ++i)
+        errors += workers[i].errors;
+    //every writer removed one key out of two of its own in the last round
+    for (u64 key = 0; key < CONCURRENT_KEYS; ++key)
+    {
+        ConcurrentValue value;
+        bool found = d_concurrent_map_get(map, &key, &value);
+        bool removed = key % (CONCURRENT_THREADS * 2) < CONCURRENT_THREADS;
+        errors += found == removed || (found && value.version != 20);
+    }
+    usize zero = 0;
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+    usize len = CONCURRENT_KEYS / 2;
+    usize map_len = d_concurrent_map_get_len(map);
+    assert_eq_custom(&map_len, &len, sizeof(usize), itoa_usize);
+    d_concurrent_map_destroy(&map);
+    //no update is lost when every thread hits the same keys
+    map = d_concurrent_map_new(sizeof(u64), sizeof(u64), 2);
+    for (usize i = 0; i < CONCURRENT_THREADS; ++i)
+    {
+        workers[i] = (ConcurrentWorker){ map, i, 0, &stop };
+        pthread_create(threads + i, NULL, concurrent_counter, workers + i);
+    }
+    for (usize i = 0; i < CONCURRENT_THREADS; ++i)
+        pthread_join(threads[i], NULL);
+    for (u64 key = 0; key < 100; ++key)
+    {
+        u64 count = 0;
+        d_concurrent_map_get(map, &key, &count);
+        errors += count != 1000000 + 200 * CONCURRENT_THREADS;
+    }
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+    d_concurrent_map_destroy(&map);
+}
+
+//Elements of an odd size, to check the buckets are packed `elem_size` bytes apart
+typedef struct {
+    u32 id;
+    u8  tag[7];
+} OddElem;
+
+u64     hash_odd_elem(const void* elem)
+{
+    return ((const OddElem*)elem) -> id;
+}
+
+bool    equal_odd_elem(const void* elem1, const void* elem2)
+{
+    return ((const OddElem*)elem1) -> id == ((const OddElem*)elem2) -> id;
+}
+
+void    test_d_hash_set_insert(void)
+{
+    DHashSet* set = d_hash_set_new(sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL);
+    usize zero = 0;
+    assert_eq_custom(&set -> len, &zero, sizeof(usize), itoa_usize);
+    assert_eq_null(d_hash_set_get(set, &zero));
+    bool valid = true;
+    for (u64 elem = 0; elem < 10000; ++elem)
+    {
+        bool inserted = false;
+        u64* stored = d_hash_set_insert(set, &elem, &inserted);
+        valid = valid && stored != NULL && *stored == elem && inserted;
+    }
+    for (u64 elem = 0; elem < 10000 && valid; ++elem)
+        valid = *(u64*)d_hash_set_get(set, &elem) == elem && d_hash_set_contains(set, &elem);
+    for (u64 elem = 10000; elem < 20000 && valid; ++elem)
+        valid = d_hash_set_get(set, &elem) == NULL && d_hash_set_contains(set, &elem) == false;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //inserting a present element keeps the set unchanged
+    u64 elem = 77;
+    bool inserted = true;
+    valid = d_hash_set_insert(set, &elem, &inserted) == d_hash_set_get(set, &elem) && inserted == false;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    usize len = 10000;
+    assert_eq_custom(&set -> len, &len, sizeof(usize), itoa_usize);
+    valid = d_hash_set_get_capacity(set) >= len;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_set_destroy(&set);
+    assert_eq_null(set);
+    d_hash_set_destroy(&set);
+    assert_eq_null(d_hash_set_new(0, d_hash_u64_key, d_equal_u64_key, NULL));
+    //elements of 11 bytes
+    set = d_hash_set_new(sizeof(OddElem), hash_odd_elem, equal_odd_elem, NULL);
+    for (u32 id = 0; id < 3000; ++id)
+    {
+        OddElem odd = { id, {0} };
+        memset(odd.tag, id & 0xff, sizeof(odd.tag));
+        d_hash_set_insert(set, &odd, NULL);
+    }
+    valid = true;
+    for (u32 id = 0; id < 3000 && valid; ++id)
+    {
+        OddElem odd = { id, {0} };
+        OddElem* stored = d_hash_set_get(set, &odd);
+        valid = stored != NULL && stored -> id == id && stored -> tag[6] == (id & 0xff);
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_set_destroy(&set);
+}
+
+//Random insertions and removals checked against a plain array indexed by the element
+void    test_d_hash_set_churn(void)
+{
+    DHashFunc hashes[] = {d_hash_u64_key, hash_constant};
+    usize ranges[] = {4096, 200};
+    bool expected = true;
+    for (usize h = 0; h < 2; ++h)
+    {
+        DHashSet* set = d_hash_set_new(sizeof(u64), hashes[h], d_equal_u64_key, NULL);
+        usize range = ranges[h];
+        bool* model = calloc(range, sizeof(bool));
+        usize model_len = 0;
+        usize mismatches = 0;
+        srand(13);
+        for (usize round = 0; round < 200000 / (1 + 20 * h); ++round)
+        {
+            u64 elem = (u64)rand() % range;
+            //elements spread on high bits only, to check the mixing of weak hashes
+            u64 stored = elem << 40;
+            if (rand() % 2)
+            {
+                bool inserted;
+                d_hash_set_insert(set, &stored, &inserted);
+                mismatches += inserted == model[elem];
+                model_len += model[elem] == false;
+                model[elem] = true;
+            }
+            else
+            {
+                mismatches += d_hash_set_remove(set, &stored) != model[elem];
+                model_len -= model[elem];
+                model[elem] = false;
+            }
+        }
+        for (u64 elem = 0; elem < range; ++elem)
+        {
+            u64 stored = elem << 40;
+            mismatches += d_hash_set_contains(set, &stored) != model[elem];
+        }
+        mismatches += set -> len != model_len;
+        //the iteration sees every element once
+        DHashSetIter it;
+        void* elem;
+        usize visited = 0;
+        d_hash_set_iter_init(&it, set);
+        while (d_hash_set_iter_next(&it, &elem))
+        {
+            mismatches += model[*(u64*)elem >> 40] == false;
+            ++visited;
+        }
+        mismatches += visited != model_len;
+        usize zero = 0;
+        assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+        //backward shifting leaves no tombstone behind, the set never grows beyond what its elements need
+        bool valid = d_hash_set_get_capacity(set) <= 2 * range;
+        assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+        free(model);
+        d_hash_set_destroy(&set);
+    }
+}
+
+void    test_d_hash_set_insert_many(void)
+{
+    DString* text = d_string_new_from_c_string("the cat and the dog and the bird saw the cat");
+    DPointerArray* tokens = d_string_split_by_char(text, ' ');
+    DHashSet* set = d_hash_set_new(sizeof(char*), d_hash_c_string_key, d_equal_c_string_key, NULL);
+    usize added = d_hash_set_insert_many(set, tokens -> pdata, tokens -> len);
+    usize unique = 6;
+    assert_eq_custom(&added, &unique, sizeof(usize), itoa_usize);
+    assert_eq_custom(&set -> len, &unique, sizeof(usize), itoa_usize);
+    const char* bird = "bird";
+    const char* fish = "fish";
+    bool valid = strcmp(*(char**)d_hash_set_get(set, &bird), "bird") == 0 && d_hash_set_contains(set, &fish) == false;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_set_destroy(&set);
+    d_pointer_array_destroy(&tokens);
+    d_string_destroy(&text);
+    //many batches with duplicates, the same result as one insertion at a time
+    set = d_hash_set_new(sizeof(u64), d_hash_u64_key, d_equal_u64_key, count_destroyed);
+    DHashSet* reference = d_hash_set_new(sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL);
+    u64* elems = malloc(10007 * sizeof(u64));
+    for (usize i = 0; i < 10007; ++i)
+        elems[i] = d_hash_u64(i) % 5000;
+    usize reference_added = 0;
+    for (usize i = 0; i < 10007; ++i)
+    {
+        bool inserted;
+        d_hash_set_insert(reference, elems + i, &inserted);
+        reference_added += inserted;
+    }
+    g_destroyed = 0;
+    added = d_hash_set_insert_many(set, elems, 10007);
+    assert_eq_custom(&added, &reference_added, sizeof(usize), itoa_usize);
+    assert_eq_custom(&set -> len, &reference -> len, sizeof(usize), itoa_usize);
+    //every duplicate given is handed to the destroy function
+    usize duplicates = 10007 - added;
+    assert_eq_custom(&g_destroyed, &duplicates, sizeof(usize), itoa_usize);
+    valid = true;
+    for (usize i = 0; i < 10007 && valid; ++i)
+        valid = d_hash_set_contains(set, elems + i);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    usize zero = 0;
+    added = d_hash_set_insert_many(set, NULL, 0);
+    assert_eq_custom(&added, &zero, sizeof(usize), itoa_usize);
+    free(elems);
+    d_hash_set_destroy(&reference);
+    g_destroyed = 0;
+    d_hash_set_destroy(&set);
+    assert_eq_custom(&g_destroyed, &reference_added, sizeof(usize), itoa_usize);
+}
+
+void    test_d_hash_set_degenerate(void)
+{
+    //with a constant hash every element shares one run, whose distances fit in 8 bits up to 255 elements
+    DHashSet* set = d_hash_set_new(sizeof(u64), hash_constant, d_equal_u64_key, NULL);
+    usize inserted_count = 0;
+    for (u64 elem = 0; elem < 300; ++elem)
+        inserted_count += d_hash_set_insert(set, &elem, NULL) != NULL;
+    usize max = 255;
+    assert_eq_custom(&inserted_count, &max, sizeof(usize), itoa_usize);
+    assert_eq_custom(&set -> len, &max, sizeof(usize), itoa_usize);
+    bool valid = true;
+    for (u64 elem = 0; elem < 300 && valid; ++elem)
+        valid = d_hash_set_contains(set, &elem) == (elem < 255);
+    //removing from the front of the run shifts the rest back and makes room again
+    for (u64 elem = 0; elem < 10 && valid; ++elem)
+        valid = d_hash_set_remove(set, &elem);
+    for (u64 elem = 10; elem < 300 && valid; ++elem)
+        valid = d_hash_set_contains(set, &elem) == (elem < 255);
+    u64 elem = 299;
+    valid = valid && d_hash_set_insert(set, &elem, NULL) != NULL && d_hash_set_contains(set, &elem);
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_set_clear(set);
+    usize zero = 0;
+    assert_eq_custom(&set -> len, &zero, sizeof(usize), itoa_usize);
+    valid = d_hash_set_contains(set, &elem) == false && d_hash_set_insert(set, &elem, NULL) != NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_hash_set_destroy(&set);
+}
+
+void    test_d_hash_set_allocator(void)
+{
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    DHashSet* set = d_hash_set_new_with_allocator(sizeof(u64), d_hash_u64_key, d_equal_u64_key, NULL, &allocator);
+    set = d_hash_set_reserve(set, 100);
+    usize allocs = counter.allocs;
+    for (u64 elem = 0; elem < 100; ++elem)
+        d_hash_set_insert(set, &elem, NULL);
+    //the reserved buckets were enough
+    assert_eq_custom(&counter.allocs, &allocs, sizeof(usize), itoa_usize);
+    d_hash_set_destroy(&set);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.size_mismatches, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.frees, &counter.allocs, sizeof(usize), itoa_usize);
+}
+
+void    test_d_intern_pool(void)
+{
+    DInternPool* pool = d_intern_pool_new(false);
+    char buffer[] = "identifier";
+    const char* first = d_intern_pool_intern(pool, buffer);
+    const char* second = d_intern_pool_intern(pool, "identifier");
+    //the canonical string is a copy, changing the given string does not change it
+    buffer[0] = 'I';
+    bool valid = first != NULL && first == second && first != buffer && strcmp(first, "identifier") == 0;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //views need no null terminator, and a DString with the same content gives the same canonical string
+    DString* dstring = d_string_new_from_c_string("identifier");
+    valid = d_intern_pool_intern_view(pool, d_string_view_from_buffer("identifier_suffix", 10)) == first
+        && d_intern_pool_intern_dstring(pool, dstring) == first
+        && d_intern_pool_intern(pool, "Identifier") != first
+        && d_intern_pool_intern(pool, "") != NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_string_destroy(&dstring);
+    usize len = 3;
+    usize pool_len = d_intern_pool_get_len(pool);
+    assert_eq_custom(&pool_len, &len, sizeof(usize), itoa_usize);
+    //ids are given in order and lead back to the canonical string
+    u32 id = d_intern_pool_intern_id(pool, d_string_view_from_c_string("Identifier"));
+    u32 one = 1;
+    assert_eq_custom(&id, &one, sizeof(u32), itoa_usize);
+    valid = d_intern_pool_string_id(first) == 0 && d_intern_pool_get_string(pool, 0) == first
+        && d_intern_pool_string_len(first) == 10 && d_intern_pool_get_string(pool, 3) == NULL
+        && d_intern_pool_get_string(pool, D_INTERN_INVALID_ID) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //finding never interns
+    valid = d_intern_pool_find(pool, d_string_view_from_c_string("identifier")) == first
+        && d_intern_pool_find(pool, d_string_view_from_c_string("missing")) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    assert_eq_custom(&pool_len, &len, sizeof(usize), itoa_usize);
+    d_intern_pool_destroy(&pool);
+    assert_eq_null(pool);
+    d_intern_pool_destroy(&pool);
+}
+
+void    test_d_intern_pool_many(void)
+{
+    DInternPool* pool = d_intern_pool_new(false);
+    const char** canonical = malloc(20000 * sizeof(const char*));
+    char buffer[32];
+    bool valid = true;
+    for (usize i = 0; i < 20000; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), "name_%zu", i);
+        canonical[i] = d_intern_pool_intern(pool, buffer);
+        valid = valid && canonical[i] != NULL && d_intern_pool_string_id(canonical[i]) == i;
+    }
+    //interning again finds the same strings, whose ids index the id table
+    for (usize i = 0; i < 20000 && valid; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), "name_%zu", i);
+        valid = d_intern_pool_intern(pool, buffer) == canonical[i] && d_intern_pool_get_string(pool, i) == canonical[i]
+            && d_intern_pool_string_len(canonical[i]) == strlen(buffer);
+    }
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    DInternStats stats;
+    d_intern_pool_get_stats(pool, &stats);
+    usize len = 20000;
+    assert_eq_custom(&stats.strings, &len, sizeof(usize), itoa_usize);
+    usize string_bytes = 0;
+    for (usize i = 0; i < 20000; ++i)
+        string_bytes += strlen(canonical[i]) + 1;
+    assert_eq_custom(&stats.string_bytes, &string_bytes, sizeof(usize), itoa_usize);
+    valid = stats.arena_bytes >= stats.string_bytes + 20000 * 8 && stats.table_bytes >= 20000 * 16
+        && stats.id_bytes >= 20000 * sizeof(char*)
+        && stats.total_bytes > stats.arena_bytes + stats.table_bytes + stats.id_bytes;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    free(canonical);
+    d_intern_pool_destroy(&pool);
+}
+
+typedef struct {
+    DInternPool*    pool;
+    usize           first;
+    const char**    canonical;
+} InternWorker;
+
+void*   intern_worker(void* arg)
+{
+    InternWorker* worker = arg;
+    char buffer[32];
+    //the workers' ranges overlap, every string is interned by two threads
+    for (usize round = 0; round < 3; ++round)
+    {
+        for (usize i = 0; i < 4000; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "shared_%zu", worker -> first + i);
+            worker -> canonical[i] = d_intern_pool_intern(worker -> pool, buffer);
+        }
+    }
+    return NULL;
+}
+
+void    test_d_intern_pool_threads(void)
+{
+    DInternPool* pool = d_intern_pool_new(true);
+    pthread_t threads[4];
+    InternWorker workers[4];
+    for (usize t = 0; t < 4; ++t)
+    {
+        workers[t] = (InternWorker){ pool, t * 2000, malloc(4000 * sizeof(const char*)) };
+        pthread_create(threads + t, NULL, intern_worker, workers + t);
+    }
+    for (usize t = 0; t < 4; ++t)
+        pthread_join(threads[t], NULL);
+    usize len = 10000;
+    usize pool_len = d_intern_pool_get_len(pool);
+    assert_eq_custom(&pool_len, &len, sizeof(usize), itoa_usize);
+    //threads interning the same string got the same pointer
+    usize mismatches = 0;
+    for (usize t = 1; t < 4; ++t)
+    {
+        for (usize i = 0; i < 2000; ++i)
+            mismatches += workers[t].canonical[i] != workers[t - 1].canonical[i + 2000];
+    }
+    //the ids are dense, every one of them leads to a distinct string
+    bool* seen = calloc(len, sizeof(bool));
+    for (u32 id = 0; id < len; ++id)
+    {
+        const char* str = d_intern_pool_get_string(pool, id);
+        mismatches += str == NULL || d_intern_pool_string_id(str) != id || strncmp(str, "shared_", 7) != 0;
+        if (str != NULL)
+        {
+            usize n = (usize)atoi(str + 7);
+            mismatches += n >= len || seen[n];
+            if (n < len)
+                seen[n] = true;
+        }
+    }
+    usize zero = 0;
+    assert_eq_custom(&mismatches, &zero, sizeof(usize), itoa_usize);
+    free(seen);
+    for (usize t = 0; t < 4; ++t)
+        free(workers[t].canonical);
+    d_intern_pool_destroy(&pool);
+}
+
+int main()
+{
+    TEST("test_d_hash_map_insert", test_d_hash_map_insert(););
+    TEST("test_d_hash_map_emplace", test_d_hash_map_emplace(););
+    TEST("test_d_hash_map_remove", test_d_hash_map_remove(););
+    TEST("test_d_hash_map_churn", test_d_hash_map_churn(););
+    TEST("test_d_hash_map_iter", test_d_hash_map_iter(););
+    TEST("test_d_hash_map_destroy_funcs", test_d_hash_map_destroy_funcs(););
+    TEST("test_d_hash_map_set", test_d_hash_map_set(););
+    TEST("test_d_hash_map_reserve", test_d_hash_map_reserve(););
+    TEST("test_d_hash_map_allocator", test_d_hash_map_allocator(););
+    TEST("test_d_string_map_insert", test_d_string_map_insert(););
+    TEST("test_d_string_map_long_keys", test_d_string_map_long_keys(););
+    TEST("test_d_string_map_emplace", test_d_string_map_emplace(););
+    TEST("test_d_string_map_remove", test_d_string_map_remove(););
+    TEST("test_d_string_map_iter", test_d_string_map_iter(););
+    TEST("test_d_string_map_allocator", test_d_string_map_allocator(););
+    TEST("test_d_hash_bytes", test_d_hash_bytes(););
+    TEST("test_d_hash_bytes_distribution", test_d_hash_bytes_distribution(););
+    TEST("test_d_hash_batch", test_d_hash_batch(););
+    TEST("test_d_hash_mixers", test_d_hash_mixers(););
+    TEST("test_d_concurrent_map", test_d_concurrent_map(););
+    TEST("test_d_concurrent_map_threads", test_d_concurrent_map_threads(););
+    TEST("test_d_hash_set_insert", test_d_hash_set_insert(););
+    TEST("test_d_hash_set_churn", test_d_hash_set_churn(););
+    TEST("test_d_hash_set_insert_many", test_d_hash_set_insert_many(););
+    TEST("test_d_hash_set_degenerate", test_d_hash_set_degenerate(););
+    TEST("test_d_hash_set_allocator", test_d_hash_set_allocator(););
+    TEST("test_d_intern_pool", test_d_intern_pool(););
+    TEST("test_d_intern_pool_many", test_d_intern_pool_many(););
+    TEST("test_d_intern_pool_threads", test_d_intern_pool_threads(););
+}
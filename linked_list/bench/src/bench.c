@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "d_unrolled_list.h"
+#include "d_linked_list.h"
+#include "darray.h"
+
+/*
+ * Sequence benchmark of DUnrolledList against DDoubleList and DArray, from 10^3 to 10^7 u64 elements.
+ *
+ * The scan sums every element: the array reads one contiguous block, the unrolled list one block per node through
+ * d_unrolled_list_iter_chunk and the doubly linked list chases a pointer per element. The insertions all happen at
+ * the middle of the sequence, the position being reached once before the timing as an iterator or a node would be
+ * kept by a real caller: the lists only touch the neighbourhood of the position, the array moves half of itself.
+ */
+
+#define SCANNED_ELEMENTS 50000000
+#define INSERTIONS 1000
+
+static double    now_in_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void    bench_unrolled(usize n, double* scan_ns, double* insert_ns)
+{
+    DUnrolledList* list = d_unrolled_list_new(sizeof(u64));
+    for (u64 i = 0; i < n; ++i)
+        d_unrolled_list_push_back(list, &i);
+    usize rounds = SCANNED_ELEMENTS / n + 1;
+    u64 sum = 0;
+    double start = now_in_seconds();
+    for (usize r = 0; r < rounds; ++r)
+    {
+        DUnrolledIter it;
+        usize count;
+        u64* values;
+        d_unrolled_list_iter_init(&it, list);
+        while ((values = d_unrolled_list_iter_chunk(&it, &count)) != NULL)
+            for (usize i = 0; i < count; ++i)
+                sum += values[i];
+    }
+    *scan_ns = (now_in_seconds() - start) * 1e9 / ((double)rounds * n);
+    DUnrolledIter it;
+    d_unrolled_list_iter_seek(&it, list, n / 2);
+    start = now_in_seconds();
+    for (u64 i = 0; i < INSERTIONS; ++i)
+        d_unrolled_list_iter_insert(&it, &i);
+    *insert_ns = (now_in_seconds() - start) * 1e9 / INSERTIONS;
+    if (sum == 42)
+        printf("unlikely\n");
+    d_unrolled_list_destroy(&list);
+}
+
+static void    bench_double_list(usize n, double* scan_ns, double* insert_ns)
+{
+    DDoubleList* list = NULL;
+    for (usize i = n; i > 0; --i)
+        d_double_list_push_front(&list, (void*)(i - 1));
+    usize rounds = SCANNED_ELEMENTS / n + 1;
+    u64 sum = 0;
+    double start = now_in_seconds();
+    for (usize r = 0; r < rounds; ++r)
+        for (DDoubleList* node = list; node != NULL; node = node -> next)
+            sum += (u64)node -> data;
+    *scan_ns = (now_in_seconds() - start) * 1e9 / ((double)rounds * n);
+    DDoubleList* middle = list;
+    for (usize i = 0; i < n / 2; ++i)
+        middle = middle -> next;
+    start = now_in_seconds();
+    for (usize i = 0; i < INSERTIONS; ++i)
+        middle = d_double_list_insert_before(&list, middle, (void*)i);
+    *insert_ns = (now_in_seconds() - start) * 1e9 / INSERTIONS;
+    if (sum == 42)
+        printf("unlikely\n");
+    d_double_list_destroy(&list, NULL);
+}
+
+static void    bench_array(usize n, double* scan_ns, double* insert_ns)
+{
+    DArray* array = d_array_new(false, sizeof(u64), n + INSERTIONS);
+    for (u64 i = 0; i < n; ++i)
+        d_array_append_vals(array, &i, 1);
+    usize rounds = SCANNED_ELEMENTS / n + 1;
+    u64 sum = 0;
+    double start = now_in_seconds();
+    for (usize r = 0; r < rounds; ++r)
+    {
+        u64* values = array -> data;
+        for (usize i = 0; i < array -> len; ++i)
+            sum += values[i];
+    }
+    *scan_ns = (now_in_seconds() - start) * 1e9 / ((double)rounds * n);
+    usize middle = n / 2;
+    start = now_in_seconds();
+    for (u64 i = 0; i < INSERTIONS; ++i)
+    {
+        d_array_append_vals(array, &i, 1);
+        u64* values = array -> data;
+        memmove(values + middle + 1, values + middle, (array -> len - 1 - middle) * sizeof(u64));
+        values[middle] = i;
+    }
+    *insert_ns = (now_in_seconds() - start) * 1e9 / INSERTIONS;
+    if (sum == 42)
+        printf("unlikely\n");
+    d_array_destroy(&array);
+}
+
+int main(void)
+{
+    printf("Sequence benchmark, u64 elements, ns per element scanned and per insertion at the middle\n");
+    printf("%10s %14s %14s %14s %14s %14s %14s\n", "n", "unrolled scan", "list scan", "array scan",
+        "unrolled ins", "list ins", "array ins");
+    for (usize n = 1000; n <= 10000000; n *= 10)
+    {
+        double scan[3];
+        double insert[3];
+        bench_unrolled(n, scan, insert);
+        bench_double_list(n, scan + 1, insert + 1);
+        bench_array(n, scan + 2, insert + 2);
+        printf("%10zu %14.2f %14.2f %14.2f %14.2f %14.2f %14.2f\n", n, scan[0], scan[1], scan[2],
+            insert[0], insert[1], insert[2]);
+    }
+    return 0;
+}
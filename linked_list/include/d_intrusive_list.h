@@ -0,0 +1,351 @@
+#ifndef __D_INTRUSIVE_LIST__H
+#define __D_INTRUSIVE_LIST__H
+
+#include <dtypes.h>
+#include <stddef.h>
+typedef struct _DListLink	DListLink;
+typedef struct _DSListLink	DSListLink;
+typedef struct _DSList		DSList;
+
+/**
+ * @brief Retrieves a pointer to the structure of type `type` whose field `member` is at `ptr`.
+ *
+ * The link of an intrusive list is a field of the element itself, this is how the element is found from its link:
+ * `Task* task = d_container_of(link, Task, link)`.
+ */
+#define d_container_of(ptr, type, member) ((type*)((char*)(ptr) - offsetof(type, member)))
+
+/*-------------------------------------------------DListLink-------------------------------------------------*/
+
+/**
+ * DListLink:
+ *
+ * The link of an intrusive doubly linked list, to be embedded in the elements of the list.
+ * The list itself is a `DListLink` too, the head, which is never an element: the list is circular through it,
+ * so no operation has a special case for the first or the last element and every one of them is O(1),
+ * splicing a whole list included. An element can be on as many lists as it has links.
+ * Unlike #DDoubleList, nothing is allocated: the elements are wherever their owner put them, and going from one
+ * element to the next is a single pointer chase.
+ *
+ * @code
+ * typedef struct { int priority; DListLink link; } Task;
+ * DListLink queue;
+ * d_list_init(&queue);
+ * d_list_push_back(&queue, &task -> link);
+ * for (DListLink* it = d_list_first(&queue); it != &queue; it = it -> next)
+ *     d_container_of(it, Task, link) -> priority++;
+ * @endcode
+ */
+struct _DListLink {
+	DListLink*	next;
+	DListLink*	prev;
+};
+
+/**
+ * @brief Initializes `head` as an empty list. A link that is not on a list may be initialized the same way,
+ *        `d_list_is_linked` then tells whether it is on one.
+ */
+static inline void	d_list_init(DListLink* head)
+{
+	head -> next = head;
+	head -> prev = head;
+}
+
+/**
+ * @brief Tells whether the list of `head` has no element.
+ */
+static inline bool	d_list_is_empty(const DListLink* head)
+{
+	return head -> next == head;
+}
+
+/**
+ * @brief Tells whether a link initialized with `d_list_init` is on a list, links removed with `d_list_remove`
+ *        are initialized again.
+ */
+static inline bool	d_list_is_linked(const DListLink* link)
+{
+	return link -> next != link;
+}
+
+//Links `link` between `prev` and `next`, which are adjacent
+static inline void	d_list_link_between(DListLink* link, DListLink* prev, DListLink* next)
+{
+	link -> prev = prev;
+	link -> next = next;
+	prev -> next = link;
+	next -> prev = link;
+}
+
+/**
+ * @brief Links `link` right after `pos`, which is an element or the head of a list.
+ */
+static inline void	d_list_insert_after(DListLink* pos, DListLink* link)
+{
+	d_list_link_between(link, pos, pos -> next);
+}
+
+/**
+ * @brief Links `link` right before `pos`, which is an element or the head of a list.
+ */
+static inline void	d_list_insert_before(DListLink* pos, DListLink* link)
+{
+	d_list_link_between(link, pos -> prev, pos);
+}
+
+/**
+ * @brief Links `link` as the first element of the list of `head`.
+ */
+static inline void	d_list_push_front(DListLink* head, DListLink* link)
+{
+	d_list_insert_after(head, link);
+}
+
+/**
+ * @brief Links `link` as the last element of the list of `head`.
+ */
+static inline void	d_list_push_back(DListLink* head, DListLink* link)
+{
+	d_list_insert_before(head, link);
+}
+
+/**
+ * @brief Unlinks `link` from its list, whichever it is, and initializes it again.
+ */
+static inline void	d_list_remove(DListLink* link)
+{
+	link -> prev -> next = link -> next;
+	link -> next -> prev = link -> prev;
+	d_list_init(link);
+}
+
+/**
+ * @brief Retrieves the first element of the list of `head`, `head` itself if the list is empty.
+ */
+static inline DListLink*	d_list_first(const DListLink* head)
+{
+	return head -> next;
+}
+
+/**
+ * @brief Retrieves the last element of the list of `head`, `head` itself if the list is empty.
+ */
+static inline DListLink*	d_list_last(const DListLink* head)
+{
+	return head -> prev;
+}
+
+/**
+ * @brief Unlinks the first element of the list of `head`.
+ *
+ * @return DListLink* The link of the element, NULL if the list is empty.
+ */
+static inline DListLink*	d_list_pop_front(DListLink* head)
+{
+	if (d_list_is_empty(head))
+		return NULL;
+	DListLink* link = head -> next;
+	d_list_remove(link);
+	return link;
+}
+
+/**
+ * @brief Unlinks the last element of the list of `head`.
+ *
+ * @return DListLink* The link of the element, NULL if the list is empty.
+ */
+static inline DListLink*	d_list_pop_back(DListLink* head)
+{
+	if (d_list_is_empty(head))
+		return NULL;
+	DListLink* link = head -> prev;
+	d_list_remove(link);
+	return link;
+}
+
+/**
+ * @brief Moves every element of the list of `other` right after `pos`, in order, leaving `other` empty.
+ *
+ * `pos` is an element or the head of another list: splicing after the head puts the elements at the front,
+ * splicing after the last element, `d_list_last(head)`, puts them at the back.
+ */
+static inline void	d_list_splice_after(DListLink* pos, DListLink* other)
+{
+	if (d_list_is_empty(other))
+		return;
+	DListLink* first = other -> next;
+	DListLink* last = other -> prev;
+	DListLink* next = pos -> next;
+	first -> prev = pos;
+	pos -> next = first;
+	last -> next = next;
+	next -> prev = last;
+	d_list_init(other);
+}
+
+/**
+ * @brief Moves every element of the list of `other` to the back of the list of `head`, leaving `other` empty.
+ */
+static inline void	d_list_splice_back(DListLink* head, DListLink* other)
+{
+	d_list_splice_after(head -> prev, other);
+}
+
+/**
+ * @brief Counts the elements of the list of `head`, in O(n).
+ */
+static inline usize	d_list_get_len(const DListLink* head)
+{
+	usize len = 0;
+	for (const DListLink* it = head -> next; it != head; it = it -> next)
+		++len;
+	return len;
+}
+
+/**
+ * @brief Iterates over the links of the list of `head`, `it` being a `DListLink*`.
+ *        The current element must not be unlinked, see `d_list_for_each_safe`.
+ */
+#define d_list_for_each(it, head) for ((it) = (head) -> next; (it) != (head); (it) = (it) -> next)
+
+/**
+ * @brief Same as `d_list_for_each`, but the current element may be unlinked, `tmp` being a spare `DListLink*`.
+ */
+#define d_list_for_each_safe(it, tmp, head) \
+	for ((it) = (head) -> next, (tmp) = (it) -> next; (it) != (head); (it) = (tmp), (tmp) = (it) -> next)
+
+/*-------------------------------------------------DSListLink-------------------------------------------------*/
+
+/**
+ * DSListLink:
+ *
+ * The link of an intrusive singly linked list, one pointer per element, to be embedded in the elements as
+ * `DListLink` is. An element can only be unlinked through the element before it, `d_slist_remove_after`,
+ * which suits stacks, queues and free lists.
+ */
+struct _DSListLink {
+	DSListLink*	next;
+};
+
+/**
+ * DSList:
+ * @param head the first element, NULL if the list is empty.
+ *
+ * An intrusive singly linked list. It also tracks the `next` field of its last element, so pushing at the back
+ * and appending a whole list are O(1), as pushing and popping at the front are. Its other fields are private.
+ */
+struct _DSList {
+	DSListLink*		head;
+	DSListLink**	tail; /* the next field of the last element, or `head` */
+};
+
+/**
+ * @brief Initializes `list` as an empty list.
+ */
+static inline void	d_slist_init(DSList* list)
+{
+	list -> head = NULL;
+	list -> tail = &list -> head;
+}
+
+/**
+ * @brief Tells whether `list` has no element.
+ */
+static inline bool	d_slist_is_empty(const DSList* list)
+{
+	return list -> head == NULL;
+}
+
+/**
+ * @brief Links `link` as the first element of `list`.
+ */
+static inline void	d_slist_push_front(DSList* list, DSListLink* link)
+{
+	link -> next = list -> head;
+	if (list -> head == NULL)
+		list -> tail = &link -> next;
+	list -> head = link;
+}
+
+/**
+ * @brief Links `link` as the last element of `list`.
+ */
+static inline void	d_slist_push_back(DSList* list, DSListLink* link)
+{
+	link -> next = NULL;
+	*list -> tail = link;
+	list -> tail = &link -> next;
+}
+
+/**
+ * @brief Unlinks the first element of `list`.
+ *
+ * @return DSListLink* The link of the element, NULL if the list is empty.
+ */
+static inline DSListLink*	d_slist_pop_front(DSList* list)
+{
+	DSListLink* link = list -> head;
+	if (link == NULL)
+		return NULL;
+	list -> head = link -> next;
+	if (list -> head == NULL)
+		list -> tail = &list -> head;
+	return link;
+}
+
+/**
+ * @brief Links `link` right after `pos`, an element of `list`.
+ */
+static inline void	d_slist_insert_after(DSList* list, DSListLink* pos, DSListLink* link)
+{
+	link -> next = pos -> next;
+	pos -> next = link;
+	if (list -> tail == &pos -> next)
+		list -> tail = &link -> next;
+}
+
+/**
+ * @brief Unlinks the element right after `pos`, an element of `list`.
+ *
+ * @return DSListLink* The link of the element, NULL if `pos` is the last element.
+ */
+static inline DSListLink*	d_slist_remove_after(DSList* list, DSListLink* pos)
+{
+	DSListLink* link = pos -> next;
+	if (link == NULL)
+		return NULL;
+	pos -> next = link -> next;
+	if (list -> tail == &link -> next)
+		list -> tail = &pos -> next;
+	return link;
+}
+
+/**
+ * @brief Moves every element of `other` to the back of `list`, in order, leaving `other` empty.
+ */
+static inline void	d_slist_splice_back(DSList* list, DSList* other)
+{
+	if (other -> head == NULL)
+		return;
+	*list -> tail = other -> head;
+	list -> tail = other -> tail;
+	d_slist_init(other);
+}
+
+/**
+ * @brief Counts the elements of `list`, in O(n).
+ */
+static inline usize	d_slist_get_len(const DSList* list)
+{
+	usize len = 0;
+	for (const DSListLink* it = list -> head; it != NULL; it = it -> next)
+		++len;
+	return len;
+}
+
+/**
+ * @brief Iterates over the links of `list`, `it` being a `DSListLink*`. The current element must not be unlinked.
+ */
+#define d_slist_for_each(it, list) for ((it) = (list) -> head; (it) != NULL; (it) = (it) -> next)
+
+#endif
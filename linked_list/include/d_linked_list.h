@@ -1,18 +1,165 @@
 #ifndef __D_LINKED_LIST__H
 #define __D_LINKED_LIST__H
 
+#include <dtypes.h>
+#include <darray.h>
 typedef struct _DSinglyList DSinglyList;
 typedef struct _DDoubleList DDoubleList;
 
+/**
+ * DSinglyList:
+ * @param data the element of the node.
+ * @param next the next node, NULL for the last one.
+ *
+ * A node of a singly linked list of pointers, the list being a pointer to its first node, NULL when it is empty.
+ * The functions taking a `DSinglyList**` update that pointer.
+ * The nodes are not allocated one by one with `malloc`: they come from a pool of fixed-size objects shared by every
+ * list, through a cache owned by the calling thread, so allocating and freeing a node is a few instructions and
+ * the nodes allocated in a row sit next to each other in the slabs of the pool, which is what a traversal reads.
+ * Nodes may be freed by another thread than the one that allocated them.
+ * When the elements are structures owned by the list, the intrusive lists of `d_intrusive_list.h` save the
+ * separate allocation of each element and the pointer chase to reach it.
+ */
 struct _DSinglyList {
 	void*			data;
 	DSinglyList*	next;
 };
 
+/**
+ * DDoubleList:
+ * @param data the element of the node.
+ * @param next the next node, NULL for the last one.
+ * @param prev the previous node, NULL for the first one.
+ *
+ * A node of a doubly linked list of pointers, the list being a pointer to its first node, NULL when it is empty.
+ * The nodes come from a shared pool as the ones of #DSinglyList do. Knowing a node, inserting next to it or
+ * removing it is O(1).
+ */
 struct _DDoubleList {
 	void*			data;
 	DDoubleList*	next;
 	DDoubleList*	prev;
 };
 
-#endif
\ No newline at end of file
+/*-------------------------------------------------DSinglyList-------------------------------------------------*/
+
+/**
+ * @brief Inserts `data` at the front of a list.
+ *
+ * @param list A pointer to the list, set to the new first node. Must not be NULL.
+ * @param data The element.
+ *
+ * @return DSinglyList* The new node, NULL if the allocation failed (the list is then left untouched).
+ */
+DSinglyList*	d_singly_list_push_front	(DSinglyList** list, void* data);
+
+/**
+ * @brief Removes the first node of a list.
+ *
+ * @param list A pointer to the list, set to the next node. Must not be NULL.
+ *
+ * @return void* The element of the removed node, NULL if the list is empty.
+ */
+void*			d_singly_list_pop_front		(DSinglyList** list);
+
+/**
+ * @brief Inserts `data` right after `node`.
+ *
+ * @return DSinglyList* The new node, NULL if the allocation failed.
+ */
+DSinglyList*	d_singly_list_insert_after	(DSinglyList* node, void* data);
+
+/**
+ * @brief Removes the node right after `node`.
+ *
+ * @return void* The element of the removed node, NULL if `node` is the last one.
+ */
+void*			d_singly_list_remove_after	(DSinglyList* node);
+
+/**
+ * @brief Reverses a list in place.
+ *
+ * @param list A pointer to the list, set to its former last node. Must not be NULL.
+ */
+void			d_singly_list_reverse		(DSinglyList** list);
+
+/**
+ * @brief Counts the nodes of a list, in O(n).
+ */
+usize			d_singly_list_get_len		(const DSinglyList* list);
+
+/**
+ * @brief Frees every node of a list, then sets it to NULL.
+ *
+ * @param list A pointer to the list. Nothing is done if it is NULL.
+ * @param free_data If not NULL, called on the element of every node.
+ */
+void			d_singly_list_destroy		(DSinglyList** list, DestroyElemFunc free_data);
+
+/*-------------------------------------------------DDoubleList-------------------------------------------------*/
+
+/**
+ * @brief Inserts `data` at the front of a list.
+ *
+ * @param list A pointer to the list, set to the new first node. Must not be NULL.
+ * @param data The element.
+ *
+ * @return DDoubleList* The new node, NULL if the allocation failed (the list is then left untouched).
+ */
+DDoubleList*	d_double_list_push_front	(DDoubleList** list, void* data);
+
+/**
+ * @brief Removes the first node of a list.
+ *
+ * @return void* The element of the removed node, NULL if the list is empty.
+ */
+void*			d_double_list_pop_front		(DDoubleList** list);
+
+/**
+ * @brief Inserts `data` right after `node`.
+ *
+ * @return DDoubleList* The new node, NULL if the allocation failed.
+ */
+DDoubleList*	d_double_list_insert_after	(DDoubleList* node, void* data);
+
+/**
+ * @brief Inserts `data` right before `node`, a node of `list`.
+ *
+ * @param list A pointer to the list, updated when `node` is its first node. Must not be NULL.
+ *
+ * @return DDoubleList* The new node, NULL if the allocation failed.
+ */
+DDoubleList*	d_double_list_insert_before	(DDoubleList** list, DDoubleList* node, void* data);
+
+/**
+ * @brief Removes `node` from `list`, in O(1).
+ *
+ * @param list A pointer to the list, updated when `node` is its first node. Must not be NULL.
+ * @param node A node of the list.
+ *
+ * @return void* The element of the removed node.
+ */
+void*			d_double_list_remove		(DDoubleList** list, DDoubleList* node);
+
+/**
+ * @brief Counts the nodes of a list, in O(n).
+ */
+usize			d_double_list_get_len		(const DDoubleList* list);
+
+/**
+ * @brief Frees every node of a list, then sets it to NULL.
+ *
+ * @param list A pointer to the list. Nothing is done if it is NULL.
+ * @param free_data If not NULL, called on the element of every node.
+ */
+void			d_double_list_destroy		(DDoubleList** list, DestroyElemFunc free_data);
+
+/**
+ * @brief Gives the nodes cached by the calling thread back to the shared pools. The nodes still in lists stay valid.
+ *
+ * It is called on its own when a thread that allocated or freed list nodes exits through `pthread_exit` or by
+ * returning from its start routine, a thread may call it earlier to hand its nodes over to the other threads.
+ */
+void			d_linked_list_flush_cache	(void);
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef __D_MPSC_QUEUE__H
+#define __D_MPSC_QUEUE__H
+
+#include <dtypes.h>
+typedef struct _DMpscLink	DMpscLink;
+typedef struct _DMpscQueue	DMpscQueue;
+
+/**
+ * @brief Number of times `d_mpsc_queue_pop_wait` polls an empty queue before the consumer sleeps on it.
+ */
+#define D_MPSC_QUEUE_SPINS 256
+
+/**
+ * DMpscLink:
+ *
+ * The link of an intrusive multi-producer single-consumer queue, to be embedded in the elements of the queue,
+ * a single `next` pointer as in #DSinglyList and #DSListLink. `d_container_of` of `d_intrusive_list.h` finds
+ * the element from its link. A link may be on one queue at a time, and may be pushed again once popped.
+ */
+struct _DMpscLink {
+	DMpscLink*	next;
+};
+
+/**
+ * DMpscQueue:
+ *
+ * A lock-free, intrusive, unbounded FIFO queue that any number of threads push to and a single thread pops from,
+ * after the design of Dmitry Vyukov: a push is one atomic exchange on the last link and a store into the
+ * previous one, with no loop and no compare-and-swap, so producers never retry nor wait on each other, and the
+ * consumer pops without any read-modify-write most of the time. The queue keeps a stub link of its own so that it
+ * is never structurally empty. Nothing is allocated: the queue can be embedded anywhere and the elements are the
+ * ones pushed.
+ * The fields the producers write and the ones the consumer writes are on separate cache lines.
+ * A push is linearizable once its exchange is done, but until the producer has stored its link into the previous
+ * one the consumer cannot see it nor anything pushed after it: `d_mpsc_queue_pop` then returns NULL although the
+ * queue is not empty, and `d_mpsc_queue_pop_wait` spins until the link shows up.
+ * Its fields are private.
+ *
+ * @code
+ * typedef struct { int job; DMpscLink link; } Work;
+ * //producers
+ * d_mpsc_queue_push(&queue, &work -> link);
+ * //consumer
+ * Work* work = d_container_of(d_mpsc_queue_pop_wait(&queue), Work, link);
+ * @endcode
+ */
+struct _DMpscQueue {
+	DMpscLink*	head __attribute__((aligned(64))); /* last link pushed, exchanged by the producers */
+	u32			sleeping; /* futex word, 1 while the consumer sleeps or is about to */
+	DMpscLink*	tail __attribute__((aligned(64))); /* next link to pop, only touched by the consumer */
+	DMpscLink	stub;
+};
+
+/**
+ * @brief Initializes an empty queue. Must be done before any other thread uses it.
+ */
+void		d_mpsc_queue_init				(DMpscQueue* queue);
+
+/**
+ * @brief Appends `link` to the queue and wakes the consumer up if it sleeps on it. May be called from any thread.
+ *
+ * @param queue The queue. Must not be NULL.
+ * @param link The link of the element. Must not be NULL nor be on a queue.
+ */
+void		d_mpsc_queue_push				(DMpscQueue* queue, DMpscLink* link);
+
+/**
+ * @brief Removes the first link of the queue without blocking. Consumer only.
+ *
+ * @return DMpscLink* The link, NULL if the queue is empty or if the first link is still being pushed.
+ */
+DMpscLink*	d_mpsc_queue_pop				(DMpscQueue* queue);
+
+/**
+ * @brief Removes up to `max` links from the front of the queue without blocking. Consumer only.
+ *
+ * @param queue The queue. Must not be NULL.
+ * @param links Receives the links in queue order. Must hold `max` pointers.
+ * @param max The maximum number of links to remove.
+ *
+ * @return usize The number of links removed, 0 if none is available.
+ */
+usize		d_mpsc_queue_pop_batch			(DMpscQueue* queue, DMpscLink** links, usize max);
+
+/**
+ * @brief Removes the first link of the queue, waiting for one if needed. Consumer only.
+ *
+ * An empty queue is polled `D_MPSC_QUEUE_SPINS` times, which catches the links pushed right after, then the
+ * consumer sleeps on a futex until a producer pushes (with `sched_yield` instead of a futex outside Linux).
+ * The producers only make the system call when the consumer actually sleeps.
+ * A consumer that must stop waiting is to be sent a link it recognizes, there is no other way to wake it up.
+ *
+ * @return DMpscLink* The link, never NULL.
+ */
+DMpscLink*	d_mpsc_queue_pop_wait			(DMpscQueue* queue);
+
+/**
+ * @brief Removes between 1 and `max` links from the front of the queue, waiting as `d_mpsc_queue_pop_wait` does
+ *        if it is empty. Consumer only.
+ *
+ * @param max The maximum number of links to remove, must not be 0.
+ *
+ * @return usize The number of links removed, at least 1.
+ */
+usize		d_mpsc_queue_pop_batch_wait		(DMpscQueue* queue, DMpscLink** links, usize max);
+
+/**
+ * @brief Tells whether the queue is empty, a link still being pushed counting as an element. Consumer only,
+ *        producers may have pushed by the time it returns.
+ */
+bool		d_mpsc_queue_is_empty			(DMpscQueue* queue);
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef __D_UNROLLED_LIST__H
+#define __D_UNROLLED_LIST__H
+
+#include <dtypes.h>
+typedef struct _DUnrolledList	DUnrolledList;
+typedef struct _DUnrolledNode	DUnrolledNode;
+typedef struct _DUnrolledIter	DUnrolledIter;
+
+/**
+ * @brief Target size of a node in bytes, its header included: two cache lines.
+ */
+#define D_UNROLLED_NODE_SIZE 128
+
+/**
+ * @brief Minimum number of elements of a node, nodes of large elements grow beyond `D_UNROLLED_NODE_SIZE` to hold them.
+ */
+#define D_UNROLLED_MIN_CAPACITY 4
+
+/**
+ * DUnrolledList:
+ * @param len the number of elements of the list.
+ * @param elem_size the size of an element in bytes.
+ * @param node_capacity the number of elements a node holds.
+ *
+ * Contains the public fields of an unrolled linked list: a doubly linked list whose nodes each hold a small array of
+ * up to `node_capacity` elements, copied inline `elem_size` bytes each as in a #DArray. A node is sized to fill
+ * `D_UNROLLED_NODE_SIZE` bytes, so a traversal reads whole cache lines of elements and follows one pointer per node
+ * instead of one per element as with #DDoubleList, while an insertion or a removal next to an iterator only moves
+ * the elements of one node instead of half of the sequence as with a #DArray.
+ * Every node but the last one is kept at least half full: an insertion into a full node splits it in two halves,
+ * except at the end of the list where a new node is started so that appending packs the nodes completely, and a
+ * removal leaving a node less than half full moves an element from the next node, or merges both if the next node
+ * is not more than half full itself.
+ * The nodes come from a pool owned by the list, so they are allocated in O(1) and sit next to each other in memory.
+ */
+struct _DUnrolledList {
+	usize	len;
+	usize	elem_size;
+	usize	node_capacity;
+};
+
+/**
+ * DUnrolledIter:
+ *
+ * A position in an unrolled list, on an element or past the last one (the end). Its fields are private.
+ * Only `d_unrolled_list_iter_insert` and `d_unrolled_list_iter_remove` keep the iterator they are given valid:
+ * any other modification of the list invalidates every iterator.
+ */
+struct _DUnrolledIter {
+	DUnrolledList*	list;
+	DUnrolledNode*	node; /* NULL at the end */
+	usize			index;
+};
+
+/**
+ * @brief Creates a new, empty unrolled list.
+ *
+ * @param elem_size The size of an element in bytes, must not be 0.
+ *
+ * @return DUnrolledList* A pointer to the new list, NULL if the allocation fails or if `elem_size` is 0 or too large.
+ */
+DUnrolledList*	d_unrolled_list_new				(usize elem_size);
+
+/**
+ * @brief Appends a copy of `elem` to the list.
+ *
+ * @return void* A pointer to the element inside the list, valid until the next modification of the list.
+ *         NULL if the allocation failed.
+ */
+void*			d_unrolled_list_push_back		(DUnrolledList* list, const void* elem);
+
+/**
+ * @brief Inserts a copy of `elem` at the front of the list.
+ *
+ * @return void* A pointer to the element inside the list, NULL if the allocation failed.
+ */
+void*			d_unrolled_list_push_front		(DUnrolledList* list, const void* elem);
+
+/**
+ * @brief Removes the last element of the list.
+ *
+ * @param list The list. Must not be NULL.
+ * @param elem If not NULL, receives a copy of the removed element.
+ *
+ * @return bool true if an element was removed, false if the list is empty.
+ */
+bool			d_unrolled_list_pop_back		(DUnrolledList* list, void* elem);
+
+/**
+ * @brief Removes the first element of the list.
+ *
+ * @return bool true if an element was removed, false if the list is empty.
+ */
+bool			d_unrolled_list_pop_front		(DUnrolledList* list, void* elem);
+
+/**
+ * @brief Retrieves the element at `index`, walking the nodes from the closest end of the list.
+ *
+ * @return void* A pointer to the element inside the list, NULL if `index` is out of bounds.
+ */
+void*			d_unrolled_list_get				(DUnrolledList* list, usize index);
+
+/**
+ * @brief Removes every element of the list and frees its nodes.
+ */
+void			d_unrolled_list_clear			(DUnrolledList* list);
+
+/**
+ * @brief Frees the list and its nodes, then sets its pointer to NULL.
+ *
+ * @param list A pointer to the list pointer. Nothing is done if it or the list is NULL.
+ */
+void			d_unrolled_list_destroy			(DUnrolledList** list);
+
+/**
+ * @brief Puts an iterator on the first element of a list, or at the end if the list is empty.
+ */
+void			d_unrolled_list_iter_init		(DUnrolledIter* it, DUnrolledList* list);
+
+/**
+ * @brief Puts an iterator on the element at `index`, or at the end if `index` is the length of the list.
+ *
+ * @return bool true on success, false if `index` is greater than the length of the list.
+ */
+bool			d_unrolled_list_iter_seek		(DUnrolledIter* it, DUnrolledList* list, usize index);
+
+/**
+ * @brief Retrieves the element an iterator is on.
+ *
+ * @return void* A pointer to the element inside the list, NULL at the end.
+ */
+void*			d_unrolled_list_iter_get		(DUnrolledIter* it);
+
+/**
+ * @brief Moves an iterator to the next element.
+ *
+ * @return bool true if the iterator is on an element, false if it reached the end.
+ */
+bool			d_unrolled_list_iter_next		(DUnrolledIter* it);
+
+/**
+ * @brief Retrieves the elements from the iterator to the end of its node, all contiguous, and moves the iterator
+ *        to the first element of the next node.
+ *
+ * The fastest way to scan a list: the inner loop runs over a plain array.
+ *
+ * @code
+ * DUnrolledIter it;
+ * usize count;
+ * u64* values;
+ * d_unrolled_list_iter_init(&it, list);
+ * while ((values = d_unrolled_list_iter_chunk(&it, &count)) != NULL)
+ *     for (usize i = 0; i < count; ++i)
+ *         sum += values[i];
+ * @endcode
+ *
+ * @param it The iterator. Must not be NULL.
+ * @param count Receives the number of elements. Must not be NULL.
+ *
+ * @return void* A pointer to the first of the elements, NULL at the end.
+ */
+void*			d_unrolled_list_iter_chunk		(DUnrolledIter* it, usize* count);
+
+/**
+ * @brief Inserts a copy of `elem` before the element the iterator is on, or at the end of the list, in O(node_capacity).
+ *
+ * The iterator is then on the inserted element.
+ *
+ * @return void* A pointer to the element inside the list, NULL if the allocation failed (the iterator is then left
+ *         untouched).
+ */
+void*			d_unrolled_list_iter_insert		(DUnrolledIter* it, const void* elem);
+
+/**
+ * @brief Removes the element the iterator is on, in O(node_capacity).
+ *
+ * The iterator is then on the element that followed the removed one, or at the end.
+ *
+ * @param it The iterator. Must not be NULL nor at the end.
+ * @param elem If not NULL, receives a copy of the removed element.
+ */
+void			d_unrolled_list_iter_remove		(DUnrolledIter* it, void* elem);
+
+#endif
@@ -1 +1,229 @@
-#include "d_linked_list.h"
\ No newline at end of file
+#include "d_linked_list.h"
+#include <d_memory_alloc.h>
+#include <pthread.h>
+
+//SHARED POOLS OF NODES, CREATED ON FIRST USE AND KEPT FOR THE WHOLE PROCESS
+static DPool*	g_singly_pool = NULL;
+static DPool*	g_double_pool = NULL;
+
+//CACHES OF THE CALLING THREAD, THE SHARED POOLS ARE ONLY LOCKED ONCE EVERY FEW DOZEN NODES
+static _Thread_local DPoolCache	g_singly_cache;
+static _Thread_local DPoolCache	g_double_cache;
+
+//KEY WHOSE DESTRUCTOR FLUSHES THE CACHES OF A THREAD WHEN IT EXITS, SET BY THE THREADS WITH AN ATTACHED CACHE
+static pthread_key_t	g_cache_key;
+static pthread_once_t	g_cache_key_once = PTHREAD_ONCE_INIT;
+static bool				g_cache_key_created = false;
+
+static void	d_linked_list_thread_exit(void* unused)
+{
+	(void)unused;
+	d_linked_list_flush_cache();
+}
+
+static void	d_linked_list_create_key(void)
+{
+	g_cache_key_created = pthread_key_create(&g_cache_key, d_linked_list_thread_exit) == 0;
+}
+
+//Attaches a cache of the calling thread to its pool, its nodes go back to the pool when the thread exits
+static void	d_linked_list_cache_init(DPoolCache* cache, DPool* pool)
+{
+	d_pool_cache_init(cache, pool);
+	pthread_once(&g_cache_key_once, d_linked_list_create_key);
+	if (g_cache_key_created)
+		pthread_setspecific(g_cache_key, cache);
+}
+
+//Pool of `*pool`, created if needed. Two threads may race to create it, one of them wins
+static DPool*	d_linked_list_get_pool(DPool** pool, usize node_size)
+{
+	DPool* current = __atomic_load_n(pool, __ATOMIC_ACQUIRE);
+	if (current != NULL)
+		return current;
+	DPool* fresh = d_pool_new(node_size, true);
+	if (fresh == NULL)
+		return NULL;
+	if (__atomic_compare_exchange_n(pool, &current, fresh, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return fresh;
+	d_pool_destroy(&fresh);
+	return current;
+}
+
+static void*	d_linked_list_alloc(DPoolCache* cache, DPool** pool, usize node_size)
+{
+	if (cache -> pool == NULL)
+	{
+		DPool* shared = d_linked_list_get_pool(pool, node_size);
+		if (shared == NULL)
+			return NULL;
+		d_linked_list_cache_init(cache, shared);
+	}
+	return d_pool_cache_alloc(cache);
+}
+
+//The node may come from another thread, the pool exists since it was allocated from it
+static void	d_linked_list_free(DPoolCache* cache, DPool** pool, void* node)
+{
+	if (cache -> pool == NULL)
+		d_linked_list_cache_init(cache, __atomic_load_n(pool, __ATOMIC_ACQUIRE));
+	d_pool_cache_free(cache, node);
+}
+
+#define d_singly_node_alloc() d_linked_list_alloc(&g_singly_cache, &g_singly_pool, sizeof(DSinglyList))
+#define d_singly_node_free(node) d_linked_list_free(&g_singly_cache, &g_singly_pool, node)
+#define d_double_node_alloc() d_linked_list_alloc(&g_double_cache, &g_double_pool, sizeof(DDoubleList))
+#define d_double_node_free(node) d_linked_list_free(&g_double_cache, &g_double_pool, node)
+
+DSinglyList*	d_singly_list_push_front	(DSinglyList** list, void* data)
+{
+	DSinglyList* node = d_singly_node_alloc();
+	if (node == NULL)
+		return NULL;
+	node -> data = data;
+	node -> next = *list;
+	*list = node;
+	return node;
+}
+
+void*			d_singly_list_pop_front		(DSinglyList** list)
+{
+	DSinglyList* node = *list;
+	if (node == NULL)
+		return NULL;
+	void* data = node -> data;
+	*list = node -> next;
+	d_singly_node_free(node);
+	return data;
+}
+
+DSinglyList*	d_singly_list_insert_after	(DSinglyList* node, void* data)
+{
+	return d_singly_list_push_front(&node -> next, data);
+}
+
+void*			d_singly_list_remove_after	(DSinglyList* node)
+{
+	return d_singly_list_pop_front(&node -> next);
+}
+
+void			d_singly_list_reverse		(DSinglyList** list)
+{
+	DSinglyList* reversed = NULL;
+	DSinglyList* node = *list;
+	while (node != NULL)
+	{
+		DSinglyList* next = node -> next;
+		node -> next = reversed;
+		reversed = node;
+		node = next;
+	}
+	*list = reversed;
+}
+
+usize			d_singly_list_get_len		(const DSinglyList* list)
+{
+	usize len = 0;
+	for (; list != NULL; list = list -> next)
+		++len;
+	return len;
+}
+
+void			d_singly_list_destroy		(DSinglyList** list, DestroyElemFunc free_data)
+{
+	if (list == NULL)
+		return;
+	while (*list != NULL)
+	{
+		void* data = d_singly_list_pop_front(list);
+		if (free_data != NULL)
+			free_data(data);
+	}
+}
+
+DDoubleList*	d_double_list_push_front	(DDoubleList** list, void* data)
+{
+	DDoubleList* node = d_double_node_alloc();
+	if (node == NULL)
+		return NULL;
+	node -> data = data;
+	node -> next = *list;
+	node -> prev = NULL;
+	if (*list != NULL)
+		(*list) -> prev = node;
+	*list = node;
+	return node;
+}
+
+void*			d_double_list_pop_front		(DDoubleList** list)
+{
+	if (*list == NULL)
+		return NULL;
+	return d_double_list_remove(list, *list);
+}
+
+DDoubleList*	d_double_list_insert_after	(DDoubleList* node, void* data)
+{
+	DDoubleList* new_node = d_double_node_alloc();
+	if (new_node == NULL)
+		return NULL;
+	new_node -> data = data;
+	new_node -> next = node -> next;
+	new_node -> prev = node;
+	if (node -> next != NULL)
+		node -> next -> prev = new_node;
+	node -> next = new_node;
+	return new_node;
+}
+
+DDoubleList*	d_double_list_insert_before	(DDoubleList** list, DDoubleList* node, void* data)
+{
+	if (node -> prev == NULL)
+		return d_double_list_push_front(list, data);
+	return d_double_list_insert_after(node -> prev, data);
+}
+
+void*			d_double_list_remove		(DDoubleList** list, DDoubleList* node)
+{
+	void* data = node -> data;
+	if (node -> prev != NULL)
+		node -> prev -> next = node -> next;
+	else
+		*list = node -> next;
+	if (node -> next != NULL)
+		node -> next -> prev = node -> prev;
+	d_double_node_free(node);
+	return data;
+}
+
+usize			d_double_list_get_len		(const DDoubleList* list)
+{
+	usize len = 0;
+	for (; list != NULL; list = list -> next)
+		++len;
+	return len;
+}
+
+void			d_double_list_destroy		(DDoubleList** list, DestroyElemFunc free_data)
+{
+	if (list == NULL)
+		return;
+	DDoubleList* node = *list;
+	while (node != NULL)
+	{
+		DDoubleList* next = node -> next;
+		if (free_data != NULL)
+			free_data(node -> data);
+		d_double_node_free(node);
+		node = next;
+	}
+	*list = NULL;
+}
+
+void			d_linked_list_flush_cache	(void)
+{
+	if (g_singly_cache.pool != NULL)
+		d_pool_cache_flush(&g_singly_cache);
+	if (g_double_cache.pool != NULL)
+		d_pool_cache_flush(&g_double_cache);
+}
@@ -0,0 +1,126 @@
+#include "d_mpsc_queue.h"
+#ifdef __linux__
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#else
+# include <sched.h>
+#endif
+
+//Sleeps as long as `*word` is `value`, or until a wake up that may be spurious
+static void	d_mpsc_futex_wait(u32* word, u32 value)
+{
+#ifdef __linux__
+	syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+#else
+	(void)word;
+	(void)value;
+	sched_yield();
+#endif
+}
+
+static void	d_mpsc_futex_wake(u32* word)
+{
+#ifdef __linux__
+	syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+	(void)word;
+#endif
+}
+
+static inline void	d_mpsc_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+void		d_mpsc_queue_init				(DMpscQueue* queue)
+{
+	queue -> stub.next = NULL;
+	queue -> head = &queue -> stub;
+	queue -> tail = &queue -> stub;
+	queue -> sleeping = 0;
+}
+
+//The exchange is sequentially consistent: with the store of `sleeping` by the consumer, either the consumer sees
+//the link before it sleeps or the producer sees that it sleeps
+static inline void	d_mpsc_queue_link(DMpscQueue* queue, DMpscLink* link)
+{
+	__atomic_store_n(&link -> next, NULL, __ATOMIC_RELAXED);
+	DMpscLink* prev = __atomic_exchange_n(&queue -> head, link, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&prev -> next, link, __ATOMIC_RELEASE);
+}
+
+void		d_mpsc_queue_push				(DMpscQueue* queue, DMpscLink* link)
+{
+	d_mpsc_queue_link(queue, link);
+	if (__atomic_load_n(&queue -> sleeping, __ATOMIC_SEQ_CST)
+		&& __atomic_exchange_n(&queue -> sleeping, 0, __ATOMIC_SEQ_CST))
+		d_mpsc_futex_wake(&queue -> sleeping);
+}
+
+DMpscLink*	d_mpsc_queue_pop				(DMpscQueue* queue)
+{
+	DMpscLink* tail = queue -> tail;
+	DMpscLink* next = __atomic_load_n(&tail -> next, __ATOMIC_ACQUIRE);
+	if (tail == &queue -> stub)
+	{
+		if (next == NULL)
+			return NULL;
+		queue -> tail = next;
+		tail = next;
+		next = __atomic_load_n(&next -> next, __ATOMIC_ACQUIRE);
+	}
+	if (next != NULL)
+	{
+		queue -> tail = next;
+		return tail;
+	}
+	//`tail` is the last link, it can only be popped once another one follows it: the stub is pushed behind it
+	if (tail != __atomic_load_n(&queue -> head, __ATOMIC_ACQUIRE))
+		return NULL;
+	d_mpsc_queue_link(queue, &queue -> stub);
+	next = __atomic_load_n(&tail -> next, __ATOMIC_ACQUIRE);
+	if (next == NULL)
+		return NULL;
+	queue -> tail = next;
+	return tail;
+}
+
+usize		d_mpsc_queue_pop_batch			(DMpscQueue* queue, DMpscLink** links, usize max)
+{
+	usize count = 0;
+	while (count < max && (links[count] = d_mpsc_queue_pop(queue)) != NULL)
+		++count;
+	return count;
+}
+
+bool		d_mpsc_queue_is_empty			(DMpscQueue* queue)
+{
+	return queue -> tail == &queue -> stub && __atomic_load_n(&queue -> head, __ATOMIC_SEQ_CST) == &queue -> stub;
+}
+
+DMpscLink*	d_mpsc_queue_pop_wait			(DMpscQueue* queue)
+{
+	for (;;)
+	{
+		for (u32 spins = 0; spins < D_MPSC_QUEUE_SPINS; ++spins)
+		{
+			DMpscLink* link = d_mpsc_queue_pop(queue);
+			if (link != NULL)
+				return link;
+			d_mpsc_pause();
+		}
+		__atomic_store_n(&queue -> sleeping, 1, __ATOMIC_SEQ_CST);
+		if (d_mpsc_queue_is_empty(queue))
+			d_mpsc_futex_wait(&queue -> sleeping, 1);
+		__atomic_store_n(&queue -> sleeping, 0, __ATOMIC_RELAXED);
+	}
+}
+
+usize		d_mpsc_queue_pop_batch_wait		(DMpscQueue* queue, DMpscLink** links, usize max)
+{
+	links[0] = d_mpsc_queue_pop_wait(queue);
+	return 1 + d_mpsc_queue_pop_batch(queue, links + 1, max - 1);
+}
@@ -0,0 +1,328 @@
+#include "d_unrolled_list.h"
+#include <d_memory_alloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct _DRealUnrolledList DRealUnrolledList;
+
+//HEADER OF A NODE, FOLLOWED BY ITS ELEMENTS
+struct _DUnrolledNode {
+	DUnrolledNode*	prev;
+	DUnrolledNode*	next;
+	usize			count;
+};
+
+//REAL UNROLLED LIST STRUCTURE ALLOCATED
+struct _DRealUnrolledList {
+	usize			len;
+	usize			elem_size;
+	usize			node_capacity;
+	usize			data_offset; /* offset of the elements inside a node */
+	DUnrolledNode*	head;
+	DUnrolledNode*	tail;
+	DPool*			pool;
+};
+
+#define d_unrolled_elem(list, node, i) ((u8*)(node) + (list) -> data_offset + (i) * (list) -> elem_size)
+
+DUnrolledList*	d_unrolled_list_new				(usize elem_size)
+{
+	if (elem_size == 0 || elem_size > D_UNROLLED_NODE_SIZE * D_UNROLLED_NODE_SIZE)
+		return NULL;
+	DRealUnrolledList* list = malloc(sizeof(DRealUnrolledList));
+	if (list == NULL)
+		return NULL;
+	usize alignment = elem_size & -elem_size;
+	if (alignment > 16)
+		alignment = 16;
+	list -> data_offset = (sizeof(DUnrolledNode) + alignment - 1) & ~(alignment - 1);
+	list -> node_capacity = (D_UNROLLED_NODE_SIZE - list -> data_offset) / elem_size;
+	if (list -> node_capacity < D_UNROLLED_MIN_CAPACITY)
+		list -> node_capacity = D_UNROLLED_MIN_CAPACITY;
+	list -> pool = d_pool_new(list -> data_offset + list -> node_capacity * elem_size, false);
+	if (list -> pool == NULL)
+	{
+		free(list);
+		return NULL;
+	}
+	list -> len = 0;
+	list -> elem_size = elem_size;
+	list -> head = NULL;
+	list -> tail = NULL;
+	return (DUnrolledList*)list;
+}
+
+//Allocates an empty node and links it right after `prev`, at the front if `prev` is NULL
+static DUnrolledNode*	d_unrolled_node_new(DRealUnrolledList* list, DUnrolledNode* prev)
+{
+	DUnrolledNode* node = d_pool_alloc(list -> pool);
+	if (node == NULL)
+		return NULL;
+	node -> count = 0;
+	node -> prev = prev;
+	node -> next = prev == NULL ? list -> head : prev -> next;
+	if (node -> next != NULL)
+		node -> next -> prev = node;
+	else
+		list -> tail = node;
+	if (prev != NULL)
+		prev -> next = node;
+	else
+		list -> head = node;
+	return node;
+}
+
+static void	d_unrolled_node_free(DRealUnrolledList* list, DUnrolledNode* node)
+{
+	if (node -> prev != NULL)
+		node -> prev -> next = node -> next;
+	else
+		list -> head = node -> next;
+	if (node -> next != NULL)
+		node -> next -> prev = node -> prev;
+	else
+		list -> tail = node -> prev;
+	d_pool_free(list -> pool, node);
+}
+
+//Inserts `elem` at `index` of `node`, NULL meaning the end of the list, and moves `it` on it
+static void*	d_unrolled_insert_at(DRealUnrolledList* list, DUnrolledNode* node, usize index, const void* elem,
+									DUnrolledIter* it)
+{
+	if (node == NULL)
+	{
+		node = list -> tail;
+		index = node == NULL ? 0 : node -> count;
+	}
+	if (node == NULL)
+	{
+		if ((node = d_unrolled_node_new(list, NULL)) == NULL)
+			return NULL;
+	}
+	else if (node -> count == list -> node_capacity)
+	{
+		DUnrolledNode* next = d_unrolled_node_new(list, node);
+		if (next == NULL)
+			return NULL;
+		//appending starts a new node, so that a list built by appending has full nodes
+		if (next == list -> tail && index == node -> count)
+		{
+			node = next;
+			index = 0;
+		}
+		else
+		{
+			usize half = list -> node_capacity / 2;
+			next -> count = node -> count - half;
+			memcpy(d_unrolled_elem(list, next, 0), d_unrolled_elem(list, node, half), next -> count * list -> elem_size);
+			node -> count = half;
+			if (index > half)
+			{
+				node = next;
+				index -= half;
+			}
+		}
+	}
+	u8* slot = d_unrolled_elem(list, node, index);
+	memmove(slot + list -> elem_size, slot, (node -> count - index) * list -> elem_size);
+	memcpy(slot, elem, list -> elem_size);
+	++node -> count;
+	++list -> len;
+	if (it != NULL)
+	{
+		it -> node = node;
+		it -> index = index;
+	}
+	return slot;
+}
+
+//Removes the element at `index` of `node` and moves `it` on the element that followed it
+static void	d_unrolled_remove_at(DRealUnrolledList* list, DUnrolledNode* node, usize index, void* elem,
+								DUnrolledIter* it)
+{
+	u8* slot = d_unrolled_elem(list, node, index);
+	if (elem != NULL)
+		memcpy(elem, slot, list -> elem_size);
+	memmove(slot, slot + list -> elem_size, (node -> count - index - 1) * list -> elem_size);
+	--node -> count;
+	--list -> len;
+	if (node -> count == 0)
+	{
+		//only the last node can get empty, the others keep half of their capacity
+		DUnrolledNode* next = node -> next;
+		d_unrolled_node_free(list, node);
+		node = next;
+		index = 0;
+	}
+	else if (node != list -> tail && node -> count < list -> node_capacity / 2)
+	{
+		DUnrolledNode* next = node -> next;
+		if (next -> count > list -> node_capacity / 2)
+		{
+			memcpy(d_unrolled_elem(list, node, node -> count), d_unrolled_elem(list, next, 0), list -> elem_size);
+			memmove(d_unrolled_elem(list, next, 0), d_unrolled_elem(list, next, 1), (next -> count - 1) * list -> elem_size);
+			++node -> count;
+			--next -> count;
+		}
+		else
+		{
+			memcpy(d_unrolled_elem(list, node, node -> count), d_unrolled_elem(list, next, 0), next -> count * list -> elem_size);
+			node -> count += next -> count;
+			d_unrolled_node_free(list, next);
+		}
+	}
+	if (node != NULL && index >= node -> count)
+	{
+		node = node -> next;
+		index = 0;
+	}
+	if (it != NULL)
+	{
+		it -> node = node;
+		it -> index = index;
+	}
+}
+
+void*			d_unrolled_list_push_back		(DUnrolledList* list, const void* elem)
+{
+	return d_unrolled_insert_at((DRealUnrolledList*)list, NULL, 0, elem, NULL);
+}
+
+void*			d_unrolled_list_push_front		(DUnrolledList* list_, const void* elem)
+{
+	DRealUnrolledList* list = (DRealUnrolledList*)list_;
+	return d_unrolled_insert_at(list, list -> head, 0, elem, NULL);
+}
+
+bool			d_unrolled_list_pop_back		(DUnrolledList* list_, void* elem)
+{
+	DRealUnrolledList* list = (DRealUnrolledList*)list_;
+	if (list -> tail == NULL)
+		return false;
+	d_unrolled_remove_at(list, list -> tail, list -> tail -> count - 1, elem, NULL);
+	return true;
+}
+
+bool			d_unrolled_list_pop_front		(DUnrolledList* list_, void* elem)
+{
+	DRealUnrolledList* list = (DRealUnrolledList*)list_;
+	if (list -> head == NULL)
+		return false;
+	d_unrolled_remove_at(list, list -> head, 0, elem, NULL);
+	return true;
+}
+
+//Node holding the element at `index`, which must be in bounds, and the index of the element inside it
+static DUnrolledNode*	d_unrolled_find(DRealUnrolledList* list, usize index, usize* node_index)
+{
+	DUnrolledNode* node;
+	if (index < list -> len / 2)
+	{
+		node = list -> head;
+		while (index >= node -> count)
+		{
+			index -= node -> count;
+			node = node -> next;
+		}
+	}
+	else
+	{
+		usize from_end = list -> len - index;
+		node = list -> tail;
+		while (from_end > node -> count)
+		{
+			from_end -= node -> count;
+			node = node -> prev;
+		}
+		index = node -> count - from_end;
+	}
+	*node_index = index;
+	return node;
+}
+
+void*			d_unrolled_list_get				(DUnrolledList* list_, usize index)
+{
+	DRealUnrolledList* list = (DRealUnrolledList*)list_;
+	if (index >= list -> len)
+		return NULL;
+	DUnrolledNode* node = d_unrolled_find(list, index, &index);
+	return d_unrolled_elem(list, node, index);
+}
+
+void			d_unrolled_list_clear			(DUnrolledList* list_)
+{
+	DRealUnrolledList* list = (DRealUnrolledList*)list_;
+	d_pool_reset(list -> pool);
+	list -> head = NULL;
+	list -> tail = NULL;
+	list -> len = 0;
+}
+
+void			d_unrolled_list_destroy			(DUnrolledList** list_)
+{
+	if (list_ == NULL || *list_ == NULL)
+		return;
+	DRealUnrolledList* list = (DRealUnrolledList*)*list_;
+	d_pool_destroy(&list -> pool);
+	free(list);
+	*list_ = NULL;
+}
+
+void			d_unrolled_list_iter_init		(DUnrolledIter* it, DUnrolledList* list)
+{
+	it -> list = list;
+	it -> node = ((DRealUnrolledList*)list) -> head;
+	it -> index = 0;
+}
+
+bool			d_unrolled_list_iter_seek		(DUnrolledIter* it, DUnrolledList* list_, usize index)
+{
+	DRealUnrolledList* list = (DRealUnrolledList*)list_;
+	if (index > list -> len)
+		return false;
+	it -> list = list_;
+	it -> node = index == list -> len ? NULL : d_unrolled_find(list, index, &index);
+	it -> index = index == list -> len ? 0 : index;
+	return true;
+}
+
+void*			d_unrolled_list_iter_get		(DUnrolledIter* it)
+{
+	if (it -> node == NULL)
+		return NULL;
+	return d_unrolled_elem((DRealUnrolledList*)it -> list, it -> node, it -> index);
+}
+
+bool			d_unrolled_list_iter_next		(DUnrolledIter* it)
+{
+	if (it -> node == NULL)
+		return false;
+	if (++it -> index >= it -> node -> count)
+	{
+		it -> node = it -> node -> next;
+		it -> index = 0;
+	}
+	return it -> node != NULL;
+}
+
+void*			d_unrolled_list_iter_chunk		(DUnrolledIter* it, usize* count)
+{
+	DUnrolledNode* node = it -> node;
+	if (node == NULL)
+		return NULL;
+	*count = node -> count - it -> index;
+	void* elems = d_unrolled_elem((DRealUnrolledList*)it -> list, node, it -> index);
+	it -> node = node -> next;
+	it -> index = 0;
+	return elems;
+}
+
+void*			d_unrolled_list_iter_insert		(DUnrolledIter* it, const void* elem)
+{
+	return d_unrolled_insert_at((DRealUnrolledList*)it -> list, it -> node, it -> index, elem, it);
+}
+
+void			d_unrolled_list_iter_remove		(DUnrolledIter* it, void* elem)
+{
+	d_unrolled_remove_at((DRealUnrolledList*)it -> list, it -> node, it -> index, elem, it);
+}
@@ -0,0 +1,593 @@
+#include <d_linked_list.h>
+#include <d_intrusive_list.h>
+#include <d_unrolled_list.h>
+#include <d_mpsc_queue.h>
+#include <dtest.h>
+#include <dutils.h>
+#include <string.h>
+#include <general_lib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+char*   itoa_usize(void* data)
+{
+    return d_itoa_usize(*((usize*)data));
+}
+
+char*   itoa_bool(void* data)
+{
+    return d_itoa_usize(*((bool*)data));
+}
+
+typedef struct {
+    usize       value;
+    DListLink   link;
+    DSListLink  slink;
+} Item;
+
+usize   g_freed = 0;
+
+void    count_freed(void* data)
+{
+    (void)data;
+    ++g_freed;
+}
+
+//Tells whether the values of the elements of `head` are the `count` ones of `expected`, in both directions
+bool    list_matches(DListLink* head, const usize* expected, usize count)
+{
+    DListLink* it;
+    usize i = 0;
+    d_list_for_each(it, head)
+    {
+        if (i >= count || d_container_of(it, Item, link) -> value != expected[i])
+            return false;
+        ++i;
+    }
+    for (it = d_list_last(head); it != head; it = it -> prev)
+    {
+        if (i == 0 || d_container_of(it, Item, link) -> value != expected[--i])
+            return false;
+    }
+    return i == 0 && d_list_get_len(head) == count;
+}
+
+void    test_d_list(void)
+{
+    Item items[6];
+    for (usize i = 0; i < 6; ++i)
+    {
+        items[i].value = i;
+        d_list_init(&items[i].link);
+    }
+    DListLink head;
+    d_list_init(&head);
+    bool expected = true;
+    bool valid = d_list_is_empty(&head) && d_list_pop_front(&head) == NULL && d_list_pop_back(&head) == NULL
+        && d_list_first(&head) == &head && d_list_is_linked(&items[0].link) == false;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_list_push_back(&head, &items[1].link);
+    d_list_push_back(&head, &items[2].link);
+    d_list_push_front(&head, &items[0].link);
+    d_list_insert_after(&items[2].link, &items[4].link);
+    d_list_insert_before(&items[4].link, &items[3].link);
+    usize order[] = {0, 1, 2, 3, 4};
+    valid = list_matches(&head, order, 5) && d_list_is_linked(&items[3].link);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //removing from the middle, then from both ends
+    d_list_remove(&items[2].link);
+    usize without_middle[] = {0, 1, 3, 4};
+    valid = list_matches(&head, without_middle, 4) && d_list_is_linked(&items[2].link) == false;
+    valid = valid && d_list_pop_front(&head) == &items[0].link && d_list_pop_back(&head) == &items[4].link;
+    usize inner[] = {1, 3};
+    valid = valid && list_matches(&head, inner, 2);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //splicing a whole list, at the back then after an element
+    DListLink other;
+    d_list_init(&other);
+    d_list_push_back(&other, &items[4].link);
+    d_list_push_back(&other, &items[5].link);
+    d_list_splice_back(&head, &other);
+    usize spliced[] = {1, 3, 4, 5};
+    valid = list_matches(&head, spliced, 4) && d_list_is_empty(&other);
+    d_list_push_back(&other, &items[0].link);
+    d_list_push_back(&other, &items[2].link);
+    d_list_splice_after(&items[1].link, &other);
+    usize spliced_inside[] = {1, 0, 2, 3, 4, 5};
+    valid = valid && list_matches(&head, spliced_inside, 6) && d_list_is_empty(&other);
+    d_list_splice_back(&head, &other);
+    valid = valid && list_matches(&head, spliced_inside, 6);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //unlinking the even values while iterating
+    DListLink* it;
+    DListLink* tmp;
+    d_list_for_each_safe(it, tmp, &head)
+    {
+        if (d_container_of(it, Item, link) -> value % 2 == 0)
+            d_list_remove(it);
+    }
+    usize odd[] = {1, 3, 5};
+    valid = list_matches(&head, odd, 3);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
+void    test_d_slist(void)
+{
+    Item items[6];
+    for (usize i = 0; i < 6; ++i)
+        items[i].value = i;
+    DSList list;
+    d_slist_init(&list);
+    bool expected = true;
+    bool valid = d_slist_is_empty(&list) && d_slist_pop_front(&list) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_slist_push_back(&list, &items[1].slink);
+    d_slist_push_front(&list, &items[0].slink);
+    d_slist_push_back(&list, &items[3].slink);
+    d_slist_insert_after(&list, &items[1].slink, &items[2].slink);
+    //inserting after the last element moves the tail
+    d_slist_insert_after(&list, &items[3].slink, &items[4].slink);
+    d_slist_push_back(&list, &items[5].slink);
+    usize i = 0;
+    DSListLink* it;
+    d_slist_for_each(it, &list)
+        valid = valid && d_container_of(it, Item, slink) -> value == i++;
+    valid = valid && i == 6 && d_slist_get_len(&list) == 6;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //removing the last element moves the tail back
+    valid = d_slist_remove_after(&list, &items[4].slink) == &items[5].slink
+        && d_slist_remove_after(&list, &items[4].slink) == NULL
+        && d_slist_remove_after(&list, &items[1].slink) == &items[2].slink;
+    d_slist_push_back(&list, &items[2].slink);
+    usize after_removals[] = {0, 1, 3, 4, 2};
+    i = 0;
+    d_slist_for_each(it, &list)
+        valid = valid && i < 5 && d_container_of(it, Item, slink) -> value == after_removals[i++];
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //splicing, then draining the list from the front
+    DSList other;
+    d_slist_init(&other);
+    d_slist_splice_back(&list, &other);
+    d_slist_push_back(&other, &items[5].slink);
+    d_slist_splice_back(&list, &other);
+    valid = d_slist_is_empty(&other) && d_slist_get_len(&list) == 6;
+    usize drained[] = {0, 1, 3, 4, 2, 5};
+    for (i = 0; i < 6; ++i)
+        valid = valid && d_container_of(d_slist_pop_front(&list), Item, slink) -> value == drained[i];
+    valid = valid && d_slist_is_empty(&list);
+    //the tail is reset once the list is empty
+    d_slist_push_back(&list, &items[0].slink);
+    valid = valid && list.head == &items[0].slink && d_slist_get_len(&list) == 1;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
+void    test_d_singly_list(void)
+{
+    DSinglyList* list = NULL;
+    bool expected = true;
+    bool valid = d_singly_list_pop_front(&list) == NULL && d_singly_list_get_len(list) == 0;
+    for (usize i = 0; i < 1000; ++i)
+        valid = valid && d_singly_list_push_front(&list, (void*)(i + 1)) == list;
+    usize len = 1000;
+    usize list_len = d_singly_list_get_len(list);
+    assert_eq_custom(&list_len, &len, sizeof(usize), itoa_usize);
+    //the nodes allocated in a row are neighbours in the slabs of the pool
+    usize far = 0;
+    for (DSinglyList* node = list; node -> next != NULL; node = node -> next)
+    {
+        intptr_t distance = (intptr_t)node -> next - (intptr_t)node;
+        far += distance > 64 * (intptr_t)sizeof(DSinglyList) || distance < -64 * (intptr_t)sizeof(DSinglyList);
+    }
+    valid = valid && far < 20;
+    d_singly_list_reverse(&list);
+    usize i = 1;
+    for (DSinglyList* node = list; node != NULL; node = node -> next)
+        valid = valid && node -> data == (void*)i++;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //inserting and removing after a node in the middle
+    DSinglyList* middle = list -> next -> next;
+    valid = d_singly_list_insert_after(middle, (void*)5000) == middle -> next
+        && d_singly_list_get_len(list) == 1001
+        && d_singly_list_remove_after(middle) == (void*)5000
+        && middle -> next -> data == (void*)4
+        && d_singly_list_pop_front(&list) == (void*)1;
+    DSinglyList* last = list;
+    while (last -> next != NULL)
+        last = last -> next;
+    valid = valid && d_singly_list_remove_after(last) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    g_freed = 0;
+    d_singly_list_destroy(&list, count_freed);
+    assert_eq_null(list);
+    len = 999;
+    assert_eq_custom(&g_freed, &len, sizeof(usize), itoa_usize);
+    d_singly_list_destroy(NULL, NULL);
+}
+
+void    test_d_double_list(void)
+{
+    DDoubleList* list = NULL;
+    DDoubleList* nodes[5];
+    for (usize i = 5; i > 0; --i)
+        nodes[i - 1] = d_double_list_push_front(&list, (void*)i);
+    bool expected = true;
+    bool valid = list == nodes[0] && nodes[0] -> prev == NULL && nodes[4] -> next == NULL
+        && d_double_list_get_len(list) == 5;
+    for (usize i = 1; i < 5; ++i)
+        valid = valid && nodes[i] -> prev == nodes[i - 1] && nodes[i - 1] -> next == nodes[i];
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //inserting around the first and the last nodes
+    DDoubleList* front = d_double_list_insert_before(&list, nodes[0], (void*)10);
+    DDoubleList* back = d_double_list_insert_after(nodes[4], (void*)60);
+    DDoubleList* inner = d_double_list_insert_before(&list, nodes[2], (void*)25);
+    valid = list == front && front -> next == nodes[0] && nodes[0] -> prev == front
+        && nodes[4] -> next == back && back -> prev == nodes[4] && back -> next == NULL
+        && nodes[1] -> next == inner && inner -> next == nodes[2] && nodes[2] -> prev == inner
+        && d_double_list_get_len(list) == 8;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //removing the first, a middle and the last node
+    valid = d_double_list_remove(&list, front) == (void*)10 && list == nodes[0] && nodes[0] -> prev == NULL
+        && d_double_list_remove(&list, inner) == (void*)25 && nodes[1] -> next == nodes[2]
+        && nodes[2] -> prev == nodes[1]
+        && d_double_list_remove(&list, back) == (void*)60 && nodes[4] -> next == NULL
+        && d_double_list_pop_front(&list) == (void*)1 && list == nodes[1] && list -> prev == NULL
+        && d_double_list_get_len(list) == 4;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    g_freed = 0;
+    d_double_list_destroy(&list, count_freed);
+    assert_eq_null(list);
+    usize len = 4;
+    assert_eq_custom(&g_freed, &len, sizeof(usize), itoa_usize);
+    valid = d_double_list_pop_front(&list) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
+typedef struct {
+    DDoubleList*    handed_over; /* nodes allocated by the thread, freed by the next one */
+    usize           errors;
+} ListWorker;
+
+void*   list_worker(void* arg)
+{
+    ListWorker* worker = arg;
+    for (usize round = 0; round < 20; ++round)
+    {
+        DSinglyList* list = NULL;
+        for (usize i = 0; i < 5000; ++i)
+            d_singly_list_push_front(&list, (void*)(i + 1));
+        for (usize i = 5000; i > 0; --i)
+            worker -> errors += d_singly_list_pop_front(&list) != (void*)i;
+        worker -> errors += list != NULL;
+    }
+    for (usize i = 0; i < 3000; ++i)
+        d_double_list_push_front(&worker -> handed_over, (void*)(i + 1));
+    return NULL;
+}
+
+void*   list_releaser(void* arg)
+{
+    ListWorker* worker = arg;
+    worker -> errors += d_double_list_get_len(worker -> handed_over) != 3000;
+    d_double_list_destroy(&worker -> handed_over, NULL);
+    //the caches of the thread go back to the pools when it exits
+    return NULL;
+}
+
+void    test_d_linked_list_threads(void)
+{
+    pthread_t threads[4];
+    ListWorker workers[4];
+    memset(workers, 0, sizeof(workers));
+    for (usize t = 0; t < 4; ++t)
+        pthread_create(threads + t, NULL, list_worker, workers + t);
+    for (usize t = 0; t < 4; ++t)
+        pthread_join(threads[t], NULL);
+    //every list is freed by another thread than the one that built it
+    for (usize t = 0; t < 4; ++t)
+        pthread_create(threads + t, NULL, list_releaser, workers + (t + 1) % 4);
+    for (usize t = 0; t < 4; ++t)
+        pthread_join(threads[t], NULL);
+    usize errors = 0;
+    for (usize t = 0; t < 4; ++t)
+        errors += workers[t].errors + (workers[t].handed_over != NULL);
+    d_linked_list_flush_cache();
+    usize zero = 0;
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+}
+
+//Tells whether `list` holds the `count` values of `expected` and every node but the last is at least half full
+bool    unrolled_matches(DUnrolledList* list, const u64* expected, usize count)
+{
+    DUnrolledIter it;
+    usize chunk_len;
+    usize i = 0;
+    bool valid = list -> len == count;
+    u64* values;
+    d_unrolled_list_iter_init(&it, list);
+    while ((values = d_unrolled_list_iter_chunk(&it, &chunk_len)) != NULL)
+    {
+        valid = valid && chunk_len > 0 && chunk_len <= list -> node_capacity
+            && (it.node == NULL || chunk_len >= list -> node_capacity / 2);
+        for (usize j = 0; j < chunk_len && valid; ++j, ++i)
+            valid = i < count && values[j] == expected[i];
+    }
+    return valid && i == count;
+}
+
+void    test_d_unrolled_list(void)
+{
+    DUnrolledList* list = d_unrolled_list_new(sizeof(u64));
+    bool expected = true;
+    bool valid = list != NULL && list -> len == 0 && list -> node_capacity >= D_UNROLLED_MIN_CAPACITY
+        && d_unrolled_list_get(list, 0) == NULL && !d_unrolled_list_pop_back(list, NULL)
+        && !d_unrolled_list_pop_front(list, NULL);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    u64 model[1000];
+    for (u64 i = 0; i < 1000; ++i)
+    {
+        model[i] = i;
+        valid = valid && *(u64*)d_unrolled_list_push_back(list, &i) == i;
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //appending packs the nodes completely
+    DUnrolledIter it;
+    usize count;
+    d_unrolled_list_iter_init(&it, list);
+    d_unrolled_list_iter_chunk(&it, &count);
+    valid = unrolled_matches(list, model, 1000) && count == list -> node_capacity;
+    for (usize i = 0; i < 1000; i += 37)
+        valid = valid && *(u64*)d_unrolled_list_get(list, i) == i;
+    valid = valid && d_unrolled_list_get(list, 1000) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //iterating one element at a time from the middle
+    valid = d_unrolled_list_iter_seek(&it, list, 500) && !d_unrolled_list_iter_seek(&it, list, 1001);
+    d_unrolled_list_iter_seek(&it, list, 500);
+    for (u64 i = 500; i < 999; ++i)
+        valid = valid && *(u64*)d_unrolled_list_iter_get(&it) == i && d_unrolled_list_iter_next(&it);
+    valid = valid && !d_unrolled_list_iter_next(&it) && d_unrolled_list_iter_get(&it) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //pops from both ends
+    u64 value;
+    valid = d_unrolled_list_pop_front(list, &value) && value == 0 && d_unrolled_list_pop_back(list, &value)
+        && value == 999 && unrolled_matches(list, model + 1, 998);
+    u64 zero = 0;
+    valid = valid && *(u64*)d_unrolled_list_push_front(list, &zero) == 0 && unrolled_matches(list, model, 999);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_unrolled_list_clear(list);
+    d_unrolled_list_iter_init(&it, list);
+    valid = list -> len == 0 && d_unrolled_list_iter_get(&it) == NULL
+        && d_unrolled_list_iter_chunk(&it, &count) == NULL;
+    //inserting at the end through an iterator
+    d_unrolled_list_iter_seek(&it, list, 0);
+    u64 one = 1;
+    valid = valid && *(u64*)d_unrolled_list_iter_insert(&it, &one) == 1 && list -> len == 1
+        && *(u64*)d_unrolled_list_iter_get(&it) == 1;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_unrolled_list_destroy(&list);
+    assert_eq_null(list);
+    d_unrolled_list_destroy(&list);
+    list = d_unrolled_list_new(0);
+    assert_eq_null(list);
+}
+
+void    test_d_unrolled_list_churn(void)
+{
+    //a small element size and a large one, the latter only fitting the minimum capacity
+    usize sizes[] = {sizeof(u64), 200};
+    bool expected = true;
+    for (usize s = 0; s < 2; ++s)
+    {
+        DUnrolledList* list = d_unrolled_list_new(sizes[s]);
+        u64* model = malloc(4000 * sizeof(u64));
+        u8 elem[200] = {0};
+        usize len = 0;
+        u64 state = 12345;
+        bool valid = list != NULL;
+        for (usize step = 0; step < 20000 && valid; ++step)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            usize index = (state >> 33) % (len + 1);
+            DUnrolledIter it;
+            d_unrolled_list_iter_seek(&it, list, index);
+            //inserting twice as often as removing in the first half, the opposite afterwards
+            bool insert = len == 0 || ((state >> 20) % 3 != 0) == (step < 10000);
+            if (insert && len < 4000)
+            {
+                u64 value = step;
+                memcpy(elem, &value, sizeof(u64));
+                memmove(model + index + 1, model + index, (len - index) * sizeof(u64));
+                model[index] = value;
+                ++len;
+                valid = d_unrolled_list_iter_insert(&it, elem) != NULL
+                    && *(u64*)d_unrolled_list_iter_get(&it) == value;
+            }
+            else if (len > 0)
+            {
+                if (index == len)
+                    --index;
+                d_unrolled_list_iter_seek(&it, list, index);
+                u8 removed[200];
+                d_unrolled_list_iter_remove(&it, removed);
+                valid = *(u64*)removed == model[index];
+                memmove(model + index, model + index + 1, (len - index - 1) * sizeof(u64));
+                --len;
+                //the iterator is on the element that followed the removed one
+                u64* next = d_unrolled_list_iter_get(&it);
+                valid = valid && (index == len ? next == NULL : *next == model[index]);
+            }
+            if (step % 97 == 0 || step == 19999)
+            {
+                if (sizes[s] == sizeof(u64))
+                    valid = valid && unrolled_matches(list, model, len);
+                else
+                {
+                    valid = valid && list -> len == len;
+                    for (usize i = 0; i < len && valid; ++i)
+                        valid = *(u64*)d_unrolled_list_get(list, i) == model[i];
+                }
+            }
+        }
+        while (len > 0 && valid)
+        {
+            u8 front[200];
+            valid = d_unrolled_list_pop_front(list, front) && *(u64*)front == model[0];
+            memmove(model, model + 1, --len * sizeof(u64));
+        }
+        valid = valid && list -> len == 0;
+        assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+        free(model);
+        d_unrolled_list_destroy(&list);
+    }
+}
+
+typedef struct {
+    usize       producer;
+    usize       seq;
+    DMpscLink   link;
+} Message;
+
+void    test_d_mpsc_queue(void)
+{
+    DMpscQueue queue;
+    Message messages[100];
+    DMpscLink* links[64];
+    d_mpsc_queue_init(&queue);
+    bool expected = true;
+    bool valid = d_mpsc_queue_is_empty(&queue) && d_mpsc_queue_pop(&queue) == NULL
+        && d_mpsc_queue_pop_batch(&queue, links, 64) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //emptying the queue after every push, then with several links queued, goes through the stub both ways
+    for (usize i = 0; i < 10; ++i)
+    {
+        messages[i].seq = i;
+        d_mpsc_queue_push(&queue, &messages[i].link);
+        DMpscLink* link = d_mpsc_queue_pop(&queue);
+        valid = valid && link != NULL && d_mpsc_queue_is_empty(&queue)
+            && d_container_of(link, Message, link) -> seq == i && d_mpsc_queue_pop(&queue) == NULL;
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    for (usize i = 0; i < 100; ++i)
+    {
+        messages[i].seq = i;
+        d_mpsc_queue_push(&queue, &messages[i].link);
+    }
+    valid = !d_mpsc_queue_is_empty(&queue);
+    usize next = 0;
+    usize count;
+    while ((count = d_mpsc_queue_pop_batch(&queue, links, 64)) > 0)
+        for (usize i = 0; i < count; ++i)
+            valid = valid && d_container_of(links[i], Message, link) -> seq == next++;
+    valid = valid && next == 100 && d_mpsc_queue_is_empty(&queue);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //a popped link may be pushed again
+    d_mpsc_queue_push(&queue, &messages[5].link);
+    d_mpsc_queue_push(&queue, &messages[3].link);
+    valid = d_mpsc_queue_pop_wait(&queue) == &messages[5].link
+        && d_mpsc_queue_pop_batch_wait(&queue, links, 64) == 1 && links[0] == &messages[3].link;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+}
+
+#define MPSC_PRODUCERS 4
+#define MPSC_MESSAGES 100000
+
+typedef struct {
+    DMpscQueue* queue;
+    Message*    messages;
+    usize       producer;
+    usize       count;
+    useconds_t  delay; /* between two pushes, to let the consumer fall asleep */
+} MpscProducer;
+
+void*   mpsc_producer(void* arg)
+{
+    MpscProducer* producer = arg;
+    for (usize i = 0; i < producer -> count; ++i)
+    {
+        producer -> messages[i].producer = producer -> producer;
+        producer -> messages[i].seq = i;
+        d_mpsc_queue_push(producer -> queue, &producer -> messages[i].link);
+        if (producer -> delay != 0)
+            usleep(producer -> delay);
+    }
+    return NULL;
+}
+
+//Consumes the messages of every producer, checking that each one's messages come in order
+usize   mpsc_consume(DMpscQueue* queue, MpscProducer* producers, usize producer_count, bool batch)
+{
+    usize next[MPSC_PRODUCERS] = {0};
+    usize total = 0;
+    usize expected_total = 0;
+    usize errors = 0;
+    DMpscLink* links[32];
+    for (usize p = 0; p < producer_count; ++p)
+        expected_total += producers[p].count;
+    while (total < expected_total)
+    {
+        usize count = 1;
+        if (batch)
+            count = d_mpsc_queue_pop_batch_wait(queue, links, 32);
+        else
+            links[0] = d_mpsc_queue_pop_wait(queue);
+        for (usize i = 0; i < count; ++i)
+        {
+            Message* message = d_container_of(links[i], Message, link);
+            errors += message -> producer >= producer_count || message -> seq != next[message -> producer]++;
+        }
+        total += count;
+    }
+    return errors + !d_mpsc_queue_is_empty(queue) + (d_mpsc_queue_pop(queue) != NULL);
+}
+
+void    test_d_mpsc_queue_threads(void)
+{
+    DMpscQueue queue;
+    pthread_t threads[MPSC_PRODUCERS];
+    MpscProducer producers[MPSC_PRODUCERS];
+    usize zero = 0;
+    d_mpsc_queue_init(&queue);
+    //a flood of messages, consumed one by one then by batches
+    for (usize round = 0; round < 2; ++round)
+    {
+        for (usize p = 0; p < MPSC_PRODUCERS; ++p)
+        {
+            producers[p] = (MpscProducer){&queue, malloc(MPSC_MESSAGES * sizeof(Message)), p, MPSC_MESSAGES, 0};
+            pthread_create(threads + p, NULL, mpsc_producer, producers + p);
+        }
+        usize errors = mpsc_consume(&queue, producers, MPSC_PRODUCERS, round == 1);
+        for (usize p = 0; p < MPSC_PRODUCERS; ++p)
+        {
+            pthread_join(threads[p], NULL);
+            free(producers[p].messages);
+        }
+        assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+    }
+    //slow producers, the consumer sleeps on the queue between most messages
+    for (usize p = 0; p < 2; ++p)
+    {
+        producers[p] = (MpscProducer){&queue, malloc(300 * sizeof(Message)), p, 300, 100 + 50 * p};
+        pthread_create(threads + p, NULL, mpsc_producer, producers + p);
+    }
+    usize errors = mpsc_consume(&queue, producers, 2, false);
+    for (usize p = 0; p < 2; ++p)
+    {
+        pthread_join(threads[p], NULL);
+        free(producers[p].messages);
+    }
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+}
+
+int main()
+{
+    TEST("test_d_list", test_d_list(););
+    TEST("test_d_slist", test_d_slist(););
+    TEST("test_d_singly_list", test_d_singly_list(););
+    TEST("test_d_double_list", test_d_double_list(););
+    TEST("test_d_linked_list_threads", test_d_linked_list_threads(););
+    TEST("test_d_unrolled_list", test_d_unrolled_list(););
+    TEST("test_d_unrolled_list_churn", test_d_unrolled_list_churn(););
+    TEST("test_d_mpsc_queue", test_d_mpsc_queue(););
+    TEST("test_d_mpsc_queue_threads", test_d_mpsc_queue_threads(););
+}
@@ -0,0 +1,363 @@
+#ifndef __D_MEMORY_ALLOC__H
+#define __D_MEMORY_ALLOC__H
+
+#include <dtypes.h>
+#include <dalloc.h>
+#include <stddef.h>
+#include <stdalign.h>
+typedef struct _DArena		DArena;
+typedef struct _DArenaChunk	DArenaChunk;
+typedef struct _DArenaMark	DArenaMark;
+typedef struct _DPool		DPool;
+typedef struct _DPoolCache	DPoolCache;
+typedef struct _DPoolSet	DPoolSet;
+
+/**
+ * @brief Size of the chunks an arena allocates when it is given a chunk size of 0.
+ */
+#define D_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+/**
+ * @brief Alignment of the memory returned by `d_arena_alloc`, suitable for any standard type.
+ */
+#define D_ARENA_DEFAULT_ALIGNMENT (alignof(max_align_t))
+
+/**
+ * DArena:
+ * @param used the number of bytes handed out by the arena since its creation or its last reset/rewind,
+ *     alignment padding included.
+ * @param capacity the total number of bytes of the chunks the arena owns.
+ *
+ * Contains the public fields of a bump-pointer arena.
+ * An arena hands out memory by moving a pointer forward inside large chunks, an allocation is a
+ * few instructions and there is no per allocation free: everything allocated is released at once by
+ * `d_arena_reset`, or down to a savepoint by `d_arena_rewind`. When the current chunk is full a new one
+ * is allocated (or a previously used one reused), so the memory already handed out never moves.
+ */
+struct _DArena {
+	usize	used;
+	usize	capacity;
+};
+
+/**
+ * DArenaMark:
+ *
+ * A savepoint of an arena, taken by `d_arena_mark` and restored by `d_arena_rewind`.
+ * Its fields are private.
+ */
+struct _DArenaMark {
+	DArenaChunk*	chunk;
+	usize			offset;
+	usize			used;
+};
+
+/**
+ * @brief Creates a new, empty arena.
+ *
+ * No chunk is allocated until the first allocation.
+ *
+ * @param chunk_size The size of the chunks the arena allocates, 0 means `D_ARENA_DEFAULT_CHUNK_SIZE`.
+ *                   Allocations larger than a chunk get a chunk of their own.
+ *
+ * @return DArena* A pointer to the new arena, NULL if the allocation fails.
+ */
+DArena*		d_arena_new				(usize chunk_size);
+
+/**
+ * @brief Allocates `size` bytes aligned on `D_ARENA_DEFAULT_ALIGNMENT`.
+ *
+ * The memory is not initialized. It stays valid until the arena is reset, rewound to a mark taken
+ * before this allocation, or destroyed.
+ *
+ * @param arena The arena to allocate from. Must not be NULL.
+ * @param size The number of bytes to allocate, 0 returns a valid pointer that must not be dereferenced.
+ *
+ * @return void* A pointer to the allocated memory, NULL if a new chunk was needed and could not be allocated.
+ */
+void*		d_arena_alloc			(DArena* arena, usize size);
+
+/**
+ * @brief Allocates `size` bytes aligned on `alignment`.
+ *
+ * @param arena The arena to allocate from. Must not be NULL.
+ * @param size The number of bytes to allocate.
+ * @param alignment The requested alignment, must be a power of two.
+ *
+ * @return void* A pointer to the allocated memory, NULL if `alignment` is not a power of two or if a new chunk
+ *         was needed and could not be allocated.
+ */
+void*		d_arena_alloc_aligned	(DArena* arena, usize size, usize alignment);
+
+/**
+ * @brief Allocates a zeroed array of `nmemb` elements of `size` bytes.
+ *
+ * @return void* A pointer to the allocated memory, NULL if `nmemb * size` overflows or if the allocation fails.
+ */
+void*		d_arena_calloc			(DArena* arena, usize nmemb, usize size);
+
+/**
+ * @brief Resizes a block previously allocated from the arena.
+ *
+ * If `ptr` is the last block handed out by the arena and its chunk has room, it is grown or shrunk in place.
+ * Otherwise a new block is allocated and the `min(old_size, new_size)` first bytes are copied, the old block is
+ * simply abandoned until the next reset. A NULL `ptr` behaves as `d_arena_alloc`.
+ *
+ * @param arena The arena `ptr` comes from. Must not be NULL.
+ * @param ptr The block to resize, or NULL.
+ * @param old_size The size `ptr` was allocated with.
+ * @param new_size The requested size.
+ *
+ * @return void* A pointer to the resized block, NULL if the allocation fails (`ptr` is then left untouched).
+ */
+void*		d_arena_realloc			(DArena* arena, void* ptr, usize old_size, usize new_size);
+
+/**
+ * @brief Copies `size` bytes from `data` into a new block of the arena.
+ *
+ * @return void* A pointer to the copy, NULL if the allocation fails.
+ */
+void*		d_arena_memdup			(DArena* arena, const void* data, usize size);
+
+/**
+ * @brief Copies a null-terminated C string into the arena.
+ *
+ * @return char* A pointer to the copy, NULL if the allocation fails or if `str` is NULL.
+ */
+char*		d_arena_strdup			(DArena* arena, const char* str);
+
+/**
+ * @brief Takes a savepoint of the arena.
+ *
+ * @param arena The arena. Must not be NULL.
+ *
+ * @return DArenaMark The savepoint, to be given back to `d_arena_rewind`.
+ */
+DArenaMark	d_arena_mark			(DArena* arena);
+
+/**
+ * @brief Releases, in one step, every allocation made since `mark` was taken.
+ *
+ * The chunks are kept and reused by the next allocations. The behavior is undefined if `mark` was taken on
+ * another arena, or before a reset or a rewind to an older mark.
+ *
+ * @param arena The arena. Must not be NULL.
+ * @param mark A savepoint taken on `arena` by `d_arena_mark`.
+ */
+void		d_arena_rewind			(DArena* arena, DArenaMark mark);
+
+/**
+ * @brief Releases every allocation of the arena in one step.
+ *
+ * The chunks are kept and reused by the next allocations, so an arena reset at the end of every request
+ * stops calling `malloc` once it has reached its steady state size.
+ *
+ * @param arena The arena. Must not be NULL.
+ */
+void		d_arena_reset			(DArena* arena);
+
+/**
+ * @brief Frees every chunk of the arena and the arena itself, then sets its pointer to NULL.
+ *
+ * @param arena A pointer to the arena pointer. Nothing is done if it or the arena is NULL.
+ */
+void		d_arena_destroy			(DArena** arena);
+
+/**
+ * @brief Builds an allocator backed by an arena, to be given to the `_with_allocator` constructors.
+ *
+ * Allocations are `d_arena_alloc`, reallocations `d_arena_realloc` and frees do nothing: the memory of
+ * the containers is released by the next `d_arena_reset`/`d_arena_rewind`. A container built with it must not
+ * be used past such a reset, `d_array_destroy` and friends can still be called on it before.
+ *
+ * @code
+ * DAllocator allocator = d_arena_allocator(arena);
+ * DArray* array = d_array_new_with_allocator(false, sizeof(int), 0, &allocator);
+ * @endcode
+ *
+ * @param arena The arena, it must outlive the containers using the allocator.
+ *
+ * @return DAllocator The allocator.
+ */
+DAllocator	d_arena_allocator		(DArena* arena);
+
+/*-------------------------------------------------DPool-------------------------------------------------*/
+
+/**
+ * @brief Size of the slabs a pool carves its objects from, objects too large for it get larger slabs.
+ */
+#define D_POOL_SLAB_SIZE (64 * 1024)
+
+/**
+ * @brief Number of objects a `DPoolCache` moves from or to its pool at once.
+ */
+#define D_POOL_CACHE_BATCH 32
+
+/**
+ * DPool:
+ * @param object_size the size of the objects of the pool, rounded up to a multiple of `sizeof(void*)`.
+ * @param live the number of objects currently allocated, objects held by a `DPoolCache` included.
+ * @param capacity the number of objects the slabs of the pool can hold.
+ *
+ * Contains the public fields of a pool of fixed-size objects, such as list or hash table nodes.
+ * The objects are carved from page-aligned slabs of `D_POOL_SLAB_SIZE` bytes and the released ones are kept in
+ * an intrusive free list, so both `d_pool_alloc` and `d_pool_free` are O(1) and a few instructions long, with no
+ * per object header. Objects are aligned on the largest power of two dividing `object_size`, up to 64 bytes.
+ * Slabs are only given back to the system by `d_pool_destroy`.
+ */
+struct _DPool {
+	usize	object_size;
+	usize	live;
+	usize	capacity;
+};
+
+/**
+ * DPoolCache:
+ *
+ * A per-thread cache in front of a thread-safe pool, usually declared `_Thread_local` or on the stack of a worker.
+ * Allocations and frees go to a private free list and the shared pool, and its lock, is only reached once every
+ * `D_POOL_CACHE_BATCH` operations, to refill the cache or to give it back half of its objects.
+ * Its fields are private.
+ */
+struct _DPoolCache {
+	DPool*	pool;
+	void*	head;
+	usize	count;
+};
+
+/**
+ * @brief Creates a new, empty pool of objects of `object_size` bytes.
+ *
+ * No slab is allocated until the first allocation.
+ *
+ * @param object_size The size of the objects, rounded up to a multiple of `sizeof(void*)`.
+ * @param thread_safe If true the pool can be shared between threads, every operation then takes a spin lock,
+ *                    see `DPoolCache` to avoid it on hot paths.
+ *
+ * @return DPool* A pointer to the new pool, NULL if the allocation fails or if `object_size` is too large.
+ */
+DPool*		d_pool_new				(usize object_size, bool thread_safe);
+
+/**
+ * @brief Allocates one object from the pool, in O(1).
+ *
+ * The memory is not initialized, released objects are handed out again most recently freed first.
+ *
+ * @param pool The pool. Must not be NULL.
+ *
+ * @return void* A pointer to the object, NULL if a new slab was needed and could not be allocated.
+ */
+void*		d_pool_alloc			(DPool* pool);
+
+/**
+ * @brief Gives an object back to its pool, in O(1).
+ *
+ * @param pool The pool `ptr` was allocated from. Must not be NULL.
+ * @param ptr The object, nothing is done if it is NULL.
+ */
+void		d_pool_free				(DPool* pool, void* ptr);
+
+/**
+ * @brief Releases every object of the pool in one step, the slabs are kept for the next allocations.
+ *
+ * The behavior is undefined if a `DPoolCache` still holds objects of the pool.
+ *
+ * @param pool The pool. Must not be NULL.
+ */
+void		d_pool_reset			(DPool* pool);
+
+/**
+ * @brief Frees every slab of the pool and the pool itself, then sets its pointer to NULL.
+ *
+ * @param pool A pointer to the pool pointer. Nothing is done if it or the pool is NULL.
+ */
+void		d_pool_destroy			(DPool** pool);
+
+/**
+ * @brief Attaches a cache to a pool.
+ *
+ * @param cache The cache to initialize. Must not be NULL.
+ * @param pool The pool the cache takes its objects from, it should be thread-safe if several caches share it.
+ */
+void		d_pool_cache_init		(DPoolCache* cache, DPool* pool);
+
+/**
+ * @brief Allocates one object through a cache.
+ *
+ * @return void* A pointer to the object, NULL if the pool could not grow.
+ */
+void*		d_pool_cache_alloc		(DPoolCache* cache);
+
+/**
+ * @brief Releases one object through a cache.
+ *
+ * The object may have been allocated through any cache of the same pool, or from the pool itself.
+ *
+ * @param cache The cache. Must not be NULL.
+ * @param ptr The object, nothing is done if it is NULL.
+ */
+void		d_pool_cache_free		(DPoolCache* cache, void* ptr);
+
+/**
+ * @brief Gives every object held by a cache back to its pool, to be called before the owning thread exits.
+ */
+void		d_pool_cache_flush		(DPoolCache* cache);
+
+/*-------------------------------------------------DPoolSet-------------------------------------------------*/
+
+/**
+ * @brief Largest size served by the pools of a `DPoolSet`, larger blocks go to `malloc`.
+ */
+#define D_POOL_SET_MAX_SIZE 4096
+
+/**
+ * @brief Creates a set of pools, one per size class, that serves blocks of any size.
+ *
+ * Sizes are rounded up to a class: every 16 bytes up to 256 bytes, then 4 classes per power of two up to
+ * `D_POOL_SET_MAX_SIZE`, so at most 25% of a block is lost to rounding. Every block is aligned on 16 bytes.
+ * As for the `DAllocator` interface, the caller gives the size of the block back when freeing it, which is how
+ * its class is found without any header.
+ *
+ * @param thread_safe Same meaning as for `d_pool_new`, applied to every pool of the set.
+ *
+ * @return DPoolSet* A pointer to the new set, NULL if the allocation fails.
+ */
+DPoolSet*	d_pool_set_new			(bool thread_safe);
+
+/**
+ * @brief Allocates `size` bytes from the pool of their size class.
+ *
+ * @return void* A pointer to the block, NULL if the allocation fails.
+ */
+void*		d_pool_set_alloc		(DPoolSet* set, usize size);
+
+/**
+ * @brief Releases a block of `size` bytes allocated from the set.
+ *
+ * @param set The set. Must not be NULL.
+ * @param ptr The block, nothing is done if it is NULL.
+ * @param size The size the block was allocated, or last reallocated, with.
+ */
+void		d_pool_set_free			(DPoolSet* set, void* ptr, usize size);
+
+/**
+ * @brief Resizes a block of the set, it stays in place when both sizes belong to the same class.
+ *
+ * @return void* A pointer to the resized block, NULL if the allocation fails (`ptr` is then left untouched).
+ */
+void*		d_pool_set_realloc		(DPoolSet* set, void* ptr, usize old_size, usize new_size);
+
+/**
+ * @brief Frees every pool of the set and the set itself, then sets its pointer to NULL.
+ */
+void		d_pool_set_destroy		(DPoolSet** set);
+
+/**
+ * @brief Builds an allocator backed by a set of pools, to be given to the `_with_allocator` constructors.
+ *
+ * @param set The set, it must outlive the containers using the allocator.
+ *
+ * @return DAllocator The allocator.
+ */
+DAllocator	d_pool_set_allocator	(DPoolSet* set);
+
+#endif
@@ -0,0 +1,596 @@
+#include <d_memory_alloc.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct _DRealArena DRealArena;
+
+//CHUNK HEADER, THE CHUNK MEMORY FOLLOWS IT
+struct _DArenaChunk {
+	DArenaChunk*	next;
+	usize			capacity; /* number of bytes after the header */
+	usize			offset; /* number of bytes already handed out */
+};
+
+//REAL ARENA STRUCTURE ALLOCATED
+struct _DRealArena {
+	usize			used;
+	usize			capacity;
+	DArenaChunk*	head; /* first chunk, the chunks after current are spare ones kept for reuse */
+	DArenaChunk*	current; /* chunk allocations are made from, NULL only while head is NULL */
+	usize			chunk_size;
+	void*			last; /* last block handed out, the one d_arena_realloc can resize in place */
+};
+
+//SIZE OF THE CHUNK HEADER ROUNDED UP SO THAT THE CHUNK MEMORY STARTS WITH THE DEFAULT ALIGNMENT
+#define D_ARENA_CHUNK_HEADER_SIZE ((sizeof(DArenaChunk) + D_ARENA_DEFAULT_ALIGNMENT - 1) & ~(D_ARENA_DEFAULT_ALIGNMENT - 1))
+
+#define d_arena_chunk_data(chunk) ((u8*)(chunk) + D_ARENA_CHUNK_HEADER_SIZE)
+
+#define d_is_power_of_two(x) ((x) != 0 && ((x) & ((x) - 1)) == 0)
+
+DArena*		d_arena_new				(usize chunk_size)
+{
+	DRealArena* arena = malloc(sizeof(DRealArena));
+	if (arena == NULL)
+		return NULL;
+	arena -> used = 0;
+	arena -> capacity = 0;
+	arena -> head = NULL;
+	arena -> current = NULL;
+	arena -> chunk_size = chunk_size == 0 ? D_ARENA_DEFAULT_CHUNK_SIZE : chunk_size;
+	arena -> last = NULL;
+	return (DArena*)arena;
+}
+
+/*
+** Makes the chunk following the current one, able to hold `needed` bytes, the current chunk.
+** Spare chunks too small for the request are freed, a new chunk is allocated when no spare one is left.
+*/
+static bool	d_arena_next_chunk(DRealArena* arena, usize needed)
+{
+	DArenaChunk** link = arena -> current == NULL ? &arena -> head : &arena -> current -> next;
+	while (*link != NULL && (*link) -> capacity < needed)
+	{
+		DArenaChunk* too_small = *link;
+		*link = too_small -> next;
+		arena -> capacity -= too_small -> capacity;
+		free(too_small);
+	}
+	if (*link == NULL)
+	{
+		usize capacity = needed > arena -> chunk_size ? needed : arena -> chunk_size;
+		if (capacity > MAX_SIZE_T_VALUE - D_ARENA_CHUNK_HEADER_SIZE)
+			return false;
+		DArenaChunk* chunk = malloc(D_ARENA_CHUNK_HEADER_SIZE + capacity);
+		if (chunk == NULL)
+			return false;
+		chunk -> next = NULL;
+		chunk -> capacity = capacity;
+		arena -> capacity += capacity;
+		*link = chunk;
+	}
+	(*link) -> offset = 0;
+	arena -> current = *link;
+	return true;
+}
+
+void*		d_arena_alloc_aligned	(DArena* arena_, usize size, usize alignment)
+{
+	DRealArena* arena = (DRealArena*)arena_;
+	if (d_is_power_of_two(alignment) == false)
+		return NULL;
+	DArenaChunk* chunk = arena -> current;
+	usize padding = 0;
+	if (chunk != NULL)
+		padding = -(uintptr_t)(d_arena_chunk_data(chunk) + chunk -> offset) & (alignment - 1);
+	if (chunk == NULL || padding > chunk -> capacity - chunk -> offset || size > chunk -> capacity - chunk -> offset - padding)
+	{
+		//worst case padding so that the block fits whatever the chunk address
+		if (size > MAX_SIZE_T_VALUE - alignment || d_arena_next_chunk(arena, size + alignment - 1) == false)
+			return NULL;
+		chunk = arena -> current;
+		padding = -(uintptr_t)d_arena_chunk_data(chunk) & (alignment - 1);
+	}
+	u8* block = d_arena_chunk_data(chunk) + chunk -> offset + padding;
+	chunk -> offset += padding + size;
+	arena -> used += padding + size;
+	arena -> last = block;
+	return block;
+}
+
+void*		d_arena_alloc			(DArena* arena, usize size)
+{
+	return d_arena_alloc_aligned(arena, size, D_ARENA_DEFAULT_ALIGNMENT);
+}
+
+void*		d_arena_calloc			(DArena* arena, usize nmemb, usize size)
+{
+	if (size != 0 && nmemb > MAX_SIZE_T_VALUE / size)
+		return NULL;
+	void* block = d_arena_alloc(arena, nmemb * size);
+	if (block != NULL)
+		memset(block, 0, nmemb * size);
+	return block;
+}
+
+void*		d_arena_realloc			(DArena* arena_, void* ptr, usize old_size, usize new_size)
+{
+	DRealArena* arena = (DRealArena*)arena_;
+	if (ptr == NULL)
+		return d_arena_alloc(arena_, new_size);
+	DArenaChunk* chunk = arena -> current;
+	if (ptr == arena -> last)
+	{
+		usize start = (u8*)ptr - d_arena_chunk_data(chunk);
+		if (new_size <= chunk -> capacity - start)
+		{
+			chunk -> offset = start + new_size;
+			arena -> used = arena -> used - old_size + new_size;
+			return ptr;
+		}
+	}
+	else if (new_size <= old_size)
+		return ptr;
+	void* block = d_arena_alloc(arena_, new_size);
+	if (block != NULL)
+		memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+	return block;
+}
+
+void*		d_arena_memdup			(DArena* arena, const void* data, usize size)
+{
+	void* block = d_arena_alloc_aligned(arena, size, 1);
+	if (block != NULL && size != 0)
+		memcpy(block, data, size);
+	return block;
+}
+
+char*		d_arena_strdup			(DArena* arena, const char* str)
+{
+	if (str == NULL)
+		return NULL;
+	return d_arena_memdup(arena, str, strlen(str) + 1);
+}
+
+DArenaMark	d_arena_mark			(DArena* arena_)
+{
+	DRealArena* arena = (DRealArena*)arena_;
+	DArenaMark mark = {
+		.chunk = arena -> current,
+		.offset = arena -> current == NULL ? 0 : arena -> current -> offset,
+		.used = arena -> used
+	};
+	return mark;
+}
+
+void		d_arena_rewind			(DArena* arena_, DArenaMark mark)
+{
+	DRealArena* arena = (DRealArena*)arena_;
+	if (mark.chunk == NULL)
+	{
+		//the mark was taken before the first allocation
+		arena -> current = arena -> head;
+		if (arena -> head != NULL)
+			arena -> head -> offset = 0;
+	}
+	else
+	{
+		arena -> current = mark.chunk;
+		mark.chunk -> offset = mark.offset;
+	}
+	arena -> used = mark.used;
+	arena -> last = NULL;
+}
+
+void		d_arena_reset			(DArena* arena)
+{
+	d_arena_rewind(arena, (DArenaMark){ .chunk = NULL, .offset = 0, .used = 0 });
+}
+
+void		d_arena_destroy			(DArena** arena_)
+{
+	if (arena_ == NULL || *arena_ == NULL)
+		return;
+	DRealArena* arena = (DRealArena*)*arena_;
+	DArenaChunk* chunk = arena -> head;
+	while (chunk != NULL)
+	{
+		DArenaChunk* next = chunk -> next;
+		free(chunk);
+		chunk = next;
+	}
+	free(arena);
+	*arena_ = NULL;
+}
+
+static void*	d_arena_allocator_alloc(void* ctx, usize size)
+{
+	return d_arena_alloc(ctx, size);
+}
+
+static void*	d_arena_allocator_realloc(void* ctx, void* ptr, usize old_size, usize new_size)
+{
+	return d_arena_realloc(ctx, ptr, old_size, new_size);
+}
+
+static void		d_arena_allocator_free(void* ctx, void* ptr, usize size)
+{
+	(void)ctx;
+	(void)ptr;
+	(void)size;
+}
+
+DAllocator	d_arena_allocator		(DArena* arena)
+{
+	return (DAllocator){
+		.alloc = d_arena_allocator_alloc,
+		.realloc = d_arena_allocator_realloc,
+		.free = d_arena_allocator_free,
+		.ctx = arena
+	};
+}
+
+/*-------------------------------------------------DPool-------------------------------------------------*/
+
+typedef struct _DRealPool	DRealPool;
+typedef struct _DPoolSlab	DPoolSlab;
+
+//SLAB HEADER, THE OBJECTS START D_POOL_SLAB_HEADER_SIZE BYTES AFTER THE SLAB ADDRESS
+struct _DPoolSlab {
+	DPoolSlab*	next;
+	usize		size;
+};
+
+//REAL POOL STRUCTURE ALLOCATED
+struct _DRealPool {
+	usize		object_size;
+	usize		live;
+	usize		capacity;
+	void*		free_list; /* released objects, linked through their first word */
+	DPoolSlab*	head;
+	DPoolSlab*	current; /* slab the never used objects are carved from */
+	u8*			bump; /* next never used object of the current slab */
+	u8*			end; /* end of the last whole object of the current slab */
+	bool		thread_safe;
+	bool		lock;
+};
+
+//THE HEADER TAKES A WHOLE CACHE LINE SO THAT THE OBJECTS KEEP THE ALIGNMENT OF THEIR SIZE UP TO 64 BYTES
+#define D_POOL_SLAB_HEADER_SIZE 64
+
+//MINIMUM NUMBER OF OBJECTS OF A SLAB, LARGE OBJECTS GET LARGER SLABS
+#define D_POOL_SLAB_MIN_OBJECTS 16
+
+#define d_pool_next(object) (*(void**)(object))
+
+static usize	d_page_size(void)
+{
+	static usize page_size = 0;
+	usize size = __atomic_load_n(&page_size, __ATOMIC_RELAXED);
+	if (size == 0)
+	{
+		long value = sysconf(_SC_PAGESIZE);
+		size = value > 0 ? (usize)value : 4096;
+		__atomic_store_n(&page_size, size, __ATOMIC_RELAXED);
+	}
+	return size;
+}
+
+static inline void	d_pool_lock(DRealPool* pool)
+{
+	if (pool -> thread_safe == false)
+		return;
+	while (__atomic_test_and_set(&pool -> lock, __ATOMIC_ACQUIRE))
+	{
+		while (__atomic_load_n(&pool -> lock, __ATOMIC_RELAXED))
+		{
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#endif
+		}
+	}
+}
+
+static inline void	d_pool_unlock(DRealPool* pool)
+{
+	if (pool -> thread_safe == true)
+		__atomic_clear(&pool -> lock, __ATOMIC_RELEASE);
+}
+
+DPool*		d_pool_new				(usize object_size, bool thread_safe)
+{
+	if (object_size > (MAX_SIZE_T_VALUE - D_POOL_SLAB_SIZE) / D_POOL_SLAB_MIN_OBJECTS)
+		return NULL;
+	DRealPool* pool = malloc(sizeof(DRealPool));
+	if (pool == NULL)
+		return NULL;
+	object_size = object_size < sizeof(void*) ? sizeof(void*) : object_size;
+	pool -> object_size = (object_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+	pool -> live = 0;
+	pool -> capacity = 0;
+	pool -> free_list = NULL;
+	pool -> head = NULL;
+	pool -> current = NULL;
+	pool -> bump = NULL;
+	pool -> end = NULL;
+	pool -> thread_safe = thread_safe;
+	pool -> lock = false;
+	return (DPool*)pool;
+}
+
+//Carves the never used objects from the slab following the current one, allocating it if there is none
+static bool	d_pool_next_slab(DRealPool* pool)
+{
+	DPoolSlab* slab = pool -> current == NULL ? pool -> head : pool -> current -> next;
+	if (slab == NULL)
+	{
+		usize page_size = d_page_size();
+		usize size = D_POOL_SLAB_HEADER_SIZE + pool -> object_size * D_POOL_SLAB_MIN_OBJECTS;
+		size = size < D_POOL_SLAB_SIZE ? D_POOL_SLAB_SIZE : (size + page_size - 1) & ~(page_size - 1);
+		void* memory;
+		if (posix_memalign(&memory, page_size, size) != 0)
+			return false;
+		slab = memory;
+		slab -> next = NULL;
+		slab -> size = size;
+		if (pool -> current == NULL)
+			pool -> head = slab;
+		else
+			pool -> current -> next = slab;
+		pool -> capacity += (size - D_POOL_SLAB_HEADER_SIZE) / pool -> object_size;
+	}
+	pool -> current = slab;
+	pool -> bump = (u8*)slab + D_POOL_SLAB_HEADER_SIZE;
+	pool -> end = pool -> bump + (slab -> size - D_POOL_SLAB_HEADER_SIZE) / pool -> object_size * pool -> object_size;
+	return true;
+}
+
+//Takes one object, the lock must be held
+static inline void*	d_pool_take(DRealPool* pool)
+{
+	void* object = pool -> free_list;
+	if (object != NULL)
+		pool -> free_list = d_pool_next(object);
+	else
+	{
+		if (pool -> bump == pool -> end && d_pool_next_slab(pool) == false)
+			return NULL;
+		object = pool -> bump;
+		pool -> bump += pool -> object_size;
+	}
+	++pool -> live;
+	return object;
+}
+
+void*		d_pool_alloc			(DPool* pool_)
+{
+	DRealPool* pool = (DRealPool*)pool_;
+	d_pool_lock(pool);
+	void* object = d_pool_take(pool);
+	d_pool_unlock(pool);
+	return object;
+}
+
+void		d_pool_free				(DPool* pool_, void* ptr)
+{
+	DRealPool* pool = (DRealPool*)pool_;
+	if (ptr == NULL)
+		return;
+	d_pool_lock(pool);
+	d_pool_next(ptr) = pool -> free_list;
+	pool -> free_list = ptr;
+	--pool -> live;
+	d_pool_unlock(pool);
+}
+
+void		d_pool_reset			(DPool* pool_)
+{
+	DRealPool* pool = (DRealPool*)pool_;
+	d_pool_lock(pool);
+	pool -> free_list = NULL;
+	pool -> live = 0;
+	pool -> current = NULL;
+	pool -> bump = NULL;
+	pool -> end = NULL;
+	d_pool_unlock(pool);
+}
+
+void		d_pool_destroy			(DPool** pool_)
+{
+	if (pool_ == NULL || *pool_ == NULL)
+		return;
+	DRealPool* pool = (DRealPool*)*pool_;
+	DPoolSlab* slab = pool -> head;
+	while (slab != NULL)
+	{
+		DPoolSlab* next = slab -> next;
+		free(slab);
+		slab = next;
+	}
+	free(pool);
+	*pool_ = NULL;
+}
+
+void		d_pool_cache_init		(DPoolCache* cache, DPool* pool)
+{
+	cache -> pool = pool;
+	cache -> head = NULL;
+	cache -> count = 0;
+}
+
+void*		d_pool_cache_alloc		(DPoolCache* cache)
+{
+	if (cache -> head == NULL)
+	{
+		//refill with a whole batch under a single lock
+		DRealPool* pool = (DRealPool*)cache -> pool;
+		d_pool_lock(pool);
+		for (usize i = 0; i < D_POOL_CACHE_BATCH; ++i)
+		{
+			void* object = d_pool_take(pool);
+			if (object == NULL)
+				break;
+			d_pool_next(object) = cache -> head;
+			cache -> head = object;
+			++cache -> count;
+		}
+		d_pool_unlock(pool);
+		if (cache -> head == NULL)
+			return NULL;
+	}
+	void* object = cache -> head;
+	cache -> head = d_pool_next(object);
+	--cache -> count;
+	return object;
+}
+
+//Gives the `count` first objects of the cache back to the pool under a single lock
+static void	d_pool_cache_release(DPoolCache* cache, usize count)
+{
+	if (count == 0)
+		return;
+	void* first = cache -> head;
+	void* last = first;
+	for (usize i = 1; i < count; ++i)
+		last = d_pool_next(last);
+	cache -> head = d_pool_next(last);
+	cache -> count -= count;
+	DRealPool* pool = (DRealPool*)cache -> pool;
+	d_pool_lock(pool);
+	d_pool_next(last) = pool -> free_list;
+	pool -> free_list = first;
+	pool -> live -= count;
+	d_pool_unlock(pool);
+}
+
+void		d_pool_cache_free		(DPoolCache* cache, void* ptr)
+{
+	if (ptr == NULL)
+		return;
+	d_pool_next(ptr) = cache -> head;
+	cache -> head = ptr;
+	if (++cache -> count >= 2 * D_POOL_CACHE_BATCH)
+		d_pool_cache_release(cache, D_POOL_CACHE_BATCH);
+}
+
+void		d_pool_cache_flush		(DPoolCache* cache)
+{
+	d_pool_cache_release(cache, cache -> count);
+}
+
+/*-------------------------------------------------DPoolSet-------------------------------------------------*/
+
+//CLASSES EVERY 16 BYTES UP TO 256 BYTES, THEN 4 CLASSES PER POWER OF TWO UP TO D_POOL_SET_MAX_SIZE
+#define D_POOL_SET_SMALL_MAX 256
+#define D_POOL_SET_SMALL_CLASSES (D_POOL_SET_SMALL_MAX / 16)
+#define D_POOL_SET_CLASSES (D_POOL_SET_SMALL_CLASSES + 4 * 4)
+
+_Static_assert(D_POOL_SET_MAX_SIZE == D_POOL_SET_SMALL_MAX << 4, "the size classes must end at D_POOL_SET_MAX_SIZE");
+
+struct _DPoolSet {
+	DPool*	pools[D_POOL_SET_CLASSES];
+};
+
+static inline usize	d_pool_set_class(usize size)
+{
+	if (size <= D_POOL_SET_SMALL_MAX)
+		return size == 0 ? 0 : (size - 1) / 16;
+	usize log2 = (sizeof(usize) * 8 - 1) - (usize)__builtin_clzl(size - 1);
+	return D_POOL_SET_SMALL_CLASSES + (log2 - 8) * 4 + ((size - 1 - ((usize)1 << log2)) >> (log2 - 2));
+}
+
+static usize	d_pool_set_class_size(usize class)
+{
+	if (class < D_POOL_SET_SMALL_CLASSES)
+		return (class + 1) * 16;
+	usize log2 = 8 + (class - D_POOL_SET_SMALL_CLASSES) / 4;
+	return ((usize)1 << log2) + ((class - D_POOL_SET_SMALL_CLASSES) % 4 + 1) * ((usize)1 << (log2 - 2));
+}
+
+DPoolSet*	d_pool_set_new			(bool thread_safe)
+{
+	DPoolSet* set = malloc(sizeof(DPoolSet));
+	if (set == NULL)
+		return NULL;
+	//a pool allocates nothing before its first allocation, so every class is created up front
+	for (usize class = 0; class < D_POOL_SET_CLASSES; ++class)
+	{
+		if ((set -> pools[class] = d_pool_new(d_pool_set_class_size(class), thread_safe)) == NULL)
+		{
+			while (class > 0)
+				d_pool_destroy(&set -> pools[--class]);
+			free(set);
+			return NULL;
+		}
+	}
+	return set;
+}
+
+void*		d_pool_set_alloc		(DPoolSet* set, usize size)
+{
+	if (size > D_POOL_SET_MAX_SIZE)
+		return malloc(size);
+	return d_pool_alloc(set -> pools[d_pool_set_class(size)]);
+}
+
+void		d_pool_set_free			(DPoolSet* set, void* ptr, usize size)
+{
+	if (size > D_POOL_SET_MAX_SIZE)
+		free(ptr);
+	else
+		d_pool_free(set -> pools[d_pool_set_class(size)], ptr);
+}
+
+void*		d_pool_set_realloc		(DPoolSet* set, void* ptr, usize old_size, usize new_size)
+{
+	if (ptr == NULL)
+		return d_pool_set_alloc(set, new_size);
+	if (old_size > D_POOL_SET_MAX_SIZE && new_size > D_POOL_SET_MAX_SIZE)
+		return realloc(ptr, new_size);
+	if (old_size <= D_POOL_SET_MAX_SIZE && new_size <= D_POOL_SET_MAX_SIZE
+		&& d_pool_set_class(old_size) == d_pool_set_class(new_size))
+		return ptr;
+	void* block = d_pool_set_alloc(set, new_size);
+	if (block == NULL)
+		return NULL;
+	memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+	d_pool_set_free(set, ptr, old_size);
+	return block;
+}
+
+void		d_pool_set_destroy		(DPoolSet** set)
+{
+	if (set == NULL || *set == NULL)
+		return;
+	for (usize class = 0; class < D_POOL_SET_CLASSES; ++class)
+		d_pool_destroy(&(*set) -> pools[class]);
+	free(*set);
+	*set = NULL;
+}
+
+static void*	d_pool_set_allocator_alloc(void* ctx, usize size)
+{
+	return d_pool_set_alloc(ctx, size);
+}
+
+static void*	d_pool_set_allocator_realloc(void* ctx, void* ptr, usize old_size, usize new_size)
+{
+	return d_pool_set_realloc(ctx, ptr, old_size, new_size);
+}
+
+static void		d_pool_set_allocator_free(void* ctx, void* ptr, usize size)
+{
+	d_pool_set_free(ctx, ptr, size);
+}
+
+DAllocator	d_pool_set_allocator	(DPoolSet* set)
+{
+	return (DAllocator){
+		.alloc = d_pool_set_allocator_alloc,
+		.realloc = d_pool_set_allocator_realloc,
+		.free = d_pool_set_allocator_free,
+		.ctx = set
+	};
+}
@@ -0,0 +1,449 @@
+#include <d_memory_alloc.h>
+#include <darray.h>
+#include <dstring.h>
+#include <dtest.h>
+#include <dutils.h>
+#include <string.h>
+#include <general_lib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+char*   itoa_usize(void* data)
+{
+    return d_itoa_usize(*((usize*)data));
+}
+
+char*   itoa_bool(void* data)
+{
+    return d_itoa_usize(*((bool*)data));
+}
+
+void    test_d_arena_alloc(void)
+{
+    DArena* arena = d_arena_new(256);
+    usize expected = 0;
+    assert_eq_custom(&arena -> used, &expected, sizeof(usize), itoa_usize);
+    assert_eq_custom(&arena -> capacity, &expected, sizeof(usize), itoa_usize);
+    //blocks are aligned, do not overlap and survive the allocation of new chunks
+    u8* blocks[100];
+    bool valid = true;
+    for (usize i = 0; i < 100; ++i)
+    {
+        blocks[i] = d_arena_alloc(arena, 1 + i % 40);
+        valid = valid && blocks[i] != NULL && (uintptr_t)blocks[i] % D_ARENA_DEFAULT_ALIGNMENT == 0;
+        if (valid)
+            memset(blocks[i], (int)i, 1 + i % 40);
+    }
+    for (usize i = 0; i < 100 && valid; ++i)
+        for (usize j = 0; j < 1 + i % 40; ++j)
+            valid = valid && blocks[i][j] == (u8)i;
+    bool expected_bool = true;
+    assert_eq_custom(&valid, &expected_bool, sizeof(bool), itoa_bool);
+    valid = arena -> capacity > 256 && arena -> used <= arena -> capacity;
+    assert_eq_custom(&valid, &expected_bool, sizeof(bool), itoa_bool);
+    //an allocation larger than a chunk gets a chunk of its own
+    u8* big = d_arena_alloc(arena, 10000);
+    valid = big != NULL && arena -> capacity >= 10000;
+    if (big != NULL)
+        memset(big, 'x', 10000);
+    assert_eq_custom(&valid, &expected_bool, sizeof(bool), itoa_bool);
+    //a zero sized allocation still returns a pointer
+    valid = d_arena_alloc(arena, 0) != NULL;
+    assert_eq_custom(&valid, &expected_bool, sizeof(bool), itoa_bool);
+    d_arena_destroy(&arena);
+    assert_eq_null(arena);
+    d_arena_destroy(&arena);
+    arena = d_arena_new(0);
+    valid = d_arena_alloc(arena, 1) != NULL && arena -> capacity == D_ARENA_DEFAULT_CHUNK_SIZE;
+    assert_eq_custom(&valid, &expected_bool, sizeof(bool), itoa_bool);
+    d_arena_destroy(&arena);
+}
+
+void    test_d_arena_alloc_aligned(void)
+{
+    DArena* arena = d_arena_new(512);
+    bool valid = true;
+    bool expected = true;
+    for (usize alignment = 1; alignment <= 4096; alignment *= 2)
+    {
+        d_arena_alloc_aligned(arena, 3, 1);
+        void* ptr = d_arena_alloc_aligned(arena, 24, alignment);
+        valid = valid && ptr != NULL && (uintptr_t)ptr % alignment == 0;
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    assert_eq_null(d_arena_alloc_aligned(arena, 8, 0));
+    assert_eq_null(d_arena_alloc_aligned(arena, 8, 24));
+    assert_eq_null(d_arena_alloc_aligned(arena, MAX_SIZE_T_VALUE - 2, 16));
+    d_arena_destroy(&arena);
+}
+
+void    test_d_arena_calloc(void)
+{
+    DArena* arena = d_arena_new(128);
+    //dirty the chunk before rewinding so that calloc has something to clear
+    memset(d_arena_alloc(arena, 100), 0xFF, 100);
+    d_arena_reset(arena);
+    u8* zeroed = d_arena_calloc(arena, 25, 4);
+    bool valid = zeroed != NULL;
+    for (usize i = 0; i < 100 && valid; ++i)
+        valid = zeroed[i] == 0;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    assert_eq_null(d_arena_calloc(arena, MAX_SIZE_T_VALUE / 2, 4));
+    d_arena_destroy(&arena);
+}
+
+void    test_d_arena_realloc(void)
+{
+    DArena* arena = d_arena_new(256);
+    char* str = d_arena_realloc(arena, NULL, 0, 6);
+    memcpy(str, "hello", 6);
+    //the last block grows in place while its chunk has room
+    char* grown = d_arena_realloc(arena, str, 6, 100);
+    bool expected = true;
+    bool valid = grown == str && arena -> used == 100;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_assert_eq(grown, "hello", 6);
+    //and shrinks in place, giving its tail back
+    grown = d_arena_realloc(arena, grown, 100, 10);
+    valid = grown == str && arena -> used == 10;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //a block which is not the last one is copied
+    char* other = d_arena_strdup(arena, "other");
+    char* moved = d_arena_realloc(arena, str, 10, 20);
+    valid = moved != str && moved != NULL && memcmp(moved, "hello", 6) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_assert_eq(other, "other", 6);
+    //unless it shrinks
+    valid = d_arena_realloc(arena, other, 6, 3) == other;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //growing past the chunk moves the block to a new chunk
+    char* last = d_arena_strdup(arena, "last");
+    char* far = d_arena_realloc(arena, last, 5, 1000);
+    valid = far != last && far != NULL && memcmp(far, "last", 5) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_arena_destroy(&arena);
+}
+
+void    test_d_arena_strdup(void)
+{
+    DArena* arena = d_arena_new(64);
+    char long_str[] = "a string longer than a whole chunk of the arena, 64 bytes is not much";
+    char* str = d_arena_strdup(arena, long_str);
+    d_assert_eq(str, long_str, strlen(long_str) + 1);
+    assert_eq_null(d_arena_strdup(arena, NULL));
+    int32 values[] = {1, 2, 3, 4};
+    int32* copy = d_arena_memdup(arena, values, sizeof(values));
+    assert_eq_custom(copy, values, sizeof(values), NULL);
+    d_arena_destroy(&arena);
+}
+
+void    test_d_arena_mark_rewind(void)
+{
+    DArena* arena = d_arena_new(128);
+    d_arena_alloc(arena, 40);
+    DArenaMark mark = d_arena_mark(arena);
+    usize used = arena -> used;
+    void* first = d_arena_alloc(arena, 16);
+    for (usize i = 0; i < 20; ++i)
+        d_arena_alloc(arena, 100);
+    usize capacity = arena -> capacity;
+    d_arena_rewind(arena, mark);
+    assert_eq_custom(&arena -> used, &used, sizeof(usize), itoa_usize);
+    //the memory after the mark is handed out again, the chunks are reused
+    bool expected = true;
+    bool valid = d_arena_alloc(arena, 16) == first;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    for (usize i = 0; i < 20; ++i)
+        d_arena_alloc(arena, 100);
+    assert_eq_custom(&arena -> capacity, &capacity, sizeof(usize), itoa_usize);
+    //nested marks
+    DArenaMark outer = d_arena_mark(arena);
+    char* kept = d_arena_strdup(arena, "kept");
+    DArenaMark inner = d_arena_mark(arena);
+    d_arena_strdup(arena, "dropped");
+    d_arena_rewind(arena, inner);
+    char* reused = d_arena_strdup(arena, "reused");
+    d_assert_eq(kept, "kept", 5);
+    d_assert_eq(reused, "reused", 7);
+    d_arena_rewind(arena, outer);
+    valid = d_arena_strdup(arena, "again") == kept;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //a mark taken before the first allocation
+    DArena* empty = d_arena_new(128);
+    DArenaMark start = d_arena_mark(empty);
+    first = d_arena_alloc(empty, 8);
+    d_arena_alloc(empty, 500);
+    d_arena_rewind(empty, start);
+    usize zero = 0;
+    assert_eq_custom(&empty -> used, &zero, sizeof(usize), itoa_usize);
+    valid = d_arena_alloc(empty, 8) == first;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_arena_destroy(&empty);
+    d_arena_destroy(&arena);
+}
+
+void    test_d_arena_reset(void)
+{
+    DArena* arena = d_arena_new(256);
+    void* first = d_arena_alloc(arena, 10);
+    for (usize round = 0; round < 3; ++round)
+        for (usize i = 0; i < 50; ++i)
+            d_arena_alloc(arena, 64);
+    usize capacity = arena -> capacity;
+    d_arena_reset(arena);
+    usize zero = 0;
+    assert_eq_custom(&arena -> used, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&arena -> capacity, &capacity, sizeof(usize), itoa_usize);
+    bool expected = true;
+    bool valid = d_arena_alloc(arena, 10) == first;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //the same workload after a reset needs no new chunk
+    for (usize round = 0; round < 3; ++round)
+        for (usize i = 0; i < 50; ++i)
+            d_arena_alloc(arena, 64);
+    assert_eq_custom(&arena -> capacity, &capacity, sizeof(usize), itoa_usize);
+    //a spare chunk too small for a large request is replaced
+    d_arena_reset(arena);
+    valid = d_arena_alloc(arena, 4096) != NULL && arena -> used == 4096;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_arena_destroy(&arena);
+}
+
+void    test_d_arena_allocator(void)
+{
+    DArena* arena = d_arena_new(0);
+    DAllocator allocator = d_arena_allocator(arena);
+    DArray* array = d_array_new_with_allocator(false, sizeof(usize), 0, &allocator);
+    DString* dstring = d_string_new_with_allocator(&allocator);
+    for (usize i = 0; i < 1000; ++i)
+    {
+        d_array_push_back(array, i);
+        d_string_push_char(dstring, 'a' + i % 26);
+    }
+    bool valid = true;
+    for (usize i = 0; i < 1000; ++i)
+        valid = valid && d_array_get_val_by_index(array, usize, i) == i && dstring -> string[i] == (char)('a' + i % 26);
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //everything lives in the arena, only its chunks were allocated with malloc
+    valid = arena -> used >= sizeof(usize) * 1000 + 1000 && arena -> capacity == D_ARENA_DEFAULT_CHUNK_SIZE;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_array_destroy(&array);
+    d_string_destroy(&dstring);
+    d_arena_destroy(&arena);
+}
+
+void    test_d_pool_alloc(void)
+{
+    DPool* pool = d_pool_new(20, false);
+    usize expected_size = 24;
+    assert_eq_custom(&pool -> object_size, &expected_size, sizeof(usize), itoa_usize);
+    //objects are distinct, aligned and keep their content across slabs
+    usize count = 10000;
+    u8** objects = malloc(sizeof(u8*) * count);
+    bool valid = true;
+    for (usize i = 0; i < count; ++i)
+    {
+        objects[i] = d_pool_alloc(pool);
+        valid = valid && objects[i] != NULL && (uintptr_t)objects[i] % 8 == 0;
+        if (valid)
+            memset(objects[i], (int)i, 20);
+    }
+    for (usize i = 0; i < count && valid; ++i)
+        for (usize j = 0; j < 20; ++j)
+            valid = valid && objects[i][j] == (u8)i;
+    bool expected = true;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    valid = pool -> live == count && pool -> capacity >= count;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //released objects are handed out again, most recently freed first
+    usize capacity = pool -> capacity;
+    d_pool_free(pool, objects[10]);
+    d_pool_free(pool, objects[20]);
+    valid = d_pool_alloc(pool) == objects[20] && d_pool_alloc(pool) == objects[10];
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    for (usize i = 0; i < count; ++i)
+        d_pool_free(pool, objects[i]);
+    d_pool_free(pool, NULL);
+    usize zero = 0;
+    assert_eq_custom(&pool -> live, &zero, sizeof(usize), itoa_usize);
+    for (usize i = 0; i < count; ++i)
+        objects[i] = d_pool_alloc(pool);
+    assert_eq_custom(&pool -> capacity, &capacity, sizeof(usize), itoa_usize);
+    free(objects);
+    d_pool_destroy(&pool);
+    assert_eq_null(pool);
+    //objects whose size is a multiple of 16 are 16 bytes aligned, large objects get larger slabs
+    pool = d_pool_new(48, false);
+    valid = true;
+    for (usize i = 0; i < 100; ++i)
+        valid = valid && (uintptr_t)d_pool_alloc(pool) % 16 == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_pool_destroy(&pool);
+    pool = d_pool_new(100000, false);
+    u8* big = d_pool_alloc(pool);
+    valid = big != NULL && pool -> capacity >= 16;
+    memset(big, 1, 100000);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_pool_destroy(&pool);
+    assert_eq_null(d_pool_new(MAX_SIZE_T_VALUE / 2, false));
+}
+
+void    test_d_pool_reset(void)
+{
+    DPool* pool = d_pool_new(sizeof(usize) * 2, false);
+    void* first = d_pool_alloc(pool);
+    for (usize i = 0; i < 20000; ++i)
+        d_pool_alloc(pool);
+    usize capacity = pool -> capacity;
+    d_pool_reset(pool);
+    usize zero = 0;
+    assert_eq_custom(&pool -> live, &zero, sizeof(usize), itoa_usize);
+    bool expected = true;
+    bool valid = d_pool_alloc(pool) == first;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    for (usize i = 0; i < 20000; ++i)
+        d_pool_alloc(pool);
+    assert_eq_custom(&pool -> capacity, &capacity, sizeof(usize), itoa_usize);
+    d_pool_destroy(&pool);
+}
+
+void    test_d_pool_cache(void)
+{
+    DPool* pool = d_pool_new(32, false);
+    DPoolCache cache;
+    d_pool_cache_init(&cache, pool);
+    void* objects[200];
+    for (usize i = 0; i < 200; ++i)
+        objects[i] = d_pool_cache_alloc(&cache);
+    //the cache takes whole batches from the pool
+    bool expected = true;
+    bool valid = pool -> live % D_POOL_CACHE_BATCH == 0 && pool -> live >= 200;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    for (usize i = 0; i < 200; ++i)
+        d_pool_cache_free(&cache, objects[i]);
+    //and never keeps more than two batches
+    valid = pool -> live < 2 * D_POOL_CACHE_BATCH;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_pool_cache_flush(&cache);
+    usize zero = 0;
+    assert_eq_custom(&pool -> live, &zero, sizeof(usize), itoa_usize);
+    d_pool_destroy(&pool);
+}
+
+#define POOL_THREADS 4
+#define POOL_THREAD_ROUNDS 20000
+
+void*   pool_worker(void* arg)
+{
+    DPool* pool = arg;
+    DPoolCache cache;
+    d_pool_cache_init(&cache, pool);
+    usize* held[64] = {0};
+    usize errors = 0;
+    for (usize round = 0; round < POOL_THREAD_ROUNDS; ++round)
+    {
+        usize slot = (round * 7) % 64;
+        if (held[slot] != NULL)
+        {
+            errors += *held[slot] != (usize)held[slot];
+            //alternate between the cache and the locked pool
+            if (round % 2)
+                d_pool_cache_free(&cache, held[slot]);
+            else
+                d_pool_free(pool, held[slot]);
+        }
+        held[slot] = round % 3 ? d_pool_cache_alloc(&cache) : d_pool_alloc(pool);
+        *held[slot] = (usize)held[slot];
+    }
+    for (usize slot = 0; slot < 64; ++slot)
+        d_pool_cache_free(&cache, held[slot]);
+    d_pool_cache_flush(&cache);
+    return (void*)errors;
+}
+
+void    test_d_pool_thread_safe(void)
+{
+    DPool* pool = d_pool_new(sizeof(usize), true);
+    pthread_t threads[POOL_THREADS];
+    for (usize i = 0; i < POOL_THREADS; ++i)
+        pthread_create(&threads[i], NULL, pool_worker, pool);
+    usize errors = 0;
+    for (usize i = 0; i < POOL_THREADS; ++i)
+    {
+        void* result;
+        pthread_join(threads[i], &result);
+        errors += (usize)result;
+    }
+    usize zero = 0;
+    assert_eq_custom(&errors, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&pool -> live, &zero, sizeof(usize), itoa_usize);
+    d_pool_destroy(&pool);
+}
+
+void    test_d_pool_set(void)
+{
+    DPoolSet* set = d_pool_set_new(false);
+    bool expected = true;
+    bool valid = true;
+    //every size up to the largest class, and above it
+    usize sizes[] = {0, 1, 16, 17, 100, 256, 257, 320, 321, 1000, 2049, 4096, 4097, 100000};
+    void* blocks[sizeof(sizes) / sizeof(*sizes)];
+    for (usize i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+    {
+        blocks[i] = d_pool_set_alloc(set, sizes[i]);
+        valid = valid && blocks[i] != NULL && (uintptr_t)blocks[i] % 16 == 0;
+        if (valid)
+            memset(blocks[i], 0xAB, sizes[i]);
+    }
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //a block stays in place while it keeps its class
+    valid = d_pool_set_realloc(set, blocks[4], 100, 112) == blocks[4];
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    char* moved = d_pool_set_realloc(set, blocks[4], 112, 3000);
+    valid = moved != blocks[4] && (u8)moved[99] == 0xAB;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    blocks[4] = moved;
+    sizes[4] = 3000;
+    for (usize i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+        d_pool_set_free(set, blocks[i], sizes[i]);
+    //a freed block is reused by the next allocation of its class
+    void* block = d_pool_set_alloc(set, 20);
+    d_pool_set_free(set, block, 20);
+    valid = d_pool_set_alloc(set, 32) == block;
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    //containers can be backed by the set
+    DAllocator allocator = d_pool_set_allocator(set);
+    DArray* array = d_array_new_with_allocator(false, sizeof(usize), 0, &allocator);
+    DString* dstring = d_string_new_with_allocator(&allocator);
+    for (usize i = 0; i < 5000; ++i)
+    {
+        d_array_push_back(array, i);
+        d_string_push_char(dstring, 'a' + i % 26);
+    }
+    valid = d_array_get_val_by_index(array, usize, 4999) == 4999 && dstring -> string[4999] == (char)('a' + 4999 % 26);
+    assert_eq_custom(&valid, &expected, sizeof(bool), itoa_bool);
+    d_array_destroy(&array);
+    d_string_destroy(&dstring);
+    d_pool_set_destroy(&set);
+    assert_eq_null(set);
+}
+
+int main()
+{
+    TEST("test_d_arena_alloc", test_d_arena_alloc(););
+    TEST("test_d_arena_alloc_aligned", test_d_arena_alloc_aligned(););
+    TEST("test_d_arena_calloc", test_d_arena_calloc(););
+    TEST("test_d_arena_realloc", test_d_arena_realloc(););
+    TEST("test_d_arena_strdup", test_d_arena_strdup(););
+    TEST("test_d_arena_mark_rewind", test_d_arena_mark_rewind(););
+    TEST("test_d_arena_reset", test_d_arena_reset(););
+    TEST("test_d_arena_allocator", test_d_arena_allocator(););
+    TEST("test_d_pool_alloc", test_d_pool_alloc(););
+    TEST("test_d_pool_reset", test_d_pool_reset(););
+    TEST("test_d_pool_cache", test_d_pool_cache(););
+    TEST("test_d_pool_thread_safe", test_d_pool_thread_safe(););
+    TEST("test_d_pool_set", test_d_pool_set(););
+}
@@ -0,0 +1,343 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dstring.h"
+#include "dstring_view.h"
+#include "dstring_fmt.h"
+#include "general_lib.h"
+
+/*
+ * Allocation benchmark for the short string optimization of DString.
+ *
+ * The same workload is built twice by the Makefile: once with the default
+ * D_STRING_SSO_CAPACITY and once with D_STRING_SSO_CAPACITY=0 (every string
+ * owns a heap buffer, which is how DString behaved before the optimization).
+ * Every call to malloc/calloc/realloc/reallocarray/free is counted through the linker
+ * --wrap option. The split benchmarks compare the copying split with the
+ * DStringView one on a log line. The format benchmarks build the same line of "key=value"
+ * pairs by formatting each integer with d_itoa_i32 and pushing it, with d_string_append_fmt
+ * and with the type checked d_string_append.
+ */
+
+void*	__real_malloc(size_t size);
+void*	__real_calloc(size_t nmemb, size_t size);
+void*	__real_realloc(void* ptr, size_t size);
+void*	__real_reallocarray(void* ptr, size_t nmemb, size_t size);
+void	__real_free(void* ptr);
+
+static usize	g_malloc_count = 0;
+static usize	g_realloc_count = 0;
+static usize	g_free_count = 0;
+
+void*	__wrap_malloc(size_t size)
+{
+    ++g_malloc_count;
+    return __real_malloc(size);
+}
+
+void*	__wrap_calloc(size_t nmemb, size_t size)
+{
+    ++g_malloc_count;
+    return __real_calloc(nmemb, size);
+}
+
+void*	__wrap_realloc(void* ptr, size_t size)
+{
+    ++g_realloc_count;
+    return __real_realloc(ptr, size);
+}
+
+void*	__wrap_reallocarray(void* ptr, size_t nmemb, size_t size)
+{
+    if (ptr == NULL)
+        ++g_malloc_count;
+    else
+        ++g_realloc_count;
+    return __real_reallocarray(ptr, nmemb, size);
+}
+
+void	__wrap_free(void* ptr)
+{
+    if (ptr != NULL)
+        ++g_free_count;
+    __real_free(ptr);
+}
+
+#define ITERATIONS 200000
+
+static const char* g_words[] = {
+    "id", "name", "user", "content-type", "localhost", "GET", "200",
+    "application/json", "Accept-Encoding", "gzip", "keep-alive", "x",
+    "a-rather-long-identifier-that-does-not-fit-inline",
+};
+
+#define WORD_COUNT (sizeof(g_words) / sizeof(g_words[0]))
+
+static double	now_in_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void	reset_counters(void)
+{
+    g_malloc_count = 0;
+    g_realloc_count = 0;
+    g_free_count = 0;
+}
+
+static void	report(const char* name, double elapsed, usize ops)
+{
+    printf("  %-26s %10zu malloc %10zu realloc %10zu free %8.2f ns/op\n",
+        name, g_malloc_count, g_realloc_count, g_free_count, elapsed * 1e9 / ops);
+}
+
+static usize	bench_new_from_c_string(void)
+{
+    usize checksum = 0;
+    for (usize i = 0; i < ITERATIONS; i++)
+    {
+        DString* dstring = d_string_new_from_c_string(g_words[i % WORD_COUNT]);
+        checksum += d_string_get_char_at(dstring, 0);
+        d_string_destroy(&dstring);
+    }
+    return checksum;
+}
+
+static usize	bench_push_char(void)
+{
+    usize checksum = 0;
+    for (usize i = 0; i < ITERATIONS; i++)
+    {
+        DString* dstring = d_string_new();
+        const char* word = g_words[i % WORD_COUNT];
+        for (usize j = 0; word[j]; j++)
+            d_string_push_char(dstring, word[j]);
+        checksum += d_string_get_capacity(dstring);
+        d_string_destroy(&dstring);
+    }
+    return checksum;
+}
+
+static usize	bench_concat(void)
+{
+    usize checksum = 0;
+    for (usize i = 0; i < ITERATIONS; i++)
+    {
+        DString* dstring = d_string_new_from_c_string(g_words[i % WORD_COUNT]);
+        d_string_push_c_str(dstring, ": ");
+        d_string_push_c_str(dstring, g_words[(i + 1) % WORD_COUNT]);
+        checksum += d_string_get_char_at(dstring, 0);
+        d_string_destroy(&dstring);
+    }
+    return checksum;
+}
+
+static usize	bench_copy(void)
+{
+    usize checksum = 0;
+    DString* words[WORD_COUNT];
+    for (usize i = 0; i < WORD_COUNT; i++)
+        words[i] = d_string_new_from_c_string(g_words[i]);
+    for (usize i = 0; i < ITERATIONS; i++)
+    {
+        DString* copy = d_string_new_from_dstring(words[i % WORD_COUNT]);
+        checksum += d_string_compare(copy, words[i % WORD_COUNT]) == 0;
+        d_string_destroy(&copy);
+    }
+    for (usize i = 0; i < WORD_COUNT; i++)
+        d_string_destroy(&words[i]);
+    return checksum;
+}
+
+static const char* g_log_line =
+    "127.0.0.1 - - [10/Oct/2024:13:55:36 +0000] \"GET /api/v1/users?id=42 HTTP/1.1\" 200 2326 \"-\" \"curl/8.4.0\"";
+
+#define SPLIT_ITERATIONS (ITERATIONS / 10)
+
+static usize	bench_split_by_char(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new_from_c_string(g_log_line);
+    for (usize i = 0; i < SPLIT_ITERATIONS; i++)
+    {
+        DPointerArray* tokens = d_string_split_by_char(line, ' ');
+        checksum += tokens -> len;
+        d_pointer_array_destroy(&tokens);
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+static usize	bench_split_by_char_view(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new_from_c_string(g_log_line);
+    for (usize i = 0; i < SPLIT_ITERATIONS; i++)
+    {
+        DArray* tokens = d_string_split_by_char_view(line, ' ');
+        checksum += tokens -> len;
+        d_array_destroy(&tokens);
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+static usize	bench_next_token_by_char(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new_from_c_string(g_log_line);
+    for (usize i = 0; i < SPLIT_ITERATIONS; i++)
+    {
+        DStringView rest = d_string_view_from_dstring(line);
+        DStringView token;
+        while (d_string_view_next_token_by_char(&rest, ' ', &token))
+            checksum += token.len;
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+static usize	bench_tokenize_copy(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new_from_c_string(g_log_line);
+    for (usize i = 0; i < SPLIT_ITERATIONS; i++)
+    {
+        DStringTokens* tokens = d_string_tokenize_by_char(line, ' ', true);
+        checksum += tokens -> len;
+        d_string_tokens_destroy(&tokens);
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+static usize	bench_tokenize_view(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new_from_c_string(g_log_line);
+    for (usize i = 0; i < SPLIT_ITERATIONS; i++)
+    {
+        DStringTokens* tokens = d_string_tokenize_by_char(line, ' ', false);
+        checksum += tokens -> len;
+        d_string_tokens_destroy(&tokens);
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+#define FMT_FIELDS 8
+
+//Output line of FMT_FIELDS "key=value " pairs, reused from one iteration to the next like a log buffer: a push
+//per piece and an allocated string per value, one format for the whole line, or two pairs per checked append
+static usize	bench_fmt_itoa_push(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new();
+    for (usize i = 0; i < ITERATIONS; i++)
+    {
+        d_string_replace_from_str(line, "");
+        for (usize j = 0; j < FMT_FIELDS; j++)
+        {
+            d_string_push_c_str(line, g_words[j]);
+            d_string_push_char(line, '=');
+            char* value = d_itoa_i32((int32)(i * j));
+            d_string_push_c_str(line, value);
+            free(value);
+            d_string_push_char(line, ' ');
+        }
+        checksum += line -> len;
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+static usize	bench_fmt_append_fmt(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new();
+    for (usize i = 0; i < ITERATIONS; i++)
+    {
+        int32 v = (int32)i;
+        d_string_replace_from_str(line, "");
+        d_string_append_fmt(line, "%s=%d %s=%d %s=%d %s=%d %s=%d %s=%d %s=%d %s=%d ", g_words[0], 0, g_words[1], v,
+            g_words[2], v * 2, g_words[3], v * 3, g_words[4], v * 4, g_words[5], v * 5, g_words[6], v * 6,
+            g_words[7], v * 7);
+        checksum += line -> len;
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+static usize	bench_fmt_append(void)
+{
+    usize checksum = 0;
+    DString* line = d_string_new();
+    for (usize i = 0; i < ITERATIONS; i++)
+    {
+        d_string_replace_from_str(line, "");
+        for (usize j = 0; j < FMT_FIELDS; j += 2)
+            d_string_append(line, g_words[j], "=", (int32)(i * j), " ", g_words[j + 1], "=", (int32)(i * (j + 1)), " ");
+        checksum += line -> len;
+    }
+    d_string_destroy(&line);
+    return checksum;
+}
+
+#define BODY_SIZE (4 << 20)
+
+//4 MiB body made of the log line repeated, built once before the body benchmarks
+static DString*	g_body = NULL;
+
+static usize	bench_split_body(void)
+{
+    DPointerArray* tokens = d_string_split_by_char(g_body, ' ');
+    usize checksum = tokens -> len;
+    d_pointer_array_destroy(&tokens);
+    return checksum;
+}
+
+static usize	bench_tokenize_body(void)
+{
+    DStringTokens* tokens = d_string_tokenize_by_char(g_body, ' ', true);
+    usize checksum = tokens -> len;
+    d_string_tokens_destroy(&tokens);
+    return checksum;
+}
+
+#define RUN_BENCH(fn, ops) \
+    do { \
+        reset_counters(); \
+        double start = now_in_seconds(); \
+        checksum += fn(); \
+        report(#fn, now_in_seconds() - start, ops); \
+    } while (0)
+
+int main(void)
+{
+    usize checksum = 0;
+    printf("DString benchmark, D_STRING_SSO_CAPACITY=%d, %d iterations\n",
+        D_STRING_SSO_CAPACITY, ITERATIONS);
+    RUN_BENCH(bench_new_from_c_string, ITERATIONS);
+    RUN_BENCH(bench_push_char, ITERATIONS);
+    RUN_BENCH(bench_concat, ITERATIONS);
+    RUN_BENCH(bench_copy, ITERATIONS);
+    RUN_BENCH(bench_split_by_char, SPLIT_ITERATIONS);
+    RUN_BENCH(bench_split_by_char_view, SPLIT_ITERATIONS);
+    RUN_BENCH(bench_next_token_by_char, SPLIT_ITERATIONS);
+    RUN_BENCH(bench_tokenize_copy, SPLIT_ITERATIONS);
+    RUN_BENCH(bench_tokenize_view, SPLIT_ITERATIONS);
+    RUN_BENCH(bench_fmt_itoa_push, ITERATIONS);
+    RUN_BENCH(bench_fmt_append_fmt, ITERATIONS);
+    RUN_BENCH(bench_fmt_append, ITERATIONS);
+    g_body = d_string_new_with_reserve(BODY_SIZE);
+    while (g_body -> len < BODY_SIZE)
+        d_string_push_c_str(g_body, g_log_line);
+    RUN_BENCH(bench_split_body, 1);
+    RUN_BENCH(bench_tokenize_body, 1);
+    d_string_destroy(&g_body);
+    printf("  checksum %zu\n", checksum);
+    return 0;
+}
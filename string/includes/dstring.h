@@ -3,6 +3,7 @@
 
 #include <dtypes.h>
 #include <darray.h>
+#include <dstring_search.h>
 typedef struct _DString DString;
 
 
@@ -25,6 +26,18 @@ struct _DString {
 
 typedef usize(*match)(char c);
 
+/**
+ * @brief Number of chars a dynamic string can hold without any heap buffer.
+ *
+ * Strings up to this length are stored inline, inside the same allocation as their
+ * header, so creating them costs a single allocation. The `string` field then points
+ * into the header and is moved to a heap buffer only when the content outgrows it.
+ * It can be overridden at compile time, 0 disables the short string optimization.
+ */
+#ifndef D_STRING_SSO_CAPACITY
+# define D_STRING_SSO_CAPACITY 23
+#endif
+
 
 
 /**
@@ -40,6 +53,20 @@ typedef usize(*match)(char c);
  */
 DString* d_string_new(void);
 
+/**
+ * @brief Creates a new, empty dynamic string whose header and buffer are allocated with `allocator`.
+ *
+ * Every allocation, reallocation and deallocation of the string goes through `allocator` instead of libc.
+ * The string only keeps a pointer to `allocator`, so it must outlive the string. Strings created from this one
+ * by the other constructors (`d_string_new_from_dstring`, the `_new` trims...) use libc.
+ *
+ * @param allocator The allocator of the string, NULL for libc.
+ *
+ * @return DString* A pointer to the newly created _DString structure. Returns
+ *         NULL if memory allocation fails.
+ */
+DString*	d_string_new_with_allocator(const DAllocator* allocator);
+
 /**
  * @brief Creates a new dynamic string from a given C string.
  *
@@ -56,6 +83,26 @@ DString* d_string_new(void);
  */
 DString* 	d_string_new_from_c_string(const char* str);
 
+/**
+ * @brief Same as `d_string_new_from_c_string` with the header and buffer allocated with `allocator`.
+ *
+ * @param str A pointer to the null-terminated C string to copy. If NULL, the string is empty.
+ * @param allocator The allocator of the string, NULL for libc. It must outlive the string.
+ *
+ * @return DString* A pointer to the newly created _DString structure. Returns
+ *         NULL if memory allocation fails.
+ */
+DString*	d_string_new_from_c_string_with_allocator(const char* str, const DAllocator* allocator);
+
+/**
+ * @brief Retrieves the allocator a dynamic string was created with.
+ *
+ * @param dstring A pointer to the _DString structure. The behavior is undefined if `dstring` is `NULL`.
+ *
+ * @return const DAllocator* The allocator of the string, NULL when it uses libc.
+ */
+const DAllocator*	d_string_get_allocator(DString* dstring);
+
 /**
  * @brief Creates a new dynamic string by copying an existing dynamic string.
  *
@@ -178,6 +225,7 @@ DString*	d_string_sub_string_in_place(DString* dstring, usize pos, usize len);
  * Returns the amount of memory allocated for the internal character array of
  * the specified _DString. The capacity indicates how many characters the
  * dynamic string can hold before needing to allocate additional memory.
+ * A string stored inline has a capacity of `D_STRING_SSO_CAPACITY`.
  *
  * @param dstring A pointer to the _DString structure whose capacity is to be
  *                retrieved. Must not be NULL. . The behavior is undefined if `dstring` is `NULL`.
@@ -212,8 +260,9 @@ DString* 	d_string_resize(DString* dstring, usize len);
  *
  * Adjusts the capacity of the given _DString to the specified new capacity. If the new capacity
  * is greater than the current capacity, additional memory will be allocated. If the new capacity
- * is less than the current length, the internal string may be truncated to fit within the new
- * capacity, but the length will be preserved. If `dstring` is `NULL`, the behavior is undefined.
+ * is less than the current length, the capacity is set to the length so no character is lost.
+ * A capacity that fits in `D_STRING_SSO_CAPACITY` moves the string back to its inline buffer.
+ * If `dstring` is `NULL`, the behavior is undefined.
  *
  * @param dstring A pointer to the _DString structure whose capacity is to be modified. 
  *                The behavior is undefined if `dstring` is `NULL`.
@@ -697,6 +746,31 @@ usize		d_string_find_last_matching_str_from_index(DString* dstring, const char *
  */
 usize		d_string_find_last_matching_str_from_end(DString* dstring, const char *str);
 
+/**
+ * @brief Same as `d_string_find_first_matching_str_from_index` with a precompiled needle.
+ *
+ * Searching many strings for the same pattern this way skips the `strlen` of the needle and, for long needles,
+ * the construction of the skip table on every call. See `d_needle_new`.
+ *
+ * @param dstring A pointer to the `_DString` structure in which to search. The behavior is undefined if `dstring` is `NULL`.
+ * @param needle The precompiled needle to find. The behavior is undefined if `needle` is `NULL`.
+ * @param pos The starting index from which to begin the search.
+ *
+ * @return usize The index of the first occurrence of `needle` at or after `pos`, `MAX_SIZE_T` if it is not found or if `pos` is out of range.
+ */
+usize		d_string_find_first_matching_needle_from_index(DString* dstring, const DNeedle* needle, usize pos);
+
+/**
+ * @brief Same as `d_string_find_last_matching_str_from_index` with a precompiled needle.
+ *
+ * @param dstring A pointer to the `_DString` structure in which to search. The behavior is undefined if `dstring` is `NULL`.
+ * @param needle The precompiled needle to find. The behavior is undefined if `needle` is `NULL`.
+ * @param pos The last index at which an occurrence may start, clamped to the last char of `dstring`.
+ *
+ * @return usize The index of the last occurrence of `needle` starting at or before `pos`, `MAX_SIZE_T` if it is not found.
+ */
+usize		d_string_find_last_matching_needle_from_index(DString* dstring, const DNeedle* needle, usize pos);
+
 
 
 /**
@@ -0,0 +1,172 @@
+#ifndef __D_STRING_FMT__H__
+#define __D_STRING_FMT__H__
+
+#include <stdarg.h>
+#include <dtypes.h>
+#include <dstring.h>
+#include <dstring_view.h>
+typedef struct _DFmtArg DFmtArg;
+
+/**
+ * @brief The kind of value a `_DFmtArg` holds, which decides how it is formatted.
+ */
+typedef enum {
+	D_FMT_ARG_STR,		/* null-terminated C string, NULL is written "(null)" */
+	D_FMT_ARG_DSTRING,	/* content of a dynamic string */
+	D_FMT_ARG_VIEW,		/* chars of a view */
+	D_FMT_ARG_CHAR,		/* a single char */
+	D_FMT_ARG_BOOL,		/* "true" or "false" */
+	D_FMT_ARG_I64,		/* any signed integer, in decimal */
+	D_FMT_ARG_U64,		/* any unsigned integer, in decimal */
+	D_FMT_ARG_DOUBLE,	/* shortest digits that read back to the same double, see `d_dtoa` */
+	D_FMT_ARG_FLOAT		/* shortest digits that read back to the same float, see `d_ftoa` */
+} DFmtArgType;
+
+/**
+ * @brief A value to append with `d_string_append`, tagged with its type.
+ *
+ * Built by `D_FMT_ARG` from the static type of an expression, so that the values given to `d_string_append`
+ * are checked by the compiler and nothing has to be parsed at runtime.
+ *
+ * @struct _DFmtArg
+ * @param type How `value` is formatted.
+ * @param value The value, the member matching `type` is set.
+ */
+struct _DFmtArg {
+	DFmtArgType	type;
+	union {
+		const char*		str;
+		const DString*	dstring;
+		DStringView		view;
+		char			c;
+		bool			b;
+		int64			i;
+		u64				u;
+		double			d;
+		float			f;
+	}			value;
+};
+
+/**
+ * @brief Appends formatted text to a dynamic string, in its spare capacity.
+ *
+ * The text is written straight into the buffer of `dstring`: no temporary string is allocated, and the string
+ * grows at most once per call. A first pass writes what fits in the spare capacity and counts the rest, when it
+ * does not all fit the string is grown geometrically as any append, to at least the total length, and the
+ * arguments are formatted again. On failure `dstring` is left as it was.
+ *
+ * A conversion is `%[flags][width][.precision][length]conversion`:
+ * - flags: `-` pads on the right instead of the left, `0` pads numbers with zeros after their sign.
+ * - width: a minimum number of chars, a number or `*` to take it from an `int` argument.
+ * - precision: for `s`, `S` and `V` only, a maximum number of chars, a number or `*` for an `int` argument.
+ * - length: `l`, `ll` and `z` for `long`, `long long` and `usize` (`ssize_t` when signed) integers. `h` with `g`
+ *   formats the double argument as a float, which prints `0.1f` as "0.1" instead of its exact double digits.
+ * - conversions: `d` and `i` signed integers, `u` unsigned ones, `x` and `X` unsigned ones in hexadecimal, `c` a
+ *   char, `s` a C string, `S` a `DString*`, `V` a `DStringView` passed by value, `g` a double in its shortest
+ *   round-trip form (`d_dtoa`), and `%%` a '%'.
+ * Integers are written by the `_no_alloc` path of the `d_itoa` family. Since `S` and `V` are not printf
+ * conversions, the format is not checked by the compiler: use `d_string_append` for checked calls.
+ * C strings and views given as arguments must not point into `dstring` itself, a `DString*` may be `dstring`.
+ *
+ * @param dstring A pointer to the `_DString` structure to append to. The behavior is undefined if `dstring` is `NULL`.
+ * @param fmt The null-terminated format.
+ *
+ * @return DString* `dstring`, or `NULL` if memory allocation fails or if `fmt` holds an unknown conversion.
+ */
+DString*	d_string_append_fmt(DString* dstring, const char* fmt, ...);
+
+/**
+ * @brief Same as `d_string_append_fmt` with the arguments in a `va_list`, which is left unused by the call.
+ */
+DString*	d_string_append_vfmt(DString* dstring, const char* fmt, va_list args);
+
+/**
+ * @brief Appends the text of `count` tagged values to a dynamic string, one after the other.
+ *
+ * Same rules as `d_string_append_fmt` (spare capacity first, at most one growth, `dstring` untouched on failure)
+ * without any format: each value is written in its default form. Usually called through `d_string_append`.
+ *
+ * @param dstring A pointer to the `_DString` structure to append to. The behavior is undefined if `dstring` is `NULL`.
+ * @param args The values.
+ * @param count The number of values.
+ *
+ * @return DString* `dstring`, or `NULL` if memory allocation fails.
+ */
+DString*	d_string_append_args(DString* dstring, const DFmtArg* args, usize count);
+
+static inline DFmtArg	d_fmt_arg_str(const char* str) { return (DFmtArg){ .type = D_FMT_ARG_STR, .value.str = str }; }
+static inline DFmtArg	d_fmt_arg_dstring(const DString* dstring) { return (DFmtArg){ .type = D_FMT_ARG_DSTRING, .value.dstring = dstring }; }
+static inline DFmtArg	d_fmt_arg_view(DStringView view) { return (DFmtArg){ .type = D_FMT_ARG_VIEW, .value.view = view }; }
+static inline DFmtArg	d_fmt_arg_char(char c) { return (DFmtArg){ .type = D_FMT_ARG_CHAR, .value.c = c }; }
+static inline DFmtArg	d_fmt_arg_bool(bool b) { return (DFmtArg){ .type = D_FMT_ARG_BOOL, .value.b = b }; }
+static inline DFmtArg	d_fmt_arg_i64(int64 i) { return (DFmtArg){ .type = D_FMT_ARG_I64, .value.i = i }; }
+static inline DFmtArg	d_fmt_arg_u64(u64 u) { return (DFmtArg){ .type = D_FMT_ARG_U64, .value.u = u }; }
+static inline DFmtArg	d_fmt_arg_double(double d) { return (DFmtArg){ .type = D_FMT_ARG_DOUBLE, .value.d = d }; }
+static inline DFmtArg	d_fmt_arg_float(float f) { return (DFmtArg){ .type = D_FMT_ARG_FLOAT, .value.f = f }; }
+
+/**
+ * @brief Tags a value with the way its static type is formatted.
+ *
+ * Any C string, `DString*`, `DStringView`, `char`, `bool`, integer or floating point type is accepted, any other
+ * type is a compile error. `signed char` and `unsigned char` (`int8`, `u8`) are numbers, `char` is a char: a char
+ * constant such as 'a' has the type `int` in C and is written as a number unless it is cast to `char`, the same goes
+ * for `true`, `false` and comparisons, which are `int` and not `bool`.
+ */
+#define D_FMT_ARG(x) _Generic((x),				\
+	char*: d_fmt_arg_str,						\
+	const char*: d_fmt_arg_str,					\
+	DString*: d_fmt_arg_dstring,				\
+	const DString*: d_fmt_arg_dstring,			\
+	DStringView: d_fmt_arg_view,				\
+	char: d_fmt_arg_char,						\
+	bool: d_fmt_arg_bool,						\
+	signed char: d_fmt_arg_i64,					\
+	short: d_fmt_arg_i64,						\
+	int: d_fmt_arg_i64,							\
+	long: d_fmt_arg_i64,						\
+	long long: d_fmt_arg_i64,					\
+	unsigned char: d_fmt_arg_u64,				\
+	unsigned short: d_fmt_arg_u64,				\
+	unsigned int: d_fmt_arg_u64,				\
+	unsigned long: d_fmt_arg_u64,				\
+	unsigned long long: d_fmt_arg_u64,			\
+	float: d_fmt_arg_float,						\
+	double: d_fmt_arg_double)(x)
+
+//Applies `m` to each of 1 to 16 arguments, separated by commas
+#define D_FMT_MAP_1(m, x) m(x)
+#define D_FMT_MAP_2(m, x, ...) m(x), D_FMT_MAP_1(m, __VA_ARGS__)
+#define D_FMT_MAP_3(m, x, ...) m(x), D_FMT_MAP_2(m, __VA_ARGS__)
+#define D_FMT_MAP_4(m, x, ...) m(x), D_FMT_MAP_3(m, __VA_ARGS__)
+#define D_FMT_MAP_5(m, x, ...) m(x), D_FMT_MAP_4(m, __VA_ARGS__)
+#define D_FMT_MAP_6(m, x, ...) m(x), D_FMT_MAP_5(m, __VA_ARGS__)
+#define D_FMT_MAP_7(m, x, ...) m(x), D_FMT_MAP_6(m, __VA_ARGS__)
+#define D_FMT_MAP_8(m, x, ...) m(x), D_FMT_MAP_7(m, __VA_ARGS__)
+#define D_FMT_MAP_9(m, x, ...) m(x), D_FMT_MAP_8(m, __VA_ARGS__)
+#define D_FMT_MAP_10(m, x, ...) m(x), D_FMT_MAP_9(m, __VA_ARGS__)
+#define D_FMT_MAP_11(m, x, ...) m(x), D_FMT_MAP_10(m, __VA_ARGS__)
+#define D_FMT_MAP_12(m, x, ...) m(x), D_FMT_MAP_11(m, __VA_ARGS__)
+#define D_FMT_MAP_13(m, x, ...) m(x), D_FMT_MAP_12(m, __VA_ARGS__)
+#define D_FMT_MAP_14(m, x, ...) m(x), D_FMT_MAP_13(m, __VA_ARGS__)
+#define D_FMT_MAP_15(m, x, ...) m(x), D_FMT_MAP_14(m, __VA_ARGS__)
+#define D_FMT_MAP_16(m, x, ...) m(x), D_FMT_MAP_15(m, __VA_ARGS__)
+#define D_FMT_COUNT(...) D_FMT_COUNT_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define D_FMT_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, n, ...) n
+#define D_FMT_CONCAT(a, b) D_FMT_CONCAT_(a, b)
+#define D_FMT_CONCAT_(a, b) a##b
+
+/**
+ * @brief Appends the text of 1 to 16 values to a dynamic string, each in the default form of its type.
+ *
+ * `d_string_append(line, "user ", id, " took ", seconds, "s\n")` writes the same text as
+ * `d_string_append_fmt(line, "user %d took %gs\n", id, seconds)` when `id` is an `int` and `seconds` a `double`,
+ * but the type of every value is checked at compile time (see `D_FMT_ARG`) and no format is parsed at runtime.
+ *
+ * @return DString* `dstring`, or `NULL` if memory allocation fails.
+ */
+#define d_string_append(dstring, ...)																\
+	d_string_append_args((dstring),																	\
+		(const DFmtArg[]){ D_FMT_CONCAT(D_FMT_MAP_, D_FMT_COUNT(__VA_ARGS__))(D_FMT_ARG, __VA_ARGS__) },	\
+		D_FMT_COUNT(__VA_ARGS__))
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef __D_STRING_SEARCH__H__
+#define __D_STRING_SEARCH__H__
+
+#include <dtypes.h>
+#include <darray.h>
+typedef struct _DByteSet DByteSet;
+typedef struct _DNeedle DNeedle;
+typedef enum _DSearchIsa DSearchIsa;
+
+/**
+ * @brief Longest needle searched with the SIMD first and last byte filter, longer ones use Boyer-Moore-Horspool.
+ */
+#define D_NEEDLE_SHORT_MAX_LEN 32
+
+/**
+ * @brief Instruction sets the search kernels can run with.
+ *
+ * The best one supported by the running CPU is picked the first time a search function is called.
+ * On non x86 targets only `D_SEARCH_ISA_SCALAR` exists.
+ */
+enum _DSearchIsa {
+	D_SEARCH_ISA_SCALAR = 0,
+	D_SEARCH_ISA_SSE2,
+	D_SEARCH_ISA_SSSE3,	/* SSE2 kernels, with byte shuffles for the byte set searches */
+	D_SEARCH_ISA_AVX2,
+};
+
+/**
+ * @brief A set of bytes, stored as a precomputed 256-bit lookup table.
+ *
+ * The table is laid out as two rows of 16 bytes indexed by the low nibble of a byte, bit `hi & 7` of
+ * `table[(hi >> 3) * 16 + lo]` being set when the byte whose high nibble is `hi` and low nibble is `lo`
+ * belongs to the set. That layout lets the SIMD kernels test 16 or 32 bytes at once with byte shuffles,
+ * while a scalar lookup stays a single load, see `d_byte_set_contains`.
+ *
+ * @struct _DByteSet
+ * @param table The 256-bit lookup table.
+ */
+struct _DByteSet {
+	u8	table[32];
+};
+
+/**
+ * @brief Tells whether the byte `c` belongs to `set`.
+ */
+#define d_byte_set_contains(set, c) \
+	((((set) -> table[(((u8)(c) >> 7) << 4) | ((u8)(c) & 0x0F)]) >> (((u8)(c) >> 4) & 7)) & 1)
+
+/**
+ * @brief Builds the set of the chars of a null-terminated C string.
+ *
+ * The null terminator is never part of the set, so the set matches exactly the chars `memchr(str, c, strlen(str))` finds.
+ *
+ * @param set The set to initialize. The behavior is undefined if `set` is `NULL`.
+ * @param str The null-terminated C string holding the chars of the set. The behavior is undefined if `str` is `NULL`.
+ */
+void		d_byte_set_init(DByteSet* set, const char* str);
+
+/**
+ * @brief Adds the byte `c` to `set`.
+ */
+void		d_byte_set_add(DByteSet* set, u8 c);
+
+/**
+ * @brief Returns the instruction set the search kernels currently run with.
+ */
+DSearchIsa	d_search_get_isa(void);
+
+/**
+ * @brief Forces the instruction set used by the search kernels.
+ *
+ * Mainly meant for tests and benchmarks. A request for an instruction set the CPU does not support
+ * is lowered to the best supported one.
+ *
+ * @param isa The requested instruction set.
+ *
+ * @return DSearchIsa The instruction set actually used from now on.
+ */
+DSearchIsa	d_search_set_isa(DSearchIsa isa);
+
+/**
+ * @brief Finds the first byte of `str[0..len)` equal to `c`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_first_byte(const char* str, usize len, char c);
+
+/**
+ * @brief Finds the last byte of `str[0..len)` equal to `c`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_last_byte(const char* str, usize len, char c);
+
+/**
+ * @brief Finds the first byte of `str[0..len)` different from `c`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_first_not_byte(const char* str, usize len, char c);
+
+/**
+ * @brief Finds the last byte of `str[0..len)` different from `c`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_last_not_byte(const char* str, usize len, char c);
+
+/**
+ * @brief Finds the first byte of `str[0..len)` that belongs to `set`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_first_in_set(const char* str, usize len, const DByteSet* set);
+
+/**
+ * @brief Finds the first byte of `str[0..len)` that does not belong to `set`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_first_not_in_set(const char* str, usize len, const DByteSet* set);
+
+/**
+ * @brief Finds the last byte of `str[0..len)` that belongs to `set`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_last_in_set(const char* str, usize len, const DByteSet* set);
+
+/**
+ * @brief Finds the last byte of `str[0..len)` that does not belong to `set`.
+ *
+ * @return usize The index of the byte, `MAX_SIZE_T_VALUE` if there is none.
+ */
+usize		d_search_last_not_in_set(const char* str, usize len, const DByteSet* set);
+
+/**
+ * @brief Finds the first occurrence of `needle[0..needle_len)` in `str[0..len)`.
+ *
+ * The strategy depends on the needle length: a single byte needle is a byte search, needles up to
+ * `D_NEEDLE_SHORT_MAX_LEN` bytes use a SIMD filter on their first and last bytes (only the positions where
+ * both match are compared), longer ones use Boyer-Moore-Horspool. For the long needles the setup cost is paid
+ * on every call, use a `DNeedle` when the same needle is searched many times.
+ *
+ * @return usize The index of the occurrence, `MAX_SIZE_T_VALUE` if there is none or if `needle_len` is 0.
+ */
+usize		d_search_first_str(const char* str, usize len, const char* needle, usize needle_len);
+
+/**
+ * @brief Finds the last occurrence of `needle[0..needle_len)` in `str[0..len)`, see `d_search_first_str`.
+ *
+ * @return usize The index of the occurrence, `MAX_SIZE_T_VALUE` if there is none or if `needle_len` is 0.
+ */
+usize		d_search_last_str(const char* str, usize len, const char* needle, usize needle_len);
+
+/**
+ * @brief Precompiles a needle so that it can be searched repeatedly without any setup cost.
+ *
+ * The needle chars are copied, `needle` does not need to outlive the returned `DNeedle`.
+ *
+ * @param needle The chars of the needle, they do not need to be null-terminated.
+ * @param len The number of chars of the needle.
+ *
+ * @return DNeedle* The precompiled needle, `NULL` if memory allocation fails or if `needle` is `NULL`.
+ */
+DNeedle*	d_needle_new(const char* needle, usize len);
+
+/**
+ * @brief Same as `d_needle_new` with a null-terminated C string.
+ */
+DNeedle*	d_needle_new_from_c_string(const char* needle);
+
+/**
+ * @brief Returns the length of a precompiled needle.
+ */
+usize		d_needle_get_len(const DNeedle* needle);
+
+/**
+ * @brief Finds the first occurrence of a precompiled needle in `str[0..len)`.
+ *
+ * @return usize The index of the occurrence, `MAX_SIZE_T_VALUE` if there is none or if the needle is empty.
+ */
+usize		d_needle_find_first(const DNeedle* needle, const char* str, usize len);
+
+/**
+ * @brief Finds the last occurrence of a precompiled needle in `str[0..len)`.
+ *
+ * @return usize The index of the occurrence, `MAX_SIZE_T_VALUE` if there is none or if the needle is empty.
+ */
+usize		d_needle_find_last(const DNeedle* needle, const char* str, usize len);
+
+/**
+ * @brief Frees a precompiled needle and sets its pointer to `NULL`.
+ */
+void		d_needle_destroy(DNeedle** needle);
+
+/**
+ * @brief Records the boundaries of every token of `str[0..len)` delimited by `c`.
+ *
+ * A token is a maximal run of bytes different from `c`, so runs of delimiters never produce empty tokens.
+ * For every token, its begin offset and its end offset (one past its last byte) are appended to `bounds`,
+ * in order. The input is classified 64 bytes at a time with the SIMD kernels and read only once.
+ *
+ * @param str The bytes to tokenize.
+ * @param len The number of bytes of `str`.
+ * @param c The delimiter.
+ * @param bounds A `DArray` of `usize` receiving the offsets. The behavior is undefined if it is `NULL`
+ *               or if its element size is not `sizeof(usize)`.
+ *
+ * @return usize The number of tokens found, `MAX_SIZE_T_VALUE` if `bounds` could not grow.
+ */
+usize		d_search_token_bounds_by_byte(const char* str, usize len, char c, DArray* bounds);
+
+/**
+ * @brief Same as `d_search_token_bounds_by_byte` but every byte of `set` is a delimiter.
+ */
+usize		d_search_token_bounds_in_set(const char* str, usize len, const DByteSet* set, DArray* bounds);
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef __D_STRING_VIEW__H__
+#define __D_STRING_VIEW__H__
+
+#include <dtypes.h>
+#include <darray.h>
+#include <dstring.h>
+typedef struct _DStringView DStringView;
+typedef struct _DStringTokens DStringTokens;
+
+/**
+ * @brief Represents a read-only, non-owning view over a sequence of chars.
+ *
+ * A _DStringView is a pointer plus a length: it never owns the chars it refers to, so creating, copying,
+ * trimming or splitting a view never allocates. The chars are NOT guaranteed to be null-terminated, always
+ * use `len`. A view is only valid as long as the buffer it points into is alive and not reallocated, a view
+ * taken on a `_DString` is invalidated by any function that may grow or shrink that `_DString`.
+ *
+ * A view whose `data` is `NULL` is the "null view", it is what view returning functions use where the
+ * `_DString` API would return `NULL`. An empty view (`len` == 0) with a non `NULL` `data` is a valid view.
+ *
+ * @struct _DStringView
+ * @param data Pointer to the first char of the view.
+ * @param len Number of chars in the view.
+ */
+struct _DStringView {
+	const char	*data;
+	usize		len;
+};
+
+/**
+ * @brief The result of a fused split, held in a single allocation.
+ *
+ * `tokens` points right after the structure, in the same block. When the tokens were copied, their chars also
+ * live in that block, each followed by a null byte so `tokens[i].data` can be used as a C string. Otherwise the
+ * tokens are views into the split string. Either way the whole result is released by `d_string_tokens_destroy`.
+ *
+ * @struct _DStringTokens
+ * @param len Number of tokens.
+ * @param tokens The tokens, in order.
+ */
+struct _DStringTokens {
+	usize		len;
+	DStringView	*tokens;
+};
+
+/**
+ * @brief The null view, returned by view functions on invalid input.
+ */
+#define D_STRING_VIEW_NULL ((DStringView){ .data = NULL, .len = 0 })
+
+/**
+ * @brief Tells whether `view` is the null view.
+ */
+#define d_string_view_is_null(view) ((view).data == NULL)
+
+/**
+ * @brief Creates a view over `len` chars starting at `data`.
+ *
+ * @param data Pointer to the first char of the view, the chars do not need to be null-terminated.
+ * @param len Number of chars in the view.
+ *
+ * @return DStringView The view, the null view if `data` is `NULL`.
+ */
+DStringView	d_string_view_from_buffer(const char* data, usize len);
+
+/**
+ * @brief Creates a view over a null-terminated C string.
+ *
+ * @param str The null-terminated C string to view.
+ *
+ * @return DStringView The view over `str` (without its null terminator), the null view if `str` is `NULL`.
+ */
+DStringView	d_string_view_from_c_string(const char* str);
+
+/**
+ * @brief Creates a view over the whole content of a dynamic string.
+ *
+ * The view is invalidated by any function that may reallocate the content of `dstring`.
+ *
+ * @param dstring A pointer to the `_DString` structure to view. The behavior is undefined if `dstring` is `NULL`.
+ *
+ * @return DStringView The view over the content of `dstring`.
+ */
+DStringView	d_string_view_from_dstring(const DString* dstring);
+
+/**
+ * @brief Copies the content of a view into a new dynamic string.
+ *
+ * @param view The view to copy.
+ *
+ * @return DString* A pointer to the newly created `_DString` structure, `NULL` if memory allocation fails.
+ *         The null view gives an empty `_DString`.
+ */
+DString*	d_string_new_from_view(DStringView view);
+
+/**
+ * @brief Copies the content of a view into a newly allocated null-terminated C string.
+ *
+ * @param view The view to copy.
+ *
+ * @return char* The newly allocated C string, `NULL` if memory allocation fails or if `view` is the null view.
+ */
+char*		d_string_view_to_c_string(DStringView view);
+
+/**
+ * @brief Compares two views lexicographically.
+ *
+ * Chars are compared as unsigned chars, if one view is a prefix of the other the shorter one compares lower.
+ *
+ * @param view1 The first view.
+ * @param view2 The second view.
+ *
+ * @return int32 A negative value if `view1` is lower than `view2`, zero if they are equal, a positive value otherwise.
+ */
+int32		d_string_view_compare(DStringView view1, DStringView view2);
+
+/**
+ * @brief Tells whether a view holds exactly the chars of a null-terminated C string.
+ *
+ * @param view The view to compare.
+ * @param str The null-terminated C string to compare against. The behavior is undefined if `str` is `NULL`.
+ *
+ * @return bool `true` if both hold the same chars, `false` otherwise.
+ */
+bool		d_string_view_equals_c_string(DStringView view, const char* str);
+
+/**
+ * @brief Narrows a view to a sub range, without copying.
+ *
+ * Follows the same rules as `d_string_substr`: if `pos` is greater than the length of `view` the null view is returned,
+ * and `len` is clamped so that the resulting view never goes past the end of `view`.
+ *
+ * @param view The view to narrow.
+ * @param pos The index of the first char of the sub view.
+ * @param len The maximum number of chars of the sub view.
+ *
+ * @return DStringView The sub view, or the null view if `pos` is out of bounds.
+ */
+DStringView	d_string_view_substr(DStringView view, usize pos, usize len);
+
+/**
+ * @brief Same as `d_string_substr` but returns a view into `dstring` instead of an allocated copy.
+ *
+ * @param dstring A pointer to the `_DString` structure. The behavior is undefined if `dstring` is `NULL`.
+ * @param pos The index of the first char of the view.
+ * @param len The maximum number of chars of the view.
+ *
+ * @return DStringView The view into `dstring`, or the null view if `pos` is out of bounds.
+ */
+DStringView	d_string_substr_view(DString* dstring, usize pos, usize len);
+
+/**
+ * @brief Finds the first occurrence of `c` in `view`, starting at index `pos`.
+ *
+ * @return usize The index of the occurrence relative to the start of `view`, `MAX_SIZE_T_VALUE` if not found or if `pos` is out of bounds.
+ */
+usize		d_string_view_find_first_matching_char_from_index(DStringView view, char c, usize pos);
+
+/**
+ * @brief Finds the last occurrence of `c` in `view`, searching backward from index `pos` (clamped to the last char).
+ *
+ * @return usize The index of the occurrence relative to the start of `view`, `MAX_SIZE_T_VALUE` if not found or if `view` is empty.
+ */
+usize		d_string_view_find_last_matching_char_from_index(DStringView view, char c, usize pos);
+
+/**
+ * @brief Finds the first char of `view`, starting at index `pos`, that is one of the chars of the null-terminated C string `str`.
+ *
+ * @return usize The index of the char relative to the start of `view`, `MAX_SIZE_T_VALUE` if not found or if `pos` is out of bounds.
+ */
+usize		d_string_view_find_first_char_in_str_from_index(DStringView view, const char* str, usize pos);
+
+/**
+ * @brief Finds the first occurrence of the chars of `needle` in `view`, starting at index `pos`.
+ *
+ * As for `d_string_find_first_matching_str_from_index`, an empty needle is never found.
+ *
+ * @return usize The index of the occurrence relative to the start of `view`, `MAX_SIZE_T_VALUE` if not found or if `pos` is out of bounds.
+ */
+usize		d_string_view_find_first_matching_str_from_index(DStringView view, DStringView needle, usize pos);
+
+/**
+ * @brief Removes every leading `c` from a view, without copying.
+ *
+ * @return DStringView The trimmed view, it is empty (but not null) if `view` only holds `c` chars.
+ */
+DStringView	d_string_view_trim_left_by_char(DStringView view, char c);
+
+/**
+ * @brief Removes every trailing `c` from a view, without copying.
+ *
+ * @return DStringView The trimmed view, it is empty (but not null) if `view` only holds `c` chars.
+ */
+DStringView	d_string_view_trim_right_by_char(DStringView view, char c);
+
+/**
+ * @brief Removes every leading char for which `fn` returns a non-zero value, without copying.
+ *
+ * @return DStringView The trimmed view. The behavior is undefined if `fn` is `NULL`.
+ */
+DStringView	d_string_view_trim_left_by_predicate(DStringView view, match fn);
+
+/**
+ * @brief Removes every trailing char for which `fn` returns a non-zero value, without copying.
+ *
+ * @return DStringView The trimmed view. The behavior is undefined if `fn` is `NULL`.
+ */
+DStringView	d_string_view_trim_right_by_predicate(DStringView view, match fn);
+
+/**
+ * @brief Same as `d_string_trim_left_by_char_new` but returns a view into `dstring`, nothing is allocated.
+ */
+DStringView	d_string_trim_left_by_char_view(DString* dstring, char c);
+
+/**
+ * @brief Same as `d_string_trim_right_by_char_new` but returns a view into `dstring`, nothing is allocated.
+ */
+DStringView	d_string_trim_right_by_char_view(DString* dstring, char c);
+
+/**
+ * @brief Same as `d_string_trim_left_by_predicate_new` but returns a view into `dstring`, nothing is allocated.
+ */
+DStringView	d_string_trim_left_by_predicate_view(DString* dstring, match fn);
+
+/**
+ * @brief Same as `d_string_trim_right_by_predicate_new` but returns a view into `dstring`, nothing is allocated.
+ */
+DStringView	d_string_trim_right_by_predicate_view(DString* dstring, match fn);
+
+/**
+ * @brief Extracts the next token delimited by `c` from `remaining`, without allocating anything.
+ *
+ * Skips the leading `c` chars of `remaining`, stores the following run of non `c` chars in `token` and advances
+ * `remaining` past it. Runs of delimiters never produce empty tokens, exactly as `d_string_split_by_char`.
+ * Typical usage:
+ *
+ * @code
+ * DStringView rest = d_string_view_from_dstring(line);
+ * DStringView token;
+ * while (d_string_view_next_token_by_char(&rest, ' ', &token))
+ *     handle(token);
+ * @endcode
+ *
+ * @param remaining The view still to be tokenized, updated by the call. The behavior is undefined if it is `NULL`.
+ * @param c The delimiter.
+ * @param token Where the token is stored. The behavior is undefined if it is `NULL`.
+ *
+ * @return bool `true` if a token was found, `false` once `remaining` holds no more token.
+ */
+bool		d_string_view_next_token_by_char(DStringView* remaining, char c, DStringView* token);
+
+/**
+ * @brief Same as `d_string_view_next_token_by_char` but any char of the null-terminated C string `str` is a delimiter.
+ */
+bool		d_string_view_next_token_by_char_of_str(DStringView* remaining, const char* str, DStringView* token);
+
+/**
+ * @brief Splits a view on `c` into a `DArray` of `DStringView`.
+ *
+ * Produces the same tokens as `d_string_split_by_char`, but the only allocations are the ones of the returned `DArray`,
+ * the tokens point into the chars of `view`.
+ *
+ * @param view The view to split.
+ * @param c The delimiter.
+ *
+ * @return DArray* A `DArray` whose elements are `DStringView` (use `d_array_get_val_by_index(array, DStringView, i)`),
+ *         `NULL` if memory allocation fails.
+ */
+DArray*		d_string_view_split_by_char(DStringView view, char c);
+
+/**
+ * @brief Same as `d_string_view_split_by_char` but any char of the null-terminated C string `str` is a delimiter.
+ */
+DArray*		d_string_view_split_by_char_of_str(DStringView view, const char* str);
+
+/**
+ * @brief Same as `d_string_split_by_char` but the tokens are `DStringView` into `dstring`, no token is copied.
+ *
+ * @return DArray* A `DArray` of `DStringView`, `NULL` if memory allocation fails. The views are invalidated
+ *         by any function that may reallocate the content of `dstring`.
+ */
+DArray*		d_string_split_by_char_view(DString* dstring, char c);
+
+/**
+ * @brief Same as `d_string_split_by_char_of_str` but the tokens are `DStringView` into `dstring`, no token is copied.
+ *
+ * @return DArray* A `DArray` of `DStringView`, `NULL` if memory allocation fails. The views are invalidated
+ *         by any function that may reallocate the content of `dstring`.
+ */
+DArray*		d_string_split_by_char_of_str_view(DString* dstring, const char* str);
+
+/**
+ * @brief Splits a dynamic string on `c` in a single pass with at most one allocation for the result.
+ *
+ * The token boundaries are first recorded by one linear SIMD scan (see `d_search_token_bounds_by_byte`), then
+ * the result is allocated once, sized for every token. Produces the same tokens as `d_string_split_by_char`.
+ *
+ * @param dstring A pointer to the `_DString` structure to split. The behavior is undefined if `dstring` is `NULL`.
+ * @param c The delimiter.
+ * @param copy If `true` the tokens are null-terminated copies stored in the result block, the result then stays
+ *             valid whatever happens to `dstring`. If `false` the tokens are views into `dstring`.
+ *
+ * @return DStringTokens* The tokens, to be released with `d_string_tokens_destroy`, `NULL` if memory allocation fails.
+ */
+DStringTokens*	d_string_tokenize_by_char(DString* dstring, char c, bool copy);
+
+/**
+ * @brief Same as `d_string_tokenize_by_char` but any char of the null-terminated C string `str` is a delimiter.
+ */
+DStringTokens*	d_string_tokenize_by_char_of_str(DString* dstring, const char* str, bool copy);
+
+/**
+ * @brief Releases the result of a `d_string_tokenize_*` function and sets its pointer to `NULL`.
+ */
+void			d_string_tokens_destroy(DStringTokens** tokens);
+
+#endif
@@ -1,51 +1,148 @@
 #include "dstring.h"
+#include "dstring_split.h"
+#include "dstring_growth.h"
 #include <string.h>
 #include <general_lib.h>
 #include <stdlib.h>
 
-#define CAPACITY 8
-
 typedef struct _DRealString DRealString;
 
 //Real String Interface
 struct _DRealString {
     char    *string;
     usize     len;
-    usize     capacity;
+    usize     capacity; /* number of chars the buffer can hold, not counting the null byte */
+    const DAllocator* allocator; /* allocator of the buffer and of the header, NULL for libc */
+    char      sso[D_STRING_SSO_CAPACITY + 1]; /* inline buffer used while the string is short enough */
 };
 
+#define d_string_is_inline(rdstring) ((rdstring) -> string == (rdstring) -> sso)
 
-DString* d_string_new(void)
+//Turns an index found in the sub string starting at `pos` back into an index of the whole string
+static inline usize d_string_offset_index(usize pos, usize i)
+{
+    return i == MAX_SIZE_T_VALUE ? MAX_SIZE_T_VALUE : pos + i;
+}
+
+static DRealString* d_string_alloc(const DAllocator* allocator)
 {
     DRealString* dstring;
-    if ((dstring = malloc(sizeof(DRealString))) == NULL)
+    if ((dstring = d_alloc(allocator, sizeof(DRealString))) == NULL)
         return NULL;
+    dstring -> allocator = allocator;
+    dstring -> string = dstring -> sso;
     dstring -> len = 0;
-    dstring -> capacity = CAPACITY;
-    if ((dstring -> string = malloc(sizeof(char) * (CAPACITY + 1))) == NULL)
-        return NULL;
-    return (DString*)dstring;
+    dstring -> capacity = D_STRING_SSO_CAPACITY;
+    dstring -> sso[0] = '\0';
+    return dstring;
 }
 
-DString* 	d_string_new_from_c_string(const char* str)
+/*
+** Moves the content of the string to a buffer of exactly new_capacity chars, going back to the
+** inline buffer when it is large enough. new_capacity must not be lower than the string length.
+*/
+static bool d_string_set_buffer(DRealString* rdstring, usize new_capacity)
+{
+    if (new_capacity <= D_STRING_SSO_CAPACITY)
+    {
+        if (d_string_is_inline(rdstring) == false)
+        {
+            memcpy(rdstring -> sso, rdstring -> string, rdstring -> len + 1);
+            d_free(rdstring -> allocator, rdstring -> string, rdstring -> capacity + 1);
+            rdstring -> string = rdstring -> sso;
+        }
+        rdstring -> capacity = D_STRING_SSO_CAPACITY;
+        return true;
+    }
+    char* buffer;
+    if (d_string_is_inline(rdstring) == true)
+    {
+        if ((buffer = d_alloc(rdstring -> allocator, sizeof(char) * (new_capacity + 1))) == NULL)
+            return false;
+        memcpy(buffer, rdstring -> sso, rdstring -> len + 1);
+    }
+    else if ((buffer = d_realloc(rdstring -> allocator, rdstring -> string, rdstring -> capacity + 1, new_capacity + 1)) == NULL)
+        return false;
+    rdstring -> string = buffer;
+    rdstring -> capacity = new_capacity;
+    return true;
+}
+
+//Makes sure the string can hold `required` chars, growing geometrically so appends are amortized O(1)
+static bool d_string_reserve(DRealString* rdstring, usize required)
+{
+    if (required <= rdstring -> capacity)
+        return true;
+    DGrowthPolicy policy = D_GROWTH_POLICY_DEFAULT;
+    usize new_size = d_growth_policy_next_capacity(&policy, rdstring -> capacity + 1, required + 1, sizeof(char));
+    if (new_size == 0)
+        return false;
+    return d_string_set_buffer(rdstring, new_size - 1);
+}
+
+DString*	d_string_grow(DString* dstring, usize required)
+{
+    return d_string_reserve((DRealString*)dstring, required) == true ? dstring : NULL;
+}
+
+//Releases the header of a string that never got a heap buffer
+static void d_string_free_header(DRealString* rdstring)
+{
+    d_free(rdstring -> allocator, rdstring, sizeof(DRealString));
+}
+
+static DString* d_string_new_from_buffer(const char* str, usize len, const DAllocator* allocator)
 {
     DRealString* dstring;
-    if ((dstring = malloc(sizeof(DRealString))) == NULL)
+    if ((dstring = d_string_alloc(allocator)) == NULL)
         return NULL;
-    usize len = strlen(str);
-    dstring -> len = len;
-    dstring -> capacity = CAPACITY;
-    if ((dstring -> string = malloc(sizeof(char) * (len + CAPACITY + 1))) == NULL)
+    if (d_string_set_buffer(dstring, len) == false)
+    {
+        d_string_free_header(dstring);
         return NULL;
-    memcpy(dstring -> string, str, len + 1);
+    }
+    if (len != 0)
+        memcpy(dstring -> string, str, len);
+    dstring -> len = len;
+    dstring -> string[len] = '\0';
     return (DString*)dstring;
 }
 
+DString* d_string_new(void)
+{
+    return (DString*)d_string_alloc(NULL);
+}
+
+DString*	d_string_new_with_allocator(const DAllocator* allocator)
+{
+    return (DString*)d_string_alloc(allocator);
+}
+
+DString* 	d_string_new_from_c_string(const char* str)
+{
+    if (str == NULL)
+        return d_string_new();
+    return d_string_new_with_substring(str, 0, MAX_SIZE_T_VALUE);
+}
+
+DString*	d_string_new_from_c_string_with_allocator(const char* str, const DAllocator* allocator)
+{
+    if (str == NULL)
+        return d_string_new_with_allocator(allocator);
+    return d_string_new_from_buffer(str, strlen(str), allocator);
+}
+
+const DAllocator*	d_string_get_allocator(DString* dstring)
+{
+    DRealString* rdstring = (DRealString*)dstring;
+    return rdstring -> allocator;
+}
+
 DString* 	d_string_new_from_dstring(DString* dstring)
 {
     if (dstring == NULL)
         return d_string_new();
-    return d_string_new_from_c_string(dstring->string);
+    return d_string_new_with_substring(dstring -> string, 0, dstring -> len);
 }
 
 char*       d_string_strdup(DString* dstring)
@@ -61,12 +158,13 @@ char*		d_string_substr(DString* dstring, usize pos, usize len)
 DString* 	d_string_new_with_reserve(usize reserve)
 {
     DRealString* dstring;
-    if ((dstring = malloc(sizeof(DRealString))) == NULL)
+    if ((dstring = d_string_alloc(NULL)) == NULL)
         return NULL;
-    dstring -> len = 0;
-    dstring -> capacity = reserve;
-    if ((dstring -> string = malloc(sizeof(char) * (reserve + 1))) == NULL)
+    if (d_string_set_buffer(dstring, reserve) == false)
+    {
+        d_string_free_header(dstring);
         return NULL;
+    }
     return (DString*)dstring;
 }
 
@@ -82,20 +180,7 @@ DString* 	d_string_new_with_substring(const char* str, usize pos, usize len)
             str_len - pos : pos + len > str_len //if len > str_len set let to str_len - pos so it has the correct num of char
             ?
             str_len - pos : len; // if len < str_len then check if pos + len exceed str boundary if so then len = str - pos
-    DRealString* dstring;
-    if ((dstring = malloc(sizeof(DRealString))) == NULL)
-        return NULL;
-    if ((dstring -> string = malloc(sizeof(char) * (len + CAPACITY + 1))) == NULL)
-    {
-        free(dstring);
-        return NULL;
-    }
-    if (len != 0)
-        memcpy(dstring -> string, str + pos, len);
-    dstring -> len = len;
-    dstring -> string[len] = '\0';
-    dstring -> capacity = CAPACITY;
-    return (DString*)dstring;
+    return d_string_new_from_buffer(str + pos, len, NULL);
 }
 
 DString*	d_string_sub_string_in_place(DString* dstring, usize pos, usize len)
@@ -111,7 +196,6 @@ DString*	d_string_sub_string_in_place(DString* dstring, usize pos, usize len)
     char* string = dstring -> string;
     memmove(string, string + pos, len);
     rdstring -> string[len] = 0;
-    rdstring -> capacity += string_len - len;
     rdstring -> len = len;
     return dstring;
 }
@@ -126,12 +210,11 @@ usize		d_string_get_capacity(DString* dstring)
 DString* 	d_string_resize(DString* dstring, usize len)
 {
     DRealString* rdstring = (DRealString*)dstring;
-    if (len >= rdstring -> len + rdstring -> capacity && d_string_modify_capacity(dstring, len * 2) == NULL)
+    if (d_string_reserve(rdstring, len) == false)
         return NULL;
     if (len > rdstring -> len)
         memset(rdstring -> string + rdstring -> len, 0, len - rdstring -> len);
-    else
-        rdstring -> string[len] = '\0';
+    rdstring -> string[len] = '\0';
     rdstring -> len = len;
     return dstring;
 }
@@ -139,32 +222,35 @@ DString* 	d_string_resize(DString* dstring, usize len)
 DString* 	d_string_modify_capacity(DString* dstring, usize new_capacity)
 {
     DRealString* rdstring = (DRealString*)dstring;
-    if ((rdstring -> string = realloc(rdstring -> string, rdstring -> len + new_capacity + 1)) == NULL)
+    new_capacity = new_capacity < rdstring -> len ? rdstring -> len : new_capacity;
+    if (new_capacity != rdstring -> capacity && d_string_set_buffer(rdstring, new_capacity) == false)
         return NULL;
-    rdstring -> capacity = new_capacity;
     return dstring;
 }
 
 DString* 	d_string_push_char(DString* dstring, char c)
 {
     DRealString* rdstring = (DRealString*)dstring;
-    if (rdstring -> capacity <= 1 && d_string_modify_capacity(dstring, rdstring -> len * 2) == NULL)
+    if (d_string_reserve(rdstring, rdstring -> len + 1) == false)
         return NULL;
     rdstring->string[rdstring->len++] = c;
     rdstring->string[rdstring->len] = '\0';
-    --rdstring->capacity;
     return dstring;
 }
 
 DString* 	d_string_push_str_with_len(DString* dstring, const char *str_to_append, usize len)
 {
     DRealString* rdstring = (DRealString*)dstring;
-    if (len >= rdstring -> capacity && d_string_modify_capacity(dstring, len * 2) == NULL)
+    //the appended chars may come from the string itself, its buffer can move while growing
+    bool    self_append = str_to_append >= rdstring -> string && str_to_append <= rdstring -> string + rdstring -> len;
+    usize   offset = str_to_append - rdstring -> string;
+    if (d_string_reserve(rdstring, rdstring -> len + len) == false)
         return NULL;
+    if (self_append == true)
+        str_to_append = rdstring -> string + offset;
     memcpy(rdstring -> string + rdstring -> len, str_to_append, len);
     rdstring -> len += len;
     rdstring -> string[rdstring -> len] = '\0';
-    rdstring -> capacity -= len;
     return dstring;
 }
 
@@ -180,19 +266,18 @@ DString* 	d_string_push_c_str(DString* dstring, const char *str_to_append)
 
 DString* 	d_string_push_str_of_dstring(DString* dstring1, DString* dstring2)
 {
-    return d_string_push_c_str(dstring1, dstring2 -> string);
+    return d_string_push_str_with_len(dstring1, dstring2 -> string, dstring2 -> len);
 }
 
 DString* 	d_string_replace_from_str(DString* dstring, const char* str)
 {
     DRealString* rdstring = (DRealString*)dstring;
     usize len = str == NULL ? 0 : strlen(str);
-    usize capacity = len + CAPACITY + 1;
     
-    if ((len >= rdstring -> len + rdstring -> capacity) && (rdstring -> string = realloc(rdstring -> string, len + capacity)) == NULL)
+    if (len > rdstring -> capacity && d_string_set_buffer(rdstring, len) == false)
         return NULL;
     if (len != 0)
-        memcpy(rdstring -> string, str, len);
+        memmove(rdstring -> string, str, len);
     rdstring -> len = len;
     rdstring -> string[len] = 0;
     return dstring;
@@ -270,9 +355,7 @@ usize		d_string_find_first_matching_char_from_index(DString* dstring, char c, us
 {
     if (pos >= dstring -> len)
         return MAX_SIZE_T_VALUE;
-    char* base_address = dstring -> string;
-    char* needle = memchr(base_address + pos, (int)c, strlen(base_address));
-    return needle == NULL ? MAX_SIZE_T_VALUE : (usize)(needle - base_address);
+    return d_string_offset_index(pos, d_search_first_byte(dstring -> string + pos, dstring -> len - pos, c));
 }
 
 usize		d_string_find_first_matching_char_from_start(DString* dstring, char c)
@@ -283,16 +366,9 @@ usize		d_string_find_first_matching_char_from_start(DString* dstring, char c)
 
 usize		d_string_find_first_not_matching_char_from_index(DString* dstring, char c, usize pos)
 {
-    usize str_len;
-    if (pos >= (str_len = dstring -> len))
+    if (pos >= dstring -> len)
         return MAX_SIZE_T_VALUE;
-    char *str = dstring -> string;
-    for (size_t i = pos; i < str_len; i++)
-    {
-        if (str[i] != c)
-            return i;
-    }
-    return MAX_SIZE_T_VALUE;
+    return d_string_offset_index(pos, d_search_first_not_byte(dstring -> string + pos, dstring -> len - pos, c));
 }
 
 usize		d_string_find_first_not_matching_char_from_start(DString* dstring, char c)
@@ -306,19 +382,7 @@ usize		d_string_find_last_matching_char_from_index(DString* dstring, char c, usi
     if ((len = dstring -> len) == 0)
         return MAX_SIZE_T_VALUE;
     pos = pos >= len ? len - 1 : pos;
-
-    usize i = pos;
-    char* s = dstring -> string;
-    while (1)
-    {
-        if (s[i] == c)
-            return i;
-        else if (i == 0)
-            break;
-        --i;
-    }
-
-    return MAX_SIZE_T_VALUE;
+    return d_search_last_byte(dstring -> string, pos + 1, c);
 }
 
 usize		d_string_find_last_matching_char_from_end(DString* dstring, char c)
@@ -331,16 +395,7 @@ usize		d_string_find_last_not_matching_char_from_index(DString* dstring, char c,
     if (dstring -> len == 0)
         return MAX_SIZE_T_VALUE;
     pos = pos >= dstring -> len ? dstring -> len - 1 : pos;
-    char *str = dstring -> string;
-    while (1)
-    {
-        if (str[pos] != c)
-            return pos;
-        if (pos == 0)
-            break;
-        --pos;
-    }
-    return MAX_SIZE_T_VALUE;
+    return d_search_last_not_byte(dstring -> string, pos + 1, c);
 }
 
 usize		d_string_find_last_not_matching_char_from_end(DString* dstring, char c)
@@ -352,15 +407,7 @@ usize		d_string_find_first_matching_str_from_index(DString* dstring, const char
 {
     if (pos >= dstring -> len)
         return MAX_SIZE_T_VALUE;
-    char* string = dstring -> string;
-    usize len = strlen(str);
-    usize string_len = dstring -> len;
-    for (usize i = pos; i < string_len; ++i)
-    {
-        if (string[i] == str[0] && string_len - i >= len && memcmp(string + i, str, len) == 0)
-            return (string + i) - string;
-    }
-    return MAX_SIZE_T_VALUE;
+    return d_string_offset_index(pos, d_search_first_str(dstring -> string + pos, dstring -> len - pos, str, strlen(str)));
 }
 
 usize		d_string_find_first_matching_str_from_start(DString* dstring, const char *str)
@@ -374,19 +421,9 @@ usize		d_string_find_last_matching_str_from_index(DString* dstring, const char *
     if ((len = dstring -> len) == 0)
         return MAX_SIZE_T_VALUE;
     pos = pos >= len ? len - 1 : pos;
-    usize string_len = len;
-    char* string = dstring -> string;
     usize str_len = strlen(str);
-    usize i = pos;
-    while (1)
-    {
-        if (string[i] == str[0] && string_len - i >= str_len && memcmp(string + i, str, str_len) == 0)
-            return (string + i) - string;
-        else if (i == 0)
-            break;
-        --i;
-    }
-    return MAX_SIZE_T_VALUE;
+    //only the occurrences starting at or before pos count
+    return d_search_last_str(dstring -> string, str_len > len - pos ? len : pos + str_len, str, str_len);
 }
 
 usize		d_string_find_last_matching_str_from_end(DString* dstring, const char *str)
@@ -394,19 +431,30 @@ usize		d_string_find_last_matching_str_from_end(DString* dstring, const char *st
     return d_string_find_last_matching_str_from_index(dstring, str, dstring -> len);
 }
 
+usize		d_string_find_first_matching_needle_from_index(DString* dstring, const DNeedle* needle, usize pos)
+{
+    if (pos >= dstring -> len)
+        return MAX_SIZE_T_VALUE;
+    return d_string_offset_index(pos, d_needle_find_first(needle, dstring -> string + pos, dstring -> len - pos));
+}
+
+usize		d_string_find_last_matching_needle_from_index(DString* dstring, const DNeedle* needle, usize pos)
+{
+    usize len;
+    if ((len = dstring -> len) == 0)
+        return MAX_SIZE_T_VALUE;
+    pos = pos >= len ? len - 1 : pos;
+    usize needle_len = d_needle_get_len(needle);
+    return d_needle_find_last(needle, dstring -> string, needle_len > len - pos ? len : pos + needle_len);
+}
+
 usize		d_string_find_first_char_in_str_from_index(DString* dstring, char* str, usize pos)
 {
-    usize dstring_len;
-    if (pos >= (dstring_len = dstring -> len))
+    DByteSet set;
+    if (pos >= dstring -> len)
         return MAX_SIZE_T_VALUE;
-    char *dstring_str = dstring -> string;
-    usize str_len = strlen(str);
-    for (size_t i = pos; i < dstring_len; i++)
-    {
-        if (memchr(str, (int)dstring_str[i], str_len) != NULL)
-            return i;
-    }
-    return MAX_SIZE_T_VALUE;
+    d_byte_set_init(&set, str);
+    return d_string_offset_index(pos, d_search_first_in_set(dstring -> string + pos, dstring -> len - pos, &set));
 }
 
 usize		d_string_find_first_char_in_str_from_start(DString* dstring, char* str)
@@ -416,17 +464,11 @@ usize		d_string_find_first_char_in_str_from_start(DString* dstring, char* str)
 
 usize		d_string_find_first_char_not_in_str_from_index(DString* dstring, char* str, usize pos)
 {
-    usize dstring_len;
-    if (pos >= (dstring_len = dstring -> len))
+    DByteSet set;
+    if (pos >= dstring -> len)
         return MAX_SIZE_T_VALUE;
-    char *dstring_str = dstring -> string;
-    usize str_len = strlen(str);
-    for (size_t i = pos; i < dstring_len; i++)
-    {
-        if (memchr(str, (int)dstring_str[i], str_len) == NULL)
-            return i;
-    }
-    return MAX_SIZE_T_VALUE;
+    d_byte_set_init(&set, str);
+    return d_string_offset_index(pos, d_search_first_not_in_set(dstring -> string + pos, dstring -> len - pos, &set));
 }
 
 
@@ -437,20 +479,12 @@ usize		d_string_find_first_char_not_in_str_from_start(DString* dstring, char* st
 
 usize		d_string_find_last_char_in_str_from_index(DString* dstring, char* str, usize pos)
 {
+    DByteSet set;
     if (dstring -> len == 0)
         return MAX_SIZE_T_VALUE;
     pos = pos >= dstring -> len ? dstring -> len - 1 : pos;
-    char *dstring_str = dstring -> string;
-    usize str_len = strlen(str);
-    while (1)
-    {
-        if (memchr(str, (int)dstring_str[pos], str_len) != NULL)
-            return pos;
-        else if (pos == 0)
-            break;
-        --pos;
-    }
-    return MAX_SIZE_T_VALUE;
+    d_byte_set_init(&set, str);
+    return d_search_last_in_set(dstring -> string, pos + 1, &set);
 }
 
 usize		d_string_find_last_char_in_str_from_end(DString* dstring, char* str)
@@ -460,20 +494,12 @@ usize		d_string_find_last_char_in_str_from_end(DString* dstring, char* str)
 
 usize		d_string_find_last_char_not_in_str_from_index(DString* dstring, char* str, usize pos)
 {
+    DByteSet set;
     if (dstring -> len == 0)
         return MAX_SIZE_T_VALUE;
     pos = pos >= dstring -> len ? dstring -> len - 1 : pos;
-    char *dstring_str = dstring -> string;
-    usize str_len = strlen(str);
-    while (1)
-    {
-        if (memchr(str, (int)dstring_str[pos], str_len) == NULL)
-            return pos;
-        else if (pos == 0)
-            break;
-        --pos;
-    }
-    return MAX_SIZE_T_VALUE;
+    d_byte_set_init(&set, str);
+    return d_search_last_not_in_set(dstring -> string, pos + 1, &set);
 }
 
 usize		d_string_find_last_char_not_in_str_from_end(DString* dstring, char* str)
@@ -662,69 +688,60 @@ DString*	d_string_trim_right_by_predicate_new(DString* dstring, match fn)
     return d_string_new_with_substring(dstring -> string, 0, i + 1);
 }
 
-DPointerArray*		d_string_split_by_char_of_str(DString* dstring, char* str)
+//Copies every token described by the `count` begin/end pairs of `bounds` in a null terminated pointer array
+static DPointerArray*	d_string_split_from_bounds(DString* dstring, const DArray* bounds, usize count)
 {
-    DPointerArray* vec = d_pointer_array_new(1, true, free);
+    DPointerArray* vec = d_pointer_array_new(count, true, free);
     if (vec == NULL)
         return NULL;
-
-    usize len = dstring -> len;
-    char* string = dstring -> string;
-    
-    usize str_len = strlen(str);
-    for (usize i = 0; i < len;)
+    const usize* offsets = bounds -> data;
+    for (usize i = 0; i < count; ++i)
     {
-        while (i < len && memchr(str, (int)string[i], str_len) != NULL)
-            ++i;
-        if (i != len)
+        usize len = offsets[2 * i + 1] - offsets[2 * i];
+        char* token = malloc(sizeof(char) * (len + 1));
+        if (token == NULL || d_pointer_array_push_back(vec, token) == NULL)
         {
-            usize j = d_string_find_first_char_in_str_from_index(dstring, str, i);
-            char* str = d_string_substr(dstring, i, j == MAX_SIZE_T_VALUE ? MAX_SIZE_T_VALUE : j - i);
-            if (str == NULL || d_pointer_array_push_back(vec, str) == NULL)
-            {
-                d_pointer_array_destroy(&vec);
-                return NULL;
-            }
-            i = j;
+            free(token);
+            d_pointer_array_destroy(&vec);
+            return NULL;
         }
-        else
-            break;
+        memcpy(token, dstring -> string + offsets[2 * i], len);
+        token[len] = '\0';
     }
     return vec;
 }
 
+DPointerArray*		d_string_split_by_char_of_str(DString* dstring, char* str)
+{
+    D_SMALL_ARRAY(usize, D_STRING_SPLIT_INLINE_BOUNDS) storage;
+    DArray* bounds = d_small_array_init(&storage, false);
+    DPointerArray* vec = NULL;
+    DByteSet set;
+    d_byte_set_init(&set, str);
+    usize count = d_search_token_bounds_in_set(dstring -> string, dstring -> len, &set, bounds);
+    if (count != MAX_SIZE_T_VALUE)
+        vec = d_string_split_from_bounds(dstring, bounds, count);
+    d_array_destroy(&bounds);
+    return vec;
+}
+
 DPointerArray*		d_string_split_by_char(DString* dstring, char c)
 {
-    DPointerArray* vec = d_pointer_array_new(10, true, free);
-    if (vec == NULL)
-        return NULL;
-    usize len = dstring -> len;
-    char* str = dstring -> string;
-    for (usize i = 0; i < len;)
-    {
-        while (i < len && str[i] == c)
-            ++i;
-        if (i != len)
-        {
-            usize j = d_string_find_first_matching_char_from_index(dstring, c, i);
-            char* str = d_string_substr(dstring, i, j == MAX_SIZE_T_VALUE ? MAX_SIZE_T_VALUE : j - i);
-            if (str == NULL || d_pointer_array_push_back(vec, str) == NULL)
-            {
-                d_pointer_array_destroy(&vec);
-                return NULL;
-            }
-            i = j;
-        }
-        else
-            break;
-    }
+    D_SMALL_ARRAY(usize, D_STRING_SPLIT_INLINE_BOUNDS) storage;
+    DArray* bounds = d_small_array_init(&storage, false);
+    DPointerArray* vec = NULL;
+    usize count = d_search_token_bounds_by_byte(dstring -> string, dstring -> len, c, bounds);
+    if (count != MAX_SIZE_T_VALUE)
+        vec = d_string_split_from_bounds(dstring, bounds, count);
+    d_array_destroy(&bounds);
     return vec;
 }
 
 void		d_string_destroy(DString** dstring)
 {
     DRealString* rdstring = ((DRealString*)*dstring);
-    free(rdstring -> string);
-    free(rdstring);
+    if (d_string_is_inline(rdstring) == false)
+        d_free(rdstring -> allocator, rdstring -> string, rdstring -> capacity + 1);
+    d_string_free_header(rdstring);
     *dstring = NULL;
 }
\ No newline at end of file
@@ -0,0 +1,365 @@
+#include "dstring_fmt.h"
+#include "dstring_growth.h"
+#include <string.h>
+#include <general_lib.h>
+
+/*
+** Destination of a formatting pass: the spare capacity of the string. Chars that do not fit are only counted,
+** so that a single growth can make room for all of them.
+*/
+typedef struct {
+    char*   buffer;
+    usize   capacity;
+    usize   len;
+} DFmtWriter;
+
+//Flags, width and precision of a conversion
+typedef struct {
+    bool    left;
+    bool    zero;
+    usize   width;
+    usize   precision; /* MAX_SIZE_T_VALUE when there is none */
+} DFmtSpec;
+
+static const DFmtSpec g_default_spec = { false, false, 0, MAX_SIZE_T_VALUE };
+
+static inline void  d_fmt_put(DFmtWriter* writer, const char* str, usize len)
+{
+    if (len <= writer -> capacity && writer -> len <= writer -> capacity - len)
+        memcpy(writer -> buffer + writer -> len, str, len);
+    writer -> len += len;
+}
+
+static inline void  d_fmt_pad(DFmtWriter* writer, char c, usize len)
+{
+    if (len <= writer -> capacity && writer -> len <= writer -> capacity - len)
+        memset(writer -> buffer + writer -> len, c, len);
+    writer -> len += len;
+}
+
+//Writes `len` chars of `text` in a field of `spec -> width` chars. Zeros go after the sign of a number
+static void d_fmt_put_field(DFmtWriter* writer, const DFmtSpec* spec, const char* text, usize len, bool number)
+{
+    usize pad = spec -> width > len ? spec -> width - len : 0;
+    if (pad == 0)
+    {
+        d_fmt_put(writer, text, len);
+        return;
+    }
+    if (spec -> left == true)
+    {
+        d_fmt_put(writer, text, len);
+        d_fmt_pad(writer, ' ', pad);
+        return;
+    }
+    //"nan" and "inf" are not padded with zeros
+    if (spec -> zero == true && number == true && len != 0 && (u8)(text[len - 1] - '0') <= 9)
+    {
+        if (text[0] == '-')
+        {
+            d_fmt_put(writer, text++, 1);
+            --len;
+        }
+        d_fmt_pad(writer, '0', pad);
+    }
+    else
+        d_fmt_pad(writer, ' ', pad);
+    d_fmt_put(writer, text, len);
+}
+
+static void d_fmt_put_text(DFmtWriter* writer, const DFmtSpec* spec, const char* text, usize len)
+{
+    if (len > spec -> precision)
+        len = spec -> precision;
+    if (spec -> width == 0)
+        d_fmt_put(writer, text, len);
+    else
+        d_fmt_put_field(writer, spec, text, len, false);
+}
+
+//Number of chars of a C string copied while looking for its end, before strlen and memcpy take over
+#define D_FMT_SHORT_STR 16
+
+//Appends a C string without measuring it first: keys, separators and units are a few chars long
+static void d_fmt_put_c_str(DFmtWriter* writer, const char* str)
+{
+    char* out = writer -> buffer;
+    usize capacity = writer -> capacity;
+    usize len = writer -> len;
+    for (usize i = 0; i < D_FMT_SHORT_STR; ++i)
+    {
+        if (str[i] == '\0')
+        {
+            writer -> len = len + i;
+            return;
+        }
+        if (len + i < capacity)
+            out[len + i] = str[i];
+    }
+    writer -> len = len + D_FMT_SHORT_STR;
+    d_fmt_put(writer, str + D_FMT_SHORT_STR, strlen(str + D_FMT_SHORT_STR));
+}
+
+static void d_fmt_put_hex(DFmtWriter* writer, const DFmtSpec* spec, u64 nb, bool upper)
+{
+    const char* digits = upper == true ? "0123456789ABCDEF" : "0123456789abcdef";
+    char buffer[16];
+    char* start = buffer + sizeof(buffer);
+    do
+    {
+        *--start = digits[nb & 15];
+        nb >>= 4;
+    } while (nb != 0);
+    d_fmt_put_field(writer, spec, start, buffer + sizeof(buffer) - start, true);
+}
+
+//Writes one tagged value. Without a width, a number is formatted in place when the spare capacity can hold its
+//longest form (and its null byte), otherwise on the stack and copied once
+static void d_fmt_put_arg(DFmtWriter* writer, const DFmtSpec* spec, const DFmtArg* arg)
+{
+    char buffer[D_DTOA_BUFFER_SIZE];
+    bool in_place = spec -> width == 0 && writer -> len <= writer -> capacity
+        && writer -> capacity - writer -> len >= D_DTOA_BUFFER_SIZE;
+    char* out = in_place == true ? writer -> buffer + writer -> len : buffer;
+    usize len;
+    switch (arg -> type)
+    {
+        case D_FMT_ARG_STR:
+            if (arg -> value.str == NULL)
+                d_fmt_put_text(writer, spec, "(null)", 6);
+            else if (spec -> width == 0 && spec -> precision == MAX_SIZE_T_VALUE)
+                d_fmt_put_c_str(writer, arg -> value.str);
+            else
+                d_fmt_put_text(writer, spec, arg -> value.str, strlen(arg -> value.str));
+            return;
+        case D_FMT_ARG_DSTRING:
+            d_fmt_put_text(writer, spec, arg -> value.dstring -> string, arg -> value.dstring -> len);
+            return;
+        case D_FMT_ARG_VIEW:
+            d_fmt_put_text(writer, spec, arg -> value.view.data, arg -> value.view.len);
+            return;
+        case D_FMT_ARG_CHAR:
+            d_fmt_put_field(writer, spec, &arg -> value.c, 1, false);
+            return;
+        case D_FMT_ARG_BOOL:
+            d_fmt_put_text(writer, spec, arg -> value.b ? "true" : "false", arg -> value.b ? 4 : 5);
+            return;
+        case D_FMT_ARG_I64:
+            len = d_i64_to_chars(arg -> value.i, out);
+            break;
+        case D_FMT_ARG_U64:
+            len = d_u64_to_chars(arg -> value.u, out);
+            break;
+        case D_FMT_ARG_DOUBLE:
+            len = d_double_to_chars(arg -> value.d, out);
+            break;
+        case D_FMT_ARG_FLOAT:
+            len = d_float_to_chars(arg -> value.f, out);
+            break;
+        default:
+            return;
+    }
+    if (in_place == true)
+        writer -> len += len;
+    else
+        d_fmt_put_field(writer, spec, buffer, len, true);
+}
+
+//Reads a width or a precision, `*` taking it from the arguments. A negative width means left-justified
+static usize    d_fmt_read_count(const char** fmt, va_list* args, bool* negative)
+{
+    const char* p = *fmt;
+    usize count = 0;
+    *negative = false;
+    if (*p == '*')
+    {
+        int value = va_arg(*args, int);
+        *negative = value < 0;
+        *fmt = p + 1;
+        return value < 0 ? (usize)0 - (usize)value : (usize)value;
+    }
+    while ((u8)(*p - '0') <= 9)
+        count = count * 10 + (*p++ - '0');
+    *fmt = p;
+    return count;
+}
+
+static void d_fmt_read_spec(const char** fmt, va_list* args, DFmtSpec* spec)
+{
+    for (;; ++*fmt)
+    {
+        if (**fmt == '-')
+            spec -> left = true;
+        else if (**fmt == '0')
+            spec -> zero = true;
+        else
+            break;
+    }
+    bool negative;
+    spec -> width = d_fmt_read_count(fmt, args, &negative);
+    spec -> left = spec -> left || negative;
+    if (**fmt == '.')
+    {
+        ++*fmt;
+        spec -> precision = d_fmt_read_count(fmt, args, &negative);
+        if (negative == true)
+            spec -> precision = MAX_SIZE_T_VALUE;
+    }
+}
+
+//Formats `fmt`, returns false on an unknown conversion
+static bool d_fmt_format(DFmtWriter* writer, const char* fmt, va_list args)
+{
+    va_list ap;
+    va_copy(ap, args);
+    for (;;)
+    {
+        //the literal chars are copied while they are scanned, the runs between conversions are short
+        char* out = writer -> buffer;
+        usize capacity = writer -> capacity;
+        usize len = writer -> len;
+        for (; *fmt != '\0' && *fmt != '%'; ++fmt, ++len)
+            if (len < capacity)
+                out[len] = *fmt;
+        writer -> len = len;
+        if (*fmt == '\0')
+            break;
+        ++fmt;
+        DFmtSpec spec = g_default_spec;
+        //flags, widths and precisions all sort before the letters of the conversions: "%d" and "%s" skip them
+        if (*fmt < 'A')
+            d_fmt_read_spec(&fmt, &ap, &spec);
+        //0 for int, 1 for long, 2 for long long, 3 for usize, -1 for h
+        int length = 0;
+        if (*fmt == 'h')
+            length = -1;
+        else if (*fmt == 'z')
+            length = 3;
+        else if (*fmt == 'l')
+            length = fmt[1] == 'l' ? 2 : 1;
+        fmt += length == 0 ? 0 : length == 2 ? 2 : 1;
+        DFmtArg arg;
+        switch (*fmt++)
+        {
+            case '%':
+                d_fmt_put(writer, "%", 1);
+                continue;
+            case 'd':
+            case 'i':
+                arg.type = D_FMT_ARG_I64;
+                arg.value.i = length == 1 ? va_arg(ap, long) : length == 2 ? va_arg(ap, long long)
+                    : length == 3 ? va_arg(ap, ssize_t) : va_arg(ap, int);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+                arg.type = D_FMT_ARG_U64;
+                arg.value.u = length == 1 ? va_arg(ap, unsigned long) : length == 2 ? va_arg(ap, unsigned long long)
+                    : length == 3 ? va_arg(ap, usize) : va_arg(ap, unsigned int);
+                if (fmt[-1] != 'u')
+                {
+                    d_fmt_put_hex(writer, &spec, arg.value.u, fmt[-1] == 'X');
+                    continue;
+                }
+                break;
+            case 'c':
+                arg.type = D_FMT_ARG_CHAR;
+                arg.value.c = (char)va_arg(ap, int);
+                break;
+            case 's':
+                arg.type = D_FMT_ARG_STR;
+                arg.value.str = va_arg(ap, const char*);
+                break;
+            case 'S':
+                arg.type = D_FMT_ARG_DSTRING;
+                arg.value.dstring = va_arg(ap, const DString*);
+                break;
+            case 'V':
+                arg.type = D_FMT_ARG_VIEW;
+                arg.value.view = va_arg(ap, DStringView);
+                break;
+            case 'g':
+                if (length == -1)
+                {
+                    arg.type = D_FMT_ARG_FLOAT;
+                    arg.value.f = (float)va_arg(ap, double);
+                }
+                else
+                {
+                    arg.type = D_FMT_ARG_DOUBLE;
+                    arg.value.d = va_arg(ap, double);
+                }
+                break;
+            default:
+                va_end(ap);
+                return false;
+        }
+        d_fmt_put_arg(writer, &spec, &arg);
+    }
+    va_end(ap);
+    return true;
+}
+
+//Formats into the spare capacity of `dstring`. If it did not fit, grows it once, geometrically to at least the total
+//length, and formats again. `fmt` is NULL when the values come from `args_array` instead of `args`
+static DString* d_string_append_pass(DString* dstring, const char* fmt, va_list* args, const DFmtArg* args_array,
+                                    usize count)
+{
+    usize len = dstring -> len;
+    DFmtWriter writer = { dstring -> string + len, d_string_get_capacity(dstring) - len, 0 };
+    for (u32 pass = 0; pass < 2; ++pass)
+    {
+        bool valid = true;
+        if (fmt != NULL)
+            valid = d_fmt_format(&writer, fmt, *args);
+        else
+            for (usize i = 0; i < count; ++i)
+                d_fmt_put_arg(&writer, &g_default_spec, &args_array[i]);
+        if (valid == false)
+        {
+            dstring -> string[len] = '\0';
+            return NULL;
+        }
+        if (writer.len <= writer.capacity)
+        {
+            //`len` and `string` are the public fields of the string, there is room for the null byte past the capacity
+            dstring -> len = len + writer.len;
+            dstring -> string[dstring -> len] = '\0';
+            return dstring;
+        }
+        //only the capacity grows, nothing is zeroed: the string keeps its old length while it is formatted again, in
+        //case it is one of the values, and gets its new one once the second pass is done
+        if (d_string_grow(dstring, len + writer.len) == NULL)
+        {
+            dstring -> string[len] = '\0';
+            return NULL;
+        }
+        writer = (DFmtWriter){ dstring -> string + len, d_string_get_capacity(dstring) - len, 0 };
+    }
+    //only reached if the values changed between the two passes
+    dstring -> string[len] = '\0';
+    return NULL;
+}
+
+DString*    d_string_append_vfmt(DString* dstring, const char* fmt, va_list args)
+{
+    va_list ap;
+    va_copy(ap, args);
+    DString* result = d_string_append_pass(dstring, fmt, &ap, NULL, 0);
+    va_end(ap);
+    return result;
+}
+
+DString*    d_string_append_fmt(DString* dstring, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    DString* result = d_string_append_pass(dstring, fmt, &args, NULL, 0);
+    va_end(args);
+    return result;
+}
+
+DString*    d_string_append_args(DString* dstring, const DFmtArg* args, usize count)
+{
+    return d_string_append_pass(dstring, NULL, NULL, args, count);
+}
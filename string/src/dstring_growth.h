@@ -0,0 +1,15 @@
+#ifndef __D_STRING_GROWTH__H
+#define __D_STRING_GROWTH__H
+
+/*
+ * Private to the string module: the growth of the string buffers, shared by the appends of `dstring.c` and the
+ * formatting of `dstring_fmt.c`.
+ */
+
+#include <dstring.h>
+
+//Makes sure `dstring` can hold `required` chars, growing geometrically with the growth policy of the appends.
+//The content and the length are kept, the new capacity is not zeroed. NULL if the allocation fails
+DString*	d_string_grow(DString* dstring, usize required);
+
+#endif
@@ -0,0 +1,772 @@
+#include "dstring_search.h"
+#include <string.h>
+#include <stdlib.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+# define D_SEARCH_X86 1
+# include <immintrin.h>
+#else
+# define D_SEARCH_X86 0
+#endif
+
+typedef struct _DSearchKernels DSearchKernels;
+
+//One implementation of every search primitive, for a given instruction set
+struct _DSearchKernels {
+    DSearchIsa  isa;
+    usize       (*first_byte)(const char* str, usize len, char c, bool negate);
+    usize       (*last_byte)(const char* str, usize len, char c, bool negate);
+    usize       (*first_in_set)(const char* str, usize len, const DByteSet* set, bool negate);
+    usize       (*last_in_set)(const char* str, usize len, const DByteSet* set, bool negate);
+    //needles of 2 to D_NEEDLE_SHORT_MAX_LEN chars, never longer than str
+    usize       (*first_short_str)(const char* str, usize len, const char* needle, usize needle_len);
+    usize       (*last_short_str)(const char* str, usize len, const char* needle, usize needle_len);
+    //bit i of the result is set when str[i] is a delimiter, always reads 64 bytes
+    u64         (*byte_mask64)(const char* str, char c);
+    u64         (*set_mask64)(const char* str, const DByteSet* set);
+};
+
+//Real Needle Interface
+struct _DNeedle {
+    usize   len;
+    usize   forward_shift[256]; /* Horspool shifts of the forward search, only built for long needles */
+    usize   backward_shift[256]; /* Horspool shifts of the backward search, only built for long needles */
+    char    data[]; /* copy of the needle chars */
+};
+
+void		d_byte_set_add(DByteSet* set, u8 c)
+{
+    set -> table[((c >> 7) << 4) | (c & 0x0F)] |= (u8)(1 << ((c >> 4) & 7));
+}
+
+void		d_byte_set_init(DByteSet* set, const char* str)
+{
+    memset(set -> table, 0, sizeof(set -> table));
+    for (; *str; ++str)
+        d_byte_set_add(set, (u8)*str);
+}
+
+/*
+** Portable kernels, also used for the tails the vector kernels leave behind.
+*/
+
+static usize	scalar_first_byte(const char* str, usize len, char c, bool negate)
+{
+    if (negate == false)
+    {
+        const char* found = len == 0 ? NULL : memchr(str, (int)c, len);
+        return found == NULL ? MAX_SIZE_T_VALUE : (usize)(found - str);
+    }
+    for (usize i = 0; i < len; ++i)
+    {
+        if (str[i] != c)
+            return i;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+static usize	scalar_last_byte(const char* str, usize len, char c, bool negate)
+{
+    while (len-- > 0)
+    {
+        if ((str[len] == c) != negate)
+            return len;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+static usize	scalar_first_in_set(const char* str, usize len, const DByteSet* set, bool negate)
+{
+    for (usize i = 0; i < len; ++i)
+    {
+        if ((bool)d_byte_set_contains(set, str[i]) != negate)
+            return i;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+static usize	scalar_last_in_set(const char* str, usize len, const DByteSet* set, bool negate)
+{
+    while (len-- > 0)
+    {
+        if ((bool)d_byte_set_contains(set, str[len]) != negate)
+            return len;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+//Candidates are located with memchr on the first needle byte, then the rest of the needle is compared
+static usize	scalar_first_short_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    usize last = len - needle_len;
+    for (usize i = 0; i <= last; ++i)
+    {
+        const char* found = memchr(str + i, (int)needle[0], last - i + 1);
+        if (found == NULL)
+            break;
+        i = found - str;
+        if (memcmp(found + 1, needle + 1, needle_len - 1) == 0)
+            return i;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+static usize	scalar_last_short_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    usize candidates = len - needle_len + 1;
+    while (candidates > 0)
+    {
+        usize i = scalar_last_byte(str, candidates, needle[0], false);
+        if (i == MAX_SIZE_T_VALUE)
+            break;
+        if (memcmp(str + i + 1, needle + 1, needle_len - 1) == 0)
+            return i;
+        candidates = i;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+static u64	scalar_byte_mask(const char* str, usize len, char c)
+{
+    u64 mask = 0;
+    for (usize i = 0; i < len; ++i)
+        mask |= (u64)(str[i] == c) << i;
+    return mask;
+}
+
+static u64	scalar_set_mask(const char* str, usize len, const DByteSet* set)
+{
+    u64 mask = 0;
+    for (usize i = 0; i < len; ++i)
+        mask |= (u64)d_byte_set_contains(set, str[i]) << i;
+    return mask;
+}
+
+static u64	scalar_byte_mask64(const char* str, char c)
+{
+    return scalar_byte_mask(str, 64, c);
+}
+
+static u64	scalar_set_mask64(const char* str, const DByteSet* set)
+{
+    return scalar_set_mask(str, 64, set);
+}
+
+static const DSearchKernels g_scalar_kernels = {
+    D_SEARCH_ISA_SCALAR, scalar_first_byte, scalar_last_byte, scalar_first_in_set, scalar_last_in_set,
+    scalar_first_short_str, scalar_last_short_str, scalar_byte_mask64, scalar_set_mask64
+};
+
+#if D_SEARCH_X86
+
+/*
+** SSE2 kernels: 16 bytes per iteration, the comparison result is turned into a bit mask with movemask
+** and the index is recovered with ctz (forward) or clz (backward). `flip` inverts the mask for the
+** "not" variants. The set kernels need pshufb and are therefore built for SSSE3.
+*/
+
+static usize	sse2_first_byte(const char* str, usize len, char c, bool negate)
+{
+    __m128i needle = _mm_set1_epi8(c);
+    u32 flip = negate ? 0xFFFF : 0;
+    usize i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str + i)), needle)) ^ flip;
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    usize j = scalar_first_byte(str + i, len - i, c, negate);
+    return j == MAX_SIZE_T_VALUE ? j : i + j;
+}
+
+static usize	sse2_last_byte(const char* str, usize len, char c, bool negate)
+{
+    __m128i needle = _mm_set1_epi8(c);
+    u32 flip = negate ? 0xFFFF : 0;
+    usize i = len;
+    while (i >= 16)
+    {
+        i -= 16;
+        u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str + i)), needle)) ^ flip;
+        if (mask != 0)
+            return i + 31 - __builtin_clz(mask);
+    }
+    return scalar_last_byte(str, i, c, negate);
+}
+
+//Returns 0xFF for every byte of `v` that belongs to the set described by the two rows of its table
+__attribute__((target("ssse3")))
+static inline __m128i	ssse3_set_match(__m128i v, __m128i row_lo, __m128i row_hi, __m128i bits)
+{
+    __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    __m128i lo = _mm_and_si128(v, nibble_mask);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask);
+    __m128i use_hi_row = _mm_cmpgt_epi8(hi, _mm_set1_epi8(7));
+    __m128i row = _mm_or_si128(_mm_andnot_si128(use_hi_row, _mm_shuffle_epi8(row_lo, lo)),
+                               _mm_and_si128(use_hi_row, _mm_shuffle_epi8(row_hi, lo)));
+    __m128i bit = _mm_shuffle_epi8(bits, hi);
+    return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+}
+
+#define D_SEARCH_SET_BITS 1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2, 4, 8, 16, 32, 64, (char)128
+
+__attribute__((target("ssse3")))
+static usize	ssse3_first_in_set(const char* str, usize len, const DByteSet* set, bool negate)
+{
+    __m128i row_lo = _mm_loadu_si128((const __m128i*)set -> table);
+    __m128i row_hi = _mm_loadu_si128((const __m128i*)(set -> table + 16));
+    __m128i bits = _mm_setr_epi8(D_SEARCH_SET_BITS);
+    u32 flip = negate ? 0xFFFF : 0;
+    usize i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+        u32 mask = (u32)_mm_movemask_epi8(ssse3_set_match(v, row_lo, row_hi, bits)) ^ flip;
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    usize j = scalar_first_in_set(str + i, len - i, set, negate);
+    return j == MAX_SIZE_T_VALUE ? j : i + j;
+}
+
+__attribute__((target("ssse3")))
+static usize	ssse3_last_in_set(const char* str, usize len, const DByteSet* set, bool negate)
+{
+    __m128i row_lo = _mm_loadu_si128((const __m128i*)set -> table);
+    __m128i row_hi = _mm_loadu_si128((const __m128i*)(set -> table + 16));
+    __m128i bits = _mm_setr_epi8(D_SEARCH_SET_BITS);
+    u32 flip = negate ? 0xFFFF : 0;
+    usize i = len;
+    while (i >= 16)
+    {
+        i -= 16;
+        __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+        u32 mask = (u32)_mm_movemask_epi8(ssse3_set_match(v, row_lo, row_hi, bits)) ^ flip;
+        if (mask != 0)
+            return i + 31 - __builtin_clz(mask);
+    }
+    return scalar_last_in_set(str, i, set, negate);
+}
+
+/*
+** Short needle kernels: a position is a candidate only if both the first and the last byte of the needle
+** match there, which is checked for 16 positions at once. Only the candidates get a memcmp of the middle bytes.
+*/
+
+static usize	sse2_first_short_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    usize candidates = len - needle_len + 1;
+    usize i = 0;
+    for (; i + 16 <= candidates; i += 16)
+    {
+        __m128i eq_first = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str + i)), first);
+        __m128i eq_last = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str + i + needle_len - 1)), last);
+        u32 mask = (u32)_mm_movemask_epi8(_mm_and_si128(eq_first, eq_last));
+        while (mask != 0)
+        {
+            usize bit = __builtin_ctz(mask);
+            if (memcmp(str + i + bit + 1, needle + 1, needle_len - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    usize j = scalar_first_short_str(str + i, len - i, needle, needle_len);
+    return j == MAX_SIZE_T_VALUE ? j : i + j;
+}
+
+static usize	sse2_last_short_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    usize i = len - needle_len + 1;
+    while (i >= 16)
+    {
+        i -= 16;
+        __m128i eq_first = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str + i)), first);
+        __m128i eq_last = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str + i + needle_len - 1)), last);
+        u32 mask = (u32)_mm_movemask_epi8(_mm_and_si128(eq_first, eq_last));
+        while (mask != 0)
+        {
+            usize bit = 31 - __builtin_clz(mask);
+            if (memcmp(str + i + bit + 1, needle + 1, needle_len - 2) == 0)
+                return i + bit;
+            mask &= ~(1U << bit);
+        }
+    }
+    return scalar_last_short_str(str, i + needle_len - 1, needle, needle_len);
+}
+
+static u64	sse2_byte_mask64(const char* str, char c)
+{
+    __m128i needle = _mm_set1_epi8(c);
+    u64 mask = 0;
+    for (usize i = 0; i < 64; i += 16)
+        mask |= (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(str + i)), needle)) << i;
+    return mask;
+}
+
+__attribute__((target("ssse3")))
+static u64	ssse3_set_mask64(const char* str, const DByteSet* set)
+{
+    __m128i row_lo = _mm_loadu_si128((const __m128i*)set -> table);
+    __m128i row_hi = _mm_loadu_si128((const __m128i*)(set -> table + 16));
+    __m128i bits = _mm_setr_epi8(D_SEARCH_SET_BITS);
+    u64 mask = 0;
+    for (usize i = 0; i < 64; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+        mask |= (u64)(u32)_mm_movemask_epi8(ssse3_set_match(v, row_lo, row_hi, bits)) << i;
+    }
+    return mask;
+}
+
+static const DSearchKernels g_sse2_kernels = {
+    D_SEARCH_ISA_SSE2, sse2_first_byte, sse2_last_byte, scalar_first_in_set, scalar_last_in_set,
+    sse2_first_short_str, sse2_last_short_str, sse2_byte_mask64, scalar_set_mask64
+};
+
+static const DSearchKernels g_ssse3_kernels = {
+    D_SEARCH_ISA_SSSE3, sse2_first_byte, sse2_last_byte, ssse3_first_in_set, ssse3_last_in_set,
+    sse2_first_short_str, sse2_last_short_str, sse2_byte_mask64, ssse3_set_mask64
+};
+
+/*
+** AVX2 kernels: same algorithms on 32 bytes per iteration, the remainder goes through the SSE2 kernels.
+*/
+
+__attribute__((target("avx2")))
+static usize	avx2_first_byte(const char* str, usize len, char c, bool negate)
+{
+    __m256i needle = _mm256_set1_epi8(c);
+    u32 flip = negate ? 0xFFFFFFFF : 0;
+    usize i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str + i)), needle)) ^ flip;
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    usize j = sse2_first_byte(str + i, len - i, c, negate);
+    return j == MAX_SIZE_T_VALUE ? j : i + j;
+}
+
+__attribute__((target("avx2")))
+static usize	avx2_last_byte(const char* str, usize len, char c, bool negate)
+{
+    __m256i needle = _mm256_set1_epi8(c);
+    u32 flip = negate ? 0xFFFFFFFF : 0;
+    usize i = len;
+    while (i >= 32)
+    {
+        i -= 32;
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str + i)), needle)) ^ flip;
+        if (mask != 0)
+            return i + 31 - __builtin_clz(mask);
+    }
+    return sse2_last_byte(str, i, c, negate);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i	avx2_set_match(__m256i v, __m256i row_lo, __m256i row_hi, __m256i bits)
+{
+    __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(v, nibble_mask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask);
+    __m256i use_hi_row = _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7));
+    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(row_lo, lo), _mm256_shuffle_epi8(row_hi, lo), use_hi_row);
+    __m256i bit = _mm256_shuffle_epi8(bits, hi);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+__attribute__((target("avx2")))
+static usize	avx2_first_in_set(const char* str, usize len, const DByteSet* set, bool negate)
+{
+    __m256i row_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set -> table));
+    __m256i row_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(set -> table + 16)));
+    __m256i bits = _mm256_setr_epi8(D_SEARCH_SET_BITS, D_SEARCH_SET_BITS);
+    u32 flip = negate ? 0xFFFFFFFF : 0;
+    usize i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(str + i));
+        u32 mask = (u32)_mm256_movemask_epi8(avx2_set_match(v, row_lo, row_hi, bits)) ^ flip;
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    usize j = ssse3_first_in_set(str + i, len - i, set, negate);
+    return j == MAX_SIZE_T_VALUE ? j : i + j;
+}
+
+__attribute__((target("avx2")))
+static usize	avx2_last_in_set(const char* str, usize len, const DByteSet* set, bool negate)
+{
+    __m256i row_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set -> table));
+    __m256i row_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(set -> table + 16)));
+    __m256i bits = _mm256_setr_epi8(D_SEARCH_SET_BITS, D_SEARCH_SET_BITS);
+    u32 flip = negate ? 0xFFFFFFFF : 0;
+    usize i = len;
+    while (i >= 32)
+    {
+        i -= 32;
+        __m256i v = _mm256_loadu_si256((const __m256i*)(str + i));
+        u32 mask = (u32)_mm256_movemask_epi8(avx2_set_match(v, row_lo, row_hi, bits)) ^ flip;
+        if (mask != 0)
+            return i + 31 - __builtin_clz(mask);
+    }
+    return ssse3_last_in_set(str, i, set, negate);
+}
+
+__attribute__((target("avx2")))
+static usize	avx2_first_short_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    usize candidates = len - needle_len + 1;
+    usize i = 0;
+    for (; i + 32 <= candidates; i += 32)
+    {
+        __m256i eq_first = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str + i)), first);
+        __m256i eq_last = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str + i + needle_len - 1)), last);
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last));
+        while (mask != 0)
+        {
+            usize bit = __builtin_ctz(mask);
+            if (memcmp(str + i + bit + 1, needle + 1, needle_len - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    usize j = sse2_first_short_str(str + i, len - i, needle, needle_len);
+    return j == MAX_SIZE_T_VALUE ? j : i + j;
+}
+
+__attribute__((target("avx2")))
+static usize	avx2_last_short_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    usize i = len - needle_len + 1;
+    while (i >= 32)
+    {
+        i -= 32;
+        __m256i eq_first = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str + i)), first);
+        __m256i eq_last = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str + i + needle_len - 1)), last);
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last));
+        while (mask != 0)
+        {
+            usize bit = 31 - __builtin_clz(mask);
+            if (memcmp(str + i + bit + 1, needle + 1, needle_len - 2) == 0)
+                return i + bit;
+            mask &= ~(1U << bit);
+        }
+    }
+    return sse2_last_short_str(str, i + needle_len - 1, needle, needle_len);
+}
+
+__attribute__((target("avx2")))
+static u64	avx2_byte_mask64(const char* str, char c)
+{
+    __m256i needle = _mm256_set1_epi8(c);
+    u32 lo = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)str), needle));
+    u32 hi = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(str + 32)), needle));
+    return ((u64)hi << 32) | lo;
+}
+
+__attribute__((target("avx2")))
+static u64	avx2_set_mask64(const char* str, const DByteSet* set)
+{
+    __m256i row_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set -> table));
+    __m256i row_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(set -> table + 16)));
+    __m256i bits = _mm256_setr_epi8(D_SEARCH_SET_BITS, D_SEARCH_SET_BITS);
+    u32 lo = (u32)_mm256_movemask_epi8(avx2_set_match(_mm256_loadu_si256((const __m256i*)str), row_lo, row_hi, bits));
+    u32 hi = (u32)_mm256_movemask_epi8(avx2_set_match(_mm256_loadu_si256((const __m256i*)(str + 32)), row_lo, row_hi, bits));
+    return ((u64)hi << 32) | lo;
+}
+
+static const DSearchKernels g_avx2_kernels = {
+    D_SEARCH_ISA_AVX2, avx2_first_byte, avx2_last_byte, avx2_first_in_set, avx2_last_in_set,
+    avx2_first_short_str, avx2_last_short_str, avx2_byte_mask64, avx2_set_mask64
+};
+
+#endif
+
+//Kernels in use, resolved on the first search
+static const DSearchKernels* g_kernels = NULL;
+
+static const DSearchKernels*	d_search_select_kernels(DSearchIsa isa)
+{
+#if D_SEARCH_X86
+    __builtin_cpu_init();
+    if (isa >= D_SEARCH_ISA_AVX2 && __builtin_cpu_supports("avx2"))
+        return &g_avx2_kernels;
+    if (isa >= D_SEARCH_ISA_SSSE3 && __builtin_cpu_supports("ssse3"))
+        return &g_ssse3_kernels;
+    if (isa >= D_SEARCH_ISA_SSE2 && __builtin_cpu_supports("sse2"))
+        return &g_sse2_kernels;
+#else
+    (void)isa;
+#endif
+    return &g_scalar_kernels;
+}
+
+static inline const DSearchKernels*	d_search_kernels(void)
+{
+    const DSearchKernels* kernels = __atomic_load_n(&g_kernels, __ATOMIC_ACQUIRE);
+    if (kernels == NULL)
+    {
+        kernels = d_search_select_kernels(D_SEARCH_ISA_AVX2);
+        __atomic_store_n(&g_kernels, kernels, __ATOMIC_RELEASE);
+    }
+    return kernels;
+}
+
+DSearchIsa	d_search_get_isa(void)
+{
+    return d_search_kernels() -> isa;
+}
+
+DSearchIsa	d_search_set_isa(DSearchIsa isa)
+{
+    const DSearchKernels* kernels = d_search_select_kernels(isa);
+    __atomic_store_n(&g_kernels, kernels, __ATOMIC_RELEASE);
+    return kernels -> isa;
+}
+
+usize		d_search_first_byte(const char* str, usize len, char c)
+{
+    return d_search_kernels() -> first_byte(str, len, c, false);
+}
+
+usize		d_search_last_byte(const char* str, usize len, char c)
+{
+    return d_search_kernels() -> last_byte(str, len, c, false);
+}
+
+usize		d_search_first_not_byte(const char* str, usize len, char c)
+{
+    return d_search_kernels() -> first_byte(str, len, c, true);
+}
+
+usize		d_search_last_not_byte(const char* str, usize len, char c)
+{
+    return d_search_kernels() -> last_byte(str, len, c, true);
+}
+
+usize		d_search_first_in_set(const char* str, usize len, const DByteSet* set)
+{
+    return d_search_kernels() -> first_in_set(str, len, set, false);
+}
+
+usize		d_search_first_not_in_set(const char* str, usize len, const DByteSet* set)
+{
+    return d_search_kernels() -> first_in_set(str, len, set, true);
+}
+
+usize		d_search_last_in_set(const char* str, usize len, const DByteSet* set)
+{
+    return d_search_kernels() -> last_in_set(str, len, set, false);
+}
+
+usize		d_search_last_not_in_set(const char* str, usize len, const DByteSet* set)
+{
+    return d_search_kernels() -> last_in_set(str, len, set, true);
+}
+
+/*
+** Boyer-Moore-Horspool, used for the needles longer than D_NEEDLE_SHORT_MAX_LEN. The forward search
+** shifts on the byte under the last needle char, the backward one on the byte under the first needle char.
+*/
+
+static void	d_horspool_build_forward_shift(usize shift[256], const char* needle, usize needle_len)
+{
+    for (usize c = 0; c < 256; ++c)
+        shift[c] = needle_len;
+    for (usize j = 0; j + 1 < needle_len; ++j)
+        shift[(u8)needle[j]] = needle_len - 1 - j;
+}
+
+static void	d_horspool_build_backward_shift(usize shift[256], const char* needle, usize needle_len)
+{
+    for (usize c = 0; c < 256; ++c)
+        shift[c] = needle_len;
+    for (usize j = needle_len - 1; j > 0; --j)
+        shift[(u8)needle[j]] = j;
+}
+
+static usize	d_horspool_first(const char* str, usize len, const char* needle, usize needle_len, const usize shift[256])
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    char last = needle[needle_len - 1];
+    for (usize i = 0; i <= len - needle_len;)
+    {
+        char c = str[i + needle_len - 1];
+        if (c == last && memcmp(str + i, needle, needle_len - 1) == 0)
+            return i;
+        i += shift[(u8)c];
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+static usize	d_horspool_last(const char* str, usize len, const char* needle, usize needle_len, const usize shift[256])
+{
+    if (needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    char first = needle[0];
+    usize i = len - needle_len;
+    while (1)
+    {
+        char c = str[i];
+        if (c == first && memcmp(str + i + 1, needle + 1, needle_len - 1) == 0)
+            return i;
+        if (shift[(u8)c] > i)
+            break;
+        i -= shift[(u8)c];
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+usize		d_search_first_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len == 0 || needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    if (needle_len == 1)
+        return d_search_first_byte(str, len, needle[0]);
+    if (needle_len <= D_NEEDLE_SHORT_MAX_LEN)
+        return d_search_kernels() -> first_short_str(str, len, needle, needle_len);
+    usize shift[256];
+    d_horspool_build_forward_shift(shift, needle, needle_len);
+    return d_horspool_first(str, len, needle, needle_len, shift);
+}
+
+usize		d_search_last_str(const char* str, usize len, const char* needle, usize needle_len)
+{
+    if (needle_len == 0 || needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    if (needle_len == 1)
+        return d_search_last_byte(str, len, needle[0]);
+    if (needle_len <= D_NEEDLE_SHORT_MAX_LEN)
+        return d_search_kernels() -> last_short_str(str, len, needle, needle_len);
+    usize shift[256];
+    d_horspool_build_backward_shift(shift, needle, needle_len);
+    return d_horspool_last(str, len, needle, needle_len, shift);
+}
+
+DNeedle*	d_needle_new(const char* needle, usize len)
+{
+    DNeedle* dneedle;
+    if (needle == NULL || (dneedle = malloc(sizeof(DNeedle) + len + 1)) == NULL)
+        return NULL;
+    dneedle -> len = len;
+    memcpy(dneedle -> data, needle, len);
+    dneedle -> data[len] = '\0';
+    if (len > D_NEEDLE_SHORT_MAX_LEN)
+    {
+        d_horspool_build_forward_shift(dneedle -> forward_shift, needle, len);
+        d_horspool_build_backward_shift(dneedle -> backward_shift, needle, len);
+    }
+    return dneedle;
+}
+
+DNeedle*	d_needle_new_from_c_string(const char* needle)
+{
+    if (needle == NULL)
+        return NULL;
+    return d_needle_new(needle, strlen(needle));
+}
+
+usize		d_needle_get_len(const DNeedle* needle)
+{
+    return needle -> len;
+}
+
+usize		d_needle_find_first(const DNeedle* needle, const char* str, usize len)
+{
+    if (needle -> len <= D_NEEDLE_SHORT_MAX_LEN)
+        return d_search_first_str(str, len, needle -> data, needle -> len);
+    return d_horspool_first(str, len, needle -> data, needle -> len, needle -> forward_shift);
+}
+
+usize		d_needle_find_last(const DNeedle* needle, const char* str, usize len)
+{
+    if (needle -> len <= D_NEEDLE_SHORT_MAX_LEN)
+        return d_search_last_str(str, len, needle -> data, needle -> len);
+    return d_horspool_last(str, len, needle -> data, needle -> len, needle -> backward_shift);
+}
+
+void		d_needle_destroy(DNeedle** needle)
+{
+    free(*needle);
+    *needle = NULL;
+}
+
+/*
+** Token boundaries. The input is classified 64 bytes at a time into a delimiter bit mask; a token starts
+** on every token byte preceded by a delimiter (or by the start of the input) and ends on every delimiter
+** preceded by a token byte. As starts and ends alternate, the positions of the bits of `starts | ends`
+** taken in order are directly the begin/end pairs. The whole input is read exactly once.
+*/
+static usize	d_search_token_bounds(const char* str, usize len, char c, const DByteSet* set, DArray* bounds)
+{
+    const DSearchKernels* kernels = d_search_kernels();
+    usize edges[64];
+    usize count = 0;
+    u64 in_token = 0;
+    for (usize i = 0; i < len; i += 64)
+    {
+        u64 delimiters;
+        if (len - i >= 64)
+            delimiters = set != NULL ? kernels -> set_mask64(str + i, set) : kernels -> byte_mask64(str + i, c);
+        else
+        {
+            //the bytes past the end are delimiters so that a token running to the end gets closed
+            delimiters = set != NULL ? scalar_set_mask(str + i, len - i, set) : scalar_byte_mask(str + i, len - i, c);
+            delimiters |= ~(u64)0 << (len - i);
+        }
+        u64 token = ~delimiters;
+        u64 previous = (token << 1) | in_token;
+        u64 changes = (token & ~previous) | (~token & previous);
+        usize n = 0;
+        while (changes != 0)
+        {
+            edges[n++] = i + __builtin_ctzll(changes);
+            changes &= changes - 1;
+        }
+        if (n != 0 && d_array_append_vals(bounds, edges, n) == NULL)
+            return MAX_SIZE_T_VALUE;
+        count += n;
+        in_token = token >> 63;
+    }
+    if (in_token != 0)
+    {
+        if (d_array_append_vals(bounds, &len, 1) == NULL)
+            return MAX_SIZE_T_VALUE;
+        ++count;
+    }
+    return count / 2;
+}
+
+usize		d_search_token_bounds_by_byte(const char* str, usize len, char c, DArray* bounds)
+{
+    return d_search_token_bounds(str, len, c, NULL, bounds);
+}
+
+usize		d_search_token_bounds_in_set(const char* str, usize len, const DByteSet* set, DArray* bounds)
+{
+    return d_search_token_bounds(str, len, 0, set, bounds);
+}
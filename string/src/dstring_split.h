@@ -0,0 +1,11 @@
+#ifndef __D_STRING_SPLIT__H
+#define __D_STRING_SPLIT__H
+
+/*
+ * Private to the string module: the tuning of the splits shared by `DString` and `DStringView`.
+ */
+
+//Number of token offsets a split records on the stack before moving them to the heap
+#define D_STRING_SPLIT_INLINE_BOUNDS 128
+
+#endif
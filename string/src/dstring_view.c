@@ -0,0 +1,319 @@
+#include "dstring_view.h"
+#include "dstring_split.h"
+#include <string.h>
+#include <stdlib.h>
+
+DStringView	d_string_view_from_buffer(const char* data, usize len)
+{
+    if (data == NULL)
+        return D_STRING_VIEW_NULL;
+    return (DStringView){ .data = data, .len = len };
+}
+
+DStringView	d_string_view_from_c_string(const char* str)
+{
+    if (str == NULL)
+        return D_STRING_VIEW_NULL;
+    return (DStringView){ .data = str, .len = strlen(str) };
+}
+
+DStringView	d_string_view_from_dstring(const DString* dstring)
+{
+    return (DStringView){ .data = dstring -> string, .len = dstring -> len };
+}
+
+DString*	d_string_new_from_view(DStringView view)
+{
+    DString* dstring = d_string_new_with_reserve(view.len);
+    if (dstring == NULL || view.len == 0)
+        return dstring;
+    return d_string_push_str_with_len(dstring, view.data, view.len);
+}
+
+char*		d_string_view_to_c_string(DStringView view)
+{
+    if (d_string_view_is_null(view))
+        return NULL;
+    char* str = malloc(sizeof(char) * (view.len + 1));
+    if (str == NULL)
+        return NULL;
+    if (view.len != 0)
+        memcpy(str, view.data, view.len);
+    str[view.len] = '\0';
+    return str;
+}
+
+int32		d_string_view_compare(DStringView view1, DStringView view2)
+{
+    usize len = view1.len < view2.len ? view1.len : view2.len;
+    int32 diff = len == 0 ? 0 : memcmp(view1.data, view2.data, len);
+    if (diff != 0)
+        return diff;
+    return (view1.len > view2.len) - (view1.len < view2.len);
+}
+
+bool		d_string_view_equals_c_string(DStringView view, const char* str)
+{
+    usize len = strlen(str);
+    return view.len == len && (len == 0 || memcmp(view.data, str, len) == 0);
+}
+
+DStringView	d_string_view_substr(DStringView view, usize pos, usize len)
+{
+    if (d_string_view_is_null(view) || pos > view.len)
+        return D_STRING_VIEW_NULL;
+    if (len > view.len - pos)
+        len = view.len - pos;
+    return (DStringView){ .data = view.data + pos, .len = len };
+}
+
+DStringView	d_string_substr_view(DString* dstring, usize pos, usize len)
+{
+    return d_string_view_substr(d_string_view_from_dstring(dstring), pos, len);
+}
+
+usize		d_string_view_find_first_matching_char_from_index(DStringView view, char c, usize pos)
+{
+    if (pos >= view.len)
+        return MAX_SIZE_T_VALUE;
+    usize i = d_search_first_byte(view.data + pos, view.len - pos, c);
+    return i == MAX_SIZE_T_VALUE ? i : pos + i;
+}
+
+usize		d_string_view_find_last_matching_char_from_index(DStringView view, char c, usize pos)
+{
+    if (view.len == 0)
+        return MAX_SIZE_T_VALUE;
+    return d_search_last_byte(view.data, pos >= view.len ? view.len : pos + 1, c);
+}
+
+usize		d_string_view_find_first_char_in_str_from_index(DStringView view, const char* str, usize pos)
+{
+    DByteSet set;
+    if (pos >= view.len)
+        return MAX_SIZE_T_VALUE;
+    d_byte_set_init(&set, str);
+    usize i = d_search_first_in_set(view.data + pos, view.len - pos, &set);
+    return i == MAX_SIZE_T_VALUE ? i : pos + i;
+}
+
+usize		d_string_view_find_first_matching_str_from_index(DStringView view, DStringView needle, usize pos)
+{
+    if (pos >= view.len)
+        return MAX_SIZE_T_VALUE;
+    usize i = d_search_first_str(view.data + pos, view.len - pos, needle.data, needle.len);
+    return i == MAX_SIZE_T_VALUE ? i : pos + i;
+}
+
+DStringView	d_string_view_trim_left_by_char(DStringView view, char c)
+{
+    usize i = d_search_first_not_byte(view.data, view.len, c);
+    if (i == MAX_SIZE_T_VALUE)
+        i = view.len;
+    if (i != 0)
+        view = (DStringView){ .data = view.data + i, .len = view.len - i };
+    return view;
+}
+
+DStringView	d_string_view_trim_right_by_char(DStringView view, char c)
+{
+    usize i = d_search_last_not_byte(view.data, view.len, c);
+    view.len = i == MAX_SIZE_T_VALUE ? 0 : i + 1;
+    return view;
+}
+
+DStringView	d_string_view_trim_left_by_predicate(DStringView view, match fn)
+{
+    usize i = 0;
+    while (i < view.len && fn(view.data[i]) != 0)
+        ++i;
+    if (i != 0)
+        view = (DStringView){ .data = view.data + i, .len = view.len - i };
+    return view;
+}
+
+DStringView	d_string_view_trim_right_by_predicate(DStringView view, match fn)
+{
+    while (view.len != 0 && fn(view.data[view.len - 1]) != 0)
+        --view.len;
+    return view;
+}
+
+DStringView	d_string_trim_left_by_char_view(DString* dstring, char c)
+{
+    return d_string_view_trim_left_by_char(d_string_view_from_dstring(dstring), c);
+}
+
+DStringView	d_string_trim_right_by_char_view(DString* dstring, char c)
+{
+    return d_string_view_trim_right_by_char(d_string_view_from_dstring(dstring), c);
+}
+
+DStringView	d_string_trim_left_by_predicate_view(DString* dstring, match fn)
+{
+    return d_string_view_trim_left_by_predicate(d_string_view_from_dstring(dstring), fn);
+}
+
+DStringView	d_string_trim_right_by_predicate_view(DString* dstring, match fn)
+{
+    return d_string_view_trim_right_by_predicate(d_string_view_from_dstring(dstring), fn);
+}
+
+bool		d_string_view_next_token_by_char(DStringView* remaining, char c, DStringView* token)
+{
+    const char* str = remaining -> data;
+    usize len = remaining -> len;
+    usize i = d_search_first_not_byte(str, len, c);
+    if (i == MAX_SIZE_T_VALUE)
+    {
+        remaining -> data = len != 0 ? str + len : str;
+        remaining -> len = 0;
+        return false;
+    }
+    usize j = d_search_first_byte(str + i, len - i, c);
+    j = j == MAX_SIZE_T_VALUE ? len : i + j;
+    *token = (DStringView){ .data = str + i, .len = j - i };
+    *remaining = (DStringView){ .data = str + j, .len = len - j };
+    return true;
+}
+
+//Same as d_string_view_next_token_by_char with every char flagged in `set` being a delimiter
+static bool	d_string_view_next_token_in_set(DStringView* remaining, const DByteSet* set, DStringView* token)
+{
+    const char* str = remaining -> data;
+    usize len = remaining -> len;
+    usize i = d_search_first_not_in_set(str, len, set);
+    if (i == MAX_SIZE_T_VALUE)
+    {
+        remaining -> data = len != 0 ? str + len : str;
+        remaining -> len = 0;
+        return false;
+    }
+    usize j = d_search_first_in_set(str + i, len - i, set);
+    j = j == MAX_SIZE_T_VALUE ? len : i + j;
+    *token = (DStringView){ .data = str + i, .len = j - i };
+    *remaining = (DStringView){ .data = str + j, .len = len - j };
+    return true;
+}
+
+bool		d_string_view_next_token_by_char_of_str(DStringView* remaining, const char* str, DStringView* token)
+{
+    DByteSet set;
+    d_byte_set_init(&set, str);
+    return d_string_view_next_token_in_set(remaining, &set, token);
+}
+
+//Builds the DArray of views described by the `count` begin/end pairs of `bounds`
+static DArray*	d_string_view_array_from_bounds(const char* str, const DArray* bounds, usize count)
+{
+    DArray* array = d_array_new(false, sizeof(DStringView), count);
+    if (array == NULL)
+        return NULL;
+    const usize* offsets = bounds -> data;
+    for (usize i = 0; i < count; ++i)
+    {
+        DStringView token = { .data = str + offsets[2 * i], .len = offsets[2 * i + 1] - offsets[2 * i] };
+        d_array_push_back(array, token);
+    }
+    return array;
+}
+
+DArray*		d_string_view_split_by_char(DStringView view, char c)
+{
+    D_SMALL_ARRAY(usize, D_STRING_SPLIT_INLINE_BOUNDS) storage;
+    DArray* bounds = d_small_array_init(&storage, false);
+    DArray* array = NULL;
+    usize count = d_search_token_bounds_by_byte(view.data, view.len, c, bounds);
+    if (count != MAX_SIZE_T_VALUE)
+        array = d_string_view_array_from_bounds(view.data, bounds, count);
+    d_array_destroy(&bounds);
+    return array;
+}
+
+DArray*		d_string_view_split_by_char_of_str(DStringView view, const char* str)
+{
+    D_SMALL_ARRAY(usize, D_STRING_SPLIT_INLINE_BOUNDS) storage;
+    DArray* bounds = d_small_array_init(&storage, false);
+    DArray* array = NULL;
+    DByteSet set;
+    d_byte_set_init(&set, str);
+    usize count = d_search_token_bounds_in_set(view.data, view.len, &set, bounds);
+    if (count != MAX_SIZE_T_VALUE)
+        array = d_string_view_array_from_bounds(view.data, bounds, count);
+    d_array_destroy(&bounds);
+    return array;
+}
+
+DArray*		d_string_split_by_char_view(DString* dstring, char c)
+{
+    return d_string_view_split_by_char(d_string_view_from_dstring(dstring), c);
+}
+
+DArray*		d_string_split_by_char_of_str_view(DString* dstring, const char* str)
+{
+    return d_string_view_split_by_char_of_str(d_string_view_from_dstring(dstring), str);
+}
+
+//Allocates the single block holding the tokens described by the `count` begin/end pairs of `bounds`
+static DStringTokens*	d_string_tokens_from_bounds(const char* str, const DArray* bounds, usize count, bool copy)
+{
+    const usize* offsets = bounds -> data;
+    usize chars = 0;
+    if (copy == true)
+    {
+        for (usize i = 0; i < count; ++i)
+            chars += offsets[2 * i + 1] - offsets[2 * i] + 1;
+    }
+    DStringTokens* tokens = malloc(sizeof(DStringTokens) + count * sizeof(DStringView) + chars);
+    if (tokens == NULL)
+        return NULL;
+    tokens -> len = count;
+    tokens -> tokens = (DStringView*)(tokens + 1);
+    char* buffer = (char*)(tokens -> tokens + count);
+    for (usize i = 0; i < count; ++i)
+    {
+        usize len = offsets[2 * i + 1] - offsets[2 * i];
+        const char* data = str + offsets[2 * i];
+        if (copy == true)
+        {
+            memcpy(buffer, data, len);
+            buffer[len] = '\0';
+            data = buffer;
+            buffer += len + 1;
+        }
+        tokens -> tokens[i] = (DStringView){ .data = data, .len = len };
+    }
+    return tokens;
+}
+
+DStringTokens*	d_string_tokenize_by_char(DString* dstring, char c, bool copy)
+{
+    D_SMALL_ARRAY(usize, D_STRING_SPLIT_INLINE_BOUNDS) storage;
+    DArray* bounds = d_small_array_init(&storage, false);
+    DStringTokens* tokens = NULL;
+    usize count = d_search_token_bounds_by_byte(dstring -> string, dstring -> len, c, bounds);
+    if (count != MAX_SIZE_T_VALUE)
+        tokens = d_string_tokens_from_bounds(dstring -> string, bounds, count, copy);
+    d_array_destroy(&bounds);
+    return tokens;
+}
+
+DStringTokens*	d_string_tokenize_by_char_of_str(DString* dstring, const char* str, bool copy)
+{
+    D_SMALL_ARRAY(usize, D_STRING_SPLIT_INLINE_BOUNDS) storage;
+    DArray* bounds = d_small_array_init(&storage, false);
+    DStringTokens* tokens = NULL;
+    DByteSet set;
+    d_byte_set_init(&set, str);
+    usize count = d_search_token_bounds_in_set(dstring -> string, dstring -> len, &set, bounds);
+    if (count != MAX_SIZE_T_VALUE)
+        tokens = d_string_tokens_from_bounds(dstring -> string, bounds, count, copy);
+    d_array_destroy(&bounds);
+    return tokens;
+}
+
+void			d_string_tokens_destroy(DStringTokens** tokens)
+{
+    free(*tokens);
+    *tokens = NULL;
+}
@@ -1,9 +1,13 @@
 #include <dstring.h>
+#include <dstring_view.h>
+#include <dstring_search.h>
+#include <dstring_fmt.h>
 #include <dtest.h>
 #include <dutils.h>
 #include <string.h>
 #include <general_lib.h>
 #include <ctype.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 char*   itoa_usize(void* data)
@@ -193,19 +197,59 @@ void    test_d_string_resize(void)
 void    test_d_string_get_capacity(void)
 {
     DString* dstring = d_string_new();
-    usize capacity = 8;
+    usize capacity = D_STRING_SSO_CAPACITY;
     usize string_capacity = d_string_get_capacity(dstring);
-    assert_eq_custom(&string_capacity, &capacity, sizeof(usize), itoa_usize); //Default capacity is 8
+    assert_eq_custom(&string_capacity, &capacity, sizeof(usize), itoa_usize); //Default capacity is the inline one
     d_string_destroy(&dstring);
 }
 
 void    test_d_string_modify_capacity(void)
 {
     DString* dstring = d_string_new();
-    usize capacity = 10;
+    usize capacity = 100;
     d_string_modify_capacity(dstring, capacity);
     usize _cap = d_string_get_capacity(dstring);
     assert_eq_custom(&_cap, &capacity, sizeof(usize), itoa_usize);
+    capacity = 10;
+    d_string_modify_capacity(dstring, capacity);
+    capacity = D_STRING_SSO_CAPACITY;
+    _cap = d_string_get_capacity(dstring);
+    assert_eq_custom(&_cap, &capacity, sizeof(usize), itoa_usize);
+    d_string_destroy(&dstring);
+}
+
+void    test_d_string_short_string_optimization(void)
+{
+    char *short_str = "short key";
+    char *long_str = "a string that is definitely too long for the inline buffer";
+    DString* dstring = d_string_new_from_c_string(short_str);
+    usize len = strlen(short_str);
+    usize capacity = D_STRING_SSO_CAPACITY;
+    usize _cap = d_string_get_capacity(dstring);
+    bool is_inline = (char*)dstring -> string > (char*)dstring && (char*)dstring -> string < (char*)dstring + 64;
+    bool expected = true;
+    assert_eq_custom(&_cap, &capacity, sizeof(usize), itoa_usize);
+    assert_eq_custom(&is_inline, &expected, sizeof(bool), NULL);
+    d_assert_eq(dstring -> string, short_str, len + 1);
+
+    d_string_push_c_str(dstring, long_str);
+    char *res = "short keya string that is definitely too long for the inline buffer";
+    len = strlen(res);
+    _cap = d_string_get_capacity(dstring);
+    d_assert(_cap >= len, &_cap, &len, itoa_usize);
+    d_assert_eq(dstring -> string, res, len + 1);
+    assert_eq_custom(&dstring -> len, &len, sizeof(usize), itoa_usize);
+
+    d_string_replace_from_str(dstring, "abc");
+    d_string_push_str_of_dstring(dstring, dstring);
+    res = "abcabc";
+    len = strlen(res);
+    d_assert_eq(dstring -> string, res, len + 1);
+    assert_eq_custom(&dstring -> len, &len, sizeof(usize), itoa_usize);
+    d_string_modify_capacity(dstring, 0);
+    _cap = d_string_get_capacity(dstring);
+    assert_eq_custom(&_cap, &capacity, sizeof(usize), itoa_usize);
+    d_assert_eq(dstring -> string, res, len + 1);
     d_string_destroy(&dstring);
 }
 
@@ -1066,6 +1110,407 @@ void    test_d_string_trim_right_by_predicate_new(void)
     d_string_destroy(&dstring1);
 }
 
+//Reference implementation the search kernels are checked against
+static usize    naive_search(const char* str, usize len, const char* set, bool negate, bool reverse)
+{
+    for (usize k = 0; k < len; ++k)
+    {
+        usize i = reverse ? len - 1 - k : k;
+        bool in_set = str[i] != '\0' && strchr(set, str[i]) != NULL;
+        if (in_set != negate)
+            return i;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+//Runs every kernel of the current instruction set on every sub buffer of `buffer`, returns the number of mismatches
+static usize    check_search_kernels(const char* buffer, usize buffer_len, const char* set_str)
+{
+    DByteSet set;
+    d_byte_set_init(&set, set_str);
+    usize mismatches = 0;
+    for (usize start = 0; start < 40; ++start)
+    {
+        for (usize len = 0; start + len <= buffer_len; ++len)
+        {
+            const char* str = buffer + start;
+            char c[2] = {set_str[0], '\0'};
+            mismatches += d_search_first_byte(str, len, c[0]) != naive_search(str, len, c, false, false);
+            mismatches += d_search_last_byte(str, len, c[0]) != naive_search(str, len, c, false, true);
+            mismatches += d_search_first_not_byte(str, len, c[0]) != naive_search(str, len, c, true, false);
+            mismatches += d_search_last_not_byte(str, len, c[0]) != naive_search(str, len, c, true, true);
+            mismatches += d_search_first_in_set(str, len, &set) != naive_search(str, len, set_str, false, false);
+            mismatches += d_search_last_in_set(str, len, &set) != naive_search(str, len, set_str, false, true);
+            mismatches += d_search_first_not_in_set(str, len, &set) != naive_search(str, len, set_str, true, false);
+            mismatches += d_search_last_not_in_set(str, len, &set) != naive_search(str, len, set_str, true, true);
+        }
+    }
+    return mismatches;
+}
+
+void    test_d_search_kernels(void)
+{
+    char buffer[160];
+    const char* sets[] = {"a", " \t\n", "\x80\xff\x01z", "0123456789", "AZaz{}~\x7f"};
+    srand(42);
+    DSearchIsa best = d_search_get_isa();
+    for (int isa = D_SEARCH_ISA_SCALAR; isa <= (int)best; ++isa)
+    {
+        usize used = d_search_set_isa((DSearchIsa)isa);
+        usize expected = isa;
+        assert_eq_custom(&used, &expected, sizeof(usize), itoa_usize);
+        for (usize k = 0; k < sizeof(sets) / sizeof(sets[0]); ++k)
+        {
+            usize set_len = strlen(sets[k]);
+            //sparse buffer: mostly one set char so both the "in" and the "not in" searches run far
+            for (usize i = 0; i < sizeof(buffer); ++i)
+                buffer[i] = rand() % 16 == 0 ? (char)(rand() % 256) : sets[k][rand() % set_len];
+            usize mismatches = check_search_kernels(buffer, sizeof(buffer), sets[k]);
+            expected = 0;
+            assert_eq_custom(&mismatches, &expected, sizeof(usize), itoa_usize);
+            for (usize i = 0; i < sizeof(buffer); ++i)
+                buffer[i] = (char)(rand() % 256);
+            mismatches = check_search_kernels(buffer, sizeof(buffer), sets[k]);
+            assert_eq_custom(&mismatches, &expected, sizeof(usize), itoa_usize);
+        }
+    }
+    d_search_set_isa(best);
+}
+
+static usize    naive_search_str(const char* str, usize len, const char* needle, usize needle_len, bool reverse)
+{
+    if (needle_len == 0 || needle_len > len)
+        return MAX_SIZE_T_VALUE;
+    for (usize k = 0; k <= len - needle_len; ++k)
+    {
+        usize i = reverse ? len - needle_len - k : k;
+        if (memcmp(str + i, needle, needle_len) == 0)
+            return i;
+    }
+    return MAX_SIZE_T_VALUE;
+}
+
+void    test_d_search_str(void)
+{
+    char buffer[300];
+    char needle[80];
+    srand(21);
+    DSearchIsa best = d_search_get_isa();
+    for (int isa = D_SEARCH_ISA_SCALAR; isa <= (int)best; ++isa)
+    {
+        d_search_set_isa((DSearchIsa)isa);
+        usize mismatches = 0;
+        for (usize round = 0; round < 400; ++round)
+        {
+            //tiny alphabets give many partial matches, the needle is often cut from the buffer itself
+            usize alphabet = 2 + rand() % 3;
+            usize len = rand() % sizeof(buffer);
+            usize needle_len = rand() % 2 ? (usize)(rand() % 6) : rand() % sizeof(needle);
+            for (usize i = 0; i < len; ++i)
+                buffer[i] = 'a' + rand() % alphabet;
+            if (needle_len <= len && rand() % 2)
+                memcpy(needle, buffer + rand() % (len - needle_len + 1), needle_len);
+            else
+            {
+                for (usize i = 0; i < needle_len; ++i)
+                    needle[i] = 'a' + rand() % alphabet;
+            }
+            DNeedle* dneedle = d_needle_new(needle, needle_len);
+            usize first = naive_search_str(buffer, len, needle, needle_len, false);
+            usize last = naive_search_str(buffer, len, needle, needle_len, true);
+            mismatches += d_search_first_str(buffer, len, needle, needle_len) != first;
+            mismatches += d_search_last_str(buffer, len, needle, needle_len) != last;
+            mismatches += d_needle_find_first(dneedle, buffer, len) != first;
+            mismatches += d_needle_find_last(dneedle, buffer, len) != last;
+            d_needle_destroy(&dneedle);
+        }
+        usize expected = 0;
+        assert_eq_custom(&mismatches, &expected, sizeof(usize), itoa_usize);
+    }
+    d_search_set_isa(best);
+}
+
+void    test_d_string_find_matching_needle(void)
+{
+    DString* dstring = d_string_new_from_c_string("the quick brown fox jumps over the lazy dog, the end");
+    DNeedle* needle = d_needle_new_from_c_string("the");
+    usize i = d_string_find_first_matching_needle_from_index(dstring, needle, 1);
+    usize expected = 31;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_find_last_matching_needle_from_index(dstring, needle, MAX_SIZE_T_VALUE);
+    expected = 45;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_find_last_matching_needle_from_index(dstring, needle, 44);
+    expected = 31;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_find_first_matching_needle_from_index(dstring, needle, 46);
+    expected = MAX_SIZE_T_VALUE;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    d_needle_destroy(&needle);
+
+    needle = d_needle_new_from_c_string("jumps over the lazy dog, the end");
+    i = d_string_find_first_matching_needle_from_index(dstring, needle, 0);
+    expected = 20;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    d_needle_destroy(&needle);
+    needle = d_needle_new_from_c_string("quick brown fox jumps over the lazy dog");
+    i = d_string_find_last_matching_needle_from_index(dstring, needle, 3);
+    expected = MAX_SIZE_T_VALUE;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_find_last_matching_needle_from_index(dstring, needle, 4);
+    expected = 4;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    d_needle_destroy(&needle);
+    d_string_destroy(&dstring);
+}
+
+void    test_d_search_token_bounds(void)
+{
+    char buffer[300];
+    DByteSet set;
+    d_byte_set_init(&set, " ,");
+    srand(7);
+    DSearchIsa best = d_search_get_isa();
+    for (int isa = D_SEARCH_ISA_SCALAR; isa <= (int)best; ++isa)
+    {
+        d_search_set_isa((DSearchIsa)isa);
+        usize mismatches = 0;
+        for (usize round = 0; round < 200; ++round)
+        {
+            usize len = rand() % sizeof(buffer);
+            for (usize i = 0; i < len; ++i)
+                buffer[i] = " ,ab"[rand() % (round % 2 ? 4 : 3)];
+            DArray* by_byte = d_array_new(false, sizeof(usize), 0);
+            DArray* in_set = d_array_new(false, sizeof(usize), 0);
+            usize count_by_byte = d_search_token_bounds_by_byte(buffer, len, ' ', by_byte);
+            usize count_in_set = d_search_token_bounds_in_set(buffer, len, &set, in_set);
+            mismatches += count_by_byte * 2 != by_byte -> len || count_in_set * 2 != in_set -> len;
+            //check against a byte per byte scan
+            usize k_byte = 0;
+            usize k_set = 0;
+            for (usize i = 0; i < len; ++i)
+            {
+                bool starts_byte = buffer[i] != ' ' && (i == 0 || buffer[i - 1] == ' ');
+                bool starts_set = d_byte_set_contains(&set, buffer[i]) == 0 && (i == 0 || d_byte_set_contains(&set, buffer[i - 1]));
+                if (starts_byte)
+                    mismatches += k_byte >= by_byte -> len || d_array_get_val_by_index(by_byte, usize, k_byte) != i, k_byte += 2;
+                if (starts_set)
+                    mismatches += k_set >= in_set -> len || d_array_get_val_by_index(in_set, usize, k_set) != i, k_set += 2;
+            }
+            mismatches += k_byte != by_byte -> len || k_set != in_set -> len;
+            for (usize k = 1; k < by_byte -> len; k += 2)
+            {
+                usize end = d_array_get_val_by_index(by_byte, usize, k);
+                mismatches += end != len && buffer[end] != ' ';
+                mismatches += buffer[end - 1] == ' ';
+            }
+            d_array_destroy(&by_byte);
+            d_array_destroy(&in_set);
+        }
+        usize expected = 0;
+        assert_eq_custom(&mismatches, &expected, sizeof(usize), itoa_usize);
+    }
+    d_search_set_isa(best);
+}
+
+void    test_d_string_tokenize(void)
+{
+    DString* dstring = d_string_new_from_c_string("  key=value; other = 12 ;last  ");
+    char *tab[] = {"key=value;", "other", "=", "12", ";last"};
+    DStringTokens* tokens = d_string_tokenize_by_char(dstring, ' ', true);
+    usize len = 5;
+    bool expected = true;
+    assert_eq_custom(&tokens -> len, &len, sizeof(usize), itoa_usize);
+    for (usize i = 0; i < tokens -> len && i < len; ++i)
+    {
+        d_assert_eq(tokens -> tokens[i].data, tab[i], strlen(tab[i]) + 1);
+        bool outside = tokens -> tokens[i].data < dstring -> string || tokens -> tokens[i].data > dstring -> string + dstring -> len;
+        assert_eq_custom(&outside, &expected, sizeof(bool), NULL);
+    }
+    d_string_tokens_destroy(&tokens);
+    assert_eq_null(tokens);
+
+    char *tab_set[] = {"key", "value", "other", "12", "last"};
+    tokens = d_string_tokenize_by_char_of_str(dstring, " =;", false);
+    assert_eq_custom(&tokens -> len, &len, sizeof(usize), itoa_usize);
+    for (usize i = 0; i < tokens -> len && i < len; ++i)
+    {
+        bool res = d_string_view_equals_c_string(tokens -> tokens[i], tab_set[i]);
+        assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+        res = tokens -> tokens[i].data >= dstring -> string && tokens -> tokens[i].data < dstring -> string + dstring -> len;
+        assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    }
+    d_string_tokens_destroy(&tokens);
+
+    d_string_replace_from_str(dstring, "   ");
+    tokens = d_string_tokenize_by_char(dstring, ' ', true);
+    len = 0;
+    assert_eq_custom(&tokens -> len, &len, sizeof(usize), itoa_usize);
+    d_string_tokens_destroy(&tokens);
+    d_string_destroy(&dstring);
+}
+
+void    test_d_string_view_substr(void)
+{
+    DString* dstring = d_string_new_from_c_string("hello world");
+    DStringView view = d_string_substr_view(dstring, 6, 100);
+    usize len = 5;
+    bool expected = true;
+    bool res = d_string_view_equals_c_string(view, "world");
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    assert_eq_custom(&view.len, &len, sizeof(usize), itoa_usize);
+    res = view.data == dstring -> string + 6;
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+
+    view = d_string_view_substr(d_string_view_from_dstring(dstring), 0, 5);
+    res = d_string_view_equals_c_string(view, "hello");
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+
+    view = d_string_substr_view(dstring, 11, 3);
+    len = 0;
+    res = d_string_view_is_null(view) == false;
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    assert_eq_custom(&view.len, &len, sizeof(usize), itoa_usize);
+
+    view = d_string_substr_view(dstring, 12, 3);
+    res = d_string_view_is_null(view);
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+
+    view = d_string_view_from_buffer("abcdef", 3);
+    char* str = d_string_view_to_c_string(view);
+    d_assert_eq(str, "abc", 4);
+    free(str);
+    DString* copy = d_string_new_from_view(view);
+    d_assert_eq(copy -> string, "abc", 4);
+    assert_eq_custom(&copy -> len, &view.len, sizeof(usize), itoa_usize);
+    d_string_destroy(&copy);
+
+    int32 cmp = d_string_view_compare(d_string_view_from_c_string("abc"), d_string_view_from_c_string("abd")) < 0;
+    int32 one = 1;
+    assert_eq_custom(&cmp, &one, sizeof(int32), itoa_i32);
+    cmp = d_string_view_compare(d_string_view_from_c_string("abcd"), view) > 0;
+    assert_eq_custom(&cmp, &one, sizeof(int32), itoa_i32);
+    cmp = d_string_view_compare(d_string_view_from_c_string("abc"), view) == 0;
+    assert_eq_custom(&cmp, &one, sizeof(int32), itoa_i32);
+    d_string_destroy(&dstring);
+}
+
+void    test_d_string_view_find(void)
+{
+    DStringView view = d_string_view_from_buffer("abcabcXYZ", 6);
+    usize i = d_string_view_find_first_matching_char_from_index(view, 'c', 3);
+    usize expected = 5;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_view_find_first_matching_char_from_index(view, 'X', 0);
+    expected = MAX_SIZE_T_VALUE;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_view_find_last_matching_char_from_index(view, 'a', MAX_SIZE_T_VALUE);
+    expected = 3;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_view_find_last_matching_char_from_index(view, 'a', 2);
+    expected = 0;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_view_find_first_char_in_str_from_index(view, "cX", 0);
+    expected = 2;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_view_find_first_matching_str_from_index(view, d_string_view_from_c_string("bc"), 2);
+    expected = 4;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_view_find_first_matching_str_from_index(view, d_string_view_from_c_string("cX"), 0);
+    expected = MAX_SIZE_T_VALUE;
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+    i = d_string_view_find_first_matching_str_from_index(view, d_string_view_from_c_string(""), 0);
+    assert_eq_custom(&i, &expected, sizeof(usize), itoa_usize);
+}
+
+void    test_d_string_view_trim(void)
+{
+    DString* dstring = d_string_new_from_c_string("  12 hello 34  ");
+    bool expected = true;
+    DStringView view = d_string_trim_left_by_char_view(dstring, ' ');
+    bool res = d_string_view_equals_c_string(view, "12 hello 34  ");
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    view = d_string_view_trim_right_by_char(view, ' ');
+    res = d_string_view_equals_c_string(view, "12 hello 34");
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    view = d_string_view_trim_left_by_predicate(view, is_num);
+    view = d_string_view_trim_right_by_predicate(view, is_num);
+    res = d_string_view_equals_c_string(view, " hello ");
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+
+    d_string_replace_from_str(dstring, "aaaa");
+    view = d_string_trim_right_by_char_view(dstring, 'a');
+    res = view.len == 0 && view.data == dstring -> string;
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    view = d_string_trim_left_by_char_view(dstring, 'a');
+    res = view.len == 0 && view.data == dstring -> string + 4;
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    d_string_replace_from_str(dstring, "ABc");
+    view = d_string_trim_left_by_predicate_view(dstring, is_upper);
+    res = d_string_view_equals_c_string(view, "c");
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    view = d_string_trim_right_by_predicate_view(dstring, is_upper);
+    res = d_string_view_equals_c_string(view, "ABc");
+    assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    d_string_destroy(&dstring);
+}
+
+void    test_splitting_by_char_view(DString* dstring, char **tab, usize nb_test, char c, const char* delims)
+{
+    printf("Start Test [%lu]\n", nb_test);
+    DArray* arr = delims == NULL ? d_string_split_by_char_view(dstring, c) : d_string_split_by_char_of_str_view(dstring, delims);
+    usize len = 0;
+    while (tab[len] != NULL)
+        ++len;
+    assert_eq_custom(&arr -> len, &len, sizeof(usize), itoa_usize);
+    for (usize i = 0; i < len && i < arr -> len; ++i)
+    {
+        DStringView view = d_array_get_val_by_index(arr, DStringView, i);
+        bool res = d_string_view_equals_c_string(view, tab[i]);
+        bool expected = true;
+        assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+        res = view.data >= dstring -> string && view.data + view.len <= dstring -> string + dstring -> len;
+        assert_eq_custom(&res, &expected, sizeof(bool), NULL);
+    }
+    printf("\nEnd Test [%lu]\n", nb_test);
+    d_array_destroy(&arr);
+}
+
+void    test_d_string_split_view(void)
+{
+    DString* dstring = d_string_new_from_c_string("ccc");
+    usize nb_test = 0;
+
+    char *tab0[] = {NULL};
+    test_splitting_by_char_view(dstring, tab0, nb_test++, 'c', NULL);
+    d_string_replace_from_str(dstring, "bonjour");
+    char *tab1[] = {"bonjour", NULL};
+    test_splitting_by_char_view(dstring, tab1, nb_test++, 'c', NULL);
+    char *tab2[] = {"b", "nj", "ur", NULL};
+    test_splitting_by_char_view(dstring, tab2, nb_test++, 'o', NULL);
+    char *tab3[] = {"onjour", NULL};
+    test_splitting_by_char_view(dstring, tab3, nb_test++, 'b', NULL);
+    char *tab4[] = {"b", "nj", NULL};
+    test_splitting_by_char_view(dstring, tab4, nb_test++, 0, "our");
+    d_string_replace_from_str(dstring, "");
+    test_splitting_by_char_view(dstring, tab0, nb_test++, 'r', NULL);
+    test_splitting_by_char_view(dstring, tab0, nb_test++, 0, " ");
+    d_string_replace_from_str(dstring, "  GET /index.html\tHTTP/1.1 ");
+    char *tab5[] = {"GET", "/index.html", "HTTP/1.1", NULL};
+    test_splitting_by_char_view(dstring, tab5, nb_test++, 0, " \t");
+
+    DStringView rest = d_string_view_from_dstring(dstring);
+    DStringView token;
+    usize count = 0;
+    while (d_string_view_next_token_by_char(&rest, ' ', &token))
+        ++count;
+    usize expected = 2;
+    assert_eq_custom(&count, &expected, sizeof(usize), itoa_usize);
+    expected = 0;
+    assert_eq_custom(&rest.len, &expected, sizeof(usize), itoa_usize);
+    d_string_destroy(&dstring);
+}
+
 void    test_splitting_by_char(DString* dstring, char **tab, usize nb_test, char c)
 {
     printf("Start Test [%lu]\n", nb_test);
@@ -1215,6 +1660,164 @@ void    test_d_string_convert_as_d_array(void)
 
 }
 
+//Allocator recording the size of every block in front of it, so that the sizes the strings give back can be checked
+typedef struct {
+    usize   allocs;
+    usize   live_bytes;
+    usize   size_mismatches;
+} CountingAllocator;
+
+void*   counting_alloc(void* ctx, usize size)
+{
+    CountingAllocator* counter = ctx;
+    usize* block = malloc(sizeof(usize) * 2 + size);
+    if (block == NULL)
+        return NULL;
+    block[0] = size;
+    ++counter -> allocs;
+    counter -> live_bytes += size;
+    return block + 2;
+}
+
+void    counting_free(void* ctx, void* ptr, usize size)
+{
+    CountingAllocator* counter = ctx;
+    usize* block = (usize*)ptr - 2;
+    counter -> size_mismatches += block[0] != size;
+    counter -> live_bytes -= block[0];
+    free(block);
+}
+
+void*   counting_realloc(void* ctx, void* ptr, usize old_size, usize new_size)
+{
+    void* new_ptr = counting_alloc(ctx, new_size);
+    if (new_ptr == NULL || ptr == NULL)
+        return new_ptr;
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    counting_free(ctx, ptr, old_size);
+    return new_ptr;
+}
+
+void    test_d_string_allocator(void)
+{
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    DString* dstring = d_string_new_with_allocator(&allocator);
+    bool expected = true;
+    bool valid = dstring != NULL && d_string_get_allocator(dstring) == &allocator && counter.allocs == 1;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    for (usize i = 0; i < 100; ++i)
+        d_string_push_c_str(dstring, "0123456789");
+    valid = dstring -> len == 1000 && strncmp(dstring -> string + 990, "0123456789", 10) == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    //back to the inline buffer, then to the heap again
+    d_string_resize(dstring, 5);
+    d_string_modify_capacity(dstring, 5);
+    d_string_modify_capacity(dstring, 200);
+    d_assert_eq(dstring -> string, "01234", 6);
+    DString* copy = d_string_new_from_c_string_with_allocator("a string too long to be stored inline", &allocator);
+    d_assert_eq(copy -> string, "a string too long to be stored inline", 38);
+    d_string_destroy(&dstring);
+    d_string_destroy(&copy);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+    assert_eq_custom(&counter.size_mismatches, &zero, sizeof(usize), itoa_usize);
+    dstring = d_string_new_from_c_string_with_allocator(NULL, NULL);
+    valid = dstring -> len == 0 && d_string_get_allocator(dstring) == NULL;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_string_destroy(&dstring);
+}
+
+void    test_d_string_append_fmt(void)
+{
+    DString* dstring = d_string_new_from_c_string("> ");
+    DString* name = d_string_new_from_c_string("dstring");
+    DStringView view = d_string_view_from_c_string("viewed text");
+    bool expected = true;
+    bool valid = d_string_append_fmt(dstring, "%d|%i|%u|%ld|%lld|%zu|%zd|%x|%X|%c|%%", -42, 7, 4000000000u,
+        -9000000000L, (long long)-9223372036854775807LL - 1, (usize)18446744073709551615ULL, (ssize_t)-3, 0xbeefu,
+        0xbeefu, 'z') == dstring;
+    char expected_text[256];
+    snprintf(expected_text, sizeof(expected_text), "> %d|%i|%u|%ld|%lld|%zu|%zd|%x|%X|%c|%%", -42, 7, 4000000000u,
+        -9000000000L, (long long)-9223372036854775807LL - 1, (usize)18446744073709551615ULL, (ssize_t)-3, 0xbeefu,
+        0xbeefu, 'z');
+    valid = valid && dstring -> len == strlen(expected_text);
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_assert_eq(dstring -> string, expected_text, dstring -> len + 1);
+    //widths, flags and precisions as printf, strings, dynamic strings and views
+    d_string_replace_from_str(dstring, "");
+    d_string_append_fmt(dstring, "[%5d][%-5d][%05d][%*s][%-*s][%.3s][%.*s][%8x][%-3c]", -42, 42, -42, 6, "ab", 4,
+        "cd", "truncated", 2, "xyz", 0xffu, 'q');
+    snprintf(expected_text, sizeof(expected_text), "[%5d][%-5d][%05d][%*s][%-*s][%.3s][%.*s][%8x][%-3c]", -42, 42,
+        -42, 6, "ab", 4, "cd", "truncated", 2, "xyz", 0xffu, 'q');
+    d_assert_eq(dstring -> string, expected_text, strlen(expected_text) + 1);
+    d_string_replace_from_str(dstring, "");
+    d_string_append_fmt(dstring, "%S %V %.4V %s %g %g %hg %g %08g", name, view, view, (char*)NULL, 0.1, 1e21, 0.1f,
+        -1.5, -1.5);
+    d_assert_eq(dstring -> string, "dstring viewed text view (null) 0.1 1e+21 0.1 -1.5 -00001.5", 60);
+    //a dynamic string may be appended to itself
+    d_string_append_fmt(name, "+%S", name);
+    d_assert_eq(name -> string, "dstring+dstring", 16);
+    //an unknown conversion leaves the string as it was
+    usize len = dstring -> len;
+    valid = d_string_append_fmt(dstring, "abc%q", 1) == NULL && dstring -> len == len
+        && dstring -> string[len] == '\0';
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_string_destroy(&dstring);
+    d_string_destroy(&name);
+}
+
+void    test_d_string_append(void)
+{
+    DString* dstring = d_string_new();
+    DString* name = d_string_new_from_c_string("dstring");
+    const char* str = "str";
+    int8 small = -5;
+    u8 byte = 200;
+    bool flag = true;
+    bool expected = true;
+    bool valid = d_string_append(dstring, "int ", -42, " u32 ", (u32)7, " u64 ", 18446744073709551615ULL, " long ",
+        -9000000000L, " small ", small, " byte ", byte, " char ", (char)'c', " bool ", flag) == dstring;
+    d_assert_eq(dstring -> string, "int -42 u32 7 u64 18446744073709551615 long -9000000000 small -5 byte 200 "
+        "char c bool true", 91);
+    d_string_replace_from_str(dstring, "");
+    valid = valid && d_string_append(dstring, str, ' ', name, " ", d_string_view_from_c_string("view"), " ", 0.3,
+        " ", 0.3f, " ", 1e-7) == dstring;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_assert_eq(dstring -> string, "str32dstring view 0.3 0.3 1e-7", 31);
+    d_string_destroy(&dstring);
+    d_string_destroy(&name);
+}
+
+//The spare capacity is used first, then the string grows a single time whatever the number of values
+void    test_d_string_append_fmt_growth(void)
+{
+    CountingAllocator counter = {0};
+    DAllocator allocator = { counting_alloc, counting_realloc, counting_free, &counter };
+    DString* dstring = d_string_new_with_allocator(&allocator);
+    bool expected = true;
+    d_string_append_fmt(dstring, "%d-%d", 12, 34);
+    bool valid = counter.allocs == 1 && strcmp(dstring -> string, "12-34") == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_string_append_fmt(dstring, "%s %d %s %g %s %u", "a string long enough to leave the inline buffer", 123456789,
+        "and another one, much longer than all of the spare capacity", 0.5, "of the string", 42u);
+    valid = counter.allocs == 2 && strcmp(dstring -> string, "12-34a string long enough to leave the inline buffer "
+        "123456789 and another one, much longer than all of the spare capacity 0.5 of the string 42") == 0;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_string_append(dstring, " and ", 1, " more line with ", 3.25, " values that grows the string once more: ",
+        "0123456789012345678901234567890123456789012345678901234567890123456789");
+    valid = counter.allocs == 3 && dstring -> len == 280;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    usize capacity = d_string_get_capacity(dstring);
+    while (dstring -> len + 10 <= capacity)
+        d_string_append(dstring, "x");
+    valid = counter.allocs == 3;
+    assert_eq_custom(&valid, &expected, sizeof(bool), NULL);
+    d_string_destroy(&dstring);
+    usize zero = 0;
+    assert_eq_custom(&counter.live_bytes, &zero, sizeof(usize), itoa_usize);
+}
+
 int main()
 {
     TEST("test_string_destroy", test_d_string_destroy(););
@@ -1227,6 +1830,7 @@ int main()
     TEST("test_d_string_get_capacity", test_d_string_get_capacity(););
     TEST("test_d_string_resize", test_d_string_resize(););
     TEST("test_d_string_modify_capacity", test_d_string_modify_capacity(););
+    TEST("test_d_string_short_string_optimization", test_d_string_short_string_optimization(););
     TEST("test_d_string_push_char", test_d_string_push_char(););
     TEST("test_d_string_push_str_with_len", test_d_string_push_str_with_len(););
     TEST("test_d_string_push_c_str", test_d_string_push_c_str(););
@@ -1298,4 +1902,18 @@ int main()
 
     TEST("test_d_string_split_by_char", test_d_string_split_by_char(););
     TEST("test_d_string_split_by_char_of_str", test_d_string_split_by_char_of_str(););
+
+    TEST("test_d_search_kernels", test_d_search_kernels(););
+    TEST("test_d_search_str", test_d_search_str(););
+    TEST("test_d_string_find_matching_needle", test_d_string_find_matching_needle(););
+    TEST("test_d_search_token_bounds", test_d_search_token_bounds(););
+    TEST("test_d_string_tokenize", test_d_string_tokenize(););
+    TEST("test_d_string_view_substr", test_d_string_view_substr(););
+    TEST("test_d_string_view_find", test_d_string_view_find(););
+    TEST("test_d_string_view_trim", test_d_string_view_trim(););
+    TEST("test_d_string_split_view", test_d_string_split_view(););
+    TEST("test_d_string_allocator", test_d_string_allocator(););
+    TEST("test_d_string_append_fmt", test_d_string_append_fmt(););
+    TEST("test_d_string_append", test_d_string_append(););
+    TEST("test_d_string_append_fmt_growth", test_d_string_append_fmt_growth(););
 }
\ No newline at end of file